@@ -0,0 +1,274 @@
+/**
+ * Word Clock Benchmarks - Light sensor trace
+ *
+ * 4000 raw 12-bit ADC readings shaped like an evening at the clock:
+ * daylight fading from ~3400 to ~1200, a lamp pushing the level back
+ * across the 2600 threshold for a while, sensor noise and lamp ripple.
+ * The sensor benchmark filters it LIGHT_SAMPLES readings at a time,
+ * exactly as readLightLevel() does.
+ *
+ * Generated, not captured; swap in a capture from a real clock to tune
+ * the filter for a particular room.
+ */
+
+#ifndef BENCH_ADC_TRACE_H
+#define BENCH_ADC_TRACE_H
+
+#include <stdint.h>
+
+static const uint16_t ADC_TRACE[] = {
+    3382, 3445, 3477, 3415, 3364, 3325, 3401, 3485, 3467, 3424, 3391, 3350, 3308, 3327, 3424, 3354,
+    3457, 3415, 3316, 3343, 3384, 3427, 3424, 3447, 3444, 3329, 3334, 3279, 3433, 3452, 3458, 3432,
+    3350, 3272, 3336, 3372, 3476, 3404, 3407, 3260, 3268, 3328, 3437, 3434, 3392, 3429, 3375, 3319,
+    3287, 3327, 3409, 3436, 3427, 3325, 3292, 3331, 3361, 3398, 3476, 3420, 3224, 3336, 3288, 3368,
+    3361, 3433, 3434, 3276, 3348, 3364, 3345, 3444, 3403, 3414, 3302, 3300, 3263, 3341, 3462, 3295,
+    3418, 3313, 3311, 3285, 3389, 3418, 3360, 3441, 3260, 3296, 3252, 3377, 3396, 3401, 3400, 3327,
+    3304, 3325, 3336, 3417, 3311, 3395, 3328, 3310, 3276, 3328, 3370, 3387, 3324, 3307, 3275, 3280,
+    3348, 3367, 3388, 3330, 3271, 3241, 3262, 3303, 3384, 3387, 3383, 3270, 3279, 3260, 3363, 3399,
+    3410, 3314, 3266, 3330, 3306, 3358, 3361, 3396, 3346, 3276, 3224, 3235, 3294, 3345, 3449, 3337,
+    3382, 3297, 3229, 3328, 3296, 3367, 3361, 3261, 3259, 3264, 3306, 3361, 3367, 3355, 3248, 3206,
+    3262, 3330, 3340, 3385, 3281, 3288, 3237, 3312, 3299, 3328, 3367, 3312, 3334, 3218, 3251, 3299,
+    3305, 3361, 3315, 3249, 3270, 3247, 3217, 3254, 3364, 3330, 3326, 3284, 3306, 3303, 3305, 3315,
+    3268, 3328, 3247, 3257, 3257, 3288, 3379, 3361, 3249, 3233, 3265, 3312, 3358, 3360, 3282, 3227,
+    3175, 3270, 3311, 3303, 3348, 3270, 3232, 3247, 3248, 3318, 3370, 3325, 3275, 3288, 3249, 3253,
+    3290, 3242, 3370, 3270, 3176, 3216, 3157, 3244, 3362, 3348, 3300, 3237, 3193, 3188, 3272, 3325,
+    3406, 3329, 3256, 3209, 3301, 3306, 3320, 3269, 3305, 3179, 3178, 3181, 3195, 3298, 3359, 3273,
+    3270, 3113, 3220, 3281, 3266, 3300, 3263, 3182, 3209, 3174, 3228, 3328, 3336, 3226, 3226, 3202,
+    3192, 3244, 3354, 3277, 3276, 3292, 3221, 3187, 3194, 3306, 3328, 3247, 3186, 3163, 3164, 3237,
+    3287, 3300, 3293, 3165, 3188, 3231, 3286, 3338, 3308, 3167, 3180, 3173, 3145, 3227, 3322, 3333,
+    3276, 3204, 3146, 3224, 3240, 3279, 3262, 3267, 3148, 3118, 3167, 3130, 3348, 3339, 3202, 3193,
+    3172, 3152, 3271, 3333, 3275, 3277, 3194, 3156, 3177, 3192, 3278, 3313, 3222, 3138, 3114, 3126,
+    3278, 3348, 3265, 3238, 3189, 3074, 3162, 3198, 3291, 3222, 3253, 3094, 3107, 3125, 3215, 3247,
+    3257, 3265, 3208, 3087, 3152, 3204, 3203, 3303, 3200, 3205, 3127, 3131, 3165, 3248, 3305, 3258,
+    3119, 3084, 3106, 3233, 3301, 3215, 3252, 3122, 3132, 3130, 3218, 3260, 3209, 3273, 3178, 3055,
+    3140, 3224, 3283, 3232, 3212, 3124, 3188, 3114, 3253, 3259, 3239, 3166, 3144, 3186, 3098, 3200,
+    3251, 3221, 3153, 3114, 3118, 3129, 3189, 3245, 3277, 3185, 3159, 3117, 3088, 3143, 3222, 3308,
+    3203, 3215, 3034, 3181, 3175, 3170, 3246, 3229, 3110, 3091, 3186, 3231, 3264, 3181, 3213, 3095,
+    3095, 3196, 3200, 3240, 3212, 3224, 3169, 3118, 3072, 3157, 3125, 3148, 3157, 3129, 3101, 3012,
+    3199, 3172, 3220, 3249, 3102, 3068, 3002, 3157, 3187, 3236, 3184, 3149, 3089, 3076, 3155, 3201,
+    3175, 3224, 3133, 2973, 3128, 3230, 3239, 3223, 3174, 3104, 3034, 3044, 3143, 3274, 3121, 3078,
+    3110, 3114, 3031, 3163, 3132, 3104, 3165, 3095, 3047, 3043, 3122, 3167, 3117, 3238, 3120, 3150,
+    3100, 3119, 3113, 3150, 3062, 3081, 2993, 3057, 3069, 3211, 3173, 3107, 3082, 3056, 3072, 3100,
+    3134, 3086, 3155, 3173, 2992, 3051, 3034, 3171, 3132, 3133, 3093, 3028, 3052, 3030, 3221, 3182,
+    3203, 3009, 2969, 3025, 2988, 3099, 3205, 3164, 3136, 2977, 3008, 3143, 3103, 3150, 3111, 3038,
+    3122, 3047, 3034, 3155, 3178, 3197, 3002, 2977, 3031, 3086, 3137, 3153, 3115, 3088, 3063, 3066,
+    3086, 3207, 3146, 3059, 3151, 3006, 3106, 3084, 3166, 3221, 3099, 3075, 3075, 3053, 3038, 3137,
+    3097, 3077, 3089, 2969, 3081, 3117, 3114, 3139, 3092, 3044, 2998, 2968, 3014, 3117, 3191, 3111,
+    2986, 3093, 2985, 3028, 3128, 3152, 3051, 3037, 2937, 3011, 3072, 3169, 3142, 3069, 3040, 2938,
+    2983, 3094, 3176, 3124, 3183, 3019, 3016, 2996, 3100, 3098, 3073, 3034, 3071, 2986, 3022, 3078,
+    3089, 3100, 3058, 2974, 2974, 3047, 3053, 3104, 3025, 3090, 3014, 3001, 2951, 3051, 3087, 3088,
+    2984, 3007, 2950, 3007, 3021, 3112, 3115, 3055, 3034, 2910, 2982, 2957, 3081, 3028, 3096, 3046,
+    3014, 3042, 3079, 3026, 3136, 3052, 2930, 2997, 2969, 3032, 3082, 3037, 3098, 2983, 2919, 2970,
+    3046, 3102, 3117, 3010, 2913, 3001, 2932, 3009, 3083, 3078, 3063, 3027, 2922, 3040, 3081, 3031,
+    3039, 3089, 2858, 2977, 3034, 2994, 3005, 3057, 3092, 3005, 2920, 2994, 3036, 3093, 3114, 3114,
+    2998, 2928, 2951, 2989, 3069, 3069, 3002, 2901, 2875, 2978, 2954, 3044, 3070, 3104, 2973, 2943,
+    2944, 2991, 3060, 3127, 3031, 2987, 2956, 2972, 2960, 3029, 3078, 3074, 2957, 2888, 2983, 2966,
+    3024, 3083, 2958, 2974, 2918, 2943, 3012, 3031, 3004, 2966, 2996, 2981, 2961, 2999, 3108, 3087,
+    2963, 2966, 2941, 2960, 3044, 3035, 2992, 2999, 2904, 2901, 2935, 2991, 2965, 3017, 3022, 3011,
+    2971, 3009, 2961, 3053, 3038, 3106, 3014, 2925, 2988, 2933, 3044, 3002, 2979, 2956, 2847, 2896,
+    2980, 3019, 2992, 3044, 2916, 2925, 2998, 2960, 2946, 3074, 3053, 2952, 2962, 2960, 2965, 3046,
+    2968, 2898, 2868, 2874, 2946, 2955, 2998, 3041, 3001, 2991, 2852, 2908, 3001, 2947, 3072, 3060,
+    2899, 2923, 2930, 2973, 2962, 3065, 2994, 2824, 2862, 2910, 2977, 2993, 2972, 2987, 2963, 2887,
+    2916, 2986, 3008, 2980, 3003, 2876, 2925, 2794, 2949, 2957, 3046, 2969, 2932, 2850, 2832, 2893,
+    2970, 2986, 3053, 2835, 2907, 2897, 2981, 2960, 3035, 2925, 2947, 2919, 2884, 2823, 2978, 2934,
+    2956, 2903, 2908, 2889, 2860, 2928, 3019, 2889, 2899, 2818, 2805, 2909, 3012, 2996, 2943, 2930,
+    2845, 2823, 2883, 2957, 3048, 2948, 2916, 2826, 2864, 2842, 3023, 2997, 2978, 2803, 2842, 2777,
+    2926, 2921, 3006, 2870, 2903, 2826, 2861, 2959, 2968, 2955, 2811, 2890, 2883, 2848, 2906, 2936,
+    2970, 2897, 2885, 2849, 2909, 2907, 2953, 2987, 2908, 2880, 2882, 2917, 2885, 2846, 2941, 2941,
+    2863, 2890, 2776, 2925, 2986, 2965, 2914, 2899, 2834, 2813, 2854, 2918, 2893, 2911, 2862, 2826,
+    2876, 2870, 2890, 2899, 2934, 2871, 2863, 2799, 2851, 2989, 2937, 2939, 2918, 2823, 2811, 2819,
+    2906, 2929, 2910, 2887, 2781, 2798, 2882, 2894, 2853, 2855, 2878, 2800, 2896, 2950, 2908, 2892,
+    2892, 2786, 2773, 2826, 2874, 2969, 2967, 2901, 2837, 2751, 2852, 2844, 2841, 2877, 2928, 2871,
+    2840, 2815, 2832, 2929, 2987, 2854, 2870, 2829, 2846, 2891, 2900, 2896, 2860, 2771, 2790, 2903,
+    2917, 2862, 2983, 2848, 2857, 2857, 2744, 2840, 2848, 2852, 2853, 2850, 2929, 2773, 2773, 2890,
+    2912, 2877, 2836, 2816, 2698, 2849, 2885, 2908, 2830, 2810, 2802, 2774, 2837, 2845, 2841, 2862,
+    2743, 2745, 2726, 2785, 2919, 2914, 2858, 2803, 2768, 2768, 2773, 2871, 2884, 2834, 2739, 2713,
+    2684, 2794, 2893, 2829, 2838, 2799, 2744, 2807, 2821, 2891, 2857, 2841, 2838, 2731, 2763, 2789,
+    2837, 2870, 2854, 2816, 2745, 2749, 2717, 2866, 2896, 2803, 2756, 2795, 2710, 2813, 2842, 2871,
+    2788, 2783, 2705, 2828, 2816, 2913, 2885, 2792, 2796, 2683, 2680, 2806, 2861, 2784, 2808, 2783,
+    2719, 2803, 2759, 2913, 2869, 2819, 2782, 2685, 2785, 2756, 2901, 2848, 2800, 2813, 2718, 2744,
+    2776, 2833, 2914, 2819, 2803, 2693, 2793, 2749, 2865, 2840, 2811, 2761, 2678, 2757, 2763, 2812,
+    2793, 2786, 2718, 2738, 2769, 2802, 2812, 2873, 2825, 2681, 2783, 2767, 2708, 2805, 2842, 2829,
+    2759, 2732, 2726, 2719, 2822, 2785, 2811, 2737, 2703, 2789, 2679, 2714, 2840, 2777, 2735, 2766,
+    2759, 2716, 2854, 2760, 2785, 2685, 2635, 2719, 2703, 2840, 2786, 2713, 2730, 2716, 2678, 2685,
+    2753, 2863, 2806, 2680, 2727, 2725, 2694, 2830, 2780, 2745, 2725, 2722, 2768, 2713, 2786, 2824,
+    2832, 2705, 2722, 2706, 2752, 2728, 2748, 2791, 2712, 2715, 2700, 2752, 2771, 2757, 2785, 2752,
+    2681, 2625, 2736, 2794, 2738, 2764, 2739, 2713, 2736, 2751, 2743, 2746, 2734, 2709, 2728, 2692,
+    2714, 2766, 2771, 2671, 2691, 2619, 2686, 2713, 2706, 2748, 2696, 2727, 2658, 2607, 2719, 2764,
+    2770, 2750, 2724, 2628, 2615, 2744, 2769, 2783, 2690, 2666, 2636, 2646, 2641, 2753, 2824, 2715,
+    2673, 2693, 2692, 2753, 2790, 2802, 2780, 2652, 2658, 2653, 2714, 2769, 2768, 2696, 2655, 2546,
+    2625, 2716, 2736, 2689, 2704, 2727, 2611, 2603, 2724, 2776, 2734, 2759, 2650, 2659, 2637, 2672,
+    2722, 2735, 2659, 2597, 2600, 2592, 2702, 2692, 2731, 2696, 2666, 2586, 2699, 2674, 2753, 2685,
+    2693, 2624, 2636, 2626, 2704, 2720, 2740, 2697, 2671, 2626, 2700, 2667, 2734, 2758, 2715, 2581,
+    2619, 2628, 2692, 2754, 2776, 2662, 2659, 2558, 2616, 2659, 2761, 2731, 2731, 2677, 2601, 2545,
+    2719, 2706, 2755, 2716, 2586, 2638, 2618, 2683, 2676, 2793, 2646, 2602, 2620, 2598, 2673, 2705,
+    2735, 2636, 2634, 2609, 2662, 2639, 2698, 2736, 2582, 2589, 2588, 2534, 2586, 2739, 2699, 2608,
+    2632, 2498, 2568, 2600, 2720, 2697, 2715, 2653, 2574, 2565, 2662, 2641, 2739, 2636, 2550, 2651,
+    2579, 2539, 2687, 2650, 2712, 2642, 2569, 2628, 2631, 2700, 2668, 2650, 2572, 2561, 2569, 2626,
+    2669, 2651, 2620, 2601, 2580, 2563, 2595, 2608, 2731, 2642, 2589, 2497, 2551, 2622, 2700, 2673,
+    2569, 2597, 2585, 2648, 2679, 2640, 2681, 2607, 2600, 2564, 2531, 2641, 2654, 2619, 2685, 2506,
+    2564, 2602, 2659, 2658, 2764, 2518, 2573, 2570, 2516, 2622, 2666, 2663, 2698, 2589, 2549, 2467,
+    2591, 2552, 2664, 2635, 2595, 2510, 2617, 2595, 2576, 2638, 2639, 2558, 2603, 2503, 2613, 2633,
+    2615, 2642, 2575, 2470, 2472, 2581, 2707, 2664, 2672, 2569, 2540, 2534, 2574, 2617, 2548, 2561,
+    2600, 2515, 2501, 2593, 2631, 2644, 2644, 2590, 2481, 2473, 2615, 2645, 2579, 2654, 2521, 2564,
+    2468, 2541, 2648, 2692, 2595, 2547, 2541, 2564, 2608, 2627, 2582, 2632, 2547, 2504, 2560, 2561,
+    2606, 2586, 2560, 2568, 2468, 2500, 2513, 2603, 2667, 2559, 2520, 2445, 2589, 2504, 2560, 2649,
+    2612, 2519, 2508, 2549, 2543, 2642, 2618, 2633, 2500, 2502, 2536, 2511, 2660, 2610, 2649, 2485,
+    2486, 2479, 2503, 2654, 2642, 2542, 2574, 2427, 2444, 2505, 2552, 2569, 2513, 2492, 2447, 2505,
+    2521, 2518, 2629, 2576, 2504, 2431, 2447, 2517, 2628, 2446, 2566, 2549, 2425, 2425, 2549, 2564,
+    2643, 2552, 2508, 2437, 2429, 2504, 2586, 2586, 2522, 2445, 2477, 2464, 2543, 2586, 2540, 2591,
+    2520, 2421, 2452, 2538, 2545, 2601, 2533, 2481, 2467, 2377, 2517, 2559, 2537, 2562, 2578, 2436,
+    2491, 2578, 2495, 2551, 2460, 2560, 2432, 2462, 2484, 2542, 2564, 2570, 2474, 2474, 2501, 2508,
+    2558, 2531, 2566, 2569, 2411, 2459, 2470, 2582, 2594, 2422, 2463, 2437, 2423, 2466, 2495, 2571,
+    2560, 2448, 2441, 2376, 2511, 2543, 2552, 2498, 2427, 2416, 2474, 2424, 2533, 2506, 2500, 2485,
+    2447, 2386, 2518, 2558, 2578, 2605, 2431, 2396, 2394, 2457, 2560, 2554, 2444, 2458, 2382, 2404,
+    2464, 2464, 2474, 2529, 2502, 2456, 2420, 2495, 2557, 2586, 2582, 2449, 2397, 2400, 2502, 2489,
+    2432, 2552, 2416, 2433, 2347, 2434, 2491, 2505, 2553, 2410, 2423, 2320, 2419, 2500, 2524, 2422,
+    2467, 2422, 2450, 2432, 2523, 2515, 2538, 2421, 2490, 2448, 2424, 2498, 2475, 2414, 2389, 2441,
+    2391, 2388, 2551, 2503, 2426, 2461, 2383, 2438, 2461, 2420, 2400, 2510, 2458, 2398, 2424, 2383,
+    2458, 2588, 2529, 2369, 2420, 2449, 2421, 2504, 2537, 2443, 2386, 2382, 2375, 2398, 2425, 2534,
+    2475, 2399, 2347, 2360, 2408, 2458, 2497, 2480, 2417, 2391, 2377, 2488, 2430, 2460, 2492, 2341,
+    2262, 2370, 2516, 2556, 2419, 2505, 2419, 2375, 2365, 2436, 2502, 2438, 2480, 2420, 2360, 2330,
+    2357, 2405, 2471, 2435, 2408, 2377, 2333, 2462, 2454, 2428, 2457, 2376, 2387, 2460, 2465, 2442,
+    2494, 2434, 2335, 2365, 2401, 2337, 2466, 2456, 2350, 2355, 2342, 2352, 2465, 2453, 2458, 2376,
+    2433, 2277, 2310, 2371, 2463, 2424, 2404, 2308, 2291, 2370, 2417, 2480, 2450, 2373, 2400, 2311,
+    2374, 2376, 2485, 2476, 2470, 2352, 2348, 2387, 2319, 2403, 2491, 2394, 2377, 2373, 2313, 2386,
+    2471, 2416, 2426, 2367, 2321, 2277, 2372, 2348, 2506, 2355, 2345, 2272, 2386, 2348, 2446, 2355,
+    2379, 2322, 2309, 2271, 2344, 2346, 2419, 2469, 2372, 2295, 2332, 2379, 2390, 2412, 2439, 2297,
+    2330, 2283, 2372, 2471, 2356, 2419, 2377, 2266, 2251, 2337, 2384, 2352, 2403, 2263, 2278, 2312,
+    2405, 2440, 2333, 2401, 2291, 2234, 2319, 2453, 2386, 2353, 2327, 2311, 2358, 2264, 2393, 2351,
+    2386, 2391, 2324, 2323, 2172, 2279, 2352, 2379, 2335, 2350, 2283, 2282, 2316, 2425, 2442, 2374,
+    2350, 2277, 2347, 2308, 2365, 2355, 2409, 2276, 2261, 2274, 2290, 2377, 2405, 2340, 2301, 2255,
+    2280, 2324, 2406, 2394, 2340, 2323, 2229, 2263, 2329, 2426, 2450, 2344, 2404, 2246, 2288, 2307,
+    2412, 2406, 2305, 2338, 2242, 2291, 2303, 2325, 2471, 2354, 2350, 2307, 2314, 2397, 2354, 2282,
+    2321, 2271, 2179, 2288, 2364, 2354, 2414, 2349, 2280, 2276, 2209, 2286, 2414, 2360, 2347, 2321,
+    2220, 2237, 2264, 2351, 2323, 2312, 2264, 2255, 2215, 2300, 2424, 2392, 2359, 2216, 2241, 2264,
+    2255, 2336, 2290, 2286, 2264, 2249, 2299, 2378, 2386, 2317, 2294, 2220, 2166, 2238, 2353, 2345,
+    2327, 2283, 2229, 2200, 2220, 2310, 2371, 2336, 2367, 2227, 2258, 2180, 2316, 2276, 2284, 2305,
+    2231, 2247, 2249, 2358, 2307, 2298, 2305, 2267, 2192, 2227, 2240, 2381, 2355, 2313, 2237, 2174,
+    2320, 2304, 2268, 2319, 2227, 2213, 2246, 2220, 2210, 2319, 2294, 2266, 2236, 2173, 2235, 2286,
+    2321, 2423, 2253, 2220, 2199, 2193, 2237, 2311, 2297, 2363, 2289, 2220, 2215, 2254, 2333, 2266,
+    2293, 2211, 2200, 2246, 2256, 2234, 2373, 2221, 2213, 2167, 2127, 2284, 2299, 2257, 2341, 2184,
+    2152, 2221, 2260, 2288, 2248, 2244, 2277, 2222, 2200, 2239, 2288, 2300, 2266, 2204, 2142, 2178,
+    2227, 2292, 2334, 2302, 2197, 2223, 2190, 2258, 2239, 2312, 2261, 2158, 2210, 2197, 2253, 2270,
+    2319, 2266, 2292, 2188, 2182, 2264, 2226, 2294, 2255, 2202, 2216, 2220, 2197, 2294, 2224, 2252,
+    2184, 2163, 2150, 2258, 2237, 2235, 2244, 2204, 2135, 2135, 2203, 2260, 2372, 2199, 2211, 2096,
+    2157, 2171, 2276, 2317, 2201, 2181, 2119, 2164, 2268, 2260, 2225, 2247, 2181, 2181, 2174, 2193,
+    2273, 2225, 2143, 2167, 2177, 2226, 2194, 2244, 2270, 3092, 3052, 3021, 3059, 3139, 3141, 3115,
+    3061, 3016, 2923, 2988, 3093, 3126, 3233, 3062, 3039, 3051, 3027, 3044, 3148, 3209, 3122, 3016,
+    2953, 3007, 3072, 3145, 3076, 3056, 2980, 3041, 2990, 3012, 3111, 3134, 3117, 3049, 2996, 3028,
+    3060, 3097, 3117, 3075, 2999, 3015, 3014, 3064, 3093, 3181, 3162, 2961, 3025, 3067, 3085, 3085,
+    3064, 3127, 2943, 3015, 3042, 3078, 3107, 3089, 3113, 3107, 3060, 3048, 3060, 3051, 3116, 3015,
+    2955, 2981, 3013, 3048, 3110, 3182, 3068, 3078, 3020, 3014, 3090, 3140, 3046, 3112, 3026, 3044,
+    2958, 3000, 3021, 3130, 3007, 3029, 2885, 2996, 3033, 3115, 3118, 3035, 3055, 2976, 2992, 2983,
+    3054, 3095, 3086, 3034, 2947, 3016, 3029, 3018, 3086, 3027, 3036, 3005, 2916, 2954, 3105, 3069,
+    3010, 2991, 2936, 2974, 3011, 3023, 3101, 2996, 3021, 2979, 2898, 3029, 3079, 3131, 3054, 2940,
+    2956, 2988, 2985, 3068, 3069, 3015, 2968, 2921, 2978, 3034, 3044, 3091, 3070, 3037, 2933, 2902,
+    2932, 3022, 3038, 3002, 2975, 2938, 2975, 2967, 3073, 3036, 2907, 2938, 2934, 2939, 3004, 3084,
+    3030, 3016, 2924, 2935, 2945, 3004, 3039, 3048, 3012, 2975, 2908, 2915, 3045, 3074, 3036, 3065,
+    2956, 2926, 2958, 2975, 3071, 3055, 3021, 3004, 2945, 2945, 2953, 3039, 3034, 2980, 2973, 2930,
+    2937, 3029, 3023, 3121, 3034, 2863, 2959, 2916, 2989, 2974, 3098, 2992, 2957, 2923, 2879, 2933,
+    3035, 3056, 2983, 2969, 2893, 2874, 2967, 2981, 2985, 2994, 2884, 2870, 2919, 3061, 3035, 3015,
+    2986, 2910, 2878, 2845, 3029, 3105, 3010, 2933, 2936, 2933, 2889, 2969, 2933, 2936, 2963, 2883,
+    2947, 2870, 2946, 2971, 3058, 2995, 2853, 2923, 2939, 2876, 2977, 3036, 2923, 2852, 2908, 2899,
+    2924, 3063, 3020, 3027, 2959, 2936, 2968, 2920, 3030, 3036, 2920, 2871, 2904, 2871, 2928, 2993,
+    2957, 2947, 2873, 2938, 2875, 2918, 3011, 2995, 2947, 2970, 2826, 2895, 2888, 2930, 2958, 2953,
+    2941, 2839, 2743, 2985, 2988, 2958, 2956, 2942, 2831, 2846, 2929, 2994, 2989, 2941, 2975, 2936,
+    2864, 3005, 2988, 2961, 2917, 2846, 2848, 2831, 2949, 2927, 3006, 2997, 2892, 2875, 2944, 2847,
+    2920, 2882, 3053, 2841, 2901, 2876, 2912, 2946, 2903, 2950, 2823, 2878, 2841, 2916, 2971, 2968,
+    2889, 2932, 2933, 2807, 2913, 2951, 2948, 2950, 2878, 2887, 2817, 2941, 3008, 2945, 2976, 2840,
+    2809, 2837, 2867, 2984, 2928, 2855, 2913, 2810, 2902, 2842, 2990, 2921, 2865, 2831, 2857, 2828,
+    2964, 2950, 2988, 2907, 2901, 2853, 2878, 2908, 2849, 2910, 2888, 2869, 2847, 2730, 2822, 2978,
+    2975, 2874, 2775, 2834, 2851, 2815, 2876, 2904, 2935, 2846, 2792, 2793, 2866, 2850, 2905, 2923,
+    2861, 2788, 2806, 2810, 2926, 2963, 2869, 2805, 2799, 2802, 2828, 2906, 2937, 2854, 2920, 2754,
+    2830, 2871, 2865, 2924, 2840, 2787, 2854, 2856, 2787, 2931, 2917, 2849, 2789, 2796, 2721, 2837,
+    2855, 2860, 2890, 2821, 2826, 2768, 2864, 2885, 2931, 2842, 2777, 2838, 2688, 2856, 2894, 2950,
+    2859, 2799, 2860, 2803, 2856, 2915, 2828, 2905, 2844, 2773, 2872, 2799, 2900, 2851, 2853, 2769,
+    2798, 2763, 2731, 2843, 2904, 2828, 2869, 2685, 2795, 2826, 2846, 2891, 2895, 2798, 2792, 2839,
+    2848, 2899, 2882, 2897, 2711, 2809, 2725, 2815, 2881, 2892, 2832, 2787, 2793, 2810, 2786, 2826,
+    2783, 2910, 2802, 2722, 2717, 2793, 2884, 2851, 2835, 2743, 2765, 2800, 2737, 2835, 2839, 2861,
+    2799, 2783, 2736, 2767, 2883, 2843, 2787, 2852, 2740, 2793, 2842, 2858, 2846, 2816, 2777, 2771,
+    2706, 2786, 2875, 2908, 2825, 2835, 2688, 2753, 2818, 2855, 2911, 2864, 2760, 2744, 2697, 2858,
+    2867, 2796, 2924, 2766, 2683, 2695, 2772, 2823, 2876, 2826, 2764, 2732, 2765, 2762, 2878, 2836,
+    2772, 2717, 2762, 2725, 2844, 2772, 2835, 2809, 2719, 2787, 2683, 2750, 2748, 2794, 2831, 2722,
+    2721, 2705, 2754, 2827, 2812, 2841, 2700, 2669, 2719, 2735, 2798, 2810, 2829, 2763, 2694, 2733,
+    2725, 2830, 2821, 2863, 2825, 2781, 2718, 2738, 2867, 2831, 2856, 2732, 2727, 2765, 2763, 2748,
+    2771, 2787, 2708, 2657, 2724, 2813, 2758, 2820, 2803, 2774, 2662, 2693, 2799, 2746, 2777, 2747,
+    2748, 2663, 2723, 2759, 2800, 2755, 2797, 2789, 2620, 2671, 2719, 2873, 2806, 2760, 2750, 2619,
+    2707, 2745, 2804, 2779, 2758, 2712, 2664, 2674, 2796, 2807, 2814, 2726, 2647, 2659, 2661, 2728,
+    2739, 2799, 2733, 2711, 2706, 2622, 2718, 2763, 2747, 2767, 2700, 2653, 2685, 2646, 2767, 2773,
+    2761, 2659, 2700, 2670, 2762, 2839, 2813, 2714, 2714, 2631, 2652, 2631, 2736, 2812, 2794, 2680,
+    2655, 2653, 2692, 2757, 2805, 2701, 2614, 2666, 2634, 2684, 2750, 2799, 2645, 2625, 2602, 2671,
+    2718, 2792, 2714, 2741, 2645, 2630, 2661, 2697, 2790, 2784, 2710, 2763, 2653, 2700, 2664, 2788,
+    2721, 2738, 2613, 2737, 2629, 2740, 2749, 2758, 2684, 2573, 2650, 2703, 2678, 2747, 2740, 2729,
+    2629, 2603, 2639, 2685, 2743, 2719, 2694, 2747, 2635, 2566, 2684, 2723, 2697, 2639, 2696, 2627,
+    2653, 2666, 2616, 2768, 2707, 2601, 2593, 2578, 2662, 2716, 2729, 2672, 2572, 2640, 2678, 2630,
+    2733, 2725, 2706, 2642, 2601, 2633, 2655, 2690, 2711, 2714, 2698, 2606, 2592, 2615, 2728, 2638,
+    2728, 2580, 2622, 2611, 2657, 2683, 2770, 2681, 2620, 2593, 2612, 2619, 2692, 2740, 2667, 2569,
+    2718, 2526, 2627, 2663, 2836, 2697, 2559, 2514, 2608, 2673, 2680, 2727, 2706, 2679, 2629, 2567,
+    2540, 2677, 2769, 2568, 2666, 2545, 2578, 2674, 2729, 2690, 2728, 2582, 2591, 2563, 2596, 2656,
+    2664, 2625, 2587, 2547, 2562, 2638, 2622, 2779, 2631, 2598, 2582, 2653, 2599, 2702, 2635, 2663,
+    2625, 2575, 2515, 2649, 2693, 2647, 2619, 2528, 2471, 2555, 2585, 2649, 2722, 2599, 2575, 2523,
+    2596, 2596, 2701, 2634, 2651, 2607, 2566, 2588, 2538, 2731, 2694, 2541, 2525, 2620, 2539, 2572,
+    2742, 2693, 2660, 2521, 2494, 2525, 2582, 2682, 2718, 2656, 2601, 2508, 2560, 2563, 2707, 2613,
+    2631, 2534, 2614, 2557, 2552, 2646, 2676, 2538, 2462, 2569, 2566, 2515, 2658, 2634, 2622, 2542,
+    2547, 2518, 2518, 2610, 2685, 2638, 2573, 2433, 2554, 2565, 2618, 2650, 2624, 2515, 2476, 2576,
+    2624, 2678, 2663, 2691, 2586, 2553, 2440, 2568, 2612, 2579, 2602, 2554, 2497, 2476, 2495, 2638,
+    2669, 2561, 2548, 2498, 2571, 2600, 2603, 2676, 2585, 2499, 2504, 2530, 2546, 2631, 2662, 2615,
+    2544, 2515, 2591, 2518, 2591, 2604, 2645, 2536, 2518, 2522, 2549, 2592, 2672, 2607, 2507, 2485,
+    2564, 2495, 2595, 2657, 2531, 2542, 2433, 2467, 2592, 2468, 2541, 2586, 2563, 2561, 2541, 2502,
+    1640, 1709, 1659, 1609, 1608, 1565, 1524, 1709, 1679, 1685, 1576, 1585, 1598, 1647, 1669, 1649,
+    1667, 1592, 1612, 1562, 1630, 1625, 1721, 1663, 1596, 1638, 1640, 1583, 1662, 1697, 1700, 1581,
+    1585, 1599, 1663, 1633, 1746, 1628, 1594, 1603, 1601, 1619, 1714, 1650, 1706, 1568, 1533, 1566,
+    1582, 1703, 1629, 1637, 1504, 1525, 1533, 1587, 1633, 1715, 1667, 1601, 1510, 1570, 1641, 1706,
+    1645, 1593, 1603, 1553, 1510, 1562, 1624, 1615, 1618, 1547, 1545, 1597, 1579, 1680, 1595, 1670,
+    1580, 1581, 1507, 1582, 1649, 1694, 1634, 1597, 1527, 1573, 1595, 1647, 1612, 1648, 1636, 1533,
+    1504, 1718, 1605, 1706, 1652, 1536, 1512, 1541, 1586, 1632, 1626, 1636, 1498, 1566, 1504, 1649,
+    1594, 1615, 1603, 1483, 1457, 1534, 1539, 1566, 1640, 1634, 1506, 1490, 1493, 1568, 1574, 1614,
+    1592, 1553, 1456, 1497, 1521, 1625, 1666, 1598, 1508, 1478, 1443, 1595, 1677, 1597, 1540, 1542,
+    1498, 1550, 1556, 1619, 1689, 1665, 1505, 1494, 1541, 1511, 1616, 1594, 1581, 1506, 1552, 1527,
+    1540, 1659, 1596, 1573, 1474, 1407, 1536, 1524, 1598, 1582, 1614, 1523, 1447, 1547, 1604, 1591,
+    1638, 1561, 1478, 1488, 1508, 1498, 1557, 1566, 1574, 1528, 1485, 1492, 1450, 1559, 1574, 1490,
+    1462, 1466, 1412, 1495, 1615, 1660, 1502, 1421, 1448, 1507, 1527, 1560, 1635, 1571, 1477, 1501,
+    1445, 1533, 1521, 1590, 1461, 1426, 1519, 1535, 1528, 1594, 1643, 1595, 1523, 1452, 1457, 1492,
+    1589, 1551, 1499, 1536, 1458, 1417, 1509, 1517, 1567, 1573, 1488, 1451, 1443, 1494, 1547, 1587,
+    1500, 1374, 1497, 1490, 1526, 1602, 1571, 1507, 1436, 1498, 1480, 1515, 1535, 1586, 1489, 1435,
+    1400, 1466, 1416, 1462, 1594, 1446, 1405, 1525, 1456, 1468, 1597, 1556, 1435, 1425, 1471, 1399,
+    1428, 1554, 1546, 1543, 1536, 1401, 1475, 1428, 1484, 1538, 1550, 1488, 1494, 1419, 1428, 1552,
+    1590, 1558, 1415, 1363, 1505, 1483, 1610, 1523, 1486, 1488, 1397, 1360, 1494, 1497, 1531, 1490,
+    1451, 1331, 1426, 1436, 1482, 1539, 1511, 1418, 1409, 1405, 1453, 1510, 1534, 1454, 1465, 1397,
+    1506, 1390, 1526, 1533, 1462, 1460, 1446, 1498, 1479, 1527, 1503, 1448, 1389, 1390, 1346, 1513,
+    1566, 1501, 1491, 1457, 1369, 1426, 1389, 1541, 1468, 1479, 1442, 1327, 1367, 1459, 1496, 1510,
+    1490, 1439, 1402, 1435, 1463, 1566, 1514, 1464, 1464, 1372, 1371, 1402, 1513, 1457, 1473, 1481,
+    1382, 1392, 1443, 1511, 1448, 1502, 1442, 1308, 1402, 1451, 1555, 1435, 1459, 1374, 1318, 1325,
+    1488, 1451, 1439, 1433, 1370, 1461, 1364, 1468, 1480, 1484, 1441, 1351, 1410, 1377, 1470, 1478,
+    1478, 1440, 1340, 1371, 1400, 1401, 1425, 1442, 1387, 1353, 1345, 1364, 1372, 1440, 1478, 1378,
+    1411, 1319, 1349, 1446, 1476, 1534, 1474, 1363, 1302, 1347, 1349, 1426, 1470, 1459, 1390, 1336,
+    1326, 1397, 1429, 1401, 1406, 1344, 1374, 1349, 1423, 1472, 1446, 1476, 1330, 1308, 1281, 1339,
+    1500, 1464, 1369, 1324, 1354, 1372, 1404, 1480, 1447, 1450, 1307, 1232, 1378, 1435, 1467, 1429,
+    1403, 1375, 1373, 1373, 1383, 1439, 1393, 1350, 1428, 1257, 1362, 1358, 1469, 1511, 1367, 1334,
+    1290, 1334, 1392, 1462, 1445, 1375, 1311, 1332, 1285, 1436, 1496, 1443, 1395, 1327, 1284, 1295,
+    1355, 1402, 1474, 1430, 1325, 1358, 1375, 1313, 1461, 1409, 1347, 1263, 1271, 1285, 1262, 1395,
+    1386, 1386, 1348, 1242, 1324, 1311, 1384, 1396, 1388, 1328, 1274, 1299, 1294, 1415, 1441, 1357,
+    1334, 1222, 1190, 1338, 1428, 1452, 1307, 1296, 1350, 1338, 1259, 1358, 1427, 1419, 1342, 1263,
+    1266, 1363, 1422, 1432, 1348, 1295, 1256, 1322, 1363, 1352, 1392, 1388, 1307, 1199, 1245, 1325,
+    1415, 1403, 1310, 1307, 1247, 1311, 1298, 1361, 1398, 1433, 1319, 1255, 1261, 1395, 1352, 1406,
+    1325, 1327, 1235, 1256, 1296, 1449, 1358, 1371, 1357, 1250, 1305, 1302, 1399, 1318, 1410, 1269,
+    1239, 1279, 1397, 1401, 1353, 1361, 1292, 1237, 1264, 1392, 1383, 1318, 1286, 1306, 1324, 1218,
+    1243, 1352, 1392, 1316, 1367, 1242, 1265, 1331, 1316, 1384, 1331, 1270, 1228, 1302, 1273, 1320,
+    1345, 1340, 1275, 1177, 1274, 1358, 1337, 1364, 1297, 1219, 1282, 1314, 1269, 1364, 1276, 1317,
+    1308, 1210, 1198, 1277, 1338, 1325, 1292, 1110, 1229, 1164, 1327, 1406, 1317, 1284, 1244, 1252,
+    1236, 1247, 1311, 1284, 1250, 1204, 1267, 1241, 1256, 1373, 1357, 1301, 1192, 1198, 1254, 1313,
+    1288, 1343, 1301, 1314, 1200, 1213, 1364, 1255, 1333, 1291, 1242, 1186, 1264, 1231, 1256, 1298,
+    1307, 1191, 1198, 1189, 1263, 1323, 1313, 1325, 1236, 1097, 1176, 1201, 1311, 1308, 1288, 1254,
+    1198, 1197, 1320, 1269, 1300, 1267, 1244, 1170, 1204, 1200, 1261, 1329, 1243, 1200, 1144, 1099,
+    1240, 1316, 1309, 1261, 1262, 1169, 1172, 1219, 1265, 1231, 1216, 1216, 1132, 1132, 1240, 1284,
+    1319, 1263, 1162, 1125, 1125, 1267, 1291, 1313, 1247, 1166, 1070, 1098, 1283, 1189, 1288, 1214,
+    1123, 1127, 1194, 1231, 1293, 1198, 1231, 1252, 1150, 1131, 1186, 1275, 1302, 1305, 1185, 1183,
+    1118, 1320, 1280, 1250, 1254, 1204, 1124, 1157, 1247, 1226, 1327, 1207, 1145, 1167, 1160, 1199,
+    1247, 1200, 1251, 1238, 1074, 1187, 1215, 1241, 1250, 1200, 1197, 1192, 1106, 1247, 1244, 1239,
+};
+
+static const int ADC_TRACE_LENGTH = sizeof(ADC_TRACE) / sizeof(ADC_TRACE[0]);
+
+#endif // BENCH_ADC_TRACE_H
@@ -0,0 +1,93 @@
+/**
+ * Word Clock Benchmarks - Timing harness
+ *
+ * The same benchmark sources build natively (timed with steady_clock) and
+ * on the ESP32-C3 (timed with the CPU cycle counter). Each benchmark is
+ * calibrated until one run takes at least BENCH_MIN_RUN_US, then run
+ * BENCH_RUNS times; the fastest run is reported, which is the one least
+ * disturbed by interrupts and the host scheduler.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "hal/cpu_hal.h"
+#else
+#include <chrono>
+#endif
+
+#ifndef BENCH_MIN_RUN_US
+#define BENCH_MIN_RUN_US 20000
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS 5
+#endif
+
+// Defeats dead-code elimination of benchmark bodies
+extern volatile uint32_t benchSink;
+
+struct BenchResult {
+    const char* name;
+    uint32_t opsPerRun;    // Operations counted per run (e.g. 144 frames)
+    uint32_t iterations;   // Body invocations per run
+    double nsPerOp;
+    double cyclesPerOp;    // 0 where no cycle counter is available
+};
+
+/**
+ * Elapsed time source: CPU cycles on the device, nanoseconds natively
+ */
+class BenchClock {
+public:
+#ifdef ARDUINO
+    static uint32_t ticks() { return cpu_hal_get_cycle_count(); }
+    static double ticksPerNs() { return getCpuFrequencyMhz() / 1000.0; }
+    static bool countsCycles() { return true; }
+#else
+    static uint64_t ticks() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    static double ticksPerNs() { return 1.0; }
+    static bool countsCycles() { return false; }
+#endif
+};
+
+/**
+ * Times `body`, which performs `opsPerCall` operations per invocation
+ */
+template <typename Body>
+BenchResult runBenchmark(const char* name, uint32_t opsPerCall, Body body) {
+    auto timeIterations = [&](uint32_t iterations) {
+        auto start = BenchClock::ticks();
+        for (uint32_t i = 0; i < iterations; i++) body();
+        return (double)(BenchClock::ticks() - start) / BenchClock::ticksPerNs();
+    };
+
+    // Calibrate
+    uint32_t iterations = 1;
+    while (timeIterations(iterations) < BENCH_MIN_RUN_US * 1000.0 && iterations < (1u << 30)) {
+        iterations *= 2;
+    }
+
+    double best = 0;
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        double ns = timeIterations(iterations);
+        if (run == 0 || ns < best) best = ns;
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.opsPerRun = opsPerCall;
+    result.iterations = iterations;
+    result.nsPerOp = best / iterations / opsPerCall;
+    result.cyclesPerOp = BenchClock::countsCycles() ? result.nsPerOp * BenchClock::ticksPerNs() : 0;
+    return result;
+}
+
+#endif // BENCH_H
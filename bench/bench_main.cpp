@@ -0,0 +1,280 @@
+/**
+ * Word Clock Benchmarks
+ *
+ * Microbenchmarks for the clock's hot paths, emitted as one JSON document
+ * so results can be stored per commit and compared:
+ * - render_all_frames:   round, look up and render each of the 144 phrases
+ * - render_day:          the same for every minute of a day
+ * - status_json:         serialise the /api/status document
+ * - status_binary:       encode and decode the /api/status.bin document
+ * - timezone_validate:   isValidTimezone() over every IANA zone name
+ * - settings_parse:      parse and range-check a saved settings form
+ * - rate_limit:          admit a request against a full table of client buckets
+ * - sensor_filter:       filter a light sensor trace and pick a brightness
+ * - transition_frame:    blend one crossfade frame between two phrases
+ * - dither_frame:        draw one frame of a settled face at a fractional brightness
+ * - image_decode:        decode a compressed firmware image, per KB written
+ *
+ * Native:  pio run -e bench_native && .pio/build/bench_native/program > bench.json
+ * Device:  pio run -e bench_esp32 -t upload -t monitor   (JSON is printed once)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <word_clock_core.h>
+#include "bench.h"
+#include "adc_trace.h"
+#include "iana_zones.h"
+
+#ifndef LIGHT_SAMPLES
+#define LIGHT_SAMPLES 10  // Matches src/config.h
+#endif
+
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "unknown"
+#endif
+
+#ifdef ARDUINO
+#define BENCH_TARGET "esp32c3"
+#else
+#define BENCH_TARGET "native"
+#endif
+
+volatile uint32_t benchSink;
+
+static CRGB benchLeds[FACE_LEDS];
+
+static BenchResult benchRenderAllFrames() {
+    return runBenchmark("render_all_frames", 144, []() {
+        for (int hour = 0; hour < 12; hour++) {
+            for (int minute = 0; minute < 60; minute += 5) {
+                renderFrame(frameFor(roundTime(hour, minute)), benchLeds);
+                benchSink += benchLeds[hour].r;
+            }
+        }
+    });
+}
+
+static BenchResult benchRenderDay() {
+    return runBenchmark("render_day", 24 * 60, []() {
+        for (int hour = 0; hour < 24; hour++) {
+            for (int minute = 0; minute < 60; minute++) {
+                benchSink += (uint32_t)frameFor(roundTime(hour, minute));
+            }
+        }
+    });
+}
+
+static BenchResult benchStatusJson() {
+    StatusSnapshot status;
+    status.lightLevel = 2417;
+    status.currentBrightness = 25;
+    status.timezone = "Australia/Sydney";
+    return runBenchmark("status_json", 1, [&status]() {
+        char json[512];
+        benchSink += formatStatusJson(json, sizeof(json), status);
+        status.lightLevel = (status.lightLevel + 1) & 4095;
+    });
+}
+
+static BenchResult benchStatusBinary() {
+    StatusBinary status;
+    status.uptimeSeconds = 86400;
+    status.lightLevel = 2417;
+    status.brightness = 25;
+    status.frame = frameFor(roundTime(14, 35));
+    return runBenchmark("status_binary", 1, [&status]() {
+        uint8_t packet[STATUS_BINARY_SIZE];
+        StatusBinary decoded;
+        benchSink += encodeStatusBinary(packet, sizeof(packet), status);
+        benchSink += decodeStatusBinary(packet, sizeof(packet), decoded);
+        status.lightLevel = (decoded.lightLevel + 1) & 4095;
+    });
+}
+
+static BenchResult benchTimezoneValidate() {
+    return runBenchmark("timezone_validate", IANA_ZONE_COUNT, []() {
+        for (int i = 0; i < IANA_ZONE_COUNT; i++) {
+            benchSink += isValidTimezone(IANA_ZONES[i]);
+        }
+    });
+}
+
+static BenchResult benchSettingsParse() {
+    static const char* const FORM[][2] = {
+        {"darkBrightness", "5"}, {"lightBrightness", "40"}, {"threshold", "2600"},
+        {"timezone", "Australia/Sydney"}, {"points", "0:5,2200:5,3000:25,4095:25"},
+        {"hysteresis", "64"}, {"slew", "10"}, {"transitionMs", "800"}, {"ditherBelow", "32"},
+    };
+    static const int FIELDS = sizeof(FORM) / sizeof(FORM[0]);
+    return runBenchmark("settings_parse", FIELDS, []() {
+        static ClockSettings next;
+        for (int i = 0; i < FIELDS; i++) {
+            benchSink += parseSetting(next, FORM[i][0], FORM[i][1]);
+        }
+        benchSink += next.brightness.lightBrightness;
+    });
+}
+
+static BenchResult benchRateLimit() {
+    // More clients than buckets, so lookups scan the whole table and evict
+    static const int CLIENTS = RATE_LIMIT_BUCKETS + 8;
+    return runBenchmark("rate_limit", CLIENTS, []() {
+        static RateLimiter limiter;
+        static uint32_t now = 0;
+        const RateLimit limit = {5, 90};
+        for (int i = 0; i < CLIENTS; i++) {
+            benchSink += limiter.admit(0xC0A80000 + i, i & 3, limit, now += 7);
+        }
+    });
+}
+
+static BenchResult benchSensorFilter() {
+    static const int WINDOWS = ADC_TRACE_LENGTH / LIGHT_SAMPLES;
+    return runBenchmark("sensor_filter", WINDOWS, []() {
+        static BrightnessController controller;
+        for (int w = 0; w < WINDOWS; w++) {
+            int level = averageLightSamples(ADC_TRACE + w * LIGHT_SAMPLES, LIGHT_SAMPLES);
+            benchSink += controller.update(level, w * 1000);
+        }
+    });
+}
+
+static BenchResult benchTransitionFrame() {
+    return runBenchmark("transition_frame", 48, []() {
+        static TransitionEngine engine;
+        static uint32_t now = 0;
+        static int phrase = 0;
+        // A fade lasts 50 frames; start the next one between frames so every run blends
+        engine.setFrame(frameFor(roundTime(phrase / 12, phrase % 12 * 5)), now);
+        phrase = (phrase + 1) % 144;
+        for (int i = 0; i < 48; i++) {
+            now += TRANSITION_FRAME_MS;
+            benchSink += engine.render(now, benchLeds);
+        }
+    });
+}
+
+static BenchResult benchDitherFrame() {
+    static TransitionEngine engine;
+    engine.setDuration(0);
+    engine.setFrame(frameFor(roundTime(14, 35)), 0);
+    engine.setBrightness((5 << 8) | 0x60, 0);  // 5.375
+    return runBenchmark("dither_frame", 64, []() {
+        static uint32_t now = 0;
+        for (int i = 0; i < 64; i++) {
+            now += TRANSITION_DITHER_MS;
+            benchSink += engine.render(now, benchLeds);
+        }
+    });
+}
+
+static bool benchImageWrite(void*, const uint8_t* data, size_t size) {
+    benchSink += data[size - 1];
+    return true;
+}
+
+static BenchResult benchImageDecode() {
+    // 64 KB of literal runs and matches, roughly the mix tools/image_encoder.h makes of code
+    static const int KB = 64;
+    static const int UNITS = KB * 1024 / 64;  // Each unit decodes to 16 literals and a 48-byte match
+    static uint8_t encoded[IMAGE_HEADER_SIZE + UNITS * 20];
+    static ImageDecoder decoder;
+    memset(encoded, 0, IMAGE_HEADER_SIZE);
+    memcpy(encoded, "WCZ", 3);
+    encoded[3] = IMAGE_FORMAT_VERSION;
+    encoded[5] = IMAGE_WINDOW_BITS;
+    uint32_t size = KB * 1024;
+    for (int i = 0; i < 4; i++) encoded[8 + i] = size >> (8 * i);
+    uint8_t* token = encoded + IMAGE_HEADER_SIZE;
+    for (int unit = 0; unit < UNITS; unit++) {
+        *token++ = 15;
+        for (int i = 0; i < 16; i++) *token++ = (uint8_t)(unit * 7 + i * 13);
+        *token++ = 0x80 | (48 - IMAGE_MATCH_MIN);
+        int back = unit % 32 < unit ? unit % 32 : 0;  // Units back, once there are that many
+        uint16_t distance = 16 + 64 * back;
+        *token++ = (distance - 1) & 0xFF;
+        *token++ = (distance - 1) >> 8;
+    }
+    return runBenchmark("image_decode", KB, []() {
+        decoder.begin(benchImageWrite, nullptr, nullptr, nullptr, 0);
+        const uint8_t* data = encoded;
+        size_t left = sizeof(encoded);
+        while (left && !decoder.failed()) {
+            size_t used = decoder.feed(data, left);
+            data += used;
+            left -= used;
+        }
+        benchSink += decoder.done();
+    });
+}
+
+/**
+ * Runs every benchmark and writes the JSON report into `buffer`
+ */
+static size_t runAll(char* buffer, size_t size) {
+    BenchResult results[] = {
+        benchRenderAllFrames(),
+        benchRenderDay(),
+        benchStatusJson(),
+        benchStatusBinary(),
+        benchTimezoneValidate(),
+        benchSettingsParse(),
+        benchRateLimit(),
+        benchSensorFilter(),
+        benchTransitionFrame(),
+        benchDitherFrame(),
+        benchImageDecode(),
+    };
+
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .member("suite", "wordclock")
+        .member("target", BENCH_TARGET)
+        .member("commit", BENCH_COMMIT)
+        .key("results").beginArray();
+    for (const BenchResult& r : results) {
+        json.beginObject()
+            .member("name", r.name)
+            .member("ops_per_run", r.opsPerRun)
+            .member("iterations", r.iterations)
+            .member("ns_per_op", r.nsPerOp);
+        if (BenchClock::countsCycles()) {
+            json.member("cycles_per_op", r.cyclesPerOp);
+        }
+        json.endObject();
+    }
+    json.endArray().endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+static char report[2048];
+
+#ifdef ARDUINO
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);  // Give the serial monitor time to attach
+    if (runAll(report, sizeof(report))) {
+        Serial.println(report);
+    } else {
+        Serial.println("{\"error\":\"report buffer too small\"}");
+    }
+}
+
+void loop() {
+    delay(1000);
+}
+
+#else
+
+int main() {
+    if (!runAll(report, sizeof(report))) {
+        fprintf(stderr, "report buffer too small\n");
+        return 1;
+    }
+    puts(report);
+    return 0;
+}
+
+#endif
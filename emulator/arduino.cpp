@@ -0,0 +1,86 @@
+/**
+ * Word Clock Emulator - Arduino core and FastLED globals
+ */
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+CFastLED FastLED;
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+// Emulated microseconds since boot
+static uint64_t emulatedMicros() {
+    auto elapsed = std::chrono::steady_clock::now() - bootTime;
+    return (uint64_t)(std::chrono::duration<double, std::micro>(elapsed).count() * emulator.speed);
+}
+
+uint32_t millis() {
+    return (uint32_t)(emulatedMicros() / 1000);
+}
+
+uint32_t micros() {
+    return (uint32_t)emulatedMicros();
+}
+
+void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms / emulator.speed));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+uint16_t analogRead(uint8_t) {
+    static std::minstd_rand noise(1);
+    int level = emulator.lightLevel + (int)(noise() % 41) - 20;
+    return (uint16_t)(level < 0 ? 0 : level > 4095 ? 4095 : level);
+}
+
+time_t emulatorUtcNow() {
+    return emulator.startUtc + (time_t)(emulatedMicros() / 1000000);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fwrite(&c, 1, 1, stderr);
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t length) {
+    return fwrite(data, 1, length, stderr);
+}
+
+size_t HardwareSerial::print(const char* s) {
+    return fputs(s, stderr) >= 0 ? strlen(s) : 0;
+}
+
+size_t HardwareSerial::println(const char* s) {
+    emulatorPrint(s);
+    return strlen(s) + 1;
+}
+
+static int bootImage = -1;
+static bool bootPendingVerify = false;
+
+void emulatorInstallImage(int fd, bool pendingVerify) {
+    bootImage = fd;
+    bootPendingVerify = pendingVerify;
+}
+
+void EspClass::restart() {
+    if (bootImage < 0) {
+        emulatorPrint("ESP.restart() - emulator exiting");
+        exit(3);
+    }
+    emulatorPrint("ESP.restart() - booting the OTA image");
+    if (bootPendingVerify) emulatorKeepPreviousImage();
+    fflush(nullptr);
+    fexecve(bootImage, emulator.argv, environ);
+    perror("ESP.restart()");
+    exit(3);
+}
@@ -0,0 +1,44 @@
+/**
+ * Word Clock Emulator - Deferred logging backend
+ *
+ * Replaces src/log.cpp. Records are formatted as they are submitted; the
+ * format string address in each record is a real pointer here, which fits
+ * the record's 32-bit field because the emulator is linked without PIE.
+ */
+
+#include "../src/log.h"
+#include "../tools/log_format.h"
+#include <atomic>
+
+static std::atomic<uint32_t> logDropCount{0};
+
+void logBegin() {}
+
+// Widens a truncated string literal address back to a pointer
+static const char* formatAt(uint32_t address) {
+    static const char probe[] = "";
+    uint64_t near = (uint64_t)(uintptr_t)probe;
+    uint64_t candidate = (near & ~0xFFFFFFFFull) | address;
+    if (candidate > near + 0x80000000ull) candidate -= 0x100000000ull;
+    else if (candidate + 0x80000000ull < near) candidate += 0x100000000ull;
+    return (const char*)(uintptr_t)candidate;
+}
+
+void logSubmit(const uint8_t* payload, size_t length) {
+    uint32_t address, timestamp;
+    memcpy(&address, payload, 4);
+    memcpy(&timestamp, payload + 4, 4);
+    uint8_t level = payload[8] >> 4;
+    uint8_t category = payload[8] & 0x7;
+    ArgReader args(payload + 9, length - 9);
+    std::string text = formatLogRecord(formatAt(address), args);
+
+    char line[320];
+    snprintf(line, sizeof(line), "[%8u.%03u] %s %-7s %s", timestamp / 1000, timestamp % 1000,
+             level < 5 ? LOG_LEVEL_NAMES[level] : "?", LOG_CATEGORY_NAMES[category], text.c_str());
+    emulatorPrint(line);
+}
+
+uint32_t logDropped() {
+    return logDropCount.load(std::memory_order_relaxed);
+}
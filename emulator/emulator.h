@@ -0,0 +1,56 @@
+/**
+ * Word Clock - Host emulator
+ *
+ * Runs the unmodified firmware (src/main.cpp) on Linux against the
+ * stand-in Arduino, FastLED, WiFi, WiFiManager, WebServer, ArduinoOTA,
+ * Update, HTTPClient, esp_ota_ops, Preferences and ezTime headers in
+ * emulator/stubs. The web server listens on a real localhost port and the
+ * LED matrix is drawn in the terminal.
+ *
+ * Time is emulated: millis(), delay() and the NTP clock all run `speed`
+ * times faster than the host clock, so a day of display updates can be
+ * watched in minutes while the HTTP routes keep answering in real time.
+ */
+
+#ifndef EMULATOR_H
+#define EMULATOR_H
+
+#include <stdint.h>
+#include <time.h>
+
+struct CRGB;
+
+struct EmulatorOptions {
+    uint16_t httpPort = 8080;  // Stands in for port 80 on the device
+    uint16_t otaPort = 3232;   // ArduinoOTA's UDP port; 0 = no OTA
+    double speed = 1.0;        // Emulated seconds per real second
+    time_t startUtc = 0;       // UTC at boot; 0 = the host clock
+    bool offline = false;      // No WiFi: the firmware falls back to simulated time
+    bool render = true;        // Draw the matrix in the terminal
+    int lightLevel = 2000;     // Light sensor reading (0-4095)
+    bool failSelfCheck = false;  // Refuse the clock's loopback requests to itself, so a new image rolls back
+    char** argv = nullptr;     // Command line, passed on to an OTA image
+};
+
+extern EmulatorOptions emulator;
+
+// UTC as seen by the emulated NTP client
+time_t emulatorUtcNow();
+
+/**
+ * Makes ESP.restart() boot an image received over OTA (an executable
+ * open on `fd`) with the same command line, instead of exiting. With
+ * `pendingVerify` the running image is kept for a rollback.
+ */
+void emulatorInstallImage(int fd, bool pendingVerify);
+
+// Hands the running image on to the next one, which boots pending verification
+void emulatorKeepPreviousImage();
+
+// Draws the LED buffer (called from FastLED.show())
+void emulatorShow(const CRGB* leds, int count, uint8_t brightness);
+
+// Prints one line of firmware output below the matrix
+void emulatorPrint(const char* line);
+
+#endif // EMULATOR_H
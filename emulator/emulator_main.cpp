@@ -0,0 +1,71 @@
+/**
+ * Word Clock Emulator - entry point
+ *
+ * Runs the firmware's setup() once and loop() forever, like the Arduino
+ * core does on the device.
+ *
+ * Usage: program [--port N] [--ota-port N] [--speed X] [--start YYYY-MM-DDTHH:MM[:SS]]
+ *                [--light LEVEL] [--offline] [--no-render] [--fail-self-check]
+ *   --port    localhost port for the web server (default 8080)
+ *   --ota-port  localhost UDP port for OTA updates (default 3232, 0 = off)
+ *   --speed   emulated seconds per real second (default 1)
+ *   --start   UTC date and time at boot (default: now)
+ *   --light   light sensor reading, 0-4095 (default 2000)
+ *   --offline no WiFi; the firmware runs on its simulated time
+ *   --no-render  do not draw the matrix (for load tests)
+ *   --fail-self-check  the clock cannot reach its own web server, so an
+ *             image it installs fails its self-check and is rolled back
+ *
+ *   pio run -e emulator && .pio/build/emulator/program --speed 60
+ */
+
+#include <Arduino.h>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <word_clock_core.h>
+
+EmulatorOptions emulator;
+
+void setup();
+void loop();
+
+static bool parseStart(const char* text, time_t& utc) {
+    int year, month, day, hour, minute, second = 0;
+    if (sscanf(text, "%d-%d-%dT%d:%d:%d", &year, &month, &day, &hour, &minute, &second) < 5) return false;
+    utc = (time_t)(daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second);
+    return true;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--port N] [--ota-port N] [--speed X] [--start YYYY-MM-DDTHH:MM[:SS]] "
+                    "[--light LEVEL] [--offline] [--no-render] [--fail-self-check]\n", program);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    emulator.startUtc = time(nullptr);
+    emulator.argv = argv;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--port") && hasValue) emulator.httpPort = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--ota-port") && hasValue) emulator.otaPort = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--speed") && hasValue) emulator.speed = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--start") && hasValue) {
+            if (!parseStart(argv[++i], emulator.startUtc)) usage(argv[0]);
+        }
+        else if (!strcmp(argv[i], "--light") && hasValue) emulator.lightLevel = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--offline")) emulator.offline = true;
+        else if (!strcmp(argv[i], "--no-render")) emulator.render = false;
+        else if (!strcmp(argv[i], "--fail-self-check")) emulator.failSelfCheck = true;
+        else usage(argv[0]);
+    }
+    if (emulator.speed <= 0) usage(argv[0]);
+
+    // Let atexit handlers restore the terminal on Ctrl-C
+    signal(SIGINT, [](int) { exit(0); });
+    signal(SIGTERM, [](int) { exit(0); });
+
+    setup();
+    for (;;) loop();
+}
@@ -0,0 +1,99 @@
+/**
+ * Word Clock Emulator - HTTPClient
+ */
+
+#include <HTTPClient.h>
+#include <poll.h>
+#include <algorithm>
+
+static std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+    return text;
+}
+
+bool HTTPClient::begin(const String& url) {
+    end();
+    const std::string& text = url.str();
+    if (text.compare(0, 7, "http://") != 0) return false;
+    size_t slash = text.find('/', 7);
+    std::string authority = text.substr(7, slash == std::string::npos ? std::string::npos : slash - 7);
+    path = slash == std::string::npos ? "/" : text.substr(slash);
+    size_t colon = authority.find(':');
+    host = authority.substr(0, colon);
+    port = colon == std::string::npos ? 80 : (uint16_t)atoi(authority.c_str() + colon + 1);
+    return !host.empty() && port != 0;
+}
+
+void HTTPClient::end() {
+    client.stop();
+    requestHeaders.clear();
+    for (auto& header : responseHeaders) header.second.clear();
+    size = -1;
+}
+
+void HTTPClient::addHeader(const String& name, const String& value) {
+    requestHeaders += name.str() + ": " + value.str() + "\r\n";
+}
+
+void HTTPClient::collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
+    responseHeaders.clear();
+    for (size_t i = 0; i < headerKeysCount; i++) responseHeaders[lowercase(headerKeys[i])] = "";
+}
+
+String HTTPClient::header(const char* name) {
+    auto found = responseHeaders.find(lowercase(name));
+    return found == responseHeaders.end() ? String() : String(found->second);
+}
+
+// One header line without its CRLF, waiting up to the timeout for each byte
+bool HTTPClient::readLine(std::string& line) {
+    line.clear();
+    for (;;) {
+        pollfd ready = {client.fd(), POLLIN, 0};
+        if (poll(&ready, 1, timeoutMs) <= 0) return false;
+        int c = client.read();
+        if (c < 0) return false;
+        if (c == '\n') break;
+        if (c != '\r') line += (char)c;
+    }
+    return true;
+}
+
+int HTTPClient::GET() {
+    client.setTimeout(connectTimeoutMs);
+    if (!client.connect(host.c_str(), port)) return HTTPC_ERROR_CONNECTION_REFUSED;
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\nUser-Agent: ESP32HTTPClient\r\n" +
+                          "Connection: close\r\n" + requestHeaders + "\r\n";
+    if (client.write((const uint8_t*)request.data(), request.size()) != request.size()) {
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+
+    std::string line;
+    if (!readLine(line)) return HTTPC_ERROR_READ_TIMEOUT;
+    int code = 0;
+    if (sscanf(line.c_str(), "HTTP/1.%*d %d", &code) != 1) return HTTPC_ERROR_CONNECTION_LOST;
+    while (readLine(line) && !line.empty()) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string name = lowercase(line.substr(0, colon));
+        size_t start = line.find_first_not_of(' ', colon + 1);
+        std::string value = start == std::string::npos ? "" : line.substr(start);
+        if (name == "content-length") size = atoi(value.c_str());
+        auto found = responseHeaders.find(name);
+        if (found != responseHeaders.end()) found->second = value;
+    }
+    return code;
+}
+
+String HTTPClient::getString() {
+    std::string body;
+    char buffer[1024];
+    while (size < 0 || (int)body.size() < size) {
+        pollfd ready = {client.fd(), POLLIN, 0};
+        if (poll(&ready, 1, timeoutMs) <= 0) break;
+        int n = client.read((uint8_t*)buffer, sizeof(buffer));
+        if (n <= 0) break;
+        body.append(buffer, n);
+    }
+    return String(body);
+}
@@ -0,0 +1,95 @@
+/**
+ * Word Clock Emulator - WiFi, WiFiManager and ezTime
+ */
+
+#include <WiFi.h>
+#include <WiFiManager.h>
+#include <ezTime.h>
+
+WiFiClass WiFi;
+Timezone UTC;
+
+static timeStatus_t ntpStatus = timeNotSet;
+static time_t ntpLastUpdate = 0;
+
+wl_status_t WiFiClass::begin(const char*, const char*) {
+    emulateConnect();
+    return status();
+}
+
+bool WiFiClass::emulateConnect() {
+    if (emulator.offline || connected) return connected;
+    raise(ARDUINO_EVENT_WIFI_STA_START);
+    raise(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    connected = true;
+    raise(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    return true;
+}
+
+void WiFiClass::raise(arduino_event_id_t event) {
+    arduino_event_info_t info = {};
+    for (auto& callback : callbacks) callback(event, info);
+}
+
+void WiFiManager::startWebPortal() {
+    server.reset(new WebServer(80));
+    if (webServerCallback) webServerCallback();
+    server->on("/", HTTP_GET, [this]() {
+        String page = String("<!DOCTYPE html><html><head><title>") + title + "</title>" + customHead +
+                      "</head><body><h1>" + title + "</h1></body></html>";
+        server->send(200, "text/html", page);
+    });
+    server->begin();
+}
+
+bool WiFiManager::process() {
+    if (server) server->handleClient();
+    return false;
+}
+
+bool waitForSync(uint16_t) {
+    if (WiFi.status() != WL_CONNECTED) return false;
+    ntpStatus = timeSet;
+    ntpLastUpdate = emulatorUtcNow();
+    return true;
+}
+
+timeStatus_t timeStatus() {
+    return ntpStatus;
+}
+
+time_t lastNtpUpdateTime() {
+    return ntpLastUpdate;
+}
+
+void events() {
+    // Periodic resync, as ezTime does from events()
+    if (ntpStatus != timeNotSet && emulatorUtcNow() - ntpLastUpdate >= NTP_INTERVAL) waitForSync();
+}
+
+bool Timezone::setLocation(const String& location) {
+    const char* rule = posixRuleFor(location.c_str());
+    if (!rule || !zone.parse(rule)) return false;
+    this->location = location;
+    posix = rule;
+    return true;
+}
+
+bool Timezone::setPosix(const String& rule) {
+    if (!zone.parse(rule.c_str())) return false;
+    posix = rule;
+    return true;
+}
+
+time_t Timezone::now() {
+    return zone.toLocal(emulatorUtcNow());
+}
+
+String Timezone::dateTime(const String&) {
+    time_t local = now();
+    struct tm fields;
+    gmtime_r(&local, &fields);
+    char text[32];
+    strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &fields);
+    return String(text) + " " + location;
+}
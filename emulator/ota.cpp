@@ -0,0 +1,166 @@
+/**
+ * Word Clock Emulator - ArduinoOTA receiver
+ *
+ * Follows ArduinoOTA.cpp in the ESP32 core: the invitation and password
+ * challenge arrive over UDP, then the clock connects back to the sender
+ * and reads the image, acknowledging each read with the bytes written.
+ * Like the device, it blocks loop() until the transfer ends and writes
+ * the image through Update, which ESP.restart() then boots.
+ */
+
+#include <ArduinoOTA.h>
+#include <Update.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../tools/md5.h"
+
+#define OTA_COMMAND_FLASH 0
+#define OTA_COMMAND_AUTH 200
+#define OTA_TIMEOUT_MS 1000          // Wait for data before acknowledging again
+#define OTA_RETRIES 3                // Acknowledgements resent before giving up
+#define OTA_READ_SIZE 1460           // As the ESP32 core reads
+
+ArduinoOTAClass ArduinoOTA;
+
+ArduinoOTAClass& ArduinoOTAClass::setPassword(const char* password) {
+    passwordMd5 = Md5::of(password);
+    return *this;
+}
+
+void ArduinoOTAClass::begin() {
+    if (!emulator.otaPort) return;
+    udp = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(emulator.otaPort);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    char line[64];
+    if (bind(udp, (sockaddr*)&address, sizeof(address)) != 0) {
+        ::close(udp);
+        udp = -1;
+        snprintf(line, sizeof(line), "OTA off: UDP port %u is in use", emulator.otaPort);
+    } else {
+        snprintf(line, sizeof(line), "OTA on udp://127.0.0.1:%u", emulator.otaPort);
+    }
+    emulatorPrint(line);
+}
+
+void ArduinoOTAClass::reply(const char* text) {
+    sockaddr_in to = {};
+    to.sin_family = AF_INET;
+    to.sin_port = senderPort;
+    to.sin_addr.s_addr = senderAddress;
+    sendto(udp, text, strlen(text), 0, (sockaddr*)&to, sizeof(to));
+}
+
+void ArduinoOTAClass::fail(ota_error_t error) {
+    waitingForAuth = false;
+    if (errorCallback) errorCallback(error);
+}
+
+void ArduinoOTAClass::handle() {
+    if (udp < 0) return;
+    char packet[128];
+    sockaddr_in from = {};
+    socklen_t fromSize = sizeof(from);
+    ssize_t n = recvfrom(udp, packet, sizeof(packet) - 1, 0, (sockaddr*)&from, &fromSize);
+    if (n <= 0) return;
+    packet[n] = '\0';
+
+    if (!waitingForAuth) {
+        // "command port size md5\n"
+        int command;
+        unsigned port;
+        unsigned long size;
+        char md5[33];
+        if (sscanf(packet, "%d %u %lu %32s", &command, &port, &size, md5) != 4 || strlen(md5) != 32) return;
+        if (command != OTA_COMMAND_FLASH) return;  // No filesystem image to update
+        senderAddress = from.sin_addr.s_addr;
+        senderPort = from.sin_port;
+        imagePort = port;
+        imageSize = size;
+        imageMd5 = md5;
+        if (!passwordMd5.empty()) {
+            nonce = Md5::of(std::to_string(micros()));
+            reply(("AUTH " + nonce).c_str());
+            waitingForAuth = true;
+            return;
+        }
+    } else {
+        // "200 cnonce md5(md5(password):nonce:cnonce)\n"
+        int command;
+        char cnonce[33], response[33];
+        if (sscanf(packet, "%d %32s %32s", &command, cnonce, response) != 3 || command != OTA_COMMAND_AUTH) return;
+        if (from.sin_addr.s_addr != senderAddress) return;
+        waitingForAuth = false;
+        if (Md5::of(passwordMd5 + ":" + nonce + ":" + cnonce) != response) {
+            reply("Authentication Failed");
+            fail(OTA_AUTH_ERROR);
+            return;
+        }
+    }
+    reply("OK");
+    runUpdate(senderAddress, imagePort, imageSize, imageMd5);
+}
+
+void ArduinoOTAClass::runUpdate(uint32_t address, uint16_t port, uint32_t size, const std::string& md5) {
+    if (!Update.begin(size)) {
+        fail(OTA_BEGIN_ERROR);
+        return;
+    }
+    Update.setMD5(md5.c_str());
+    if (startCallback) startCallback();
+    if (progressCallback) progressCallback(0, size);
+
+    int client = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in sender = {};
+    sender.sin_family = AF_INET;
+    sender.sin_port = htons(port);
+    sender.sin_addr.s_addr = address;
+    if (connect(client, (sockaddr*)&sender, sizeof(sender)) != 0) {
+        ::close(client);
+        Update.abort();
+        fail(OTA_CONNECT_ERROR);
+        return;
+    }
+
+    uint32_t total = 0;
+    size_t written = 0;
+    char ack[16];
+    for (int tried = 0; total < size;) {
+        pollfd ready = {client, POLLIN, 0};
+        if (poll(&ready, 1, OTA_TIMEOUT_MS) <= 0) {
+            if (!written || tried++ >= OTA_RETRIES) break;
+            send(client, ack, snprintf(ack, sizeof(ack), "%zu", written), MSG_NOSIGNAL);
+            continue;
+        }
+        uint8_t buffer[OTA_READ_SIZE];
+        ssize_t n = recv(client, buffer, std::min<size_t>(sizeof(buffer), size - total), 0);
+        if (n <= 0 || Update.write(buffer, n) != (size_t)n) break;
+        tried = 0;
+        written = n;
+        total += n;
+        send(client, ack, snprintf(ack, sizeof(ack), "%zu", written), MSG_NOSIGNAL);
+        if (progressCallback) progressCallback(total, size);
+    }
+    if (total < size) {
+        ::close(client);
+        Update.abort();
+        fail(OTA_RECEIVE_ERROR);
+        return;
+    }
+    if (!Update.end()) {
+        const char* error = Update.errorString();
+        send(client, error, strlen(error), MSG_NOSIGNAL);
+        ::close(client);
+        fail(OTA_END_ERROR);
+        return;
+    }
+    send(client, "OK", 2, MSG_NOSIGNAL);
+    ::close(client);
+    if (endCallback) endCallback();
+    ESP.restart();
+}
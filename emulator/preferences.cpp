@@ -0,0 +1,136 @@
+/**
+ * Word Clock Emulator - Preferences
+ */
+
+#include <Preferences.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define NVS_ENV "WORDCLOCK_EMULATOR_NVS"
+
+enum NvsType : uint8_t {
+    NVS_INT,
+    NVS_STRING,  // Stored with its terminator, as getString() returns it
+    NVS_BYTES,
+};
+
+struct NvsEntry {
+    uint8_t type;
+    std::string value;
+};
+
+// Every namespace's entries, keyed "namespace/key"
+static std::map<std::string, NvsEntry> entries;
+static int nvs = -1;
+
+// Record layout: type, key length, value length, key, value
+struct NvsRecord {
+    uint8_t type;
+    uint8_t keyLength;
+    uint16_t valueLength;
+};
+
+// Reads the store the image before this one handed on, or starts an empty one
+static bool open() {
+    if (nvs >= 0) return true;
+    const char* fd = getenv(NVS_ENV);
+    if (!fd) {
+        nvs = memfd_create("wordclock-nvs", 0);  // Not close-on-exec: the next image inherits it
+        if (nvs < 0) return false;
+        char text[12];
+        snprintf(text, sizeof(text), "%d", nvs);
+        setenv(NVS_ENV, text, 1);
+        return true;
+    }
+    nvs = atoi(fd);
+    NvsRecord record;
+    char key[256];
+    for (off_t at = 0; pread(nvs, &record, sizeof(record), at) == sizeof(record);) {
+        at += sizeof(record);
+        std::string value(record.valueLength, '\0');
+        if (pread(nvs, key, record.keyLength, at) != record.keyLength ||
+            pread(nvs, &value[0], record.valueLength, at + record.keyLength) != record.valueLength) {
+            break;
+        }
+        at += record.keyLength + record.valueLength;
+        entries[std::string(key, record.keyLength)] = {record.type, value};
+    }
+    return true;
+}
+
+// Writes every entry back; the store is small enough to rewrite on each change
+static bool commit() {
+    std::string data;
+    for (const auto& entry : entries) {
+        NvsRecord record = {entry.second.type, (uint8_t)entry.first.size(), (uint16_t)entry.second.value.size()};
+        data.append((const char*)&record, sizeof(record));
+        data.append(entry.first);
+        data.append(entry.second.value);
+    }
+    return ftruncate(nvs, 0) == 0 && pwrite(nvs, data.data(), data.size(), 0) == (ssize_t)data.size();
+}
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    if (!open() || strlen(name) > 15) return false;  // NVS namespace names are at most 15 characters
+    space = std::string(name) + "/";
+    this->readOnly = readOnly;
+    return true;
+}
+
+void Preferences::end() {
+    space.clear();
+}
+
+static const NvsEntry* find(const std::string& space, const char* key, uint8_t type) {
+    if (space.empty()) return nullptr;
+    auto found = entries.find(space + key);
+    return found != entries.end() && found->second.type == type ? &found->second : nullptr;
+}
+
+bool Preferences::isKey(const char* key) {
+    return !space.empty() && entries.count(space + key) != 0;
+}
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+    const NvsEntry* entry = find(space, key, NVS_INT);
+    if (!entry) return defaultValue;
+    int32_t value;
+    memcpy(&value, entry->value.data(), sizeof(value));
+    return value;
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+    const NvsEntry* entry = find(space, key, NVS_STRING);
+    if (!entry || entry->value.size() > maxLen) return 0;
+    memcpy(value, entry->value.data(), entry->value.size());
+    return entry->value.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLen) {
+    const NvsEntry* entry = find(space, key, NVS_BYTES);
+    if (!entry || entry->value.size() > maxLen) return 0;
+    memcpy(buffer, entry->value.data(), entry->value.size());
+    return entry->value.size();
+}
+
+size_t Preferences::put(const char* key, uint8_t type, const void* value, size_t length) {
+    if (space.empty() || readOnly || strlen(key) > 15 || length > UINT16_MAX) return 0;
+    entries[space + key] = {type, std::string((const char*)value, length)};
+    return commit() ? length : 0;
+}
+
+size_t Preferences::putInt(const char* key, int32_t value) {
+    return put(key, NVS_INT, &value, sizeof(value));
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    return put(key, NVS_STRING, value, strlen(value) + 1) ? strlen(value) : 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    return put(key, NVS_BYTES, value, length);
+}
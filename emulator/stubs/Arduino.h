@@ -0,0 +1,123 @@
+/**
+ * Word Clock Emulator - Arduino core stand-in
+ *
+ * Only what the firmware uses. Timing follows the emulated clock (see
+ * emulator.h), so delay(1000) takes a second divided by the speed-up.
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <functional>
+#include <string>
+#include "../emulator.h"
+
+#define PROGMEM
+#define PGM_P const char*
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+
+// Returns emulator.lightLevel plus a little sensor noise
+uint16_t analogRead(uint8_t pin);
+
+/**
+ * Arduino String on top of std::string
+ */
+class String {
+public:
+    String() = default;
+    String(const char* s) : text(s ? s : "") {}
+    String(const std::string& s) : text(s) {}
+    explicit String(int value) : text(std::to_string(value)) {}
+    explicit String(unsigned int value) : text(std::to_string(value)) {}
+    explicit String(long value) : text(std::to_string(value)) {}
+    explicit String(unsigned long value) : text(std::to_string(value)) {}
+
+    const char* c_str() const { return text.c_str(); }
+    unsigned int length() const { return text.length(); }
+    long toInt() const { return atol(text.c_str()); }
+    float toFloat() const { return atof(text.c_str()); }
+    bool isEmpty() const { return text.empty(); }
+    bool equalsIgnoreCase(const String& other) const { return strcasecmp(text.c_str(), other.c_str()) == 0; }
+    bool startsWith(const String& prefix) const { return text.compare(0, prefix.text.size(), prefix.text) == 0; }
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t i = text.find(c, from);
+        return i == std::string::npos ? -1 : (int)i;
+    }
+    String substring(unsigned int from, unsigned int to = ~0u) const {
+        if (from > text.size()) return String();
+        return String(text.substr(from, to == ~0u ? std::string::npos : to - from));
+    }
+    char operator[](unsigned int i) const { return i < text.size() ? text[i] : 0; }
+
+    String& operator+=(const String& other) { text += other.text; return *this; }
+    String& operator+=(const char* s) { text += s; return *this; }
+    String& operator+=(char c) { text += c; return *this; }
+    friend String operator+(String a, const String& b) { return a += b; }
+    friend String operator+(String a, const char* b) { return a += b; }
+    bool operator==(const String& other) const { return text == other.text; }
+    bool operator==(const char* s) const { return text == s; }
+    bool operator!=(const String& other) const { return text != other.text; }
+    bool operator<(const String& other) const { return text < other.text; }
+
+    const std::string& str() const { return text; }
+
+private:
+    std::string text;
+};
+
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* data, size_t length);
+    size_t print(const char* s);
+    size_t println(const char* s = "");
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t println(const String& s) { return println(s.c_str()); }
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    [[noreturn]] void restart();
+    uint32_t getFreeHeap() { return 200 * 1024; }
+    uint32_t getMinFreeHeap() { return 200 * 1024; }
+    // Of the running image: the emulator's executable
+    uint32_t getSketchSize();
+    String getSketchMD5();
+};
+
+extern EspClass ESP;
+
+class IPAddress {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+    uint8_t operator[](int i) const { return octets[i]; }
+    // Network byte order in memory, as on the ESP32
+    operator uint32_t() const {
+        uint32_t address;
+        memcpy(&address, octets, sizeof(address));
+        return address;
+    }
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(text);
+    }
+
+private:
+    uint8_t octets[4];
+};
+
+#endif // ARDUINO_H
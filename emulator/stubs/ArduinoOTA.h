@@ -0,0 +1,64 @@
+/**
+ * Word Clock Emulator - ArduinoOTA stand-in
+ *
+ * Receives updates with the same protocol as the ESP32 core (espota.py's
+ * UDP invitation, MD5 password challenge and TCP transfer with a byte
+ * count acknowledged per read), on the emulator's --ota-port. An image
+ * is accepted only if it is an ELF file, standing in for the ESP32
+ * image's magic byte; after onEnd() the emulator restarts into it, so
+ * pushing another emulator build really changes what the clock runs.
+ */
+
+#ifndef ARDUINO_OTA_H
+#define ARDUINO_OTA_H
+
+#include <Arduino.h>
+
+typedef enum {
+    OTA_AUTH_ERROR,
+    OTA_BEGIN_ERROR,
+    OTA_CONNECT_ERROR,
+    OTA_RECEIVE_ERROR,
+    OTA_END_ERROR,
+} ota_error_t;
+
+class ArduinoOTAClass {
+public:
+    typedef std::function<void()> THandlerFunction;
+    typedef std::function<void(ota_error_t)> THandlerFunction_Error;
+    typedef std::function<void(unsigned int, unsigned int)> THandlerFunction_Progress;
+
+    ArduinoOTAClass& setHostname(const char*) { return *this; }
+    ArduinoOTAClass& setPassword(const char* password);
+    ArduinoOTAClass& setPort(uint16_t) { return *this; }
+    ArduinoOTAClass& onStart(THandlerFunction fn) { startCallback = fn; return *this; }
+    ArduinoOTAClass& onEnd(THandlerFunction fn) { endCallback = fn; return *this; }
+    ArduinoOTAClass& onError(THandlerFunction_Error fn) { errorCallback = fn; return *this; }
+    ArduinoOTAClass& onProgress(THandlerFunction_Progress fn) { progressCallback = fn; return *this; }
+
+    void begin();
+    void handle();
+
+private:
+    void runUpdate(uint32_t address, uint16_t port, uint32_t size, const std::string& md5);
+    void fail(ota_error_t error);
+    void reply(const char* text);
+
+    THandlerFunction startCallback, endCallback;
+    THandlerFunction_Error errorCallback;
+    THandlerFunction_Progress progressCallback;
+    std::string passwordMd5;
+
+    int udp = -1;
+    bool waitingForAuth = false;
+    std::string nonce;
+    uint32_t senderAddress = 0;  // Network order
+    uint16_t senderPort = 0;     // Network order; where the UDP replies go
+    uint16_t imagePort = 0;      // Where the image is fetched from
+    uint32_t imageSize = 0;
+    std::string imageMd5;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif // ARDUINO_OTA_H
@@ -0,0 +1,73 @@
+/**
+ * Word Clock Emulator - FastLED stand-in
+ *
+ * show() hands the buffer and global brightness to the terminal renderer.
+ */
+
+#ifndef FASTLED_H
+#define FASTLED_H
+
+#include <stdint.h>
+#include "../emulator.h"
+
+struct CRGB {
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        White = 0xFFFFFF,
+    };
+
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+
+    CRGB() = default;
+    constexpr CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    constexpr CRGB(HTMLColorCode color) : r(color >> 16), g(color >> 8), b(color) {}
+
+    bool operator==(const CRGB& other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB& other) const { return !(*this == other); }
+};
+
+enum EOrder { RGB, GRB };
+
+#define BINARY_DITHER 0x01
+#define DISABLE_DITHER 0x00
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER>
+class WS2812B {};
+
+inline void fill_solid(CRGB* leds, int count, const CRGB& color) {
+    for (int i = 0; i < count; i++) leds[i] = color;
+}
+
+class CFastLED {
+public:
+    template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CFastLED& addLeds(CRGB* data, int count) {
+        leds = data;
+        ledCount = count;
+        return *this;
+    }
+
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() const { return brightness; }
+    void setDither(uint8_t) {}
+
+    void show() {
+        if (leds) emulatorShow(leds, ledCount, brightness);
+    }
+
+    void clear(bool writeData = false) {
+        if (leds) fill_solid(leds, ledCount, CRGB::Black);
+        if (writeData) show();
+    }
+
+private:
+    CRGB* leds = nullptr;
+    int ledCount = 0;
+    uint8_t brightness = 255;
+};
+
+extern CFastLED FastLED;
+
+#endif // FASTLED_H
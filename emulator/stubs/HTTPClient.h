@@ -0,0 +1,52 @@
+/**
+ * Word Clock Emulator - HTTPClient stand-in
+ *
+ * The subset of the ESP32 core's HTTPClient the firmware uses: a plain
+ * http:// GET with extra request headers, chosen response headers, and
+ * the body read either whole or from the connection.
+ */
+
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <WiFi.h>
+#include <map>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+class HTTPClient {
+public:
+    bool begin(const String& url);
+    void end();
+    void setTimeout(uint16_t ms) { timeoutMs = ms; }
+    void setConnectTimeout(int32_t ms) { connectTimeoutMs = ms; }
+
+    void addHeader(const String& name, const String& value);
+    void collectHeaders(const char* headerKeys[], const size_t headerKeysCount);
+    String header(const char* name);
+
+    int GET();
+    int getSize() const { return size; }  // Content-Length, or -1 if not sent
+    String getString();
+    WiFiClient* getStreamPtr() { return &client; }
+    bool connected() { return client.connected(); }
+
+private:
+    bool readLine(std::string& line);
+
+    WiFiClient client;
+    std::string host;
+    uint16_t port = 80;
+    std::string path;
+    std::string requestHeaders;
+    std::map<std::string, std::string> responseHeaders;  // Collected names, lowercase
+    int size = -1;
+    uint32_t timeoutMs = 5000;
+    uint32_t connectTimeoutMs = 5000;
+};
+
+#endif // HTTP_CLIENT_H
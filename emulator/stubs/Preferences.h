@@ -0,0 +1,38 @@
+/**
+ * Word Clock Emulator - Preferences stand-in
+ *
+ * NVS is an anonymous memory file that an image booted by ESP.restart()
+ * inherits, like flash surviving a reboot: settings and the update log
+ * carry over from an image to the one it installs, or rolls back to.
+ * Each emulator run starts with it empty.
+ */
+
+#ifndef PREFERENCES_H
+#define PREFERENCES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+
+    bool isKey(const char* key);
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    size_t getString(const char* key, char* value, size_t maxLen);
+    size_t getBytes(const char* key, void* buffer, size_t maxLen);
+
+    size_t putInt(const char* key, int32_t value);
+    size_t putString(const char* key, const char* value);
+    size_t putBytes(const char* key, const void* value, size_t length);
+
+private:
+    size_t put(const char* key, uint8_t type, const void* value, size_t length);
+
+    std::string space;  // "namespace/" while begun, else empty
+    bool readOnly = false;
+};
+
+#endif // PREFERENCES_H
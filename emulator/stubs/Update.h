@@ -0,0 +1,42 @@
+/**
+ * Word Clock Emulator - Update stand-in
+ *
+ * Writes the image to an anonymous memory file instead of the inactive
+ * OTA partition. end() checks the MD5 given to setMD5() and that the
+ * image is an ELF file, standing in for the ESP32 image's magic byte,
+ * then makes the next ESP.restart() boot it pending verification (see
+ * esp_ota_ops.h).
+ */
+
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include <Arduino.h>
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+class UpdateClass {
+public:
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN);
+    bool setMD5(const char* expectedMd5);
+    size_t write(uint8_t* data, size_t length);
+    bool end(bool evenIfRemaining = false);
+    void abort();
+
+    bool isRunning() const { return image >= 0; }
+    bool hasError() const { return error != nullptr; }
+    const char* errorString() const { return error ? error : "No Error"; }
+    size_t progress() const { return written; }
+    size_t size() const { return total; }
+
+private:
+    int image = -1;
+    size_t total = 0;
+    size_t written = 0;
+    std::string expectedMd5;
+    const char* error = nullptr;
+};
+
+extern UpdateClass Update;
+
+#endif // UPDATE_H
@@ -0,0 +1,114 @@
+/**
+ * Word Clock Emulator - WebServer stand-in
+ *
+ * Serves the firmware's routes on a localhost TCP port with the same
+ * scheduling as the ESP32 WebServer: handleClient() takes at most one
+ * waiting connection, reads the request, runs the handler and closes the
+ * connection. Concurrent clients queue in the listen backlog, exactly as
+ * they wait for the loop task on the device.
+ *
+ * Query strings, application/x-www-form-urlencoded and multipart/form-data
+ * bodies become args; any other body is available as arg("plain"), or is
+ * streamed through raw() to the route's upload handler if it has one.
+ * A handler that sends nothing but keeps a copy of client() leaves the
+ * connection open for a later answer, as on the device.
+ */
+
+#ifndef WEBSERVER_H
+#define WEBSERVER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+#define HTTP_RAW_BUFLEN 1436
+
+enum HTTPRawStatus { RAW_START, RAW_WRITE, RAW_END, RAW_ABORTED };
+
+struct HTTPRaw {
+    HTTPRawStatus status;
+    size_t totalSize;    // Body bytes so far
+    size_t currentSize;  // Bytes in buf
+    uint8_t buf[HTTP_RAW_BUFLEN];
+};
+
+class WebServer {
+public:
+    typedef std::function<void()> THandlerFunction;
+
+    explicit WebServer(int port = 80);
+    ~WebServer();
+
+    void begin();
+    void close();
+    void handleClient();
+
+    void on(const String& uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void on(const String& uri, HTTPMethod method, THandlerFunction handler);
+    // `upload` receives a non-form body through raw() as it arrives, instead of arg("plain")
+    void on(const String& uri, HTTPMethod method, THandlerFunction handler, THandlerFunction upload);
+    void onNotFound(THandlerFunction handler) { notFoundHandler = handler; }
+
+    // The connection being served; keep a copy to answer after the handler returns
+    WiFiClient client() { return connection; }
+    String uri() const { return requestUri; }
+    HTTPMethod method() const { return requestMethod; }
+    String arg(const String& name) const;
+    String arg(int i) const;
+    String argName(int i) const;
+    int args() const { return (int)requestArgs.size(); }
+    bool hasArg(const String& name) const;
+    String header(const String& name) const;
+    HTTPRaw& raw() { return rawBody; }
+
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+    void send_P(int code, PGM_P contentType, PGM_P content);
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength);
+    void setContentLength(size_t length) { contentLength = length; }
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+    void sendContent(const char* content, size_t size);
+
+private:
+    struct Route {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction handler;
+        THandlerFunction upload;
+    };
+
+    bool readRequest();
+    bool streamBody(std::string& received, size_t length, std::chrono::steady_clock::time_point deadline);
+    void parseArgs(const std::string& encoded);
+    void parseMultipart(const std::string& body, const std::string& boundary);
+    void sendHead(int code, const char* contentType, size_t length);
+    void writeAll(const char* data, size_t size);
+    void finishResponse();
+
+    int port;
+    int listenSocket = -1;
+    WiFiClient connection;
+    std::vector<Route> routes;
+    const Route* match = nullptr;  // Route of the request being served
+    HTTPRaw rawBody;
+    THandlerFunction notFoundHandler;
+
+    HTTPMethod requestMethod = HTTP_GET;
+    String requestUri;
+    std::vector<std::pair<String, String>> requestArgs;
+    std::vector<std::pair<String, String>> requestHeaders;
+    std::string extraHeaders;
+    size_t contentLength = CONTENT_LENGTH_NOT_SET;
+    bool chunked = false;
+    bool responded = false;
+};
+
+#endif // WEBSERVER_H
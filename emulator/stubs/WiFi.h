@@ -0,0 +1,92 @@
+/**
+ * Word Clock Emulator - WiFi stand-in
+ *
+ * Connected unless the emulator runs with --offline; the "network" is the
+ * host's loopback interface.
+ */
+
+#ifndef WIFI_H
+#define WIFI_H
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+    ARDUINO_EVENT_WIFI_READY = 0,
+    ARDUINO_EVENT_WIFI_STA_START = 2,
+    ARDUINO_EVENT_WIFI_STA_CONNECTED = 4,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED = 5,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP = 7,
+} arduino_event_id_t;
+
+typedef union {
+    uint32_t unused;
+} arduino_event_info_t;
+
+typedef std::function<void(arduino_event_id_t event, arduino_event_info_t info)> WiFiEventFuncCb;
+
+class WiFiClass {
+public:
+    wl_status_t status() const { return connected ? WL_CONNECTED : WL_DISCONNECTED; }
+    wl_status_t begin(const char* ssid = nullptr, const char* password = nullptr);
+    IPAddress localIP() const { return IPAddress(127, 0, 0, 1); }
+    void onEvent(WiFiEventFuncCb callback) { callbacks.push_back(callback); }
+
+    // Emulator only: connects (unless offline) and raises the matching events
+    bool emulateConnect();
+
+private:
+    void raise(arduino_event_id_t event);
+
+    bool connected = false;
+    std::vector<WiFiEventFuncCb> callbacks;
+};
+
+extern WiFiClass WiFi;
+
+/**
+ * A TCP connection. Copies share the socket, as on the ESP32, so a copy
+ * kept after a WebServer handler returns keeps the connection open
+ */
+class WiFiClient {
+public:
+    WiFiClient() = default;
+    explicit WiFiClient(int fd);  // Emulator only: takes over a connected socket
+
+    // Blocks until connected; port 80 on this clock is the emulator's --port
+    int connect(IPAddress ip, uint16_t port);
+    int connect(const char* host, uint16_t port);
+    uint8_t connected();
+    IPAddress remoteIP();
+    size_t write(const uint8_t* data, size_t size);
+    size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    int available();
+    int read(uint8_t* buffer, size_t size);  // What has arrived, up to `size`; never blocks
+    int read();
+    void setTimeout(uint32_t ms) { timeoutMs = ms; }
+    void stop();
+    explicit operator bool() const { return socket && socket->fd >= 0; }
+
+    // Emulator only
+    int fd() const { return socket ? socket->fd : -1; }
+    long useCount() const { return socket.use_count(); }
+
+private:
+    struct Socket {
+        int fd;
+        ~Socket();
+    };
+    std::shared_ptr<Socket> socket;
+    uint32_t timeoutMs = 3000;
+};
+
+#endif // WIFI_H
@@ -0,0 +1,41 @@
+/**
+ * Word Clock Emulator - WiFiManager stand-in
+ *
+ * autoConnect() "joins" the network unless the emulator is offline, and
+ * startWebPortal() brings up the WebServer with the firmware's routes plus
+ * a plain portal page at "/", as the real portal does once connected.
+ */
+
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <Arduino.h>
+#include <WebServer.h>
+#include <WiFi.h>
+#include <memory>
+
+class WiFiManager {
+public:
+    std::unique_ptr<WebServer> server;
+
+    void setTitle(const String& title) { this->title = title; }
+    void setClass(const String&) {}
+    void setCaptivePortalEnable(bool) {}
+    void setConfigPortalTimeout(unsigned long) {}
+    void setShowInfoUpdate(bool) {}
+    void setWebServerCallback(std::function<void()> callback) { webServerCallback = callback; }
+    void setCustomHeadElement(const char* html) { customHead = html ? html : ""; }
+
+    bool autoConnect(const char* = nullptr, const char* = nullptr) { return WiFi.emulateConnect(); }
+    void startWebPortal();
+    void stopWebPortal() { server.reset(); }
+    bool getWebPortalActive() { return server != nullptr; }
+    bool process();
+
+private:
+    String title = "WiFiManager";
+    String customHead;
+    std::function<void()> webServerCallback;
+};
+
+#endif // WIFI_MANAGER_H
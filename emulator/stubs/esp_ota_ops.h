@@ -0,0 +1,33 @@
+/**
+ * Word Clock Emulator - esp_ota_ops stand-in
+ *
+ * An image booted by ESP.restart() after Update.end() runs pending
+ * verification, like an app partition under a bootloader built with
+ * rollback. The image it replaced stays open on a descriptor named in
+ * the environment until the new one is marked valid; marking it invalid
+ * restarts into that image again. The running partition reads as the
+ * running image (see esp_partition.h).
+ */
+
+#ifndef ESP_OTA_OPS_H
+#define ESP_OTA_OPS_H
+
+#include <esp_partition.h>
+
+#define ESP_ERR_OTA_ROLLBACK_FAILED 0x1508
+
+typedef enum {
+    ESP_OTA_IMG_NEW = 0x0,
+    ESP_OTA_IMG_PENDING_VERIFY = 0x1,
+    ESP_OTA_IMG_VALID = 0x2,
+    ESP_OTA_IMG_INVALID = 0x3,
+    ESP_OTA_IMG_ABORTED = 0x4,
+    ESP_OTA_IMG_UNDEFINED = 0xFFFFFFFF,
+} esp_ota_img_states_t;
+
+const esp_partition_t* esp_ota_get_running_partition();
+esp_err_t esp_ota_get_state_partition(const esp_partition_t* partition, esp_ota_img_states_t* state);
+esp_err_t esp_ota_mark_app_valid_cancel_rollback();
+esp_err_t esp_ota_mark_app_invalid_rollback_and_reboot();
+
+#endif // ESP_OTA_OPS_H
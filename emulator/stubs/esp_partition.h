@@ -0,0 +1,25 @@
+/**
+ * Word Clock Emulator - esp_partition stand-in
+ *
+ * The only partition is the running app, which reads as the emulator's
+ * own executable, so a delta update finds the image it was made against.
+ */
+
+#ifndef ESP_PARTITION_H
+#define ESP_PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_SIZE 0x104
+
+typedef struct {
+    const char* label;
+} esp_partition_t;
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* buffer, size_t size);
+
+#endif // ESP_PARTITION_H
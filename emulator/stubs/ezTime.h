@@ -0,0 +1,48 @@
+/**
+ * Word Clock Emulator - ezTime stand-in
+ *
+ * NTP time is the emulated UTC clock. Zones are resolved from the core's
+ * COMMON_TIMEZONES POSIX rules instead of the ezTime lookup server, so
+ * setLocation() only accepts those zones.
+ */
+
+#ifndef EZTIME_H
+#define EZTIME_H
+
+#include <Arduino.h>
+#include <word_clock_core.h>
+
+typedef enum {
+    timeNotSet,
+    timeNeedsSync,
+    timeSet,
+} timeStatus_t;
+
+#define NTP_INTERVAL 1801  // Seconds between resyncs, as ezTime
+
+bool waitForSync(uint16_t timeout = 0);
+timeStatus_t timeStatus();
+time_t lastNtpUpdateTime();
+void events();
+
+class Timezone {
+public:
+    bool setLocation(const String& location = "");
+    bool setPosix(const String& rule);
+    String getPosix() const { return posix; }
+
+    // Local time in this zone
+    time_t now();
+
+    // "Y-m-d H:i:s T" - the emulator ignores ezTime's format strings
+    String dateTime(const String& format = "");
+
+private:
+    String location;
+    String posix = "UTC0";
+    PosixTimezone zone;
+};
+
+extern Timezone UTC;
+
+#endif // EZTIME_H
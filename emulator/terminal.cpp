@@ -0,0 +1,90 @@
+/**
+ * Word Clock Emulator - Terminal rendering
+ *
+ * The matrix is drawn in the top lines of the terminal with 24-bit ANSI
+ * colours, each LED labelled with its part of the word it lights. Output
+ * from the firmware scrolls in a region underneath.
+ */
+
+#include <FastLED.h>
+#include <word_clock_core.h>
+#include <chrono>
+#include <unistd.h>
+
+#define MATRIX_LINES 10         // 8 rows, a status line and a gap
+#define REDRAW_INTERVAL_MS 100  // Redraw unchanged frames (for the clock line) this often
+
+static bool ansi = false;
+static char labels[FACE_LEDS][4];
+
+static void terminalRestore() {
+    if (ansi) printf("\x1b[r\x1b[?25h\n");
+    fflush(stdout);
+}
+
+static void terminalBegin() {
+    static bool started = false;
+    if (started) return;
+    started = true;
+    ansi = emulator.render && isatty(STDOUT_FILENO);
+    if (!ansi) return;
+    faceLabels(labels);
+    // Clear, hide the cursor and scroll output below the matrix
+    printf("\x1b[2J\x1b[?25l\x1b[%d;r\x1b[%d;1H", MATRIX_LINES + 1, MATRIX_LINES + 1);
+    atexit(terminalRestore);
+}
+
+void emulatorShow(const CRGB* leds, int count, uint8_t brightness) {
+    terminalBegin();
+    if (!ansi) return;
+
+    static CRGB shown[FACE_LEDS];
+    static uint8_t shownBrightness = 0;
+    static auto lastDraw = std::chrono::steady_clock::time_point();
+    auto now = std::chrono::steady_clock::now();
+    bool changed = brightness != shownBrightness;
+    for (int i = 0; i < count && i < FACE_LEDS; i++) changed |= leds[i] != shown[i];
+    if (!changed && now - lastDraw < std::chrono::milliseconds(REDRAW_INTERVAL_MS)) return;
+    lastDraw = now;
+    shownBrightness = brightness;
+    for (int i = 0; i < count && i < FACE_LEDS; i++) shown[i] = leds[i];
+
+    std::string out = "\x1b" "7\x1b[1;1H";
+    char cell[64];
+    for (int row = 0; row < 8; row++) {
+        out += "  ";
+        for (int col = 0; col < 8; col++) {
+            int led = ledAt(row, col);
+            // Scale by the global brightness, but keep dim LEDs visible
+            const CRGB& c = shown[led];
+            int r = c.r * brightness / 255, g = c.g * brightness / 255, b = c.b * brightness / 255;
+            auto level = [](int v) { return v ? 60 + v * 195 / 255 : 0; };
+            if (r + g + b == 0) {
+                snprintf(cell, sizeof(cell), "\x1b[38;5;238m %-3s", labels[led]);
+            } else {
+                snprintf(cell, sizeof(cell), "\x1b[1;38;2;%d;%d;%dm %-3s\x1b[22m", level(r), level(g), level(b), labels[led]);
+            }
+            out += cell;
+        }
+        out += "\x1b[0m\x1b[K\n";
+    }
+
+    time_t utc = emulatorUtcNow();
+    struct tm fields;
+    gmtime_r(&utc, &fields);
+    char status[96];
+    strftime(status, sizeof(status), "  %Y-%m-%d %H:%M:%S UTC", &fields);
+    out += status;
+    snprintf(status, sizeof(status), "  x%g  brightness %u  light %d%s\x1b[K",
+             emulator.speed, brightness, emulator.lightLevel, emulator.offline ? "  offline" : "");
+    out += status;
+    out += "\x1b" "8";
+    fputs(out.c_str(), stdout);
+    fflush(stdout);
+}
+
+void emulatorPrint(const char* line) {
+    terminalBegin();
+    printf("%s\n", line);
+    fflush(stdout);
+}
@@ -0,0 +1,158 @@
+/**
+ * Word Clock Emulator - Update and esp_ota_ops
+ */
+
+#include <Update.h>
+#include <esp_ota_ops.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../tools/md5.h"
+
+#define UPDATE_IMAGE_MAX (64u << 20)  // Stands in for the OTA partition size
+#define PREVIOUS_IMAGE_ENV "WORDCLOCK_EMULATOR_PREVIOUS_IMAGE"
+
+UpdateClass Update;
+
+bool UpdateClass::begin(size_t size) {
+    abort();
+    if (size == 0 || (size != UPDATE_SIZE_UNKNOWN && size > UPDATE_IMAGE_MAX)) {
+        error = "Not Enough Space";
+        return false;
+    }
+    image = memfd_create("wordclock-ota", MFD_CLOEXEC);
+    if (image < 0) {
+        error = "Flash Write Failed";
+        return false;
+    }
+    total = size;
+    error = nullptr;
+    return true;
+}
+
+bool UpdateClass::setMD5(const char* md5) {
+    if (strlen(md5) != 32) return false;
+    expectedMd5 = md5;
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t* data, size_t length) {
+    if (image < 0 || error) return 0;
+    if (total != UPDATE_SIZE_UNKNOWN && written + length > total) {
+        error = "Not Enough Space";
+        return 0;
+    }
+    if (pwrite(image, data, length, written) != (ssize_t)length) {
+        error = "Flash Write Failed";
+        return 0;
+    }
+    written += length;
+    return length;
+}
+
+bool UpdateClass::end(bool evenIfRemaining) {
+    if (image < 0 || error) return false;
+    if (total != UPDATE_SIZE_UNKNOWN && written < total && !evenIfRemaining) {
+        error = "Bad Size Given";
+        return false;
+    }
+    Md5 digest;
+    uint8_t buffer[4096];
+    char magic[4] = {};
+    for (size_t at = 0; at < written;) {
+        ssize_t n = pread(image, buffer, sizeof(buffer), at);
+        if (n <= 0) break;
+        if (at == 0) memcpy(magic, buffer, n < 4 ? n : 4);
+        digest.update(buffer, n);
+        at += n;
+    }
+    if (!expectedMd5.empty() && digest.hex() != expectedMd5) {
+        error = "MD5 Check Failed";
+    } else if (memcmp(magic, "\x7f" "ELF", 4) != 0) {
+        error = "Wrong Magic Byte";
+    }
+    if (error) return false;
+    emulatorInstallImage(image, true);
+    image = -1;  // Now owned by ESP.restart()
+    return true;
+}
+
+void UpdateClass::abort() {
+    if (image >= 0) ::close(image);
+    image = -1;
+    total = written = 0;
+    expectedMd5.clear();
+    error = "Aborted";
+}
+
+// The running image, read as the app partition
+static int runningImage() {
+    static int fd = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+    return fd;
+}
+
+uint32_t EspClass::getSketchSize() {
+    struct stat info;
+    return fstat(runningImage(), &info) == 0 ? (uint32_t)info.st_size : 0;
+}
+
+String EspClass::getSketchMD5() {
+    static String md5;  // Computed once, as on the device
+    if (md5.isEmpty()) {
+        Md5 digest;
+        uint8_t buffer[4096];
+        ssize_t n;
+        for (off_t at = 0; (n = pread(runningImage(), buffer, sizeof(buffer), at)) > 0; at += n) {
+            digest.update(buffer, n);
+        }
+        md5 = String(digest.hex());
+    }
+    return md5;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t*, size_t offset, void* buffer, size_t size) {
+    if (pread(runningImage(), buffer, size, offset) != (ssize_t)size) return ESP_ERR_INVALID_SIZE;
+    return ESP_OK;
+}
+
+// The image this one replaced, or -1 once this one is valid
+static int previousImage() {
+    const char* fd = getenv(PREVIOUS_IMAGE_ENV);
+    return fd ? atoi(fd) : -1;
+}
+
+const esp_partition_t* esp_ota_get_running_partition() {
+    static const esp_partition_t running = {"app"};
+    return &running;
+}
+
+esp_err_t esp_ota_get_state_partition(const esp_partition_t*, esp_ota_img_states_t* state) {
+    *state = previousImage() >= 0 ? ESP_OTA_IMG_PENDING_VERIFY : ESP_OTA_IMG_VALID;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_valid_cancel_rollback() {
+    int previous = previousImage();
+    if (previous >= 0) ::close(previous);
+    unsetenv(PREVIOUS_IMAGE_ENV);
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_invalid_rollback_and_reboot() {
+    int previous = previousImage();
+    if (previous < 0) return ESP_ERR_OTA_ROLLBACK_FAILED;
+    unsetenv(PREVIOUS_IMAGE_ENV);
+    fcntl(previous, F_SETFD, FD_CLOEXEC);
+    emulatorInstallImage(previous, false);
+    ESP.restart();
+}
+
+void emulatorKeepPreviousImage() {
+    if (previousImage() >= 0) ::close(previousImage());  // Replaced before it was verified
+    int previous = open("/proc/self/exe", O_RDONLY);  // Inherited by the new image
+    if (previous < 0) return;
+    char fd[12];
+    snprintf(fd, sizeof(fd), "%d", previous);
+    setenv(PREVIOUS_IMAGE_ENV, fd, 1);
+}
@@ -0,0 +1,441 @@
+/**
+ * Word Clock Emulator - WebServer on a localhost socket
+ */
+
+#include <WebServer.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#define HTTP_MAX_DATA_WAIT 5000   // ms to wait for a request, as on the device
+#define HTTP_MAX_REQUEST (64 * 1024)
+
+static const char* statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
+
+static std::string urlDecode(const std::string& text) {
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '+') {
+            out += ' ';
+        } else if (text[i] == '%' && i + 2 < text.size()) {
+            out += (char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else {
+            out += text[i];
+        }
+    }
+    return out;
+}
+
+WebServer::WebServer(int port) : port(port) {}
+
+WebServer::~WebServer() {
+    close();
+}
+
+void WebServer::begin() {
+    // Port 80 on the device is the emulator's --port on the host
+    int hostPort = port == 80 ? emulator.httpPort : port;
+    // Close-on-exec, so a restart into an OTA image can listen again
+    listenSocket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int yes = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(hostPort);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listenSocket, (sockaddr*)&address, sizeof(address)) != 0 || listen(listenSocket, 64) != 0) {
+        perror("WebServer");
+        exit(1);
+    }
+    fcntl(listenSocket, F_SETFL, O_NONBLOCK);
+
+    char line[64];
+    snprintf(line, sizeof(line), "HTTP server on http://127.0.0.1:%d/", hostPort);
+    emulatorPrint(line);
+}
+
+void WebServer::close() {
+    if (listenSocket >= 0) ::close(listenSocket);
+    listenSocket = -1;
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction handler) {
+    routes.push_back({uri, method, handler, nullptr});
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction handler, THandlerFunction upload) {
+    routes.push_back({uri, method, handler, upload});
+}
+
+// Appends what the connection has, waiting until `deadline`
+static bool receive(WiFiClient& connection, std::string& into, std::chrono::steady_clock::time_point deadline) {
+    int remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    pollfd waiting = {connection.fd(), POLLIN, 0};
+    if (remaining <= 0 || poll(&waiting, 1, remaining) <= 0) return false;
+    char buffer[4096];
+    ssize_t n = recv(connection.fd(), buffer, sizeof(buffer), 0);
+    if (n <= 0) return false;
+    into.append(buffer, n);
+    return true;
+}
+
+void WebServer::handleClient() {
+    if (listenSocket < 0) return;
+    int fd = accept4(listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) return;
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    connection = WiFiClient(fd);
+
+    if (readRequest()) {
+        responded = false;
+        chunked = false;
+        contentLength = CONTENT_LENGTH_NOT_SET;
+        extraHeaders.clear();
+        if (match) match->handler();
+        else if (notFoundHandler) notFoundHandler();
+        else send(404, "text/plain", "Not found");
+        finishResponse();
+    }
+    connection = WiFiClient();  // Closes it unless a handler kept a copy
+}
+
+bool WebServer::readRequest() {
+    std::string request;
+    size_t headerEnd;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(HTTP_MAX_DATA_WAIT);
+    while ((headerEnd = request.find("\r\n\r\n")) == std::string::npos) {
+        if (request.size() > HTTP_MAX_REQUEST || !receive(connection, request, deadline)) return false;
+    }
+
+    // Request line
+    size_t lineEnd = request.find("\r\n");
+    std::string line = request.substr(0, lineEnd);
+    size_t space1 = line.find(' ');
+    size_t space2 = line.find(' ', space1 + 1);
+    if (space1 == std::string::npos || space2 == std::string::npos) return false;
+    std::string method = line.substr(0, space1);
+    std::string target = line.substr(space1 + 1, space2 - space1 - 1);
+
+    static const struct { const char* name; HTTPMethod method; } METHODS[] = {
+        {"GET", HTTP_GET}, {"HEAD", HTTP_HEAD}, {"POST", HTTP_POST}, {"PUT", HTTP_PUT},
+        {"PATCH", HTTP_PATCH}, {"DELETE", HTTP_DELETE}, {"OPTIONS", HTTP_OPTIONS},
+    };
+    requestMethod = HTTP_ANY;
+    for (const auto& m : METHODS) {
+        if (method == m.name) requestMethod = m.method;
+    }
+
+    requestArgs.clear();
+    requestHeaders.clear();
+    size_t query = target.find('?');
+    requestUri = String(target.substr(0, query));
+    if (query != std::string::npos) parseArgs(target.substr(query + 1));
+
+    // Headers
+    for (size_t at = lineEnd + 2; at < headerEnd;) {
+        size_t end = request.find("\r\n", at);
+        std::string header = request.substr(at, end - at);
+        size_t colon = header.find(':');
+        if (colon != std::string::npos) {
+            size_t value = header.find_first_not_of(' ', colon + 1);
+            requestHeaders.push_back({String(header.substr(0, colon)), String(value == std::string::npos ? "" : header.substr(value))});
+        }
+        at = end + 2;
+    }
+
+    match = nullptr;
+    for (const Route& route : routes) {
+        if (route.uri == requestUri && (route.method == HTTP_ANY || route.method == requestMethod)) {
+            match = &route;
+            break;
+        }
+    }
+
+    // Body
+    size_t bodyLength = strtoul(header("Content-Length").c_str(), nullptr, 10);
+    std::string body = request.substr(headerEnd + 4);
+    std::string contentType = header("Content-Type").str();
+    bool form = contentType.compare(0, 33, "application/x-www-form-urlencoded") == 0 ||
+                contentType.compare(0, 19, "multipart/form-data") == 0;
+    if (!form && match && match->upload && requestMethod != HTTP_GET) return streamBody(body, bodyLength, deadline);
+    while (body.size() < bodyLength) {
+        if (body.size() > HTTP_MAX_REQUEST || !receive(connection, body, deadline)) return false;
+    }
+    body.resize(bodyLength);
+    if (contentType.compare(0, 33, "application/x-www-form-urlencoded") == 0) {
+        parseArgs(body);
+    } else if (contentType.compare(0, 19, "multipart/form-data") == 0) {
+        size_t b = contentType.find("boundary=");
+        if (b != std::string::npos) parseMultipart(body, contentType.substr(b + 9));
+    } else if (!body.empty()) {
+        requestArgs.push_back({"plain", String(body)});
+    }
+    return true;
+}
+
+// Hands the body to the route's upload handler a buffer at a time, as the ESP32 core does
+bool WebServer::streamBody(std::string& received, size_t length, std::chrono::steady_clock::time_point deadline) {
+    rawBody.status = RAW_START;
+    rawBody.totalSize = rawBody.currentSize = 0;
+    match->upload();
+    rawBody.status = RAW_WRITE;
+    while (rawBody.totalSize < length) {
+        if (received.empty() && !receive(connection, received, deadline)) {
+            rawBody.status = RAW_ABORTED;
+            match->upload();
+            return false;
+        }
+        size_t n = std::min<size_t>({received.size(), HTTP_RAW_BUFLEN, length - rawBody.totalSize});
+        memcpy(rawBody.buf, received.data(), n);
+        received.erase(0, n);
+        rawBody.currentSize = n;
+        rawBody.totalSize += n;
+        match->upload();
+    }
+    rawBody.status = RAW_END;
+    match->upload();
+    return true;
+}
+
+void WebServer::parseArgs(const std::string& encoded) {
+    for (size_t at = 0; at <= encoded.size();) {
+        size_t end = encoded.find('&', at);
+        if (end == std::string::npos) end = encoded.size();
+        std::string pair = encoded.substr(at, end - at);
+        if (!pair.empty()) {
+            size_t equals = pair.find('=');
+            std::string name = urlDecode(pair.substr(0, equals));
+            std::string value = equals == std::string::npos ? "" : urlDecode(pair.substr(equals + 1));
+            requestArgs.push_back({String(name), String(value)});
+        }
+        at = end + 1;
+    }
+}
+
+void WebServer::parseMultipart(const std::string& body, const std::string& boundary) {
+    std::string delimiter = "--" + boundary;
+    for (size_t at = body.find(delimiter); at != std::string::npos;) {
+        size_t partStart = at + delimiter.size() + 2;
+        size_t next = body.find(delimiter, partStart);
+        if (next == std::string::npos) break;
+        size_t headersEnd = body.find("\r\n\r\n", partStart);
+        if (headersEnd != std::string::npos && headersEnd < next) {
+            std::string headers = body.substr(partStart, headersEnd - partStart);
+            size_t name = headers.find("name=\"");
+            if (name != std::string::npos) {
+                size_t nameEnd = headers.find('"', name + 6);
+                std::string value = body.substr(headersEnd + 4, next - headersEnd - 4 - 2);  // Drop the CRLF before the delimiter
+                requestArgs.push_back({String(headers.substr(name + 6, nameEnd - name - 6)), String(value)});
+            }
+        }
+        at = next;
+    }
+}
+
+String WebServer::arg(const String& name) const {
+    for (const auto& a : requestArgs) {
+        if (a.first == name) return a.second;
+    }
+    return String();
+}
+
+String WebServer::arg(int i) const {
+    return i >= 0 && i < args() ? requestArgs[i].second : String();
+}
+
+String WebServer::argName(int i) const {
+    return i >= 0 && i < args() ? requestArgs[i].first : String();
+}
+
+bool WebServer::hasArg(const String& name) const {
+    for (const auto& a : requestArgs) {
+        if (a.first == name) return true;
+    }
+    return false;
+}
+
+String WebServer::header(const String& name) const {
+    for (const auto& h : requestHeaders) {
+        if (h.first.equalsIgnoreCase(name)) return h.second;
+    }
+    return String();
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    std::string line = name.str() + ": " + value.str() + "\r\n";
+    extraHeaders = first ? line + extraHeaders : extraHeaders + line;
+}
+
+void WebServer::sendHead(int code, const char* contentType, size_t length) {
+    if (contentLength != CONTENT_LENGTH_NOT_SET) length = contentLength;
+    chunked = length == CONTENT_LENGTH_UNKNOWN;
+
+    char head[256];
+    int n = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n", code, statusText(code),
+                     contentType ? contentType : "text/html");
+    std::string response(head, n);
+    if (chunked) {
+        response += "Transfer-Encoding: chunked\r\n";
+    } else {
+        response += "Content-Length: " + std::to_string(length) + "\r\n";
+    }
+    response += extraHeaders;
+    response += "Connection: close\r\n\r\n";
+    writeAll(response.data(), response.size());
+    responded = true;
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    sendHead(code, contentType, content.length());
+    if (requestMethod != HTTP_HEAD) sendContent(content);
+}
+
+void WebServer::send_P(int code, PGM_P contentType, PGM_P content) {
+    send_P(code, contentType, content, strlen(content));
+}
+
+void WebServer::send_P(int code, PGM_P contentType, PGM_P content, size_t length) {
+    sendHead(code, contentType, length);
+    if (requestMethod != HTTP_HEAD) sendContent(content, length);
+}
+
+void WebServer::sendContent(const char* content, size_t size) {
+    if (size == 0) return;  // An empty chunk would end a chunked response
+    if (chunked) {
+        char length[16];
+        int n = snprintf(length, sizeof(length), "%zx\r\n", size);
+        writeAll(length, n);
+        writeAll(content, size);
+        writeAll("\r\n", 2);
+    } else {
+        writeAll(content, size);
+    }
+}
+
+void WebServer::finishResponse() {
+    if (!responded && connection.useCount() > 1) return;  // Kept to answer later
+    if (!responded) send(500, "text/plain", "Handler sent no response");
+    if (chunked) writeAll("0\r\n\r\n", 5);
+}
+
+void WebServer::writeAll(const char* data, size_t size) {
+    connection.write((const uint8_t*)data, size);
+}
+
+WiFiClient::WiFiClient(int fd) : socket(new Socket{fd}) {}
+
+WiFiClient::Socket::~Socket() {
+    if (fd >= 0) ::close(fd);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    stop();
+    bool self = ip == WiFi.localIP() && port == 80;
+    if (self && emulator.failSelfCheck) return 0;
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(self ? emulator.httpPort : port);
+    address.sin_addr.s_addr = (uint32_t)ip;
+    timeval timeout = {(time_t)(timeoutMs / 1000), (suseconds_t)(timeoutMs % 1000 * 1000)};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (::connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        ::close(fd);
+        return 0;
+    }
+    socket.reset(new Socket{fd});
+    return 1;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &found) != 0 || !found) return 0;
+    uint32_t address = ntohl(((sockaddr_in*)found->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(found);
+    return connect(IPAddress(address >> 24, address >> 16, address >> 8, address), port);
+}
+
+int WiFiClient::available() {
+    int pending = 0;
+    if (!*this || ioctl(socket->fd, FIONREAD, &pending) != 0) return 0;
+    return pending;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    if (!*this) return -1;
+    ssize_t n = recv(socket->fd, buffer, size, MSG_DONTWAIT);
+    return n > 0 ? (int)n : -1;
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+uint8_t WiFiClient::connected() {
+    if (!*this) return 0;
+    char c;
+    ssize_t n = recv(socket->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+}
+
+size_t WiFiClient::write(const uint8_t* data, size_t size) {
+    size_t written = 0;
+    while (*this && written < size) {
+        ssize_t n = ::send(socket->fd, data + written, size - written, MSG_NOSIGNAL);
+        if (n <= 0) break;  // Client went away
+        written += n;
+    }
+    return written;
+}
+
+IPAddress WiFiClient::remoteIP() {
+    sockaddr_in peer = {};
+    socklen_t size = sizeof(peer);
+    if (!*this || getpeername(socket->fd, (sockaddr*)&peer, &size) != 0 || peer.sin_family != AF_INET) {
+        return IPAddress();
+    }
+    uint32_t address = ntohl(peer.sin_addr.s_addr);
+    return IPAddress(address >> 24, address >> 16, address >> 8, address);
+}
+
+void WiFiClient::stop() {
+    if (!socket) return;
+    if (socket->fd >= 0) ::close(socket->fd);
+    socket->fd = -1;
+    socket.reset();
+}
@@ -0,0 +1,129 @@
+/**
+ * Word Clock Core - Brightness policy
+ */
+
+#include "brightness.h"
+#include "json_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static int clampInt(int v, int low, int high) {
+    return v < low ? low : v > high ? high : v;
+}
+
+CurveSettings curveFromSettings(const BrightnessSettings& settings) {
+    CurveSettings curve;
+    int dark = clampInt(settings.darkBrightness, 0, 255);
+    int light = clampInt(settings.lightBrightness, 0, 255);
+    int rampStart = clampInt(settings.threshold - CURVE_DEFAULT_RAMP / 2, 1, LIGHT_LEVEL_MAX - 2);
+    int rampEnd = clampInt(settings.threshold + CURVE_DEFAULT_RAMP / 2, rampStart + 1, LIGHT_LEVEL_MAX - 1);
+    curve.points[0] = {0, (uint8_t)dark};
+    curve.points[1] = {(uint16_t)rampStart, (uint8_t)dark};
+    curve.points[2] = {(uint16_t)rampEnd, (uint8_t)light};
+    curve.points[3] = {LIGHT_LEVEL_MAX, (uint8_t)light};
+    curve.count = 4;
+    return curve;
+}
+
+bool parseCurvePoints(const char* text, CurveSettings& curve) {
+    CurvePoint points[CURVE_MAX_POINTS];
+    int count = 0;
+    const char* p = text;
+    while (*p) {
+        if (count == CURVE_MAX_POINTS) return false;
+        char* end;
+        long level = strtol(p, &end, 10);
+        if (end == p || *end != ':') return false;
+        p = end + 1;
+        long brightness = strtol(p, &end, 10);
+        if (end == p || (*end && *end != ',')) return false;
+        p = *end ? end + 1 : end;
+
+        if (level < 0 || level > LIGHT_LEVEL_MAX || brightness < 0 || brightness > 255) return false;
+        if (count > 0 && level <= points[count - 1].level) return false;
+        points[count++] = {(uint16_t)level, (uint8_t)brightness};
+    }
+    if (count < 2) return false;
+
+    curve.count = count;
+    for (int i = 0; i < count; i++) curve.points[i] = points[i];
+    return true;
+}
+
+size_t formatCurvePoints(char* buffer, size_t size, const CurveSettings& curve) {
+    size_t used = 0;
+    if (size) buffer[0] = '\0';
+    for (int i = 0; i < curve.count; i++) {
+        int n = snprintf(buffer + used, size - used, "%s%u:%u", i ? "," : "",
+                         curve.points[i].level, curve.points[i].brightness);
+        if (n < 0 || (size_t)n >= size - used) return 0;
+        used += n;
+    }
+    return used;
+}
+
+size_t formatCurveJson(char* buffer, size_t size, const CurveSettings& curve) {
+    JsonWriter json(buffer, size);
+    json.beginObject().key("points").beginArray();
+    for (int i = 0; i < curve.count; i++) {
+        json.beginArray().value(curve.points[i].level).value(curve.points[i].brightness).endArray();
+    }
+    json.endArray()
+        .member("hysteresis", curve.hysteresis)
+        .member("slewPerSecond", curve.slewPerSecond)
+        .endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+int averageLightSamples(const uint16_t* samples, int count) {
+    if (count <= 0) return 0;
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        total += samples[i];
+    }
+    return total / count;
+}
+
+void BrightnessController::setCurve(const CurveSettings& curve) {
+    settings = curve;
+    const CurvePoint* points = settings.points;
+    int last = settings.count - 1;
+
+    // Each bucket takes the curve's value at the middle of its ADC range
+    int segment = 0;
+    for (int bucket = 0; bucket < CURVE_LUT_SIZE; bucket++) {
+        int x = (bucket << (12 - CURVE_LUT_BITS)) + (1 << (11 - CURVE_LUT_BITS));
+        if (x <= points[0].level) {
+            lut[bucket] = points[0].brightness << 8;
+            continue;
+        }
+        if (x >= points[last].level) {
+            lut[bucket] = points[last].brightness << 8;
+            continue;
+        }
+        while (x > points[segment + 1].level) segment++;
+        const CurvePoint& a = points[segment];
+        const CurvePoint& b = points[segment + 1];
+        int span = b.level - a.level;
+        lut[bucket] = (uint16_t)((a.brightness << 8) + ((b.brightness - a.brightness) * 256 * (x - a.level) + span / 2) / span);
+    }
+}
+
+uint8_t BrightnessController::update(int lightLevel, uint32_t nowMs) {
+    uint32_t elapsed = nowMs - lastUpdate;
+    lastUpdate = nowMs;
+
+    // Ignore small changes so a level sitting on a bend does not flicker
+    bool first = level < 0;
+    if (first || abs(lightLevel - level) > settings.hysteresis) level = lightLevel;
+
+    uint16_t target = lookupFixed(level);
+    if (first || settings.slewPerSecond == 0) {
+        value = target;
+    } else {
+        uint32_t step = (uint32_t)settings.slewPerSecond * 256 * elapsed / 1000;
+        if (target > value) value = (uint32_t)(target - value) > step ? value + step : target;
+        else value = (uint32_t)(value - target) > step ? value - step : target;
+    }
+    return (value + 128) >> 8;
+}
@@ -0,0 +1,114 @@
+/**
+ * Word Clock Core - Brightness policy
+ *
+ * Chooses the LED brightness for an ambient light reading. The light
+ * level is mapped through a piecewise-linear curve of up to
+ * CURVE_MAX_POINTS points, compiled into a lookup table whenever the curve
+ * changes so each reading costs one table load. Hysteresis on the light
+ * level and a slew-rate limit on the output keep the display from
+ * flickering or jumping when the room light hovers around a bend.
+ *
+ * The table and the output are 8.8 fixed point, so a curve between two
+ * brightness steps keeps its fraction for the renderer to dither.
+ */
+
+#ifndef WORD_CLOCK_BRIGHTNESS_H
+#define WORD_CLOCK_BRIGHTNESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LIGHT_LEVEL_MAX 4095  // 12-bit ADC
+#define CURVE_MAX_POINTS 8
+#define CURVE_LUT_BITS 8      // 256 buckets of 16 ADC counts, 8.8 fixed point
+#define CURVE_LUT_SIZE (1 << CURVE_LUT_BITS)
+#define CURVE_DEFAULT_RAMP 800  // Width of the dark-to-light ramp built from BrightnessSettings
+
+struct BrightnessSettings {
+    int darkBrightness = 5;     // Changed from 20
+    int lightBrightness = 25;   // Changed from 255
+    int threshold = 2600;       // Changed from 2000
+};
+
+struct CurvePoint {
+    uint16_t level;      // Light level, 0-4095
+    uint8_t brightness;  // LED brightness, 0-255
+};
+
+struct CurveSettings {
+    uint8_t count = 0;                   // Points in use, 2 to CURVE_MAX_POINTS
+    CurvePoint points[CURVE_MAX_POINTS]; // Sorted by level, strictly increasing
+    uint16_t hysteresis = 64;            // Light level change ignored, in ADC counts
+    uint16_t slewPerSecond = 10;         // Fastest brightness change, in steps per second (0 = instant)
+};
+
+/**
+ * Curve for the classic dark/light settings: darkBrightness below the
+ * threshold, lightBrightness above, joined by a CURVE_DEFAULT_RAMP wide
+ * ramp centred on the threshold instead of a hard switch
+ */
+CurveSettings curveFromSettings(const BrightnessSettings& settings);
+
+/**
+ * Parses "level:brightness,level:brightness,..." into the curve's points
+ * @return false (leaving the curve unchanged) if the list is malformed,
+ *         out of range, not strictly increasing or has too few/many points
+ */
+bool parseCurvePoints(const char* text, CurveSettings& curve);
+
+/**
+ * Writes the curve's points as parseCurvePoints() reads them
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatCurvePoints(char* buffer, size_t size, const CurveSettings& curve);
+
+/**
+ * Writes the curve as JSON: points, hysteresis and slew rate
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatCurveJson(char* buffer, size_t size, const CurveSettings& curve);
+
+/**
+ * Filters raw ADC readings into a light level (0 dark - 4095 bright)
+ * by averaging them.
+ */
+int averageLightSamples(const uint16_t* samples, int count);
+
+/**
+ * Turns light levels into brightness through the compiled curve
+ */
+class BrightnessController {
+public:
+    BrightnessController() { setCurve(curveFromSettings(BrightnessSettings())); }
+
+    // Recompiles the lookup table; the output then slews to the new curve
+    void setCurve(const CurveSettings& curve);
+    const CurveSettings& curve() const { return settings; }
+
+    // Brightness the curve gives for a light level in 8.8 fixed point, without hysteresis or slew
+    uint16_t lookupFixed(int lightLevel) const {
+        return lut[(lightLevel < 0 ? 0 : lightLevel > LIGHT_LEVEL_MAX ? LIGHT_LEVEL_MAX : lightLevel) >> (12 - CURVE_LUT_BITS)];
+    }
+    uint8_t lookup(int lightLevel) const { return (lookupFixed(lightLevel) + 128) >> 8; }
+
+    /**
+     * Feeds a light reading and returns the brightness to show
+     * @param nowMs Milliseconds timestamp, for the slew-rate limit
+     */
+    uint8_t update(int lightLevel, uint32_t nowMs);
+
+    // Light level the output is following (after hysteresis)
+    int acceptedLevel() const { return level; }
+
+    // Current output in 8.8 fixed point, for renderers that can show fractions
+    uint16_t output() const { return value; }
+
+private:
+    CurveSettings settings;
+    uint16_t lut[CURVE_LUT_SIZE];
+    int level = -1;      // -1 until the first reading
+    uint16_t value = 0;  // 8.8 fixed point
+    uint32_t lastUpdate = 0;
+};
+
+#endif // WORD_CLOCK_BRIGHTNESS_H
@@ -0,0 +1,173 @@
+/**
+ * Word Clock Core - Clock face
+ *
+ * Time Display Format:
+ * Minutes:
+ * - XX:00 -> "O'CLOCK"
+ * - XX:05 -> "FIVE PAST"
+ * - XX:10 -> "TEN PAST"
+ * - XX:15 -> "QUARTER PAST"
+ * - XX:20 -> "TWENTY PAST"
+ * - XX:25 -> "TWENTY FIVE PAST"
+ * - XX:30 -> "HALF PAST"
+ * - XX:35 -> "TWENTY FIVE TO" (next hour)
+ * - XX:40 -> "TWENTY TO" (next hour)
+ * - XX:45 -> "QUARTER TO" (next hour)
+ * - XX:50 -> "TEN TO" (next hour)
+ * - XX:55 -> "FIVE TO" (next hour)
+ */
+
+#include "clock_face.h"
+#include <stdio.h>
+#include <string.h>
+
+constexpr uint8_t WORDS[WORD_COUNT][8] = {
+    {63, 62},          // IT IS
+    {60, 59},          // HALF
+    {57, 56},          // TEN
+    {48, 49, 50, 51},  // QUARTER
+    {52, 53, 54, 55},  // TWENTY
+    {47, 46},          // FIVE
+    {45, 44, 43, 42},  // MINUTES
+    {40},              // TO
+    {32, 33},          // PAST
+    {35, 36},          // ONE
+    {37, 38, 39},      // THREE
+    {31, 30},          // TWO
+    {28, 27},          // FOUR
+    {25, 24},          // FIVE
+    {16, 17},          // SIX
+    {18, 19, 20},      // SEVEN
+    {21, 22, 23},      // EIGHT
+    {15, 14},          // NINE
+    {13},              // TEN
+    {10, 9, 8},        // ELEVEN
+    {0, 1, 2},         // TWELVE
+    {4, 5, 6, 7},      // O'CLOCK
+};
+
+constexpr uint8_t WORD_LENGTHS[WORD_COUNT] = {2, 2, 2, 4, 4, 2, 4, 1, 2, 2, 3, 2, 2, 2, 2, 3, 3, 2, 1, 3, 3, 4};
+
+const char* const WORD_NAMES[WORD_COUNT] = {
+    "IT IS", "HALF", "TEN", "QUARTER", "TWENTY", "FIVE", "MINUTES", "TO", "PAST",
+    "ONE", "THREE", "TWO", "FOUR", "FIVE", "SIX", "SEVEN", "EIGHT", "NINE", "TEN",
+    "ELEVEN", "TWELVE", "O'CLOCK",
+};
+
+constexpr Word HOUR_WORDS[12] = {
+    WORD_TWELVE, WORD_ONE, WORD_TWO, WORD_THREE, WORD_FOUR, WORD_FIVE,
+    WORD_SIX, WORD_SEVEN, WORD_EIGHT, WORD_NINE, WORD_TEN, WORD_ELEVEN,
+};
+
+static constexpr FrameMask maskOf(Word word) {
+    FrameMask mask = 0;
+    for (int i = 0; i < WORD_LENGTHS[word]; i++) {
+        mask |= (FrameMask)1 << WORDS[word][i];
+    }
+    return mask;
+}
+
+/**
+ * Builds the frame for one of the 144 phrases
+ * @param hour12 Hour on a 12-hour dial, 0 meaning twelve
+ * @param slot Five-minute slot within the hour (0-11)
+ */
+static constexpr FrameMask composeFrame(int hour12, int slot) {
+    // Always display "IT IS"
+    FrameMask mask = maskOf(WORD_IT_IS);
+    int minutes = slot * 5;
+
+    // Past the half hour we count down to the next hour
+    if (minutes > 30) {
+        hour12 = (hour12 + 1) % 12;
+    }
+
+    if (minutes > 0) {
+        if (minutes <= 30) {
+            mask |= maskOf(WORD_PAST);
+        } else {
+            mask |= maskOf(WORD_TO);
+            minutes = 60 - minutes;
+        }
+
+        switch (minutes) {
+            case 5: mask |= maskOf(WORD_FIVE_MINUTES); break;
+            case 10: mask |= maskOf(WORD_TEN_MINUTES); break;
+            case 15: mask |= maskOf(WORD_QUARTER); break;
+            case 20: mask |= maskOf(WORD_TWENTY); break;
+            case 25: mask |= maskOf(WORD_TWENTY) | maskOf(WORD_FIVE_MINUTES); break;
+            case 30: mask |= maskOf(WORD_HALF); break;
+        }
+    }
+
+    mask |= maskOf(HOUR_WORDS[hour12]);
+
+    // Only display O'CLOCK when it's exactly on the hour
+    if (minutes == 0) {
+        mask |= maskOf(WORD_OCLOCK);
+    }
+    return mask;
+}
+
+struct FrameTable {
+    FrameMask frames[12][12];
+
+    constexpr FrameTable() : frames() {
+        for (int h = 0; h < 12; h++) {
+            for (int s = 0; s < 12; s++) {
+                frames[h][s] = composeFrame(h, s);
+            }
+        }
+    }
+};
+
+// Every phrase the clock can show, computed at compile time
+static constexpr FrameTable FRAME_TABLE;
+
+FaceTime roundTime(int hour, int minute) {
+    int roundedMinutes = ((minute + 2) / 5) * 5;
+    if (roundedMinutes == 60) {
+        roundedMinutes = 0;
+        hour = (hour + 1) % 24;
+    }
+    return {(uint8_t)hour, (uint8_t)roundedMinutes};
+}
+
+uint8_t frameRow(FrameMask frame, int row) {
+    uint8_t bits = 0;
+    for (int col = 0; col < 8; col++) {
+        if ((frame >> ledAt(row, col)) & 1) bits |= 1 << col;
+    }
+    return bits;
+}
+
+void faceLabels(char labels[FACE_LEDS][4]) {
+    for (int i = 0; i < FACE_LEDS; i++) strcpy(labels[i], ".");
+    for (int w = 0; w < WORD_COUNT; w++) {
+        char letters[16];
+        int n = 0;
+        for (const char* c = WORD_NAMES[w]; *c; c++) {
+            if (*c != ' ') letters[n++] = *c;
+        }
+        int per = (n + WORD_LENGTHS[w] - 1) / WORD_LENGTHS[w];
+        for (int i = 0; i < WORD_LENGTHS[w]; i++) {
+            int from = i * per;
+            int count = from >= n ? 0 : n - from < per ? n - from : per;
+            snprintf(labels[WORDS[w][i]], 4, "%.*s", count < 3 ? count : 3, letters + from);
+        }
+    }
+}
+
+FrameMask wordMask(Word word) {
+    return maskOf(word);
+}
+
+FrameMask frameFor(FaceTime time) {
+    return FRAME_TABLE.frames[time.hour % 12][(time.minute / 5) % 12];
+}
+
+void renderFrame(FrameMask frame, CRGB* leds, CRGB on) {
+    for (int i = 0; i < FACE_LEDS; i++) {
+        leds[i] = (frame >> i) & 1 ? on : CRGB(CRGB::Black);
+    }
+}
@@ -0,0 +1,129 @@
+/**
+ * Word Clock Core - Clock face
+ *
+ * Turns a time of day into the set of LEDs to light. A frame is a 64-bit
+ * mask with bit N set when LED N is on, so rendering, comparing and
+ * storing frames never touches the LED buffer.
+ *
+ * LED Matrix Layout (8x8):
+ * The matrix is arranged in a zig-zag pattern, with words overlaid on a mask.
+ * Numbers represent LED indices (0-63).
+ *
+ * 63 62 61 60 59 58 57 56   <- Row 0: IT IS | HALF | TEN
+ * 48 49 50 51 52 53 54 55   <- Row 1: QUARTER | TWENTY
+ * 47 46 45 44 43 42 41 40   <- Row 2: FIVE | MINUTES | TO
+ * 32 33 34 35 36 37 38 39   <- Row 3: PAST | ONE | THREE
+ * 31 30 29 28 27 26 25 24   <- Row 4: TWO | FOUR | FIVE
+ * 16 17 18 19 20 21 22 23   <- Row 5: SIX | SEVEN | EIGHT
+ * 15 14 13 12 11 10  9  8   <- Row 6: NINE | TEN | ELEVEN
+ *  0  1  2  3  4  5  6  7   <- Row 7: TWELVE | O'CLOCK
+ */
+
+#ifndef WORD_CLOCK_FACE_H
+#define WORD_CLOCK_FACE_H
+
+#include <stdint.h>
+#include "hal.h"
+
+#define FACE_LEDS 64
+
+typedef uint64_t FrameMask;
+
+// Words on the face, in the order of the WORDS table
+enum Word : uint8_t {
+    WORD_IT_IS,
+    WORD_HALF,
+    WORD_TEN_MINUTES,
+    WORD_QUARTER,
+    WORD_TWENTY,
+    WORD_FIVE_MINUTES,
+    WORD_MINUTES,
+    WORD_TO,
+    WORD_PAST,
+    WORD_ONE,
+    WORD_THREE,
+    WORD_TWO,
+    WORD_FOUR,
+    WORD_FIVE,
+    WORD_SIX,
+    WORD_SEVEN,
+    WORD_EIGHT,
+    WORD_NINE,
+    WORD_TEN,
+    WORD_ELEVEN,
+    WORD_TWELVE,
+    WORD_OCLOCK,
+    WORD_COUNT
+};
+
+// Word positions in LED array - each sub-array contains LED indices for a word
+extern const uint8_t WORDS[WORD_COUNT][8];
+
+// Number of LEDs used for each word
+extern const uint8_t WORD_LENGTHS[WORD_COUNT];
+
+// Printable name of each word
+extern const char* const WORD_NAMES[WORD_COUNT];
+
+// Hour words indexed by hour 1-12 (index 0 is TWELVE, for midnight/noon)
+extern const Word HOUR_WORDS[12];
+
+// A time of day as shown on the face: 24-hour clock, minutes a multiple of 5
+struct FaceTime {
+    uint8_t hour;
+    uint8_t minute;
+
+    bool operator==(const FaceTime& other) const { return hour == other.hour && minute == other.minute; }
+    bool operator!=(const FaceTime& other) const { return !(*this == other); }
+};
+
+/**
+ * Rounds a time to the nearest 5 minutes
+ * XX:58 and later roll over to the next hour (and 23:58 to 00:00)
+ */
+FaceTime roundTime(int hour, int minute);
+
+/**
+ * Hour (0-23) and minute of a local time_t
+ */
+inline int hourOf(time_t localTime) { return (int)((localTime % 86400 + 86400) % 86400 / 3600); }
+inline int minuteOf(time_t localTime) { return (int)((localTime % 3600 + 3600) % 3600 / 60); }
+
+/**
+ * LED index at a row (0 = top) and column (0 = left) of the matrix
+ */
+inline int ledAt(int row, int col) {
+    int base = (7 - row) * 8;
+    return row % 2 == 0 ? base + 7 - col : base + col;
+}
+
+/**
+ * One row of a frame as seen from the front: bit N is lit when the LED in
+ * column N (0 = left) is
+ */
+uint8_t frameRow(FrameMask frame, int row);
+
+/**
+ * Letters printed over each LED: a word's letters spread across its LEDs,
+ * at most three per LED ("QUARTER" -> QU AR TE R), and "." where there is
+ * no word
+ */
+void faceLabels(char labels[FACE_LEDS][4]);
+
+/**
+ * LEDs that make up one word
+ */
+FrameMask wordMask(Word word);
+
+/**
+ * LEDs to light for a rounded time, e.g. 14:35 -> IT IS TWENTY FIVE TO THREE
+ * Looks the frame up in a table of the 144 distinct phrases.
+ */
+FrameMask frameFor(FaceTime time);
+
+/**
+ * Copies a frame into an LED buffer: lit LEDs get `on`, the rest black
+ */
+void renderFrame(FrameMask frame, CRGB* leds, CRGB on = CRGB::White);
+
+#endif // WORD_CLOCK_FACE_H
@@ -0,0 +1,123 @@
+/**
+ * Word Clock Core - Double-buffered value
+ *
+ * Publishes a small value (the clock settings) from writers to readers
+ * without making a reader wait. There are two slots: one holds the
+ * published value, and a writer fills the other and then publishes it by
+ * bumping the version, whose low bit names the slot. A reader registers
+ * on the published slot, checks that it is still the published one, and
+ * copies it out; it retries only if a new version was published in
+ * between, never because a writer is busy.
+ *
+ * A writer waits, yielding to other tasks, until no reader is still
+ * copying the slot it is about to overwrite. Writers are serialised by a
+ * mutex (a FreeRTOS one on the device), and update() hands the writer the
+ * current value to edit, so two handlers changing different fields
+ * cannot lose each other's change. Each published value gets the next
+ * version number, which makes cheap change detection possible.
+ */
+
+#ifndef WORD_CLOCK_DOUBLE_BUFFER_H
+#define WORD_CLOCK_DOUBLE_BUFFER_H
+
+#include <stdint.h>
+#include <atomic>
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <mutex>
+#include <thread>
+#endif
+
+template <typename T>
+class DoubleBuffer {
+public:
+    explicit DoubleBuffer(const T& initial = T()) {
+        slots[0] = initial;
+#ifdef ESP_PLATFORM
+        writer = xSemaphoreCreateMutexStatic(&writerBuffer);
+#endif
+    }
+
+    DoubleBuffer(const DoubleBuffer&) = delete;
+    DoubleBuffer& operator=(const DoubleBuffer&) = delete;
+
+    /**
+     * Copies out the latest published value
+     * @param version If given, receives the version of the value returned
+     */
+    T load(uint32_t* version = nullptr) const {
+        for (;;) {
+            uint32_t current = published.load();
+            uint32_t slot = current & 1;
+            readers[slot].fetch_add(1);
+            // Still published: a writer now waits for us before reusing this slot
+            if (published.load() == current) {
+                T copy = slots[slot];
+                readers[slot].fetch_sub(1, std::memory_order_release);
+                if (version) *version = current;
+                return copy;
+            }
+            readers[slot].fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // Version of the latest published value; starts at 0
+    uint32_t version() const { return published.load(std::memory_order_acquire); }
+
+    /**
+     * Lets `change` edit a copy of the current value, and publishes it as a
+     * new version if `change` returns true
+     * @param version If given, receives the version current afterwards
+     * @return Whether a new version was published
+     */
+    template <typename F>
+    bool update(F change, uint32_t* version = nullptr) {
+        lock();
+        uint32_t current = published.load(std::memory_order_relaxed);
+        T next = slots[current & 1];  // Stable: only writers modify it
+        bool publish = change(next);
+        if (publish) {
+            uint32_t slot = (current + 1) & 1;
+            while (readers[slot].load() != 0) pause();  // Readers of the version before this one
+            slots[slot] = next;
+            published.store(current + 1);
+            current++;
+        }
+        if (version) *version = current;
+        unlock();
+        return publish;
+    }
+
+    void store(const T& value) {
+        update([&value](T& current) {
+            current = value;
+            return true;
+        });
+    }
+
+private:
+#ifdef ESP_PLATFORM
+    void lock() { xSemaphoreTake(writer, portMAX_DELAY); }
+    void unlock() { xSemaphoreGive(writer); }
+    static void pause() { vTaskDelay(1); }  // Lets a lower-priority reader finish its copy
+
+    StaticSemaphore_t writerBuffer;
+    SemaphoreHandle_t writer;
+#else
+    void lock() { writer.lock(); }
+    void unlock() { writer.unlock(); }
+    static void pause() { std::this_thread::yield(); }
+
+    std::mutex writer;
+#endif
+
+    T slots[2];
+    std::atomic<uint32_t> published{0};  // Version; its low bit is the slot holding it
+    mutable std::atomic<uint16_t> readers[2] = {{0}, {0}};
+};
+
+#endif // WORD_CLOCK_DOUBLE_BUFFER_H
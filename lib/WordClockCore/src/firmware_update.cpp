@@ -0,0 +1,232 @@
+/**
+ * Word Clock Core - Firmware updates
+ */
+
+#include "firmware_update.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* const UPDATE_EVENT_NAMES[UPDATE_EVENT_KIND_COUNT] = {
+    "started", "installed", "failed", "verified", "rolledBack",
+};
+
+const char* const UPDATE_ENCODING_NAMES[] = {"raw", "lzss", "delta"};
+
+static const char HTTP_SCHEME[] = "http://";
+
+// Manifest
+
+bool isValidUpdateUrl(const char* url) {
+    if (!*url) return true;
+    size_t length = strlen(url);
+    if (length >= UPDATE_URL_MAX || strncmp(url, HTTP_SCHEME, strlen(HTTP_SCHEME)) != 0) return false;
+    for (const char* c = url; *c; c++) {
+        if ((unsigned char)*c <= ' ' || *c == '"' || *c == '\\' || (unsigned char)*c >= 0x7F) return false;
+    }
+    const char* host = url + strlen(HTTP_SCHEME);
+    size_t hostLength = strcspn(host, ":/");
+    if (hostLength == 0) return false;
+    if (host[hostLength] == ':') {
+        char* end;
+        long port = strtol(host + hostLength + 1, &end, 10);
+        if (end == host + hostLength + 1 || port < 1 || port > 65535 || (*end && *end != '/')) return false;
+    }
+    return true;
+}
+
+// Resolves `url` against the manifest's URL as a browser would, for the three forms a manifest uses
+static bool resolveUrl(char* out, const char* base, const char* url) {
+    int n;
+    if (strncmp(url, HTTP_SCHEME, strlen(HTTP_SCHEME)) == 0) {
+        n = snprintf(out, UPDATE_URL_MAX, "%s", url);
+    } else if (url[0] == '/') {
+        const char* host = base + strlen(HTTP_SCHEME);
+        int origin = (int)(host - base + strcspn(host, "/"));
+        n = snprintf(out, UPDATE_URL_MAX, "%.*s%s", origin, base, url);
+    } else {
+        const char* slash = strrchr(base + strlen(HTTP_SCHEME), '/');
+        int directory = slash ? (int)(slash - base + 1) : (int)strlen(base);
+        n = snprintf(out, UPDATE_URL_MAX, "%.*s%s%s", directory, base, slash ? "" : "/", url);
+    }
+    return n > 0 && n < UPDATE_URL_MAX && isValidUpdateUrl(out);
+}
+
+// A byte count from a manifest: a whole number from 1 to UINT32_MAX
+static bool parseSize(const char* text, uint32_t& size) {
+    if (!text) return false;
+    char* end;
+    unsigned long long bytes = strtoull(text, &end, 10);
+    if (*end || bytes == 0 || bytes > UINT32_MAX) return false;
+    size = (uint32_t)bytes;
+    return true;
+}
+
+// Checks an MD5 in hex and copies it in lowercase
+static bool copyMd5(char* out, const char* md5) {
+    if (!md5 || strlen(md5) != UPDATE_MD5_SIZE - 1 || strspn(md5, "0123456789abcdefABCDEF") != UPDATE_MD5_SIZE - 1) {
+        return false;
+    }
+    for (int i = 0; i < UPDATE_MD5_SIZE; i++) {
+        char c = md5[i];
+        out[i] = c >= 'A' && c <= 'F' ? c - 'A' + 'a' : c;
+    }
+    return true;
+}
+
+bool parseUpdateManifest(const char* json, size_t length, const char* manifestUrl, UpdateManifest& manifest,
+                         char* error, size_t errorSize) {
+    JsonReader reader;
+    if (!reader.parse(json, length)) {
+        snprintf(error, errorSize, "Manifest: %s", reader.error());
+        return false;
+    }
+    const char* version = nullptr;
+    const char* url = nullptr;
+    const char* size = nullptr;
+    const char* md5 = nullptr;
+    const char* encoding = nullptr;
+    const char* transferSize = nullptr;
+    const char* delta = nullptr;
+    const char* deltaBase = nullptr;
+    const char* deltaSize = nullptr;
+    for (int i = 0; i < reader.count(); i++) {
+        const JsonMember& m = reader.member(i);
+        if (strcmp(m.key, "version") == 0 && m.type == JSON_STRING) version = m.value;
+        else if (strcmp(m.key, "url") == 0 && m.type == JSON_STRING) url = m.value;
+        else if (strcmp(m.key, "size") == 0 && m.type == JSON_NUMBER) size = m.value;
+        else if (strcmp(m.key, "md5") == 0 && m.type == JSON_STRING) md5 = m.value;
+        else if (strcmp(m.key, "encoding") == 0 && m.type == JSON_STRING) encoding = m.value;
+        else if (strcmp(m.key, "transferSize") == 0 && m.type == JSON_NUMBER) transferSize = m.value;
+        else if (strcmp(m.key, "delta") == 0 && m.type == JSON_STRING) delta = m.value;
+        else if (strcmp(m.key, "deltaBase") == 0 && m.type == JSON_STRING) deltaBase = m.value;
+        else if (strcmp(m.key, "deltaSize") == 0 && m.type == JSON_NUMBER) deltaSize = m.value;
+    }
+
+    const char* problem = nullptr;
+    bool compressed = encoding && strcmp(encoding, "lzss") == 0;
+    if (!version || !*version || strlen(version) >= UPDATE_VERSION_MAX) problem = "version";
+    else if (!url || !resolveUrl(manifest.url, manifestUrl, url)) problem = "url";
+    else if (!parseSize(size, manifest.size)) problem = "size";
+    else if (!copyMd5(manifest.md5, md5)) problem = "md5";
+    else if (encoding && !compressed && strcmp(encoding, "raw") != 0) problem = "encoding";
+    else if (compressed ? !parseSize(transferSize, manifest.transferSize) : transferSize != nullptr) {
+        problem = "transferSize";
+    } else if (delta && (!resolveUrl(manifest.deltaUrl, manifestUrl, delta) || !parseSize(deltaSize, manifest.deltaSize))) {
+        problem = "delta";
+    } else if (delta && !copyMd5(manifest.deltaBase, deltaBase)) {
+        problem = "deltaBase";
+    }
+    if (problem) {
+        snprintf(error, errorSize, "Manifest: missing or invalid %s", problem);
+        return false;
+    }
+    memcpy(manifest.version, version, strlen(version) + 1);
+    manifest.encoding = compressed ? UPDATE_LZSS : UPDATE_RAW;
+    if (!compressed) manifest.transferSize = manifest.size;
+    if (!delta) {
+        manifest.deltaUrl[0] = '\0';
+        manifest.deltaBase[0] = '\0';
+        manifest.deltaSize = 0;
+    }
+    return true;
+}
+
+UpdateEncoding chooseUpdateEncoding(const UpdateManifest& manifest, const char* runningMd5) {
+    if (manifest.deltaUrl[0] && strcmp(manifest.deltaBase, runningMd5) == 0) return UPDATE_DELTA;
+    return manifest.encoding;
+}
+
+// Download
+
+void UpdateDownload::begin(uint32_t size, uint32_t nowMs) {
+    total = size;
+    received_ = 0;
+    failed_ = 0;
+    retryAt = nowMs;
+}
+
+size_t UpdateDownload::formatRange(char* buffer, size_t size) const {
+    if (received_ == 0) return 0;
+    int n = snprintf(buffer, size, "bytes=%lu-", (unsigned long)received_);
+    return n > 0 && (size_t)n < size ? n : 0;
+}
+
+long UpdateDownload::accept(int code, const char* contentRange) const {
+    if (code == 200) return received_;
+    if (code != 206) return -1;
+    unsigned long first, last, length;
+    if (sscanf(contentRange, "bytes %lu-%lu/%lu", &first, &last, &length) != 3) return -1;
+    if (length != total || first > received_ || last < received_) return -1;
+    return received_ - first;
+}
+
+void UpdateDownload::received(uint32_t bytes) {
+    received_ += bytes;
+    if (bytes) failed_ = 0;
+}
+
+bool UpdateDownload::failed(uint32_t nowMs) {
+    failed_++;
+    uint32_t delay = UPDATE_RETRY_MIN_MS;
+    for (int i = 1; i < failed_ && delay < UPDATE_RETRY_MAX_MS; i++) delay *= 2;
+    retryAt = nowMs + (delay < UPDATE_RETRY_MAX_MS ? delay : UPDATE_RETRY_MAX_MS);
+    return failed_ < UPDATE_RETRIES;
+}
+
+// Log
+
+void UpdateLog::record(uint32_t utc, UpdateEventKind kind, UpdateSource source, const char* version,
+                       const char* detail) {
+    UpdateEvent& e = state.events[state.next];
+    e.utc = utc;
+    e.kind = kind;
+    e.source = source;
+    snprintf(e.version, sizeof(e.version), "%s", version ? version : "");
+    snprintf(e.detail, sizeof(e.detail), "%s", detail ? detail : "");
+    state.next = (state.next + 1) % UPDATE_LOG_SIZE;
+    if (state.used < UPDATE_LOG_SIZE) state.used++;
+}
+
+const UpdateEvent& UpdateLog::at(int i) const {
+    return state.events[(state.next - state.used + i + UPDATE_LOG_SIZE) % UPDATE_LOG_SIZE];
+}
+
+bool UpdateLog::rolledBack(const char* version) const {
+    for (int i = 0; i < state.used; i++) {
+        const UpdateEvent& e = at(i);
+        if (e.kind == UPDATE_ROLLED_BACK && strcmp(e.version, version) == 0) return true;
+    }
+    return false;
+}
+
+void UpdateLog::writeJson(JsonWriter& json) const {
+    json.beginArray();
+    for (int i = 0; i < state.used; i++) {
+        const UpdateEvent& e = at(i);
+        json.beginObject()
+            .member("utc", (unsigned long)e.utc)
+            .member("event", UPDATE_EVENT_NAMES[e.kind])
+            .member("source", e.source == UPDATE_PULL ? "pull" : "push")
+            .member("version", (const char*)e.version)
+            .member("detail", (const char*)e.detail)
+            .endObject();
+    }
+    json.endArray();
+}
+
+bool UpdateLog::load(const void* bytes, size_t size) {
+    State loaded;
+    if (size != sizeof(loaded)) return false;
+    memcpy(&loaded, bytes, size);
+    if (loaded.format != state.format || loaded.next >= UPDATE_LOG_SIZE || loaded.used > UPDATE_LOG_SIZE) return false;
+    for (UpdateEvent& e : loaded.events) {
+        if (e.kind >= UPDATE_EVENT_KIND_COUNT) return false;
+        e.version[UPDATE_VERSION_MAX - 1] = '\0';
+        e.detail[UPDATE_DETAIL_MAX - 1] = '\0';
+    }
+    state = loaded;
+    return true;
+}
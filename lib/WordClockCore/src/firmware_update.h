@@ -0,0 +1,186 @@
+/**
+ * Word Clock Core - Firmware updates
+ *
+ * The parts of pulling an update that do not touch the network or flash:
+ * - UpdateManifest: what the update server offers, read from a small flat
+ *   JSON document such as
+ *   {"version":"v1.4.0","url":"firmware.bin","size":1184512,"md5":"9e10..."}
+ *   The image may be compressed ("encoding":"lzss" with its
+ *   "transferSize"), and a delta against one older image may be offered
+ *   as well ("delta", "deltaBase" and "deltaSize"); see image_codec.h
+ * - UpdateDownload: where a download stands, which Range to ask for after
+ *   the connection drops, and how long to back off before asking
+ * - UpdateLog: the last few update events, pulled and pushed, kept in NVS
+ *   so a failed or rolled-back update leaves a trail
+ *
+ * Fetching and flashing are platform code (src/pull_update.cpp).
+ */
+
+#ifndef WORD_CLOCK_FIRMWARE_UPDATE_H
+#define WORD_CLOCK_FIRMWARE_UPDATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class JsonWriter;
+
+#define UPDATE_VERSION_MAX 32  // As git describe prints it, with room for -dirty
+#define UPDATE_URL_MAX 96
+#define UPDATE_MD5_SIZE 33     // 32 hex digits and the terminator
+#define UPDATE_DETAIL_MAX 40
+
+#ifndef UPDATE_RETRIES
+#define UPDATE_RETRIES 8  // Failed attempts in a row before a download is abandoned
+#endif
+
+#ifndef UPDATE_RETRY_MIN_MS
+#define UPDATE_RETRY_MIN_MS 2000  // Doubles with each failure in a row
+#endif
+
+#ifndef UPDATE_RETRY_MAX_MS
+#define UPDATE_RETRY_MAX_MS 60000
+#endif
+
+#ifndef UPDATE_LOG_SIZE
+#define UPDATE_LOG_SIZE 8
+#endif
+
+enum UpdateEncoding : uint8_t {
+    UPDATE_RAW,    // The image as flashed
+    UPDATE_LZSS,   // Compressed (see image_codec.h)
+    UPDATE_DELTA,  // Compressed, with copies from the running image
+};
+
+struct UpdateManifest {
+    char version[UPDATE_VERSION_MAX];
+    char url[UPDATE_URL_MAX];  // Absolute, resolved against the manifest's own URL
+    uint32_t size;              // Of the image as flashed
+    char md5[UPDATE_MD5_SIZE];  // Of the image as flashed; lowercase hex
+    UpdateEncoding encoding;    // Of `url`: raw or lzss
+    uint32_t transferSize;      // Of `url`
+    char deltaUrl[UPDATE_URL_MAX];       // "" if no delta is offered
+    char deltaBase[UPDATE_MD5_SIZE];     // MD5 of the image the delta applies to
+    uint32_t deltaSize;
+};
+
+/**
+ * Reads a manifest. "url" and "delta" may be relative to `manifestUrl`;
+ * "version", "url", "size" and "md5" are required, the rest optional, and
+ * all are checked.
+ * @return false with the reason in `error` if it is not a usable manifest
+ */
+bool parseUpdateManifest(const char* json, size_t length, const char* manifestUrl, UpdateManifest& manifest,
+                         char* error, size_t errorSize);
+
+/**
+ * What to fetch for a manifest: its delta when it was made against the
+ * running image, else the full image
+ * @param runningMd5 Lowercase hex MD5 of the running image
+ * @return UPDATE_DELTA, or the full image's encoding
+ */
+UpdateEncoding chooseUpdateEncoding(const UpdateManifest& manifest, const char* runningMd5);
+
+extern const char* const UPDATE_ENCODING_NAMES[];
+
+// Whether a URL is one the clock can fetch: empty (off), or http://host[:port]/path
+bool isValidUpdateUrl(const char* url);
+
+class UpdateDownload {
+public:
+    // Starts over for an image of `size` bytes; the first request is due at once
+    void begin(uint32_t size, uint32_t nowMs);
+
+    uint32_t size() const { return total; }
+    uint32_t offset() const { return received_; }
+    bool complete() const { return received_ >= total; }
+    int failures() const { return failed_; }
+
+    // Whether the next request may be made
+    bool due(uint32_t nowMs) const { return (int32_t)(nowMs - retryAt) >= 0; }
+
+    /**
+     * Writes the Range header value for the next request, e.g. "bytes=4096-"
+     * @return Its length; 0 when the download starts from the beginning
+     */
+    size_t formatRange(char* buffer, size_t size) const;
+
+    /**
+     * Checks a response against the download: a 206 must start at or
+     * before the offset and be of the same image; a 200 is the whole image
+     * again (the server ignored the Range)
+     * @param contentRange The Content-Range header, or "" if there was none
+     * @return Body bytes to skip before the next wanted byte, or -1 if the
+     *         response cannot continue the download
+     */
+    long accept(int code, const char* contentRange) const;
+
+    // Records bytes written; progress clears the failure count
+    void received(uint32_t bytes);
+
+    /**
+     * Records a failed request or a dropped connection and backs off
+     * @return false once UPDATE_RETRIES attempts in a row have failed
+     */
+    bool failed(uint32_t nowMs);
+
+private:
+    uint32_t total = 0;
+    uint32_t received_ = 0;
+    uint32_t retryAt = 0;
+    int failed_ = 0;
+};
+
+enum UpdateEventKind : uint8_t {
+    UPDATE_STARTED,      // Download or push began
+    UPDATE_INSTALLED,    // Image written and checked; restarting into it
+    UPDATE_FAILED,       // Gave up; the running image is unchanged
+    UPDATE_VERIFIED,     // The new image passed its self-check and is kept
+    UPDATE_ROLLED_BACK,  // The new image failed its self-check or did not boot
+    UPDATE_EVENT_KIND_COUNT
+};
+
+enum UpdateSource : uint8_t {
+    UPDATE_PULL,  // Fetched from the manifest URL
+    UPDATE_PUSH,  // Sent with ArduinoOTA
+};
+
+struct UpdateEvent {
+    uint32_t utc;  // 0 while the time is not known
+    UpdateEventKind kind;
+    UpdateSource source;
+    char version[UPDATE_VERSION_MAX];  // Image the event is about, if known
+    char detail[UPDATE_DETAIL_MAX];
+};
+
+class UpdateLog {
+public:
+    void record(uint32_t utc, UpdateEventKind kind, UpdateSource source, const char* version, const char* detail);
+
+    // Events held, oldest first
+    int count() const { return state.used; }
+    const UpdateEvent& at(int i) const;
+    const UpdateEvent* latest() const { return state.used ? &at(state.used - 1) : nullptr; }
+
+    // Whether `version` was rolled back, so it is not fetched again
+    bool rolledBack(const char* version) const;
+
+    // Writes the events as a JSON array, oldest first
+    void writeJson(JsonWriter& json) const;
+
+    // Raw form for NVS
+    const void* data() const { return &state; }
+    static constexpr size_t dataSize() { return sizeof(State); }
+    bool load(const void* bytes, size_t size);
+
+private:
+    struct State {
+        uint8_t format;
+        uint8_t next;
+        uint8_t used;
+        UpdateEvent events[UPDATE_LOG_SIZE];
+    } state = {1, 0, 0, {}};
+};
+
+extern const char* const UPDATE_EVENT_NAMES[UPDATE_EVENT_KIND_COUNT];
+
+#endif // WORD_CLOCK_FIRMWARE_UPDATE_H
@@ -0,0 +1,73 @@
+/**
+ * Word Clock Core - Hardware abstraction shims
+ *
+ * On the device these map straight onto Arduino and FastLED. Everywhere
+ * else (the native PlatformIO env, host tools) they are small stand-ins so
+ * the clock logic compiles and runs without a board attached.
+ */
+
+#ifndef WORD_CLOCK_HAL_H
+#define WORD_CLOCK_HAL_H
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#else
+
+// Milliseconds since the program started
+uint32_t millis();
+
+// Minimal FastLED CRGB replacement - only what the clock core uses
+struct CRGB {
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        White = 0xFFFFFF,
+    };
+
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+
+    CRGB() = default;
+    constexpr CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    constexpr CRGB(HTMLColorCode color) : r(color >> 16), g(color >> 8), b(color) {}
+
+    bool operator==(const CRGB& other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB& other) const { return !(*this == other); }
+};
+
+#endif // ARDUINO
+
+/**
+ * Source of local wall-clock time.
+ * The firmware wraps ezTime; tests and tools can substitute their own.
+ */
+class ClockSource {
+public:
+    virtual ~ClockSource() = default;
+
+    // Current local time as seconds since 1970 (timezone already applied)
+    virtual time_t now() = 0;
+};
+
+/**
+ * Clock that only moves when told to - for driving the core at any speed
+ */
+class ManualClock final : public ClockSource {
+public:
+    explicit ManualClock(time_t start = 0) : current(start) {}
+
+    time_t now() override { return current; }
+    void set(time_t t) { current = t; }
+    void advance(time_t seconds) { current += seconds; }
+
+private:
+    time_t current;
+};
+
+#endif // WORD_CLOCK_HAL_H
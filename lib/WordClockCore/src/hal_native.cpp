@@ -0,0 +1,16 @@
+/**
+ * Word Clock Core - Native implementations of the hardware shims
+ */
+
+#ifndef ARDUINO
+
+#include "hal.h"
+#include <chrono>
+
+uint32_t millis() {
+    static const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+#endif // ARDUINO
@@ -0,0 +1,126 @@
+/**
+ * Word Clock Core - Health monitor
+ */
+
+#include "health.h"
+#include "json_writer.h"
+#include <stdio.h>
+
+static const char* const ALERT_NAMES[] = {"stack", "heapLow", "fragmentation", "heapTrend"};
+
+HealthMonitor::HealthMonitor(const char* const* taskNames, int taskCount, const HealthLimits& limits)
+    : names(taskNames), tasks(taskCount < HEALTH_MAX_TASKS ? taskCount : HEALTH_MAX_TASKS), limit(limits) {}
+
+const HealthSample& HealthMonitor::at(int i) const {
+    int oldest = used < HEALTH_HISTORY ? 0 : next;
+    return ring[(oldest + i) % HEALTH_HISTORY];
+}
+
+uint8_t HealthMonitor::record(const HealthSample& sample) {
+    ring[next] = sample;
+    next = (next + 1) % HEALTH_HISTORY;
+    if (used < HEALTH_HISTORY) used++;
+
+    uint8_t previous = active;
+    active = evaluate(sample);
+    latched |= active;
+    return active & ~previous;
+}
+
+uint8_t HealthMonitor::evaluate(const HealthSample& sample) const {
+    uint8_t result = 0;
+    for (int t = 0; t < tasks; t++) {
+        if (sample.stackFree[t] != HEALTH_TASK_MISSING && sample.stackFree[t] < limit.minStackFree) {
+            result |= HEALTH_ALERT_STACK;
+        }
+    }
+    if (sample.freeHeap < limit.minFreeHeap) result |= HEALTH_ALERT_HEAP_LOW;
+    if ((uint64_t)sample.largestFreeBlock * 100 < (uint64_t)sample.freeHeap * limit.minLargestBlockPercent) {
+        result |= HEALTH_ALERT_FRAGMENTATION;
+    }
+    if (heapTrendPerHour() < -(int32_t)limit.maxHeapLossPerHour) result |= HEALTH_ALERT_HEAP_TREND;
+    return result;
+}
+
+int32_t HealthMonitor::heapTrendPerHour() const {
+    if (used < HEALTH_TREND_MIN_SAMPLES) return 0;
+
+    // Times relative to the oldest sample, in hours, keep the sums small
+    double t0 = at(0).uptimeMs;
+    double sumT = 0, sumH = 0, sumTT = 0, sumTH = 0;
+    for (int i = 0; i < used; i++) {
+        double t = (at(i).uptimeMs - t0) / 3600000.0;
+        double h = at(i).freeHeap;
+        sumT += t;
+        sumH += h;
+        sumTT += t * t;
+        sumTH += t * h;
+    }
+    double denominator = used * sumTT - sumT * sumT;
+    if (denominator <= 0) return 0;
+    return (int32_t)((used * sumTH - sumT * sumH) / denominator);
+}
+
+static void alertList(JsonWriter& json, const char* name, uint8_t alerts) {
+    json.key(name).beginArray();
+    for (int i = 0; i < 4; i++) {
+        if (alerts & (1 << i)) json.value(ALERT_NAMES[i]);
+    }
+    json.endArray();
+}
+
+size_t formatHealthJson(char* buffer, size_t size, const HealthMonitor& monitor) {
+    JsonWriter json(buffer, size);
+    const HealthSample* latest = monitor.latest();
+    json.beginObject()
+        .member("alert", monitor.latchedAlerts() != 0)
+        .member("samples", monitor.count());
+    alertList(json, "alerts", monitor.alerts());
+    alertList(json, "latchedAlerts", monitor.latchedAlerts());
+    if (latest) {
+        json.member("uptimeMs", latest->uptimeMs)
+            .key("heap").beginObject()
+                .member("free", latest->freeHeap)
+                .member("minFree", latest->minFreeHeap)
+                .member("largestBlock", latest->largestFreeBlock)
+                .member("trendPerHour", (long)monitor.heapTrendPerHour())
+            .endObject()
+            .key("tasks").beginArray();
+        for (int t = 0; t < monitor.taskCount(); t++) {
+            if (latest->stackFree[t] == HEALTH_TASK_MISSING) continue;
+            json.beginObject()
+                .member("name", monitor.taskName(t))
+                .member("stackFree", latest->stackFree[t])
+                .endObject();
+        }
+        json.endArray();
+    }
+    json.endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+size_t formatHealthCsvLine(char* buffer, size_t size, const HealthMonitor& monitor, int index) {
+    size_t used = 0;
+    auto append = [&](const char* format, auto value) {
+        if (used >= size) return;
+        int n = snprintf(buffer + used, size - used, format, value);
+        used = n < 0 ? size : used + n;
+    };
+
+    if (index < 0) {
+        append("%s", "uptime_ms,free_heap,min_free_heap,largest_block");
+        for (int t = 0; t < monitor.taskCount(); t++) append(",%s", monitor.taskName(t));
+    } else {
+        const HealthSample& s = monitor.at(index);
+        append("%lu", (unsigned long)s.uptimeMs);
+        append(",%lu", (unsigned long)s.freeHeap);
+        append(",%lu", (unsigned long)s.minFreeHeap);
+        append(",%lu", (unsigned long)s.largestFreeBlock);
+        for (int t = 0; t < monitor.taskCount(); t++) {
+            if (s.stackFree[t] == HEALTH_TASK_MISSING) append("%s", ",");
+            else append(",%u", (unsigned)s.stackFree[t]);
+        }
+    }
+    append("%s", "\n");
+    return used < size ? used : 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * Word Clock Core - Health monitor
+ *
+ * Keeps a ring of periodic stack and heap readings and decides when they
+ * breach the limits: a task close to overflowing its stack, free heap
+ * running low or fragmented, or free heap trending down (a leak).
+ * Alerts are latched until cleared, so a breach between two polls of
+ * /api/health is not missed.
+ *
+ * Taking the readings is platform code (src/health_monitor.cpp); everything here
+ * runs on the host as well.
+ */
+
+#ifndef WORD_CLOCK_HEALTH_H
+#define WORD_CLOCK_HEALTH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HEALTH_MAX_TASKS 8
+#define HEALTH_TASK_MISSING 0xFFFF  // stackFree value for a task that does not exist
+
+#ifndef HEALTH_HISTORY
+#define HEALTH_HISTORY 60  // Samples kept
+#endif
+
+#define HEALTH_TREND_MIN_SAMPLES 10  // Samples needed before the heap trend is judged
+
+struct HealthSample {
+    uint32_t uptimeMs;
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;       // Lowest free heap since boot
+    uint32_t largestFreeBlock;  // Largest single allocation that would succeed
+    uint16_t stackFree[HEALTH_MAX_TASKS];  // Bytes of stack never used (high-water mark)
+};
+
+struct HealthLimits {
+    uint32_t minStackFree = 512;          // Bytes of stack headroom per task
+    uint32_t minFreeHeap = 16 * 1024;
+    uint8_t minLargestBlockPercent = 25;  // Largest block as a share of free heap
+    uint32_t maxHeapLossPerHour = 4096;   // Downward free heap trend, bytes per hour
+};
+
+enum HealthAlert : uint8_t {
+    HEALTH_ALERT_STACK = 1,
+    HEALTH_ALERT_HEAP_LOW = 2,
+    HEALTH_ALERT_FRAGMENTATION = 4,
+    HEALTH_ALERT_HEAP_TREND = 8,
+};
+
+class HealthMonitor {
+public:
+    /**
+     * @param taskNames Names of the tasks in each stackFree column
+     */
+    HealthMonitor(const char* const* taskNames, int taskCount, const HealthLimits& limits = HealthLimits());
+
+    /**
+     * Adds a sample and re-evaluates the limits
+     * @return Alerts raised by this sample that were not already active
+     */
+    uint8_t record(const HealthSample& sample);
+
+    // Alerts for the latest sample, and every alert since clearLatched()
+    uint8_t alerts() const { return active; }
+    uint8_t latchedAlerts() const { return latched; }
+    void clearLatched() { latched = active; }
+
+    // Samples held, oldest first
+    int count() const { return used; }
+    const HealthSample& at(int i) const;
+    const HealthSample* latest() const { return used ? &at(used - 1) : nullptr; }
+
+    /**
+     * Least-squares slope of free heap over the ring, in bytes per hour
+     * (0 until HEALTH_TREND_MIN_SAMPLES samples are held)
+     */
+    int32_t heapTrendPerHour() const;
+
+    int taskCount() const { return tasks; }
+    const char* taskName(int i) const { return names[i]; }
+    const HealthLimits& limits() const { return limit; }
+
+private:
+    uint8_t evaluate(const HealthSample& sample) const;
+
+    const char* const* names;
+    int tasks;
+    HealthLimits limit;
+    HealthSample ring[HEALTH_HISTORY];
+    int next = 0;
+    int used = 0;
+    uint8_t active = 0;
+    uint8_t latched = 0;
+};
+
+/**
+ * Writes the /api/health summary: latest sample, per-task stack headroom,
+ * heap trend and alerts
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatHealthJson(char* buffer, size_t size, const HealthMonitor& monitor);
+
+/**
+ * Writes one CSV line for /api/health/history (header when index is -1)
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatHealthCsvLine(char* buffer, size_t size, const HealthMonitor& monitor, int index);
+
+#endif // WORD_CLOCK_HEALTH_H
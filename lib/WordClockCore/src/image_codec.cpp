@@ -0,0 +1,203 @@
+/**
+ * Word Clock Core - Compressed and delta firmware images
+ */
+
+#include "image_codec.h"
+#include <string.h>
+
+#define WINDOW_MASK (IMAGE_WINDOW_SIZE - 1)
+#define VARINT_LAST_SHIFT 28  // The fifth byte holds the top 4 bits of a uint32
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static uint32_t readUint32(const uint8_t* p) {
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+void ImageDecoder::begin(WriteImage write, ReadBase readBase, void* context, const char* baseMd5, uint32_t baseSize) {
+    this->write = write;
+    this->readBase = readBase;
+    this->context = context;
+    this->baseSize = baseSize;
+    haveBase = baseMd5 && strlen(baseMd5) == 32;
+    for (int i = 0; haveBase && i < 16; i++) {
+        int high = hexDigit(baseMd5[2 * i]), low = hexDigit(baseMd5[2 * i + 1]);
+        if (high < 0 || low < 0) haveBase = false;
+        this->baseMd5[i] = (uint8_t)(high << 4 | low);
+    }
+    state = HEADER;
+    failure = nullptr;
+    flags = 0;
+    reach = 0;
+    size = written = flushed = 0;
+    count = value = length = 0;
+    shift = 0;
+    baseOffset = baseNext = 0;
+}
+
+bool ImageDecoder::fail(const char* why) {
+    state = FAILED;
+    failure = why;
+    return false;
+}
+
+bool ImageDecoder::readHeader() {
+    if (memcmp(header, "WCZ", 3) != 0) return fail("Not an encoded image");
+    if (header[3] != IMAGE_FORMAT_VERSION) return fail("Unknown image format");
+    flags = header[4];
+    if (header[5] < 8 || header[5] > IMAGE_WINDOW_BITS) return fail("Image window too large");
+    reach = 1u << header[5];
+    size = readUint32(header + 8);
+    if (size == 0) return fail("Empty image");
+    if (delta()) {
+        if (!haveBase || !readBase) return fail("Delta without a base image");
+        if (memcmp(header + 16, baseMd5, 16) != 0 || readUint32(header + 12) != baseSize) {
+            return fail("Delta is for another image");
+        }
+    }
+    state = TOKEN;
+    return true;
+}
+
+// Hands the decoded bytes not yet written to the sink; they are contiguous in the window
+bool ImageDecoder::flush() {
+    if (written == flushed) return true;
+    if (!write(context, window + (flushed & WINDOW_MASK), written - flushed)) return fail("Image write failed");
+    flushed = written;
+    return true;
+}
+
+bool ImageDecoder::startToken(uint8_t token) {
+    if (token < 0x80) {
+        count = token + 1u;
+        state = LITERALS;
+    } else if (token < IMAGE_TOKEN_BASE_COPY) {
+        length = (token & 0x3F) + IMAGE_MATCH_MIN;
+        count = value = 0;
+        state = MATCH_DISTANCE;
+    } else if (token == IMAGE_TOKEN_BASE_COPY) {
+        if (!delta()) return fail("Base copy in a plain image");
+        value = shift = 0;
+        state = BASE_OFFSET;
+    } else {
+        return fail("Invalid token");
+    }
+    return true;
+}
+
+bool ImageDecoder::copyMatch(uint32_t distance) {
+    if (distance > reach || distance > written) return fail("Match before the start of the image");
+    if (length > size - written) return fail("Image longer than its header says");
+    for (uint32_t i = 0; i < length; i++) {
+        window[written & WINDOW_MASK] = window[(written - distance) & WINDOW_MASK];
+        written++;
+        if (!(written & WINDOW_MASK) && !flush()) return false;
+    }
+    state = written == size ? DONE : TOKEN;
+    return true;
+}
+
+// Reads base bytes straight into the window, up to `budget`
+bool ImageDecoder::copyBase(uint32_t& budget) {
+    while (length && budget) {
+        uint32_t room = IMAGE_WINDOW_SIZE - (written & WINDOW_MASK);
+        uint32_t n = length < room ? length : room;
+        if (n > budget) n = budget;
+        if (!readBase(context, baseOffset, window + (written & WINDOW_MASK), n)) return fail("Base image read failed");
+        written += n;
+        baseOffset += n;
+        length -= n;
+        budget -= n;
+        if (!(written & WINDOW_MASK) && !flush()) return false;
+    }
+    if (length == 0) state = written == size ? DONE : TOKEN;
+    return true;
+}
+
+size_t ImageDecoder::feed(const uint8_t* data, size_t available) {
+    size_t used = 0;
+    uint32_t start = written;
+    while (state != DONE && state != FAILED) {
+        if (written - start >= IMAGE_FEED_OUTPUT_MAX) break;
+        if (state == BASE_COPY) {
+            uint32_t budget = IMAGE_FEED_OUTPUT_MAX - (written - start);
+            copyBase(budget);
+            continue;
+        }
+        if (used == available) break;
+
+        uint8_t byte = data[used];
+        switch (state) {
+            case HEADER:
+                header[count++] = byte;
+                used++;
+                if (count == IMAGE_HEADER_SIZE) {
+                    count = 0;
+                    readHeader();
+                }
+                break;
+            case TOKEN:
+                used++;
+                startToken(byte);
+                break;
+            case LITERALS: {
+                uint32_t room = IMAGE_WINDOW_SIZE - (written & WINDOW_MASK);
+                uint32_t n = count < room ? count : room;
+                if (n > available - used) n = available - used;
+                if (n > size - written) {
+                    fail("Image longer than its header says");
+                    break;
+                }
+                memcpy(window + (written & WINDOW_MASK), data + used, n);
+                used += n;
+                written += n;
+                count -= n;
+                if (!(written & WINDOW_MASK) && !flush()) break;
+                if (count == 0) state = written == size ? DONE : TOKEN;
+                break;
+            }
+            case MATCH_DISTANCE:
+                used++;
+                value |= (uint32_t)byte << (8 * count++);
+                if (count == 2) copyMatch(value + 1);
+                break;
+            case BASE_OFFSET:
+            case BASE_LENGTH:
+                used++;
+                if (shift == VARINT_LAST_SHIFT && byte > 0x0F) {
+                    fail("Invalid varint");  // Longer than five bytes, or past 32 bits
+                    break;
+                }
+                value |= (uint32_t)(byte & 0x7F) << shift;
+                shift += 7;
+                if (byte & 0x80) break;
+                if (state == BASE_OFFSET) {
+                    // Zigzag: 0, -1, 1, -2, ... relative to the end of the last copy
+                    int32_t delta = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+                    baseOffset = baseNext + delta;
+                    value = shift = 0;
+                    state = BASE_LENGTH;
+                } else {
+                    length = value;
+                    if (length == 0 || baseOffset > baseSize || length > baseSize - baseOffset) {
+                        fail("Base copy outside the base image");
+                    } else if (length > size - written) {
+                        fail("Image longer than its header says");
+                    } else {
+                        baseNext = baseOffset + length;
+                        state = BASE_COPY;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    if (state != FAILED) flush();
+    return used;
+}
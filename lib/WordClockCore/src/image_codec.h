@@ -0,0 +1,132 @@
+/**
+ * Word Clock Core - Compressed and delta firmware images
+ *
+ * An update can be sent as an encoded image: LZSS over a small window,
+ * optionally with copies from the image the clock is running (a delta).
+ * ImageDecoder turns the stream back into the image as it arrives, with
+ * IMAGE_WINDOW_SIZE bytes of RAM, handing each full window to a sink
+ * that writes it to the OTA partition. The encoder is host code
+ * (tools/image_encoder.h).
+ *
+ * Layout (integers little-endian):
+ *
+ *   offset  field
+ *        0  magic          "WCZ"
+ *        3  format version IMAGE_FORMAT_VERSION
+ *        4  flags          bit 0: delta
+ *        5  window bits    back-references reach 2^bits bytes (8-16)
+ *        6  reserved       0, 2 bytes
+ *        8  image size     uint32, bytes decoded
+ *       12  base size      uint32, size of the delta's base image, else 0
+ *       16  base MD5       16 bytes, of the delta's base image, else 0
+ *       32  tokens         until image size bytes are decoded
+ *
+ * Tokens, by their first byte t:
+ *   0x00-0x7F  literals: t + 1 bytes follow
+ *   0x80-0xBF  match: (t & 0x3F) + 3 bytes from a uint16 distance - 1 back
+ *   0xC0       base copy: varint zigzag(offset - end of the last base
+ *              copy), varint length; bytes from the base image
+ *   0xC1-0xFF  invalid
+ */
+
+#ifndef WORD_CLOCK_IMAGE_CODEC_H
+#define WORD_CLOCK_IMAGE_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define IMAGE_FORMAT_VERSION 1
+#define IMAGE_HEADER_SIZE 32
+#define IMAGE_FLAG_DELTA 0x01
+#define IMAGE_LITERAL_MAX 128
+#define IMAGE_MATCH_MIN 3
+#define IMAGE_MATCH_MAX 66
+#define IMAGE_TOKEN_BASE_COPY 0xC0
+
+#ifndef IMAGE_WINDOW_BITS
+#define IMAGE_WINDOW_BITS 12  // Largest window the decoder holds: 4 KB
+#endif
+#define IMAGE_WINDOW_SIZE (1u << IMAGE_WINDOW_BITS)
+
+#ifndef IMAGE_FEED_OUTPUT_MAX
+#define IMAGE_FEED_OUTPUT_MAX 16384  // Bytes decoded per feed() call, so a long base copy is spread out
+#endif
+
+class ImageDecoder {
+public:
+    // Writes decoded bytes; false stops decoding
+    typedef bool (*WriteImage)(void* context, const uint8_t* data, size_t size);
+    // Reads the running image at `offset`; false stops decoding
+    typedef bool (*ReadBase)(void* context, uint32_t offset, uint8_t* buffer, size_t size);
+
+    /**
+     * Starts a new image
+     * @param baseMd5 Hex MD5 of the running image, which a delta must be
+     *                made against; nullptr if deltas cannot be applied
+     */
+    void begin(WriteImage write, ReadBase readBase, void* context, const char* baseMd5, uint32_t baseSize);
+
+    /**
+     * Decodes from `data`, stopping early once IMAGE_FEED_OUTPUT_MAX bytes
+     * have been written
+     * @return Bytes of `data` consumed; call again with the rest. Check
+     *         failed() when it is short of `size` with nothing pending.
+     */
+    size_t feed(const uint8_t* data, size_t size);
+
+    // Whether a base copy is under way, so feed() has work without more input
+    bool pending() const { return state == BASE_COPY; }
+
+    bool done() const { return state == DONE; }
+    bool failed() const { return state == FAILED; }
+    const char* error() const { return failure; }
+
+    bool delta() const { return flags & IMAGE_FLAG_DELTA; }
+    uint32_t imageSize() const { return size; }  // 0 until the header has arrived
+    uint32_t produced() const { return written; }
+
+private:
+    enum State : uint8_t {
+        HEADER,
+        TOKEN,
+        LITERALS,
+        MATCH_DISTANCE,
+        BASE_OFFSET,
+        BASE_LENGTH,
+        BASE_COPY,
+        DONE,
+        FAILED,
+    };
+
+    bool fail(const char* why);
+    bool readHeader();
+    bool flush();
+    bool startToken(uint8_t token);
+    bool copyMatch(uint32_t distance);
+    bool copyBase(uint32_t& budget);
+
+    WriteImage write = nullptr;
+    ReadBase readBase = nullptr;
+    void* context = nullptr;
+    uint8_t baseMd5[16] = {};
+    bool haveBase = false;
+    uint32_t baseSize = 0;
+
+    State state = HEADER;
+    const char* failure = nullptr;
+    uint8_t header[IMAGE_HEADER_SIZE];
+    uint8_t flags = 0;
+    uint32_t reach = 0;       // Longest match distance in this image
+    uint32_t size = 0;
+    uint32_t written = 0;     // Bytes decoded
+    uint32_t flushed = 0;     // Bytes handed to write()
+    uint32_t count = 0;       // Header bytes, literals left, or bytes of the token read
+    uint32_t value = 0;       // Varint or distance being read
+    uint8_t shift = 0;
+    uint32_t length = 0;      // Of the match or base copy
+    uint32_t baseOffset = 0;  // Next byte of a base copy
+    uint32_t baseNext = 0;    // End of the last base copy
+    uint8_t window[IMAGE_WINDOW_SIZE];
+};
+
+#endif // WORD_CLOCK_IMAGE_CODEC_H
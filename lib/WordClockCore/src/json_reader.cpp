@@ -0,0 +1,198 @@
+/**
+ * Word Clock Core - JSON reader
+ */
+
+#include "json_reader.h"
+#include <string.h>
+
+static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool JsonReader::fail(const char* why) {
+    failure = why;
+    failedAt = in - start;
+    return false;
+}
+
+const char* JsonReader::reject(const char* why) {
+    fail(why);
+    return nullptr;
+}
+
+void JsonReader::skipSpace() {
+    while (in < end && (*in == ' ' || *in == '\t' || *in == '\n' || *in == '\r')) in++;
+}
+
+bool JsonReader::store(char c) {
+    if (textUsed >= sizeof(text)) return fail("Document too large");
+    text[textUsed++] = c;
+    return true;
+}
+
+bool JsonReader::storeUtf8(uint32_t codepoint) {
+    if (codepoint < 0x80) return store(codepoint);
+    if (codepoint < 0x800) {
+        return store(0xC0 | codepoint >> 6) && store(0x80 | (codepoint & 0x3F));
+    }
+    if (codepoint < 0x10000) {
+        return store(0xE0 | codepoint >> 12) && store(0x80 | (codepoint >> 6 & 0x3F)) &&
+               store(0x80 | (codepoint & 0x3F));
+    }
+    return store(0xF0 | codepoint >> 18) && store(0x80 | (codepoint >> 12 & 0x3F)) &&
+           store(0x80 | (codepoint >> 6 & 0x3F)) && store(0x80 | (codepoint & 0x3F));
+}
+
+const char* JsonReader::readString() {
+    const char* out = text + textUsed;
+    in++;  // Opening quote
+    while (in < end && *in != '"') {
+        char c = *in;
+        if ((unsigned char)c < 0x20) return reject("Control character in string");
+        if (c != '\\') {
+            if (!store(c)) return nullptr;
+            in++;
+            continue;
+        }
+        if (++in >= end) break;
+        static const char ESCAPES[] = "\"\"\\\\//b\bf\fn\nr\rt\t";
+        const char* escape = *in && *in != 'u' ? strchr(ESCAPES, *in) : nullptr;
+        if (escape && (escape - ESCAPES) % 2 == 0) {
+            if (!store(escape[1])) return nullptr;
+            in++;
+            continue;
+        }
+        if (*in != 'u') return reject("Invalid escape");
+
+        uint32_t codepoint = 0;
+        for (int units = 0; units < 2; units++) {
+            if (end - in < 5) return reject("Invalid escape");
+            uint32_t unit = 0;
+            for (int i = 1; i <= 4; i++) {
+                int digit = hexValue(in[i]);
+                if (digit < 0) return reject("Invalid escape");
+                unit = unit << 4 | digit;
+            }
+            in += 5;
+            if (units == 0 && unit >= 0xD800 && unit < 0xDC00) {
+                // High surrogate: its pair must follow as another escape
+                codepoint = unit;
+                if (end - in < 2 || in[0] != '\\' || in[1] != 'u') return reject("Unpaired surrogate");
+                in++;
+                continue;
+            }
+            if (units == 1) {
+                if (unit < 0xDC00 || unit >= 0xE000) return reject("Unpaired surrogate");
+                codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (unit - 0xDC00);
+            } else {
+                if (unit >= 0xDC00 && unit < 0xE000) return reject("Unpaired surrogate");
+                codepoint = unit;
+            }
+            break;
+        }
+        if (codepoint == 0) return reject("NUL in string");
+        if (!storeUtf8(codepoint)) return nullptr;
+    }
+    if (in >= end) return reject("Unterminated string");
+    in++;  // Closing quote
+    return store('\0') ? out : nullptr;
+}
+
+const char* JsonReader::readNumber() {
+    const char* first = in;
+    if (in < end && *in == '-') in++;
+    if (in < end && *in == '0') {
+        in++;
+    } else if (in < end && isDigit(*in)) {
+        while (in < end && isDigit(*in)) in++;
+    } else {
+        return reject("Invalid number");
+    }
+    if (in < end && *in == '.') {
+        if (++in >= end || !isDigit(*in)) return reject("Invalid number");
+        while (in < end && isDigit(*in)) in++;
+    }
+    if (in < end && (*in == 'e' || *in == 'E')) {
+        in++;
+        if (in < end && (*in == '+' || *in == '-')) in++;
+        if (in >= end || !isDigit(*in)) return reject("Invalid number");
+        while (in < end && isDigit(*in)) in++;
+    }
+    const char* out = text + textUsed;
+    for (const char* p = first; p < in; p++) {
+        if (!store(*p)) return nullptr;
+    }
+    return store('\0') ? out : nullptr;
+}
+
+const char* JsonReader::readLiteral(const char* word) {
+    size_t length = strlen(word);
+    if ((size_t)(end - in) < length || memcmp(in, word, length) != 0) return reject("Invalid value");
+    in += length;
+    return word;
+}
+
+bool JsonReader::parse(const char* json, size_t length) {
+    start = in = json;
+    end = json + length;
+    textUsed = 0;
+    used = 0;
+    failure = nullptr;
+    failedAt = 0;
+
+    skipSpace();
+    if (in >= end || *in != '{') return fail("Expected an object");
+    in++;
+    skipSpace();
+    if (in < end && *in == '}') {
+        in++;
+    } else {
+        for (;;) {
+            skipSpace();
+            if (in >= end || *in != '"') return fail("Expected a member name");
+            const char* key = readString();
+            if (!key) return false;
+            for (int i = 0; i < used; i++) {
+                if (strcmp(members[i].key, key) == 0) return fail("Duplicate member");
+            }
+            skipSpace();
+            if (in >= end || *in != ':') return fail("Expected ':'");
+            in++;
+            skipSpace();
+            if (in >= end) return fail("Expected a value");
+
+            JsonMember member = {key, nullptr, JSON_STRING};
+            switch (*in) {
+                case '"': member.value = readString(); break;
+                case 't': member.value = readLiteral("true"); member.type = JSON_BOOL; break;
+                case 'f': member.value = readLiteral("false"); member.type = JSON_BOOL; break;
+                case 'n': readLiteral("null"); member.value = ""; member.type = JSON_NULL; break;
+                case '{':
+                case '[': return fail("Nested values are not supported");
+                default: member.value = readNumber(); member.type = JSON_NUMBER; break;
+            }
+            if (failure) return false;
+            if (used == JSON_READER_MAX_MEMBERS) return fail("Too many members");
+            members[used++] = member;
+
+            skipSpace();
+            if (in < end && *in == ',') {
+                in++;
+                continue;
+            }
+            if (in < end && *in == '}') {
+                in++;
+                break;
+            }
+            return fail("Expected ',' or '}'");
+        }
+    }
+    skipSpace();
+    if (in != end) return fail("Trailing characters after the object");
+    return true;
+}
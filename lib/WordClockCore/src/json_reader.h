@@ -0,0 +1,71 @@
+/**
+ * Word Clock Core - JSON reader
+ *
+ * Parses one flat JSON object - string, number, true, false and null
+ * members, no nested objects or arrays - into fixed storage, without
+ * allocating. Strings are unescaped (\uXXXX becomes UTF-8); numbers are
+ * checked against the JSON grammar and kept as text. A document with more
+ * than JSON_READER_MAX_MEMBERS members, more than JSON_READER_TEXT_MAX
+ * bytes of keys and values, or a duplicate key is rejected whole.
+ */
+
+#ifndef WORD_CLOCK_JSON_READER_H
+#define WORD_CLOCK_JSON_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define JSON_READER_MAX_MEMBERS 16
+#define JSON_READER_TEXT_MAX 512
+
+enum JsonValueType : uint8_t {
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_BOOL,  // value is "true" or "false"
+    JSON_NULL,  // value is ""
+};
+
+struct JsonMember {
+    const char* key;
+    const char* value;
+    JsonValueType type;
+};
+
+class JsonReader {
+public:
+    /**
+     * Parses a document; members point into the reader, so they stay valid
+     * until the next parse()
+     * @return false if it is not one flat object that fits
+     */
+    bool parse(const char* json, size_t length);
+
+    int count() const { return used; }
+    const JsonMember& member(int i) const { return members[i]; }
+
+    // Why the last parse() failed, and where
+    const char* error() const { return failure; }
+    size_t errorOffset() const { return failedAt; }
+
+private:
+    bool fail(const char* why);
+    const char* reject(const char* why);  // fail() for the value readers
+    void skipSpace();
+    const char* readString();
+    const char* readNumber();
+    const char* readLiteral(const char* word);
+    bool store(char c);
+    bool storeUtf8(uint32_t codepoint);
+
+    const char* in = nullptr;
+    const char* start = nullptr;
+    const char* end = nullptr;
+    JsonMember members[JSON_READER_MAX_MEMBERS];
+    char text[JSON_READER_TEXT_MAX];
+    size_t textUsed = 0;
+    int used = 0;
+    const char* failure = nullptr;
+    size_t failedAt = 0;
+};
+
+#endif // WORD_CLOCK_JSON_READER_H
@@ -0,0 +1,124 @@
+/**
+ * Word Clock Core - JSON writer
+ */
+
+#include "json_writer.h"
+#include <stdio.h>
+
+JsonWriter::JsonWriter(char* buffer, size_t size) : buffer(buffer), size(size) {
+    if (size > 0) buffer[0] = '\0';
+    else overflow = true;
+}
+
+void JsonWriter::put(char c) {
+    if (used + 1 >= size) {
+        overflow = true;
+        return;
+    }
+    buffer[used++] = c;
+    buffer[used] = '\0';
+}
+
+void JsonWriter::put(const char* s) {
+    while (*s) put(*s++);
+}
+
+void JsonWriter::putUnsigned(uint64_t v) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    while (n) put(digits[--n]);
+}
+
+void JsonWriter::separate() {
+    if (needComma) put(',');
+    needComma = true;
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separate();
+    put('{');
+    needComma = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    put('}');
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separate();
+    put('[');
+    needComma = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    put(']');
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* name) {
+    value(name);
+    put(':');
+    needComma = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::signedValue(int64_t v) {
+    separate();
+    if (v < 0) {
+        put('-');
+        putUnsigned(0 - (uint64_t)v);
+    } else {
+        putUnsigned(v);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::unsignedValue(uint64_t v) {
+    separate();
+    putUnsigned(v);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double v) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.3f", v);
+    separate();
+    put(text);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v) {
+    separate();
+    put(v ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* s) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    separate();
+    put('"');
+    for (; *s; s++) {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\') {
+            put('\\');
+            put(c);
+        } else if (c < 0x20) {
+            put("\\u00");
+            put(HEX_DIGITS[c >> 4]);
+            put(HEX_DIGITS[c & 0xF]);
+        } else {
+            put(c);
+        }
+    }
+    put('"');
+    return *this;
+}
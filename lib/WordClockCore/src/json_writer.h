@@ -0,0 +1,61 @@
+/**
+ * Word Clock Core - JSON writer
+ *
+ * Appends JSON to a caller-supplied buffer without allocating. Commas
+ * between members are inserted automatically. If the buffer runs out the
+ * writer stops writing and ok() turns false; the output is then truncated
+ * and must not be sent.
+ */
+
+#ifndef WORD_CLOCK_JSON_WRITER_H
+#define WORD_CLOCK_JSON_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t size);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    // Member name inside an object; follow with a value or begin*()
+    JsonWriter& key(const char* name);
+
+    JsonWriter& value(int v) { return signedValue(v); }
+    JsonWriter& value(long v) { return signedValue(v); }
+    JsonWriter& value(long long v) { return signedValue(v); }
+    JsonWriter& value(unsigned v) { return unsignedValue(v); }
+    JsonWriter& value(unsigned long v) { return unsignedValue(v); }
+    JsonWriter& value(unsigned long long v) { return unsignedValue(v); }
+    JsonWriter& value(double v);  // Three decimal places
+    JsonWriter& value(bool v);
+    JsonWriter& value(const char* s);  // Escaped as a JSON string
+
+    // Shorthand for key(name).value(v)
+    template <typename T>
+    JsonWriter& member(const char* name, T v) { return key(name).value(v); }
+
+    bool ok() const { return !overflow; }
+    size_t length() const { return used; }
+    const char* c_str() const { return buffer; }
+
+private:
+    JsonWriter& signedValue(int64_t v);
+    JsonWriter& unsignedValue(uint64_t v);
+    void separate();
+    void put(char c);
+    void put(const char* s);
+    void putUnsigned(uint64_t v);
+
+    char* buffer;
+    size_t size;
+    size_t used = 0;
+    bool overflow = false;
+    bool needComma = false;
+};
+
+#endif // WORD_CLOCK_JSON_WRITER_H
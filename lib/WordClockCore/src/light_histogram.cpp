@@ -0,0 +1,137 @@
+/**
+ * Word Clock Core - Light histogram
+ */
+
+#include "light_histogram.h"
+#include "json_writer.h"
+#include <string.h>
+
+void LightHistogram::record(int hour, int lightLevel) {
+    if (hour < 0 || hour >= LIGHT_HIST_HOURS) return;
+    int bin = (lightLevel < 0 ? 0 : lightLevel > LIGHT_LEVEL_MAX ? LIGHT_LEVEL_MAX : lightLevel) / LIGHT_HIST_BIN_WIDTH;
+    bins[hour][bin]++;
+
+    // Halving keeps the shape of the row while older samples fade out
+    if (hourTotal(hour) >= LIGHT_HIST_AGE_AT) {
+        for (int b = 0; b < LIGHT_HIST_BINS; b++) bins[hour][b] /= 2;
+    }
+}
+
+void LightHistogram::clear() {
+    memset(bins, 0, sizeof(bins));
+}
+
+uint32_t LightHistogram::hourTotal(int hour) const {
+    uint32_t sum = 0;
+    for (int b = 0; b < LIGHT_HIST_BINS; b++) sum += bins[hour][b];
+    return sum;
+}
+
+uint32_t LightHistogram::total() const {
+    uint32_t sum = 0;
+    for (int h = 0; h < LIGHT_HIST_HOURS; h++) sum += hourTotal(h);
+    return sum;
+}
+
+bool LightHistogram::load(const void* bytes, size_t size) {
+    if (size != sizeof(bins)) return false;
+    memcpy(bins, bytes, size);
+    return true;
+}
+
+LightSuggestion LightHistogram::suggest() const {
+    LightSuggestion result;
+    uint32_t counts[LIGHT_HIST_BINS] = {};
+    for (int h = 0; h < LIGHT_HIST_HOURS; h++) {
+        for (int b = 0; b < LIGHT_HIST_BINS; b++) counts[b] += bins[h][b];
+    }
+    double n = 0, sum = 0, sumSquares = 0;
+    for (int b = 0; b < LIGHT_HIST_BINS; b++) {
+        n += counts[b];
+        sum += (double)b * counts[b];
+        sumSquares += (double)b * b * counts[b];
+    }
+    if (n < LIGHT_HIST_MIN_SAMPLES) return result;
+
+    // Otsu: dark class is bins 0..split, light class split+1..
+    int split = -1, splitEnd = -1;
+    double best = 0, darkN = 0, darkSum = 0;
+    for (int b = 0; b < LIGHT_HIST_BINS - 1; b++) {
+        darkN += counts[b];
+        darkSum += (double)b * counts[b];
+        double lightN = n - darkN;
+        if (darkN == 0 || lightN == 0) continue;
+        double meanDiff = darkSum / darkN - (sum - darkSum) / lightN;
+        double between = darkN * lightN * meanDiff * meanDiff;
+        if (between > best) {
+            best = between;
+            split = splitEnd = b;
+        } else if (between == best) {
+            splitEnd = b;  // Empty bins between the classes score the same
+        }
+    }
+    split = (split + splitEnd) / 2;
+    double variance = n * sumSquares - sum * sum;
+    if (split < 0 || variance <= 0) return result;
+
+    // 90th percentile of the dark class and 10th of the light one, at bin edges
+    uint32_t darkTotal = 0, lightTotal = 0;
+    for (int b = 0; b <= split; b++) darkTotal += counts[b];
+    for (int b = split + 1; b < LIGHT_HIST_BINS; b++) lightTotal += counts[b];
+    int darkTop = 0, lightBottom = split + 1;
+    for (uint32_t seen = 0; darkTop < split; darkTop++) {
+        seen += counts[darkTop];
+        if (seen * 10 >= darkTotal * 9) break;
+    }
+    for (uint32_t seen = 0; lightBottom < LIGHT_HIST_BINS - 1; lightBottom++) {
+        seen += counts[lightBottom];
+        if (seen * 10 >= lightTotal) break;
+    }
+
+    result.valid = true;
+    result.threshold = (split + 1) * LIGHT_HIST_BIN_WIDTH;
+    result.darkLevel = (darkTop + 1) * LIGHT_HIST_BIN_WIDTH - 1;
+    result.lightLevel = lightBottom * LIGHT_HIST_BIN_WIDTH;
+    // best / n^2 is the between-class variance and variance / n^2 the total
+    result.separation = best / variance;
+
+    for (int h = 0; h < LIGHT_HIST_HOURS; h++) {
+        uint32_t dark = 0;
+        for (int b = 0; b <= split; b++) dark += bins[h][b];
+        if (dark * 2 > hourTotal(h)) result.darkHours |= 1UL << h;
+    }
+    return result;
+}
+
+CurveSettings curveFromSuggestion(const LightSuggestion& suggestion, const BrightnessSettings& settings) {
+    CurveSettings curve = curveFromSettings(settings);
+    curve.points[1].level = (uint16_t)suggestion.darkLevel;
+    curve.points[2].level = (uint16_t)suggestion.lightLevel;
+    return curve;
+}
+
+size_t formatLightSuggestionJson(char* buffer, size_t size, const LightSuggestion& suggestion) {
+    JsonWriter json(buffer, size);
+    json.beginObject().member("valid", suggestion.valid);
+    if (suggestion.valid) {
+        json.member("threshold", suggestion.threshold)
+            .member("darkLevel", suggestion.darkLevel)
+            .member("lightLevel", suggestion.lightLevel)
+            .member("separation", suggestion.separation)
+            .key("darkHours").beginArray();
+        for (int h = 0; h < LIGHT_HIST_HOURS; h++) {
+            if (suggestion.darkHours & (1UL << h)) json.value(h);
+        }
+        json.endArray();
+    }
+    json.endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+size_t formatLightHistogramRow(char* buffer, size_t size, const LightHistogram& histogram, int hour) {
+    JsonWriter json(buffer, size);
+    json.beginArray();
+    for (int b = 0; b < LIGHT_HIST_BINS; b++) json.value(histogram.count(hour, b));
+    json.endArray();
+    return json.ok() ? json.length() : 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * Word Clock Core - Light histogram
+ *
+ * Learns what "dark" and "light" mean for the room the clock is in. Light
+ * levels are counted into LIGHT_HIST_BINS bins for each hour of the day;
+ * when an hour's row reaches LIGHT_HIST_AGE_AT samples it is halved, so
+ * the table stays 1.5 KB and follows the last few weeks rather than
+ * everything since it was installed.
+ *
+ * suggest() splits the distribution of all hours into a dark and a light
+ * class with Otsu's method (the split that maximises the between-class
+ * variance) and proposes curve breakpoints at the edges of the two
+ * classes.
+ *
+ * Storing the table is platform code (src/light_calibration.cpp); the
+ * raw bytes are exposed for it.
+ */
+
+#ifndef WORD_CLOCK_LIGHT_HISTOGRAM_H
+#define WORD_CLOCK_LIGHT_HISTOGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "brightness.h"
+
+#define LIGHT_HIST_HOURS 24
+#define LIGHT_HIST_BINS 32
+#define LIGHT_HIST_BIN_WIDTH ((LIGHT_LEVEL_MAX + 1) / LIGHT_HIST_BINS)  // 128 ADC counts
+
+#ifndef LIGHT_HIST_AGE_AT
+#define LIGHT_HIST_AGE_AT 2048  // Samples per hour before halving: ~5 weeks at one a minute
+#endif
+
+#ifndef LIGHT_HIST_MIN_SAMPLES
+#define LIGHT_HIST_MIN_SAMPLES 1440  // A day at one a minute before suggesting anything
+#endif
+
+struct LightSuggestion {
+    bool valid = false;    // Enough samples, and both classes populated
+    int threshold = 0;     // Otsu split between dark and light
+    int darkLevel = 0;     // Top of the dark class (90th percentile)
+    int lightLevel = 0;    // Bottom of the light class (10th percentile)
+    double separation = 0; // Between-class / total variance, 0-1; low means one class
+    uint32_t darkHours = 0;  // Bit N set when hour N is mostly below the threshold
+};
+
+class LightHistogram {
+public:
+    /**
+     * Counts a light level against an hour of the day
+     * @param hour Local hour, 0-23
+     */
+    void record(int hour, int lightLevel);
+    void clear();
+
+    uint16_t count(int hour, int bin) const { return bins[hour][bin]; }
+    uint32_t hourTotal(int hour) const;
+    uint32_t total() const;
+
+    LightSuggestion suggest() const;
+
+    // The table as bytes, for persisting it
+    const void* data() const { return bins; }
+    static constexpr size_t dataSize() { return sizeof(bins); }
+    bool load(const void* bytes, size_t size);
+
+private:
+    uint16_t bins[LIGHT_HIST_HOURS][LIGHT_HIST_BINS] = {};
+};
+
+/**
+ * Curve for a suggestion: the settings' dark brightness up to darkLevel,
+ * rising to their light brightness at lightLevel
+ */
+CurveSettings curveFromSuggestion(const LightSuggestion& suggestion, const BrightnessSettings& settings);
+
+/**
+ * Writes a suggestion as a JSON object
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatLightSuggestionJson(char* buffer, size_t size, const LightSuggestion& suggestion);
+
+/**
+ * Writes one hour's bin counts as a JSON array
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatLightHistogramRow(char* buffer, size_t size, const LightHistogram& histogram, int hour);
+
+#endif // WORD_CLOCK_LIGHT_HISTOGRAM_H
@@ -0,0 +1,81 @@
+/**
+ * Word Clock Core - Light history
+ */
+
+#include "light_history.h"
+#include "brightness.h"
+#include <stdio.h>
+
+void LightHistoryTier::add(uint32_t seconds, int level, uint8_t brightness) {
+    uint16_t clamped = level < 0 ? 0 : level > LIGHT_LEVEL_MAX ? LIGHT_LEVEL_MAX : level;
+    uint32_t index = seconds / periodSeconds;
+    if (samples && index != current) flush();
+    if (!samples) {
+        current = index;
+        minLevel = maxLevel = clamped;
+    }
+    levelSum += clamped;
+    brightnessSum += brightness;
+    samples++;
+    if (clamped < minLevel) minLevel = clamped;
+    if (clamped > maxLevel) maxLevel = clamped;
+}
+
+void LightHistoryTier::flush() {
+    // Periods without readings in between become gaps (a ring's worth at most)
+    if (used && current > newest + 1) {
+        uint32_t missing = current - newest - 1;
+        if (missing > capacity) missing = capacity;
+        for (uint32_t i = 0; i < missing; i++) push({LIGHT_HISTORY_GAP, 0, 0});
+    }
+    int spread = (maxLevel - minLevel) / 16;
+    push({(uint16_t)(levelSum / samples), (uint8_t)(brightnessSum / samples), (uint8_t)(spread > 255 ? 255 : spread)});
+    newest = current;
+    levelSum = brightnessSum = 0;
+    samples = 0;
+}
+
+void LightHistoryTier::push(const LightHistoryEntry& entry) {
+    entries[next] = entry;
+    next = (next + 1) % capacity;
+    if (used < capacity) used++;
+}
+
+const LightHistoryEntry& LightHistoryTier::at(int i) const {
+    int oldest = used < capacity ? 0 : next;
+    return entries[(oldest + i) % capacity];
+}
+
+int LightHistoryTier::runFrom(int i) const {
+    int oldest = used < capacity ? 0 : next;
+    int position = (oldest + i) % capacity;
+    int run = capacity - position;
+    return used - i < run ? used - i : run;
+}
+
+void LightHistoryTier::fillHeader(LightHistoryTierHeader& header) const {
+    header.periodSeconds = periodSeconds;
+    header.newestSeconds = newestSeconds();
+    header.capacity = capacity;
+    header.count = used;
+}
+
+void LightHistory::record(uint32_t seconds, int level, uint8_t brightness) {
+    for (LightHistoryTier& t : tiers) t.add(seconds, level, brightness);
+}
+
+size_t formatLightHistoryCsvLine(char* buffer, size_t size, const LightHistoryTier& tier, int index) {
+    int n;
+    if (index < 0) {
+        n = snprintf(buffer, size, "period_start_s,level,brightness,spread\n");
+    } else {
+        const LightHistoryEntry& e = tier.at(index);
+        unsigned long start = tier.newestSeconds() - (unsigned long)(tier.count() - 1 - index) * tier.period();
+        if (e.level == LIGHT_HISTORY_GAP) {
+            n = snprintf(buffer, size, "%lu,,,\n", start);
+        } else {
+            n = snprintf(buffer, size, "%lu,%u,%u,%u\n", start, e.level, e.brightness, e.spread * 16);
+        }
+    }
+    return n > 0 && (size_t)n < size ? n : 0;
+}
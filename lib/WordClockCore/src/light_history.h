@@ -0,0 +1,137 @@
+/**
+ * Word Clock Core - Light history
+ *
+ * Recent light levels and the brightness applied for them, kept at three
+ * resolutions in fixed rings:
+ * - every second for the last 10 minutes
+ * - every minute for the last day
+ * - every 15 minutes for the last week
+ *
+ * Each tier averages the raw readings that fall in its period and keeps
+ * their spread (max - min), so a flickering sensor still shows up once
+ * the detail has been averaged away. Periods with no readings are stored
+ * as gaps. All storage is static: LIGHT_HISTORY_BYTES in total.
+ *
+ * The rings are served by /api/light/history as a LightHistoryHeader
+ * followed, for each tier, by a LightHistoryTierHeader and its entries
+ * oldest first.
+ */
+
+#ifndef WORD_CLOCK_LIGHT_HISTORY_H
+#define WORD_CLOCK_LIGHT_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LIGHT_HISTORY_MAGIC 0x484C4357  // "WCLH" little-endian
+#define LIGHT_HISTORY_FORMAT_VERSION 1
+
+#define LIGHT_HISTORY_TIERS 3
+#define LIGHT_HISTORY_GAP 0xFFFF  // Level of a period with no readings
+
+// Period and length of each tier
+#define LIGHT_HISTORY_SECONDS_PERIOD 1
+#define LIGHT_HISTORY_SECONDS_LENGTH 600   // 10 minutes
+#define LIGHT_HISTORY_MINUTES_PERIOD 60
+#define LIGHT_HISTORY_MINUTES_LENGTH 1440  // 1 day
+#define LIGHT_HISTORY_QUARTERS_PERIOD 900
+#define LIGHT_HISTORY_QUARTERS_LENGTH 672  // 7 days
+
+struct LightHistoryEntry {
+    uint16_t level;      // Mean light level, or LIGHT_HISTORY_GAP
+    uint8_t brightness;  // Mean brightness applied
+    uint8_t spread;      // Light level max - min, in units of 16 ADC counts
+};
+
+struct LightHistoryHeader {
+    uint32_t magic;          // LIGHT_HISTORY_MAGIC
+    uint16_t version;        // LIGHT_HISTORY_FORMAT_VERSION
+    uint16_t entrySize;      // sizeof(LightHistoryEntry)
+    uint32_t nowSeconds;     // Uptime when the dump was taken
+    uint32_t tierCount;      // Tiers that follow
+};
+
+struct LightHistoryTierHeader {
+    uint32_t periodSeconds;
+    uint32_t newestSeconds;  // Uptime at the start of the newest entry's period
+    uint16_t capacity;
+    uint16_t count;          // Entries that follow
+};
+
+static_assert(sizeof(LightHistoryEntry) == 4, "LightHistoryEntry must stay 4 bytes");
+static_assert(sizeof(LightHistoryHeader) == 16, "LightHistoryHeader layout changed");
+static_assert(sizeof(LightHistoryTierHeader) == 12, "LightHistoryTierHeader layout changed");
+
+#define LIGHT_HISTORY_BYTES (sizeof(LightHistoryEntry) * \
+    (LIGHT_HISTORY_SECONDS_LENGTH + LIGHT_HISTORY_MINUTES_LENGTH + LIGHT_HISTORY_QUARTERS_LENGTH))
+
+class LightHistoryTier {
+public:
+    LightHistoryTier(LightHistoryEntry* storage, uint16_t length, uint32_t period)
+        : entries(storage), capacity(length), periodSeconds(period) {}
+
+    // Adds a raw reading; the period it falls in is stored once it is over
+    void add(uint32_t seconds, int level, uint8_t brightness);
+
+    uint32_t period() const { return periodSeconds; }
+    uint16_t length() const { return capacity; }
+    uint16_t count() const { return used; }
+    const LightHistoryEntry& at(int i) const;  // Oldest first
+    int runFrom(int i) const;  // Entries from at(i) on that are contiguous in memory
+    uint32_t newestSeconds() const { return newest * periodSeconds; }
+
+    void fillHeader(LightHistoryTierHeader& header) const;
+
+private:
+    void push(const LightHistoryEntry& entry);
+    void flush();
+
+    LightHistoryEntry* entries;
+    uint16_t capacity;
+    uint32_t periodSeconds;
+    uint16_t used = 0;
+    uint16_t next = 0;
+    uint32_t newest = 0;  // Period index of the newest entry
+
+    // Readings of the period in progress
+    uint32_t current = 0;
+    uint32_t levelSum = 0;
+    uint32_t brightnessSum = 0;
+    uint16_t samples = 0;
+    uint16_t minLevel = 0;
+    uint16_t maxLevel = 0;
+};
+
+class LightHistory {
+public:
+    LightHistory() = default;
+    LightHistory(const LightHistory&) = delete;  // The tiers point into this object
+    LightHistory& operator=(const LightHistory&) = delete;
+
+    /**
+     * Records a reading in every tier
+     * @param seconds Monotonic seconds (uptime); must not go backwards
+     */
+    void record(uint32_t seconds, int level, uint8_t brightness);
+
+    const LightHistoryTier& tier(int i) const { return tiers[i]; }
+
+private:
+    LightHistoryEntry secondsRing[LIGHT_HISTORY_SECONDS_LENGTH];
+    LightHistoryEntry minutesRing[LIGHT_HISTORY_MINUTES_LENGTH];
+    LightHistoryEntry quartersRing[LIGHT_HISTORY_QUARTERS_LENGTH];
+    LightHistoryTier tiers[LIGHT_HISTORY_TIERS] = {
+        {secondsRing, LIGHT_HISTORY_SECONDS_LENGTH, LIGHT_HISTORY_SECONDS_PERIOD},
+        {minutesRing, LIGHT_HISTORY_MINUTES_LENGTH, LIGHT_HISTORY_MINUTES_PERIOD},
+        {quartersRing, LIGHT_HISTORY_QUARTERS_LENGTH, LIGHT_HISTORY_QUARTERS_PERIOD},
+    };
+};
+
+/**
+ * Writes one CSV line for a tier entry ("period_start_s,level,brightness,spread";
+ * header when index is -1, empty fields for a gap)
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatLightHistoryCsvLine(char* buffer, size_t size, const LightHistoryTier& tier, int index);
+
+#endif // WORD_CLOCK_LIGHT_HISTORY_H
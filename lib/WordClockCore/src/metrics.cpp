@@ -0,0 +1,85 @@
+/**
+ * Word Clock Core - Metrics registry
+ */
+
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+const MetricInfo METRICS[METRIC_COUNT] = {
+#define METRIC_INFO(id, type, name, help) {name, type, help},
+    CLOCK_METRICS(METRIC_INFO)
+#undef METRIC_INFO
+};
+
+std::atomic<uint32_t> metricValues[METRIC_COUNT];
+
+const uint16_t METRIC_HTTP_CODE_LIST[METRIC_HTTP_CODES] = {200, 400, 404, 409, 413, 429, 500, 501, 0};
+
+static std::atomic<uint32_t> httpResponses[METRIC_HTTP_ROUTES][METRIC_HTTP_CODES];
+
+#define HTTP_METRIC "wordclock_http_responses_total"
+#define HTTP_HEADER_ITEM METRIC_COUNT                   // HELP and TYPE of the HTTP counter
+#define HTTP_FIRST_ITEM (METRIC_COUNT + 1)              // Then one item per route and code
+#define ITEM_COUNT (HTTP_FIRST_ITEM + METRIC_HTTP_ROUTES * METRIC_HTTP_CODES)
+#define ITEM_MAX 256                                    // Longest item, with its help text
+
+static int codeIndex(int code) {
+    for (int i = 0; i < METRIC_HTTP_CODES - 1; i++) {
+        if (METRIC_HTTP_CODE_LIST[i] == code) return i;
+    }
+    return METRIC_HTTP_CODES - 1;
+}
+
+void metricHttpResponse(uint8_t route, int code) {
+    if (route >= METRIC_HTTP_ROUTES) route = 0;
+    httpResponses[route][codeIndex(code)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t metricHttpCount(uint8_t route, int codeIndex) {
+    return httpResponses[route][codeIndex].load(std::memory_order_relaxed);
+}
+
+size_t MetricsText::formatItem(char* buffer, size_t size, int item) const {
+    int n;
+    if (item < 0) {
+        n = snprintf(buffer, size, "# HELP wordclock_build_info Firmware version.\n"
+                     "# TYPE wordclock_build_info gauge\n"
+                     "wordclock_build_info{version=\"%s\"} 1\n", version);
+    } else if (item < METRIC_COUNT) {
+        const MetricInfo& m = METRICS[item];
+        n = snprintf(buffer, size, "# HELP %s %s\n# TYPE %s %s\n%s %lu\n", m.name, m.help, m.name,
+                     m.type == METRIC_COUNTER ? "counter" : "gauge", m.name,
+                     (unsigned long)metricValue((MetricId)item));
+    } else if (item == HTTP_HEADER_ITEM) {
+        n = snprintf(buffer, size, "# HELP " HTTP_METRIC " HTTP responses by route and status code.\n"
+                     "# TYPE " HTTP_METRIC " counter\n");
+    } else {
+        int route = (item - HTTP_FIRST_ITEM) / METRIC_HTTP_CODES;
+        int code = (item - HTTP_FIRST_ITEM) % METRIC_HTTP_CODES;
+        uint32_t count = metricHttpCount(route, code);
+        if (count == 0) return 0;
+        char codeText[8] = "other";
+        if (METRIC_HTTP_CODE_LIST[code]) snprintf(codeText, sizeof(codeText), "%u", METRIC_HTTP_CODE_LIST[code]);
+        const char* name = route < routeCount && routeNames[route] ? routeNames[route] : "other";
+        n = snprintf(buffer, size, HTTP_METRIC "{route=\"%s\",code=\"%s\"} %lu\n", name, codeText,
+                     (unsigned long)count);
+    }
+    return n > 0 && (size_t)n < size ? n : 0;
+}
+
+size_t MetricsText::next(char* buffer, size_t size) {
+    size_t used = 0;
+    char text[ITEM_MAX];
+    for (; item < ITEM_COUNT; item++) {
+        size_t length = formatItem(text, sizeof(text), item);
+        if (length + 1 > size - used) {
+            if (used) break;  // Starts the next chunk
+            continue;         // Can never fit: skip it rather than stall
+        }
+        memcpy(buffer + used, text, length);
+        used += length;
+    }
+    if (used < size) buffer[used] = '\0';
+    return used;
+}
@@ -0,0 +1,106 @@
+/**
+ * Word Clock Core - Metrics registry
+ *
+ * Operational counters and gauges for every subsystem, in static storage.
+ * Each metric is described once, in CLOCK_METRICS below; updating one is
+ * a single relaxed atomic add or store, cheap enough for the render path
+ * and safe from any task. HTTP responses are counted per route and status
+ * code in a fixed table.
+ *
+ * MetricsText renders the registry in the Prometheus text format a chunk
+ * at a time into a caller's buffer, so /metrics never needs the whole
+ * document in RAM.
+ */
+
+#ifndef WORD_CLOCK_METRICS_H
+#define WORD_CLOCK_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+enum MetricType : uint8_t {
+    METRIC_COUNTER,  // Only goes up (wraps at 2^32, which Prometheus reads as a reset)
+    METRIC_GAUGE,    // Set to the current value
+};
+
+// X(id, type, name, help)
+#define CLOCK_METRICS(X) \
+    X(UPTIME,             METRIC_GAUGE,   "wordclock_uptime_seconds", "Seconds since boot.") \
+    X(LED_SHOWS,          METRIC_COUNTER, "wordclock_led_shows_total", "LED buffer transfers to the matrix.") \
+    X(FRAMES,             METRIC_COUNTER, "wordclock_frames_rendered_total", "Transition and dither frames drawn.") \
+    X(PHRASES,            METRIC_COUNTER, "wordclock_phrase_changes_total", "Times the face moved to a new phrase.") \
+    X(ADC_SAMPLES,        METRIC_COUNTER, "wordclock_adc_samples_total", "Light sensor ADC samples taken.") \
+    X(BRIGHTNESS_CHANGES, METRIC_COUNTER, "wordclock_brightness_changes_total", "Changes of the brightness being shown.") \
+    X(NTP_SYNCS,          METRIC_COUNTER, "wordclock_ntp_syncs_total", "Successful NTP time syncs.") \
+    X(NTP_FAILURES,       METRIC_COUNTER, "wordclock_ntp_sync_failures_total", "NTP syncs that failed or went overdue.") \
+    X(WIFI_RECONNECTS,    METRIC_COUNTER, "wordclock_wifi_reconnects_total", "WiFi connections regained after a drop.") \
+    X(OTA_ATTEMPTS,       METRIC_COUNTER, "wordclock_ota_attempts_total", "OTA updates started.") \
+    X(OTA_FAILURES,       METRIC_COUNTER, "wordclock_ota_failures_total", "OTA updates that failed.") \
+    X(OTA_ROLLBACKS,      METRIC_COUNTER, "wordclock_ota_rollbacks_total", "Updated images rolled back after boot.") \
+    X(OTA_BYTES,          METRIC_COUNTER, "wordclock_ota_download_bytes_total", "Bytes downloaded for pull updates.") \
+    X(NVS_WRITES,         METRIC_COUNTER, "wordclock_nvs_writes_total", "Settings written to flash.") \
+    X(RATE_LIMITED,       METRIC_COUNTER, "wordclock_http_rate_limited_total", "Requests refused with 429.") \
+    X(LIGHT_LEVEL,        METRIC_GAUGE,   "wordclock_light_level", "Filtered light sensor reading (0-4095).") \
+    X(BRIGHTNESS,         METRIC_GAUGE,   "wordclock_brightness", "Brightness the face is heading for (0-255).") \
+    X(FREE_HEAP,          METRIC_GAUGE,   "wordclock_free_heap_bytes", "Free heap.") \
+    X(MIN_FREE_HEAP,      METRIC_GAUGE,   "wordclock_min_free_heap_bytes", "Lowest free heap since boot.")
+
+enum MetricId : uint8_t {
+#define METRIC_ID(id, type, name, help) METRIC_##id,
+    CLOCK_METRICS(METRIC_ID)
+#undef METRIC_ID
+    METRIC_COUNT
+};
+
+struct MetricInfo {
+    const char* name;
+    MetricType type;
+    const char* help;
+};
+
+extern const MetricInfo METRICS[METRIC_COUNT];
+extern std::atomic<uint32_t> metricValues[METRIC_COUNT];
+
+inline void metricAdd(MetricId id, uint32_t n = 1) { metricValues[id].fetch_add(n, std::memory_order_relaxed); }
+inline void metricSet(MetricId id, uint32_t value) { metricValues[id].store(value, std::memory_order_relaxed); }
+inline uint32_t metricValue(MetricId id) { return metricValues[id].load(std::memory_order_relaxed); }
+
+#define METRIC_HTTP_ROUTES 24  // Route numbers counted; higher ones count as route 0
+
+// Status codes counted separately; any other is counted as "other"
+#define METRIC_HTTP_CODES 9
+extern const uint16_t METRIC_HTTP_CODE_LIST[METRIC_HTTP_CODES];
+
+// Counts one response sent for a route
+void metricHttpResponse(uint8_t route, int code);
+
+uint32_t metricHttpCount(uint8_t route, int codeIndex);
+
+/**
+ * Renders the registry in the Prometheus text format (version 0.0.4),
+ * whole lines at a time, after a wordclock_build_info line carrying the
+ * firmware version. HTTP responses are labelled with the route names
+ * given, and only routes and codes that have been seen are listed.
+ */
+class MetricsText {
+public:
+    MetricsText(const char* version, const char* const* routeNames, int routeCount)
+        : version(version), routeNames(routeNames), routeCount(routeCount) {}
+
+    /**
+     * Writes the next chunk: as many whole lines as fit
+     * @return Length written; 0 once everything has been
+     */
+    size_t next(char* buffer, size_t size);
+
+private:
+    size_t formatItem(char* buffer, size_t size, int item) const;
+
+    const char* version;
+    const char* const* routeNames;
+    int routeCount;
+    int item = -1;  // The build info comes first
+};
+
+#endif // WORD_CLOCK_METRICS_H
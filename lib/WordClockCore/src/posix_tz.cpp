@@ -0,0 +1,176 @@
+/**
+ * Word Clock Core - POSIX timezone rules
+ */
+
+#include "posix_tz.h"
+
+int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    // Howard Hinnant's days_from_civil
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = (unsigned)(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+int yearOf(time_t t) {
+    int64_t days = (int64_t)t / 86400 - ((int64_t)t % 86400 < 0);
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = (unsigned)(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    return (int)(yoe + era * 400) + (mp >= 10);
+}
+
+static bool isLeap(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+static bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+static bool parseNumber(const char*& p, int& value, int maxDigits) {
+    if (!isDigit(*p)) return false;
+    value = 0;
+    for (int i = 0; i < maxDigits && isDigit(*p); i++) {
+        value = value * 10 + (*p++ - '0');
+    }
+    return true;
+}
+
+// Zone abbreviation: at least three letters, or anything in <angle brackets>
+static bool parseName(const char*& p) {
+    if (*p == '<') {
+        while (*p && *p != '>') p++;
+        if (*p != '>') return false;
+        p++;
+        return true;
+    }
+    const char* start = p;
+    while (isAlpha(*p)) p++;
+    return p - start >= 3;
+}
+
+// [+|-]hh[:mm[:ss]] in seconds
+static bool parseTime(const char*& p, int32_t& seconds) {
+    int sign = 1;
+    if (*p == '+' || *p == '-') {
+        sign = *p == '-' ? -1 : 1;
+        p++;
+    }
+    int hours, minutes = 0, secs = 0;
+    if (!parseNumber(p, hours, 3)) return false;
+    if (*p == ':') {
+        p++;
+        if (!parseNumber(p, minutes, 2)) return false;
+        if (*p == ':') {
+            p++;
+            if (!parseNumber(p, secs, 2)) return false;
+        }
+    }
+    seconds = sign * (hours * 3600 + minutes * 60 + secs);
+    return true;
+}
+
+bool PosixTimezone::parse(const char* rule) {
+    *this = PosixTimezone();
+    const char* p = rule;
+    int32_t offset;
+
+    // POSIX offsets count west of UTC, ours east
+    if (!parseName(p) || !parseTime(p, offset)) return false;
+    stdOffset = -offset;
+    dstOffset = stdOffset;
+    if (!*p) return true;
+
+    if (!parseName(p)) return false;
+    dst = true;
+    dstOffset = stdOffset + 3600;
+    if (*p && *p != ',') {
+        if (!parseTime(p, offset)) return false;
+        dstOffset = -offset;
+    }
+
+    // No rules given: use the US rules, as glibc does
+    if (!*p) p = ",M3.2.0,M11.1.0";
+
+    Rule* rules[] = {&start, &end};
+    for (Rule* r : rules) {
+        if (*p++ != ',') return false;
+        int a, b, c;
+        if (*p == 'M') {
+            p++;
+            if (!parseNumber(p, a, 2) || *p++ != '.' || !parseNumber(p, b, 1) || *p++ != '.' || !parseNumber(p, c, 1)) return false;
+            if (a < 1 || a > 12 || b < 1 || b > 5 || c > 6) return false;
+            r->kind = Rule::MONTH_WEEK_DAY;
+            r->month = a;
+            r->week = b;
+            r->day = c;
+        } else if (*p == 'J') {
+            p++;
+            if (!parseNumber(p, a, 3) || a < 1 || a > 365) return false;
+            r->kind = Rule::JULIAN_NO_LEAP;
+            r->day = a;
+        } else {
+            if (!parseNumber(p, a, 3) || a > 365) return false;
+            r->kind = Rule::JULIAN_ZERO;
+            r->day = a;
+        }
+        if (*p == '/') {
+            p++;
+            if (!parseTime(p, r->time)) return false;
+        }
+    }
+    return *p == '\0';
+}
+
+int64_t PosixTimezone::ruleDay(const Rule& rule, int year) {
+    int64_t jan1 = daysFromCivil(year, 1, 1);
+    switch (rule.kind) {
+        case Rule::JULIAN_NO_LEAP:
+            return jan1 + rule.day - 1 + (isLeap(year) && rule.day >= 60 ? 1 : 0);
+        case Rule::JULIAN_ZERO:
+            return jan1 + rule.day;
+        case Rule::MONTH_WEEK_DAY:
+        default: {
+            int64_t first = daysFromCivil(year, rule.month, 1);
+            int64_t next = rule.month == 12 ? daysFromCivil(year + 1, 1, 1) : daysFromCivil(year, rule.month + 1, 1);
+            int weekday = (int)(((first + 4) % 7 + 7) % 7);  // 1970-01-01 was a Thursday
+            int64_t day = first + (rule.day - weekday + 7) % 7 + (rule.week - 1) * 7;
+            while (day >= next) day -= 7;  // Week 5 means the last one in the month
+            return day;
+        }
+    }
+}
+
+void PosixTimezone::transitions(int year, time_t& dstStart, time_t& dstEnd) const {
+    // Start is given in standard time, end in daylight time
+    dstStart = (time_t)(ruleDay(start, year) * 86400 + start.time - stdOffset);
+    dstEnd = (time_t)(ruleDay(end, year) * 86400 + end.time - dstOffset);
+}
+
+int32_t PosixTimezone::offsetAt(time_t utc, time_t* validUntil) const {
+    int year = yearOf(utc);
+    time_t nextYear = (time_t)(daysFromCivil(year + 1, 1, 1) * 86400);
+    if (!dst) {
+        if (validUntil) *validUntil = nextYear;
+        return stdOffset;
+    }
+
+    time_t dstStart, dstEnd;
+    transitions(year, dstStart, dstEnd);
+    bool inDst = dstStart < dstEnd
+        ? utc >= dstStart && utc < dstEnd       // Northern hemisphere
+        : utc < dstEnd || utc >= dstStart;      // Southern: DST spans the new year
+
+    if (validUntil) {
+        time_t until = nextYear;
+        if (dstStart > utc && dstStart < until) until = dstStart;
+        if (dstEnd > utc && dstEnd < until) until = dstEnd;
+        *validUntil = until;
+    }
+    return inDst ? dstOffset : stdOffset;
+}
@@ -0,0 +1,102 @@
+/**
+ * Word Clock Core - POSIX timezone rules
+ *
+ * Evaluates POSIX TZ strings such as "AEST-10AEDT,M10.1.0,M4.1.0/3", the
+ * same rules ezTime fetches for a zone, so local time and DST transitions
+ * can be computed without a network or the C library's timezone database.
+ *
+ * Supported: quoted (<+04>) and alphabetic names, offsets with minutes and
+ * seconds, Mm.w.d / Jn / n rules, and transition times outside 0-24h
+ * (e.g. Cairo's "M10.5.4/24").
+ */
+
+#ifndef WORD_CLOCK_POSIX_TZ_H
+#define WORD_CLOCK_POSIX_TZ_H
+
+#include <stdint.h>
+#include <time.h>
+#include "hal.h"
+
+class PosixTimezone {
+public:
+    /**
+     * Parses a POSIX TZ string
+     * @return false if the string is malformed (the zone is then left as UTC)
+     */
+    bool parse(const char* rule);
+
+    /**
+     * Offset from UTC, in seconds, in force at a UTC instant
+     * @param validUntil If given, receives the next UTC instant at which the
+     *                   offset may change (a DST transition or a year boundary)
+     */
+    int32_t offsetAt(time_t utc, time_t* validUntil = nullptr) const;
+
+    // Local wall-clock time for a UTC instant
+    time_t toLocal(time_t utc) const { return utc + offsetAt(utc); }
+
+    bool hasDst() const { return dst; }
+    int32_t standardOffset() const { return stdOffset; }
+    int32_t daylightOffset() const { return dstOffset; }
+
+    /**
+     * UTC instants DST starts and ends in a given year
+     */
+    void transitions(int year, time_t& dstStart, time_t& dstEnd) const;
+
+private:
+    struct Rule {
+        enum Kind : uint8_t { MONTH_WEEK_DAY, JULIAN_NO_LEAP, JULIAN_ZERO } kind = MONTH_WEEK_DAY;
+        uint16_t day = 0;    // Day of week (M), or day of year (J / n)
+        uint8_t week = 0;    // Week 1-5 (M, 5 = last)
+        uint8_t month = 0;   // Month 1-12 (M)
+        int32_t time = 7200; // Seconds after local midnight, may be negative or > 24h
+    };
+
+    // Local midnight of the rule's day in the given year, as days since 1970
+    static int64_t ruleDay(const Rule& rule, int year);
+
+    int32_t stdOffset = 0;  // Seconds east of UTC
+    int32_t dstOffset = 0;
+    bool dst = false;
+    Rule start;
+    Rule end;
+};
+
+/**
+ * Local time in a POSIX zone on top of a UTC clock - what ezTime's
+ * Timezone::now() provides on the device. The offset is cached until the
+ * next possible transition, so reading it every simulated second is cheap.
+ */
+class ZonedClock final : public ClockSource {
+public:
+    ZonedClock(ClockSource& utcClock, const PosixTimezone& zone) : utcClock(utcClock), zone(zone) {}
+
+    time_t now() override {
+        time_t utc = utcClock.now();
+        if (utc < cachedFrom || utc >= cachedUntil) {
+            offset = zone.offsetAt(utc, &cachedUntil);
+            cachedFrom = utc;
+        }
+        return utc + offset;
+    }
+
+private:
+    ClockSource& utcClock;
+    const PosixTimezone& zone;
+    int32_t offset = 0;
+    time_t cachedFrom = 1;
+    time_t cachedUntil = 0;
+};
+
+/**
+ * Days since 1970-01-01 for a civil date
+ */
+int64_t daysFromCivil(int year, unsigned month, unsigned day);
+
+/**
+ * Calendar year containing a time_t
+ */
+int yearOf(time_t t);
+
+#endif // WORD_CLOCK_POSIX_TZ_H
@@ -0,0 +1,50 @@
+/**
+ * Word Clock Core - Rate limiting
+ */
+
+#include "rate_limit.h"
+
+// Bucket units per token: refilling perMinute tokens a minute adds
+// exactly perMinute units a millisecond, so no fraction is ever dropped
+#define TOKEN 60000
+
+RateLimiter::Bucket* RateLimiter::find(uint32_t client, uint8_t route, uint32_t nowMs) {
+    Bucket* oldest = &buckets[0];
+    for (Bucket& b : buckets) {
+        if (b.used && b.client == client && b.route == route) return &b;
+        if (!oldest->used) continue;
+        if (!b.used || nowMs - b.lastMs > nowMs - oldest->lastMs) oldest = &b;
+    }
+    return oldest;
+}
+
+uint32_t RateLimiter::admit(uint32_t client, uint8_t route, const RateLimit& limit, uint32_t nowMs) {
+    if (limit.burst == 0) return 0;
+    uint32_t full = (uint32_t)limit.burst * TOKEN;
+
+    Bucket* bucket = find(client, route, nowMs);
+    if (!bucket->used || bucket->client != client || bucket->route != route) {
+        *bucket = {client, nowMs, full, route, true};  // New clients start with a full bucket
+    } else {
+        uint64_t refill = (uint64_t)(nowMs - bucket->lastMs) * limit.perMinute;
+        bucket->tokens = refill >= full - bucket->tokens ? full : bucket->tokens + (uint32_t)refill;
+        bucket->lastMs = nowMs;
+    }
+
+    if (bucket->tokens >= TOKEN) {
+        bucket->tokens -= TOKEN;
+        return 0;
+    }
+    if (limit.perMinute == 0) return UINT32_MAX;
+    return (TOKEN - bucket->tokens + limit.perMinute - 1) / limit.perMinute;
+}
+
+int RateLimiter::clients() const {
+    int used = 0;
+    for (const Bucket& b : buckets) used += b.used;
+    return used;
+}
+
+void RateLimiter::reset() {
+    for (Bucket& b : buckets) b.used = false;
+}
@@ -0,0 +1,55 @@
+/**
+ * Word Clock Core - Rate limiting
+ *
+ * A token bucket per client and route. Each bucket holds up to `burst`
+ * requests and refills at `perMinute`; a request takes one token or is
+ * refused, with the time until the next token so the server can send
+ * Retry-After. Buckets live in a fixed table: a client seen for the first
+ * time takes a free slot, or the one idle longest, so memory does not
+ * grow with the number of clients on the network.
+ */
+
+#ifndef WORD_CLOCK_RATE_LIMIT_H
+#define WORD_CLOCK_RATE_LIMIT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RATE_LIMIT_BUCKETS
+#define RATE_LIMIT_BUCKETS 24  // Client/route pairs tracked at once
+#endif
+
+struct RateLimit {
+    uint16_t burst;      // Requests allowed back to back; 0 = unlimited
+    uint16_t perMinute;  // Sustained rate
+};
+
+class RateLimiter {
+public:
+    /**
+     * Takes a token from the client's bucket for the route
+     * @param client Client address (an IPv4 address as a number)
+     * @return 0 if the request is admitted, otherwise milliseconds until it would be
+     */
+    uint32_t admit(uint32_t client, uint8_t route, const RateLimit& limit, uint32_t nowMs);
+
+    // Buckets in use
+    int clients() const;
+
+    void reset();
+
+private:
+    struct Bucket {
+        uint32_t client;
+        uint32_t lastMs;     // Last refill
+        uint32_t tokens;     // In 1/60000 of a token
+        uint8_t route;
+        bool used;
+    };
+
+    Bucket* find(uint32_t client, uint8_t route, uint32_t nowMs);
+
+    Bucket buckets[RATE_LIMIT_BUCKETS] = {};
+};
+
+#endif // WORD_CLOCK_RATE_LIMIT_H
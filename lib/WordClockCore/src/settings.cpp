@@ -0,0 +1,273 @@
+/**
+ * Word Clock Core - Clock settings
+ *
+ * Everything here is generated from CLOCK_SETTINGS. The per-field work is
+ * picked by overloading on the member's type, so each expansion is a
+ * plain call and the compiler inlines it into one switch per operation.
+ */
+
+#include "settings.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "timezones.h"
+#include <stdlib.h>
+
+const SettingField SETTING_FIELDS[SETTING_COUNT] = {
+#define SETTING_FIELD(name, type, member, min, max, def, key, label, help) \
+    {#name, type, min, max, key, label, help},
+    CLOCK_SETTINGS(SETTING_FIELD)
+#undef SETTING_FIELD
+};
+
+// Defaults
+
+// Constant-initialised, so it is set before any ClockSettings is constructed
+static char defaultTimezone[TIMEZONE_NAME_MAX] = "Etc/UTC";  // isValidTimezone() wants Region/City
+
+bool setDefaultTimezone(const char* name) {
+    size_t length = strlen(name);
+    if (length == 0 || length >= sizeof(defaultTimezone) || !isValidTimezone(name)) return false;
+    memcpy(defaultTimezone, name, length + 1);
+    return true;
+}
+
+template <typename T>
+static void setDefault(T& member, long value) { member = value; }
+
+static void setDefault(char (&member)[TIMEZONE_NAME_MAX], const char* value) {
+    snprintf(member, sizeof(member), "%s", value);
+}
+
+static void setDefault(char (&member)[UPDATE_URL_MAX], const char* value) {
+    snprintf(member, sizeof(member), "%s", value);
+}
+
+static void setDefault(CurveSettings&, const char*) {}  // Built from the brightness below
+
+ClockSettings::ClockSettings() {
+#define SETTING_DEFAULT(name, type, member, min, max, def, key, label, help) setDefault(member, def);
+    CLOCK_SETTINGS(SETTING_DEFAULT)
+#undef SETTING_DEFAULT
+    CurveSettings built = curveFromSettings(brightness);
+    curve.count = built.count;
+    for (int i = 0; i < built.count; i++) curve.points[i] = built.points[i];
+}
+
+// Parsing: the whole text must be the value, and in range
+
+template <typename T>
+static bool parseField(T& member, long min, long max, const char* text) {
+    char* end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end || value < min || value > max) return false;
+    member = value;
+    return true;
+}
+
+static bool parseField(char (&member)[TIMEZONE_NAME_MAX], long min, long max, const char* text) {
+    long length = strlen(text);
+    if (length < min || length > max || !isValidTimezone(text)) return false;
+    memcpy(member, text, length + 1);
+    return true;
+}
+
+static bool parseField(char (&member)[UPDATE_URL_MAX], long min, long max, const char* text) {
+    long length = strlen(text);
+    if (length < min || length > max || !isValidUpdateUrl(text)) return false;
+    memcpy(member, text, length + 1);
+    return true;
+}
+
+static bool parseField(CurveSettings& member, long min, long max, const char* text) {
+    CurveSettings curve = member;
+    if (!parseCurvePoints(text, curve) || curve.count < min || curve.count > max) return false;
+    member = curve;
+    return true;
+}
+
+SettingId findSetting(const char* name) {
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        if (strcmp(name, SETTING_FIELDS[i].name) == 0) return (SettingId)i;
+    }
+    return SETTING_COUNT;
+}
+
+SettingResult parseSetting(ClockSettings& settings, SettingId id, const char* text) {
+    bool ok = false;
+    switch (id) {
+#define SETTING_PARSE(name, type, member, min, max, def, key, label, help) \
+    case SETTING_##name: ok = parseField(settings.member, min, max, text); break;
+        CLOCK_SETTINGS(SETTING_PARSE)
+#undef SETTING_PARSE
+        default: return SETTING_UNKNOWN;
+    }
+    return ok ? SETTING_OK : SETTING_INVALID;
+}
+
+SettingResult parseSetting(ClockSettings& settings, const char* name, const char* text) {
+    return parseSetting(settings, findSetting(name), text);
+}
+
+// Text form
+
+template <typename T>
+static int formatField(char* buffer, size_t size, const T& member) {
+    return snprintf(buffer, size, "%ld", (long)member);
+}
+
+static int formatField(char* buffer, size_t size, const char (&member)[TIMEZONE_NAME_MAX]) {
+    return snprintf(buffer, size, "%s", member);
+}
+
+static int formatField(char* buffer, size_t size, const char (&member)[UPDATE_URL_MAX]) {
+    return snprintf(buffer, size, "%s", member);
+}
+
+static int formatField(char* buffer, size_t size, const CurveSettings& member) {
+    if (formatCurvePoints(buffer, size, member) == 0 && member.count) return -1;
+    return strlen(buffer);
+}
+
+size_t formatSetting(char* buffer, size_t size, const ClockSettings& settings, SettingId id) {
+    int n = -1;
+    switch (id) {
+#define SETTING_FORMAT(name, type, member, min, max, def, key, label, help) \
+    case SETTING_##name: n = formatField(buffer, size, settings.member); break;
+        CLOCK_SETTINGS(SETTING_FORMAT)
+#undef SETTING_FORMAT
+        default: break;
+    }
+    return n > 0 && (size_t)n < size ? n : 0;
+}
+
+template <typename T>
+static long intField(const T& member) { return member; }
+static long intField(const char (&)[TIMEZONE_NAME_MAX]) { return 0; }
+static long intField(const char (&)[UPDATE_URL_MAX]) { return 0; }
+static long intField(const CurveSettings&) { return 0; }
+
+long settingValue(const ClockSettings& settings, SettingId id) {
+    switch (id) {
+#define SETTING_VALUE(name, type, member, min, max, def, key, label, help) \
+    case SETTING_##name: return intField(settings.member);
+        CLOCK_SETTINGS(SETTING_VALUE)
+#undef SETTING_VALUE
+        default: return 0;
+    }
+}
+
+size_t formatSettingError(char* buffer, size_t size, SettingId id) {
+    int n;
+    if (id >= SETTING_COUNT) {
+        n = snprintf(buffer, size, "Unknown setting");
+    } else if (SETTING_FIELDS[id].type == SETTING_INT) {
+        n = snprintf(buffer, size, "%s must be %ld-%ld", SETTING_FIELDS[id].name,
+                     SETTING_FIELDS[id].min, SETTING_FIELDS[id].max);
+    } else if (SETTING_FIELDS[id].type == SETTING_TIMEZONE) {
+        n = snprintf(buffer, size, "Invalid timezone format");
+    } else if (SETTING_FIELDS[id].type == SETTING_URL) {
+        n = snprintf(buffer, size, "%s must be empty or http://host[:port]/path", SETTING_FIELDS[id].name);
+    } else {
+        n = snprintf(buffer, size, "Invalid curve points");
+    }
+    return n > 0 && (size_t)n < size ? n : 0;
+}
+
+bool parseSettingsJson(ClockSettings& settings, const JsonReader& document, char* error, size_t size) {
+    for (int i = 0; i < document.count(); i++) {
+        const JsonMember& member = document.member(i);
+        SettingId id = findSetting(member.key);
+        if (id == SETTING_COUNT) {
+            snprintf(error, size, "Unknown setting: %s", member.key);
+            return false;
+        }
+        JsonValueType expected = SETTING_FIELDS[id].type == SETTING_INT ? JSON_NUMBER : JSON_STRING;
+        if (member.type != expected) {
+            snprintf(error, size, "%s must be a %s", member.key, expected == JSON_NUMBER ? "number" : "string");
+            return false;
+        }
+        if (parseSetting(settings, id, member.value) != SETTING_OK) {
+            formatSettingError(error, size, id);
+            return false;
+        }
+    }
+    return true;
+}
+
+void rebuildCurve(ClockSettings& settings, const ClockSettings& before) {
+    const BrightnessSettings& now = settings.brightness;
+    const BrightnessSettings& was = before.brightness;
+    bool brightnessChanged = now.darkBrightness != was.darkBrightness ||
+        now.lightBrightness != was.lightBrightness || now.threshold != was.threshold;
+    bool pointsChanged = settings.curve.count != before.curve.count ||
+        memcmp(settings.curve.points, before.curve.points, sizeof(CurvePoint) * settings.curve.count) != 0;
+    if (!brightnessChanged || pointsChanged) return;
+
+    CurveSettings built = curveFromSettings(now);
+    settings.curve.count = built.count;
+    for (int i = 0; i < built.count; i++) settings.curve.points[i] = built.points[i];
+}
+
+bool setTimezoneName(ClockSettings& settings, const char* name) {
+    size_t length = strlen(name);
+    if (length >= sizeof(settings.timezone)) return false;
+    memcpy(settings.timezone, name, length + 1);
+    return true;
+}
+
+// JSON
+
+template <typename T>
+static void jsonField(JsonWriter& json, const char* name, const T& member) {
+    json.member(name, (long)member);
+}
+
+static void jsonField(JsonWriter& json, const char* name, const char (&member)[TIMEZONE_NAME_MAX]) {
+    json.member(name, (const char*)member);
+}
+
+static void jsonField(JsonWriter& json, const char* name, const char (&member)[UPDATE_URL_MAX]) {
+    json.member(name, (const char*)member);
+}
+
+static void jsonField(JsonWriter& json, const char* name, const CurveSettings& member) {
+    char text[SETTING_TEXT_MAX];
+    formatCurvePoints(text, sizeof(text), member);
+    json.member(name, (const char*)text);
+}
+
+void writeSettingsJson(JsonWriter& json, const ClockSettings& settings) {
+#define SETTING_JSON(name, type, member, min, max, def, key, label, help) \
+    jsonField(json, #name, settings.member);
+    CLOCK_SETTINGS(SETTING_JSON)
+#undef SETTING_JSON
+}
+
+size_t formatSettingSchemaJson(char* buffer, size_t size, SettingId id) {
+    static const char* const TYPE_NAMES[] = {"int", "timezone", "curve", "url"};
+    const ClockSettings defaults;  // Not static: the timezone default is set at boot
+    const SettingField& field = SETTING_FIELDS[id];
+    char text[SETTING_TEXT_MAX];
+    formatSetting(text, sizeof(text), defaults, id);
+
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .member("name", field.name)
+        .member("type", TYPE_NAMES[field.type])
+        .member("min", field.min)
+        .member("max", field.max);
+    if (field.type == SETTING_INT) {
+        json.member("default", settingValue(defaults, id));
+    } else {
+        json.member("default", (const char*)text);
+    }
+    json.member("label", field.label)
+        .member("help", field.help);
+    if (field.type == SETTING_TIMEZONE) {
+        json.key("options").beginArray();
+        for (size_t i = 0; i < COMMON_TIMEZONE_COUNT; i++) json.value(COMMON_TIMEZONES[i]);
+        json.endArray();
+    }
+    json.endObject();
+    return json.ok() ? json.length() : 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * Word Clock Core - Clock settings
+ *
+ * Everything a user can change through the web interface, as one plain
+ * value. The firmware publishes it through a DoubleBuffer: HTTP handlers
+ * build a new version and publish it whole, and the display and sensor
+ * code read a consistent copy and apply what changed, so neither ever
+ * sees a half-written update.
+ *
+ * Every setting is described once, in CLOCK_SETTINGS below: its form and
+ * JSON name, type, range, default, NVS key and label. The form parser and
+ * range check, the JSON members, the NVS codec and the schema the settings
+ * page builds its form from are all generated from that table, so adding
+ * a setting is one line and none of them can disagree about it.
+ */
+
+#ifndef WORD_CLOCK_SETTINGS_H
+#define WORD_CLOCK_SETTINGS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "brightness.h"
+#include "firmware_update.h"
+#include "transition.h"
+
+#define TIMEZONE_NAME_MAX 48  // Longest IANA name is 32 characters
+#define SETTING_TEXT_MAX UPDATE_URL_MAX  // Longest text form of a setting: an update URL
+
+class JsonReader;
+class JsonWriter;
+
+enum SettingType : uint8_t {
+    SETTING_INT,       // Whole number in [min, max]
+    SETTING_TIMEZONE,  // IANA name (see timezones.h); max is the length limit
+    SETTING_CURVE,     // "level:brightness,..." (see parseCurvePoints); min/max count points
+    SETTING_URL,       // "" or http://host[:port]/path (see isValidUpdateUrl); max is the length limit
+};
+
+/**
+ * X(name, type, member, min, max, default, nvsKey, label, help)
+ *
+ * name is the form argument and JSON member; member is the field of
+ * ClockSettings it lives in. NVS keys are at most 15 characters and must
+ * never be reused for something else. The curve's default is empty: it is
+ * built from the brightness defaults. The timezone's is the one given to
+ * setDefaultTimezone().
+ */
+#define CLOCK_SETTINGS(X) \
+    X(darkBrightness,  SETTING_INT,      brightness.darkBrightness,  0, 255, 5, "dark", \
+      "Dark Mode Brightness", "Recommended: 1-10 for dark rooms.") \
+    X(lightBrightness, SETTING_INT,      brightness.lightBrightness, 0, 255, 25, "light", \
+      "Light Mode Brightness", "Recommended: 20-50 for bright rooms.") \
+    X(threshold,       SETTING_INT,      brightness.threshold, 0, LIGHT_LEVEL_MAX, 2600, "thresh", \
+      "Light/Dark Threshold", "Higher values mean the room needs to be brighter to trigger light mode.") \
+    X(timezone,        SETTING_TIMEZONE, timezone, 1, TIMEZONE_NAME_MAX - 1, defaultTimezone, "tz", \
+      "Timezone", "Region/City from the tz database, e.g. America/New_York.") \
+    X(points,          SETTING_CURVE,    curve, 2, CURVE_MAX_POINTS, "", "curve", \
+      "Curve Points", "level:brightness pairs, levels increasing, e.g. 0:5,2200:5,3000:25,4095:25. " \
+      "Rebuilt from the values above when they change.") \
+    X(hysteresis,      SETTING_INT,      curve.hysteresis, 0, LIGHT_LEVEL_MAX, 64, "hyst", \
+      "Hysteresis", "Light level change ignored, to stop flicker near a bend.") \
+    X(slew,            SETTING_INT,      curve.slewPerSecond, 0, 255, 10, "slew", \
+      "Slew Rate", "Fastest brightness change in steps per second. 0 = instant.") \
+    X(transitionMs,    SETTING_INT,      transitionMs, 0, TRANSITION_MAX_MS, TRANSITION_DEFAULT_MS, "fadeMs", \
+      "Fade Length", "Milliseconds to crossfade between phrases. 0 = hard cut.") \
+    X(ditherBelow,     SETTING_INT,      ditherBelow, 0, 255, TRANSITION_DITHER_BELOW, "dither", \
+      "Dither Below", "Brightness under which fractional steps are dithered. 0 = off.") \
+    X(updateUrl,       SETTING_URL,      updateUrl, 0, UPDATE_URL_MAX - 1, "", "updUrl", \
+      "Update Manifest URL", "http:// address of the firmware manifest to check. Empty = no automatic updates.") \
+    X(updateHours,     SETTING_INT,      updateHours, 1, 168, 24, "updHours", \
+      "Update Check Interval", "Hours between checks of the manifest.")
+
+enum SettingId : uint8_t {
+#define SETTING_ID(name, type, member, min, max, def, key, label, help) SETTING_##name,
+    CLOCK_SETTINGS(SETTING_ID)
+#undef SETTING_ID
+    SETTING_COUNT
+};
+
+struct SettingField {
+    const char* name;
+    SettingType type;
+    long min;
+    long max;
+    const char* nvsKey;
+    const char* label;
+    const char* help;
+};
+
+extern const SettingField SETTING_FIELDS[SETTING_COUNT];
+
+struct ClockSettings {
+    BrightnessSettings brightness;
+    CurveSettings curve;
+    char timezone[TIMEZONE_NAME_MAX];
+    uint16_t transitionMs;
+    uint8_t ditherBelow;
+    char updateUrl[UPDATE_URL_MAX];
+    uint8_t updateHours;
+
+    ClockSettings();  // Every setting at its schema default
+};
+
+enum SettingResult : uint8_t {
+    SETTING_OK,
+    SETTING_UNKNOWN,  // No setting of that name
+    SETTING_INVALID,  // Not a value of the setting's type, or out of range
+};
+
+/**
+ * Looks a setting up by its form/JSON name
+ * @return Its id, or SETTING_COUNT if there is none
+ */
+SettingId findSetting(const char* name);
+
+/**
+ * Parses and range-checks a setting's text form into the settings
+ * @return SETTING_INVALID (leaving them unchanged) if the text is rejected
+ */
+SettingResult parseSetting(ClockSettings& settings, SettingId id, const char* text);
+
+// Same, by name; SETTING_UNKNOWN if there is no such setting
+SettingResult parseSetting(ClockSettings& settings, const char* name, const char* text);
+
+/**
+ * Writes a setting's text form, as parseSetting() accepts it
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatSetting(char* buffer, size_t size, const ClockSettings& settings, SettingId id);
+
+// Value of a SETTING_INT setting
+long settingValue(const ClockSettings& settings, SettingId id);
+
+/**
+ * Writes why a value was rejected, e.g. "darkBrightness must be 0-255"
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatSettingError(char* buffer, size_t size, SettingId id);
+
+/**
+ * Applies every member of a parsed JSON object: numbers for SETTING_INT
+ * settings, strings for the rest. Stops at the first member that is not a
+ * setting, has the wrong JSON type or is rejected, writing why into
+ * `error`; `settings` may then be partly changed, so edit a copy.
+ * @return Whether every member was applied
+ */
+bool parseSettingsJson(ClockSettings& settings, const JsonReader& document, char* error, size_t size);
+
+/**
+ * Finishes an edit: when the dark/light brightness or threshold changed
+ * and the curve points did not, rebuilds the points from them (keeping
+ * the hysteresis and slew rate)
+ */
+void rebuildCurve(ClockSettings& settings, const ClockSettings& before);
+
+/**
+ * Sets the timezone default, for ClockSettings() and the schema. The
+ * firmware passes DEFAULT_TIMEZONE from its config.h before building any
+ * settings; until then it is "Etc/UTC".
+ * @return false (leaving it unchanged) if the name is not a valid zone
+ */
+bool setDefaultTimezone(const char* name);
+
+/**
+ * Copies a timezone name into the settings
+ * @return false (leaving them unchanged) if the name does not fit
+ */
+bool setTimezoneName(ClockSettings& settings, const char* name);
+
+/**
+ * Adds every setting to the open JSON object: numbers for SETTING_INT,
+ * strings for the rest
+ */
+void writeSettingsJson(JsonWriter& json, const ClockSettings& settings);
+
+/**
+ * Writes one setting's schema entry as a JSON object: name, type, range,
+ * default, label and help, plus the common zones for the timezone
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatSettingSchemaJson(char* buffer, size_t size, SettingId id);
+
+/**
+ * Reads every setting stored under its NVS key, through anything shaped
+ * like Arduino's Preferences (isKey, getInt, getString). Stored values go
+ * through the same checks as form input; a missing or rejected one keeps
+ * its current value.
+ * @return Settings loaded
+ */
+template <typename Store>
+int loadSettings(Store& store, ClockSettings& settings) {
+    int loaded = 0;
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        const SettingField& field = SETTING_FIELDS[i];
+        if (!store.isKey(field.nvsKey)) continue;
+        char text[SETTING_TEXT_MAX];
+        if (field.type == SETTING_INT) {
+            snprintf(text, sizeof(text), "%ld", (long)store.getInt(field.nvsKey, 0));
+        } else if (!store.getString(field.nvsKey, text, sizeof(text))) {
+            continue;
+        }
+        if (parseSetting(settings, (SettingId)i, text) == SETTING_OK) loaded++;
+    }
+    return loaded;
+}
+
+/**
+ * Writes the settings that differ from `saved` (what the store already
+ * holds, defaults included), so an unchanged setting never costs a flash
+ * write
+ * @return Settings written
+ */
+template <typename Store>
+int saveSettings(Store& store, const ClockSettings& settings, const ClockSettings& saved) {
+    int written = 0;
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        const SettingField& field = SETTING_FIELDS[i];
+        char text[SETTING_TEXT_MAX], old[SETTING_TEXT_MAX];
+        formatSetting(text, sizeof(text), settings, (SettingId)i);
+        formatSetting(old, sizeof(old), saved, (SettingId)i);
+        if (strcmp(text, old) == 0) continue;
+        if (field.type == SETTING_INT) {
+            store.putInt(field.nvsKey, settingValue(settings, (SettingId)i));
+        } else {
+            store.putString(field.nvsKey, text);
+        }
+        written++;
+    }
+    return written;
+}
+
+#endif // WORD_CLOCK_SETTINGS_H
@@ -0,0 +1,39 @@
+/**
+ * Word Clock Core - State version
+ */
+
+#include "state_version.h"
+#include "json_writer.h"
+
+static const char* const CHANGE_NAMES[STATE_CHANGE_KINDS] = {"frame", "brightness", "settings", "sync"};
+
+void StateVersion::bump(StateChange what) {
+    current++;
+    for (int i = 0; i < STATE_CHANGE_KINDS; i++) {
+        if (what & (1 << i)) changedAt[i] = current;
+    }
+}
+
+uint8_t StateVersion::changesSince(uint32_t since) const {
+    if (since > current) return STATE_CHANGE_ALL;  // From before a reboot
+    uint8_t changes = 0;
+    for (int i = 0; i < STATE_CHANGE_KINDS; i++) {
+        if (changedAt[i] > since) changes |= 1 << i;
+    }
+    return changes;
+}
+
+size_t formatStateJson(char* buffer, size_t size, const StateVersion& state, uint32_t since, bool timedOut) {
+    uint8_t changes = state.changesSince(since);
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .member("version", state.version())
+        .key("changed").beginArray();
+    for (int i = 0; i < STATE_CHANGE_KINDS; i++) {
+        if (changes & (1 << i)) json.value(CHANGE_NAMES[i]);
+    }
+    json.endArray()
+        .member("timeout", timedOut)
+        .endObject();
+    return json.ok() ? json.length() : 0;
+}
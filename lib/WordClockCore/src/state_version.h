@@ -0,0 +1,50 @@
+/**
+ * Word Clock Core - State version
+ *
+ * One counter that goes up whenever something a client shows changes:
+ * the phrase on the face, the brightness, the settings or the time sync.
+ * Clients long-poll /api/wait?since=N and are answered as soon as the
+ * version differs from N. The change list then tells them what to reload,
+ * so they need neither a timer nor a request per value they show.
+ *
+ * The version restarts at 0 on boot. A client whose version is ahead of
+ * the clock's is told that everything changed.
+ */
+
+#ifndef WORD_CLOCK_STATE_VERSION_H
+#define WORD_CLOCK_STATE_VERSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum StateChange : uint8_t {
+    STATE_FRAME = 1,
+    STATE_BRIGHTNESS = 2,
+    STATE_SETTINGS = 4,
+    STATE_SYNC = 8,
+};
+
+#define STATE_CHANGE_KINDS 4
+#define STATE_CHANGE_ALL ((1 << STATE_CHANGE_KINDS) - 1)
+
+class StateVersion {
+public:
+    void bump(StateChange what);
+
+    uint32_t version() const { return current; }
+
+    // StateChange bits of everything that changed after version `since`
+    uint8_t changesSince(uint32_t since) const;
+
+private:
+    uint32_t current = 0;
+    uint32_t changedAt[STATE_CHANGE_KINDS] = {};  // Version of each kind's last change
+};
+
+/**
+ * Writes the /api/wait answer: {"version":N,"changed":["frame",...],"timeout":false}
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatStateJson(char* buffer, size_t size, const StateVersion& state, uint32_t since, bool timedOut);
+
+#endif // WORD_CLOCK_STATE_VERSION_H
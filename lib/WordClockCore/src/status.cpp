@@ -0,0 +1,49 @@
+/**
+ * Word Clock Core - Status document
+ */
+
+#include "status.h"
+#include "json_writer.h"
+#include <stdio.h>
+
+size_t formatStatusJson(char* buffer, size_t size, const StatusSnapshot& status) {
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .member("lightLevel", status.lightLevel)
+        .member("currentBrightness", status.currentBrightness)
+        .member("timezone", status.timezone)
+        .member("settingsVersion", status.settingsVersion)
+        .key("settings").beginObject();
+    writeSettingsJson(json, status.settings);
+    json.endObject().endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+size_t formatFrameJson(char* buffer, size_t size, const FrameSnapshot& frame, bool labels) {
+    char mask[17], time[8] = "--:--";  // Until the first frame is set
+    snprintf(mask, sizeof(mask), "%016llx", (unsigned long long)frame.frame);
+    if (frame.time.hour < 24) snprintf(time, sizeof(time), "%02u:%02u", frame.time.hour, frame.time.minute);
+
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .member("mask", (const char*)mask)
+        .key("rows").beginArray();
+    for (int row = 0; row < 8; row++) json.value(frameRow(frame.frame, row));
+    json.endArray()
+        .member("brightness", frame.brightness)
+        .member("time", (const char*)time)
+        .member("localTime", (long long)frame.localTime)
+        .member("synced", frame.synced)
+        .member("version", frame.stateVersion);
+    if (labels) {
+        static char faceText[FACE_LEDS][4];
+        if (!faceText[0][0]) faceLabels(faceText);
+        json.key("labels").beginArray();
+        for (int row = 0; row < 8; row++) {
+            for (int col = 0; col < 8; col++) json.value((const char*)faceText[ledAt(row, col)]);
+        }
+        json.endArray();
+    }
+    json.endObject();
+    return json.ok() ? json.length() : 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * Word Clock Core - Status document
+ *
+ * The JSON served by /api/status and /api/frame, built from plain
+ * snapshots so it can be produced (and benchmarked) without the web server.
+ */
+
+#ifndef WORD_CLOCK_STATUS_H
+#define WORD_CLOCK_STATUS_H
+
+#include <stddef.h>
+#include "clock_face.h"
+#include "settings.h"
+
+struct StatusSnapshot {
+    int lightLevel;
+    int currentBrightness;
+    const char* timezone;
+    ClockSettings settings;
+    uint32_t settingsVersion = 0;  // Changes whenever any setting does
+};
+
+/**
+ * Writes the status JSON into a buffer
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatStatusJson(char* buffer, size_t size, const StatusSnapshot& status);
+
+/**
+ * What the face shows: the phrase being faded to (or settled on), at what
+ * brightness, and the time it stands for
+ */
+struct FrameSnapshot {
+    FrameMask frame = 0;
+    uint8_t brightness = 0;
+    FaceTime time = {0, 0};   // Rounded time the frame shows
+    int64_t localTime = 0;    // Device clock, seconds since 1970 in the local zone
+    bool synced = false;      // Whether that clock comes from NTP
+    uint32_t stateVersion = 0;
+};
+
+/**
+ * Writes the frame JSON: the mask as 16 hex digits (a JSON number cannot
+ * hold 64 bits exactly) and as 8 row bytes (see frameRow()), so a client
+ * can draw the face without knowing the LED wiring. With `labels`, adds
+ * the letters of all 64 LEDs in row order (see faceLabels()).
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatFrameJson(char* buffer, size_t size, const FrameSnapshot& frame, bool labels);
+
+#endif // WORD_CLOCK_STATUS_H
@@ -0,0 +1,97 @@
+/**
+ * Word Clock Core - Binary status
+ */
+
+#include "status_binary.h"
+
+static uint8_t* putUnsigned(uint8_t* out, uint8_t type, uint64_t value, int bytes) {
+    *out++ = type;
+    for (int i = bytes - 1; i >= 0; i--) *out++ = value >> (8 * i);
+    return out;
+}
+
+static uint8_t* putU8(uint8_t* out, uint8_t v) { return putUnsigned(out, 0xCC, v, 1); }
+static uint8_t* putU16(uint8_t* out, uint16_t v) { return putUnsigned(out, 0xCD, v, 2); }
+static uint8_t* putU32(uint8_t* out, uint32_t v) { return putUnsigned(out, 0xCE, v, 4); }
+static uint8_t* putU64(uint8_t* out, uint64_t v) { return putUnsigned(out, 0xCF, v, 8); }
+
+size_t encodeStatusBinary(uint8_t* buffer, size_t size, const StatusBinary& status) {
+    if (size < STATUS_BINARY_SIZE) return 0;
+    uint8_t* out = buffer;
+    *out++ = 0x90 | STATUS_BINARY_FIELDS;
+    out = putU8(out, status.version);
+    out = putU32(out, status.uptimeSeconds);
+    out = putU32(out, status.localTime);
+    out = putU32(out, status.lastSync);
+    out = putU8(out, status.syncState);
+    out = putU16(out, status.lightLevel);
+    out = putU8(out, status.brightness);
+    out = putU32(out, status.settingsVersion);
+    out = putU64(out, status.frame);
+    out = putU32(out, status.freeHeap);
+    out = putU32(out, status.minFreeHeap);
+    out = putU8(out, status.healthAlerts);
+    return out - buffer;
+}
+
+/**
+ * Reads any MessagePack unsigned integer (positive fixint or uint8-64) no
+ * larger than `max`
+ */
+static bool getUnsigned(const uint8_t*& in, const uint8_t* end, uint64_t max, uint64_t& value) {
+    if (in >= end) return false;
+    uint8_t type = *in++;
+    int bytes;
+    if (type < 0x80) {
+        value = type;
+        return value <= max;
+    }
+    switch (type) {
+        case 0xCC: bytes = 1; break;
+        case 0xCD: bytes = 2; break;
+        case 0xCE: bytes = 4; break;
+        case 0xCF: bytes = 8; break;
+        default: return false;
+    }
+    if (end - in < bytes) return false;
+    value = 0;
+    for (int i = 0; i < bytes; i++) value = value << 8 | *in++;
+    return value <= max;
+}
+
+template <typename T>
+static bool getField(const uint8_t*& in, const uint8_t* end, T& field) {
+    uint64_t value;
+    if (!getUnsigned(in, end, (T)~(T)0, value)) return false;
+    field = value;
+    return true;
+}
+
+bool decodeStatusBinary(const uint8_t* data, size_t size, StatusBinary& status) {
+    const uint8_t* in = data;
+    const uint8_t* end = data + size;
+    if (in >= end) return false;
+    uint32_t fields;
+    if ((*in & 0xF0) == 0x90) {
+        fields = *in++ & 0x0F;
+    } else if (*in == 0xDC && size >= 3) {
+        fields = in[1] << 8 | in[2];
+        in += 3;
+    } else {
+        return false;
+    }
+    if (fields < STATUS_BINARY_FIELDS) return false;
+
+    return getField(in, end, status.version) && status.version >= STATUS_BINARY_VERSION &&
+           getField(in, end, status.uptimeSeconds) &&
+           getField(in, end, status.localTime) &&
+           getField(in, end, status.lastSync) &&
+           getField(in, end, status.syncState) &&
+           getField(in, end, status.lightLevel) &&
+           getField(in, end, status.brightness) &&
+           getField(in, end, status.settingsVersion) &&
+           getField(in, end, status.frame) &&
+           getField(in, end, status.freeHeap) &&
+           getField(in, end, status.minFreeHeap) &&
+           getField(in, end, status.healthAlerts);
+}
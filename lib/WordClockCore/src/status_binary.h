@@ -0,0 +1,67 @@
+/**
+ * Word Clock Core - Binary status
+ *
+ * The compact status served by /api/status.bin for fleet monitoring: one
+ * MessagePack array of STATUS_BINARY_FIELDS unsigned integers. Every
+ * field is written with its fixed-width MessagePack type (uint8, uint16,
+ * uint32 or uint64, whatever the value), so the document is always
+ * STATUS_BINARY_SIZE bytes and each field sits at the same offset:
+ *
+ *   offset  field            type
+ *        0  array header     fixarray (0x9c)
+ *        1  format version   uint8    STATUS_BINARY_VERSION
+ *        3  uptime           uint32   seconds since boot
+ *        8  local time       uint32   seconds since 1970 in the clock's zone
+ *       13  last NTP sync    uint32   UTC seconds since 1970, 0 = never
+ *       18  sync state       uint8    0 not set, 1 needs sync, 2 set
+ *       20  light level      uint16   0-4095
+ *       23  brightness       uint8    LED brightness shown
+ *       25  settings version uint32
+ *       30  frame            uint64   FrameMask on the face (see clock_face.h)
+ *       39  free heap        uint32   bytes
+ *       44  min free heap    uint32   bytes, lowest since boot
+ *       49  health alerts    uint8    latched HealthAlert bits
+ *
+ * Any MessagePack decoder reads it as an array. decodeStatusBinary()
+ * accepts any unsigned encoding of each field and ignores fields added
+ * after these, so collectors keep working when the format grows.
+ */
+
+#ifndef WORD_CLOCK_STATUS_BINARY_H
+#define WORD_CLOCK_STATUS_BINARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define STATUS_BINARY_VERSION 1
+#define STATUS_BINARY_FIELDS 12
+#define STATUS_BINARY_SIZE 51
+
+struct StatusBinary {
+    uint8_t version = STATUS_BINARY_VERSION;
+    uint32_t uptimeSeconds = 0;
+    uint32_t localTime = 0;
+    uint32_t lastSync = 0;
+    uint8_t syncState = 0;
+    uint16_t lightLevel = 0;
+    uint8_t brightness = 0;
+    uint32_t settingsVersion = 0;
+    uint64_t frame = 0;
+    uint32_t freeHeap = 0;
+    uint32_t minFreeHeap = 0;
+    uint8_t healthAlerts = 0;
+};
+
+/**
+ * Writes the status as MessagePack
+ * @return STATUS_BINARY_SIZE, or 0 if the buffer was too small
+ */
+size_t encodeStatusBinary(uint8_t* buffer, size_t size, const StatusBinary& status);
+
+/**
+ * Reads a document written by encodeStatusBinary() (this version or later)
+ * @return false if it is not one, leaving `status` unspecified
+ */
+bool decodeStatusBinary(const uint8_t* data, size_t size, StatusBinary& status);
+
+#endif // WORD_CLOCK_STATUS_BINARY_H
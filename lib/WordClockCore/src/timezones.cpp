@@ -0,0 +1,76 @@
+/**
+ * Word Clock Core - Timezone names
+ */
+
+#include "timezones.h"
+#include <string.h>
+
+const char* const COMMON_TIMEZONES[] = {
+    "Africa/Cairo",
+    "America/Chicago",
+    "America/Los_Angeles",
+    "America/New_York",
+    "America/Toronto",
+    "Asia/Dubai",
+    "Asia/Hong_Kong",
+    "Asia/Singapore",
+    "Asia/Tokyo",
+    "Australia/Adelaide",
+    "Australia/Brisbane",
+    "Australia/Melbourne",
+    "Australia/Perth",
+    "Australia/Sydney",
+    "Europe/Amsterdam",
+    "Europe/Berlin",
+    "Europe/London",
+    "Europe/Paris",
+    "Pacific/Auckland"
+};
+
+const size_t COMMON_TIMEZONE_COUNT = sizeof(COMMON_TIMEZONES) / sizeof(COMMON_TIMEZONES[0]);
+
+// From tzdata 2025b; these are the rules ezTime serves for the same zones
+const char* const COMMON_TIMEZONE_RULES[] = {
+    "EET-2EEST,M4.5.5/0,M10.5.4/24",       // Africa/Cairo
+    "CST6CDT,M3.2.0,M11.1.0",              // America/Chicago
+    "PST8PDT,M3.2.0,M11.1.0",              // America/Los_Angeles
+    "EST5EDT,M3.2.0,M11.1.0",              // America/New_York
+    "EST5EDT,M3.2.0,M11.1.0",              // America/Toronto
+    "<+04>-4",                             // Asia/Dubai
+    "HKT-8",                               // Asia/Hong_Kong
+    "<+08>-8",                             // Asia/Singapore
+    "JST-9",                               // Asia/Tokyo
+    "ACST-9:30ACDT,M10.1.0,M4.1.0/3",      // Australia/Adelaide
+    "AEST-10",                             // Australia/Brisbane
+    "AEST-10AEDT,M10.1.0,M4.1.0/3",        // Australia/Melbourne
+    "AWST-8",                              // Australia/Perth
+    "AEST-10AEDT,M10.1.0,M4.1.0/3",        // Australia/Sydney
+    "CET-1CEST,M3.5.0,M10.5.0/3",          // Europe/Amsterdam
+    "CET-1CEST,M3.5.0,M10.5.0/3",          // Europe/Berlin
+    "GMT0BST,M3.5.0/1,M10.5.0",            // Europe/London
+    "CET-1CEST,M3.5.0,M10.5.0/3",          // Europe/Paris
+    "NZST-12NZDT,M9.5.0,M4.1.0/3",         // Pacific/Auckland
+};
+
+static_assert(sizeof(COMMON_TIMEZONE_RULES) == sizeof(COMMON_TIMEZONES), "One rule per common timezone");
+
+const char* posixRuleFor(const char* tz) {
+    for (size_t i = 0; i < COMMON_TIMEZONE_COUNT; i++) {
+        if (strcmp(tz, COMMON_TIMEZONES[i]) == 0) return COMMON_TIMEZONE_RULES[i];
+    }
+    return nullptr;
+}
+
+bool isValidTimezone(const char* tz) {
+    // Check common timezones first
+    for (size_t i = 0; i < COMMON_TIMEZONE_COUNT; i++) {
+        if (strcmp(tz, COMMON_TIMEZONES[i]) == 0) return true;
+    }
+    
+    // Basic format validation
+    if (!strchr(tz, '/')) return false;   // Must contain region/city format
+    if (strlen(tz) < 7) return false;     // Minimum length (e.g., "US/East")
+    if (strchr(tz, ' ')) return false;    // No spaces allowed
+    
+    return true;
+}
@@ -0,0 +1,28 @@
+/**
+ * Word Clock Core - Timezone names
+ */
+
+#ifndef WORD_CLOCK_TIMEZONES_H
+#define WORD_CLOCK_TIMEZONES_H
+
+#include <stddef.h>
+
+// Zones offered in the settings page, in alphabetical order
+extern const char* const COMMON_TIMEZONES[];
+extern const size_t COMMON_TIMEZONE_COUNT;
+
+// POSIX TZ rule for each entry of COMMON_TIMEZONES (see posix_tz.h)
+extern const char* const COMMON_TIMEZONE_RULES[];
+
+/**
+ * POSIX TZ rule for a common zone, or nullptr if the zone is not in the list
+ */
+const char* posixRuleFor(const char* tz);
+
+/**
+ * Accepts the common zones plus anything shaped like an IANA Region/City name.
+ * The zone itself is only confirmed when ezTime looks it up.
+ */
+bool isValidTimezone(const char* tz);
+
+#endif // WORD_CLOCK_TIMEZONES_H
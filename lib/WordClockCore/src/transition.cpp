@@ -0,0 +1,127 @@
+/**
+ * Word Clock Core - Transitions
+ */
+
+#include "transition.h"
+#include "json_writer.h"
+#include <string.h>
+
+void TransitionEngine::setFrame(FrameMask target, uint32_t nowMs) {
+    if (target == toFrame) return;
+    memcpy(fromLevel, level, sizeof(level));
+    toFrame = target;
+    fadeStart = nowMs;
+    schedule(nowMs);
+    fading = true;
+    counters.transitions++;
+}
+
+void TransitionEngine::setBrightness(uint16_t target, uint32_t nowMs) {
+    if (target == toBrightness) return;
+    fromBrightness = brightness;
+    toBrightness = target;
+    rampStart = nowMs;
+    schedule(nowMs);
+    ramping = true;
+    counters.transitions++;
+}
+
+void TransitionEngine::schedule(uint32_t nowMs) {
+    // Coming out of idle, show the first frame straight away (a dithered
+    // face is already drawing, so the transition starts on its next frame)
+    if (!active()) nextFrame = nowMs;
+}
+
+uint16_t TransitionEngine::progress(uint32_t start, uint32_t nowMs) const {
+    uint32_t elapsed = nowMs - start;
+    if (elapsed >= duration) return 256;
+    return (uint16_t)((elapsed << 8) / duration);
+}
+
+uint32_t TransitionEngine::msUntilNextFrame(uint32_t nowMs) const {
+    if (!active()) return TRANSITION_FRAME_MS;
+    int32_t wait = (int32_t)(nextFrame - nowMs);
+    return wait > 0 ? wait : 0;
+}
+
+uint8_t TransitionEngine::render(uint32_t nowMs, CRGB* leds) {
+    // Slots that passed without a frame are dropped, not caught up on
+    uint32_t period = framePeriod();
+    uint32_t late = nowMs - nextFrame;
+    if ((int32_t)late >= (int32_t)period) {
+        uint32_t missed = late / period;
+        counters.dropped += missed;
+        nextFrame += missed * period;
+    }
+    lastFrameDithered = !fading && !ramping;
+
+    if (fading) {
+        int t = progress(fadeStart, nowMs);
+        for (int i = 0; i < FACE_LEDS; i++) {
+            int to = (toFrame >> i) & 1 ? 255 : 0;
+            level[i] = (uint8_t)(fromLevel[i] + (to - fromLevel[i]) * t / 256);
+        }
+        fading = t < 256;
+    }
+    if (ramping) {
+        int t = progress(rampStart, nowMs);
+        brightness = (uint16_t)(fromBrightness + ((int32_t)toBrightness - fromBrightness) * t / 256);
+        ramping = t < 256;
+    }
+    // The period can change with the brightness, so schedule after the ramp
+    nextFrame += framePeriod();
+
+    uint8_t step = brightness >> 8;
+    if (dithering()) {
+        uint16_t sum = ditherError + (brightness & 0xFF);
+        step += sum >> 8;
+        ditherError = (uint8_t)sum;
+    } else {
+        step = (brightness + 128) >> 8;
+        ditherError = 0;
+    }
+
+    for (int i = 0; i < FACE_LEDS; i++) {
+        leds[i] = CRGB(level[i], level[i], level[i]);
+    }
+    counters.frames++;
+    if (lastFrameDithered) counters.ditherFrames++;
+    return step;
+}
+
+void TransitionEngine::recordFrameTime(uint32_t us) {
+    counters.lastFrameUs = us;
+    if (us > counters.maxFrameUs) counters.maxFrameUs = us;
+    counters.totalFrameUs += us;
+    if (lastFrameDithered) counters.ditherFrameUs += us;
+}
+
+size_t formatTransitionJson(char* buffer, size_t size, const TransitionEngine& engine) {
+    const TransitionStats& stats = engine.stats();
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .member("durationMs", engine.durationMs())
+        .member("frameMs", TRANSITION_FRAME_MS)
+        .member("active", engine.active())
+        .member("transitions", stats.transitions)
+        .member("frames", stats.frames)
+        .member("dropped", stats.dropped)
+        .key("frameUs").beginObject()
+            .member("last", stats.lastFrameUs)
+            .member("max", stats.maxFrameUs)
+            .member("avg", stats.frames ? (unsigned long)(stats.totalFrameUs / stats.frames) : 0UL)
+        .endObject();
+
+    // Share of the CPU (and LED bus, which show() waits on) dithering takes
+    unsigned long ditherAvg = stats.ditherFrames ? (unsigned long)(stats.ditherFrameUs / stats.ditherFrames) : 0UL;
+    json.key("dither").beginObject()
+        .member("below", engine.ditherBelow())
+        .member("active", engine.dithering())
+        .member("frameMs", TRANSITION_DITHER_MS)
+        .member("frames", stats.ditherFrames)
+        .member("avgFrameUs", ditherAvg)
+        .member("busyPercent", ditherAvg * 100.0 / (TRANSITION_DITHER_MS * 1000))
+        .endObject()
+        .endObject();
+    return json.ok() ? json.length() : 0;
+}
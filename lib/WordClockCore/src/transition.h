@@ -0,0 +1,141 @@
+/**
+ * Word Clock Core - Transitions
+ *
+ * Crossfades the face between frames and ramps the brightness, instead of
+ * cutting straight to the new phrase. Each LED carries an 8-bit level; a
+ * frame of a transition blends from the levels shown when it started to
+ * the target frame by an 8-bit fraction of the duration elapsed.
+ *
+ * Frames are only produced while something is changing. Once the fade and
+ * the brightness ramp have settled, due() stays false and nothing is
+ * pushed to the LEDs until the next target arrives (unless dithering,
+ * below). A new target during a fade starts from whatever is on the face
+ * at that moment, so transitions can be interrupted, and targets set
+ * between two frames coalesce into one.
+ *
+ * Brightness is 8.8 fixed point. The LEDs only take whole steps, which are
+ * coarse at the bottom of the range (5 and 6 differ by 20%), so below
+ * ditherBelow() a fractional brightness is shown by error diffusion over
+ * frames: each frame shows the whole step below or above, carrying the
+ * remainder to the next. That needs a steady refresh, so while the face is
+ * settled on a fraction it keeps drawing at TRANSITION_DITHER_MS; whole
+ * steps and brighter levels stay idle.
+ */
+
+#ifndef WORD_CLOCK_TRANSITION_H
+#define WORD_CLOCK_TRANSITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hal.h"
+#include "clock_face.h"
+
+#ifndef TRANSITION_FRAME_MS
+#define TRANSITION_FRAME_MS 16  // ~60 frames per second
+#endif
+
+#ifndef TRANSITION_DEFAULT_MS
+#define TRANSITION_DEFAULT_MS 800
+#endif
+
+#ifndef TRANSITION_DITHER_MS
+#define TRANSITION_DITHER_MS 8  // ~125 frames per second while dithering
+#endif
+
+#ifndef TRANSITION_DITHER_BELOW
+#define TRANSITION_DITHER_BELOW 32  // Dither brightness below this step (0 = never)
+#endif
+
+#define TRANSITION_MAX_MS 10000
+
+struct TransitionStats {
+    uint32_t transitions = 0;   // Fades and ramps started
+    uint32_t frames = 0;        // Frames pushed to the LEDs
+    uint32_t dropped = 0;       // Frame slots missed because a frame came late
+    uint32_t lastFrameUs = 0;   // Time to blend and show the latest frame
+    uint32_t maxFrameUs = 0;
+    uint64_t totalFrameUs = 0;
+    uint32_t ditherFrames = 0;    // Frames drawn only to dither a settled face
+    uint64_t ditherFrameUs = 0;   // Time spent on them
+};
+
+class TransitionEngine {
+public:
+    // Length of a fade or brightness ramp (0 = cut straight to the target)
+    void setDuration(uint32_t ms) { duration = ms < TRANSITION_MAX_MS ? ms : TRANSITION_MAX_MS; }
+    uint32_t durationMs() const { return duration; }
+
+    // Starts a fade to a new frame; the current target again is ignored
+    void setFrame(FrameMask target, uint32_t nowMs);
+
+    // Starts a ramp to an 8.8 fixed point brightness; the current target again is ignored
+    void setBrightness(uint16_t target, uint32_t nowMs);
+
+    // Brightness step below which fractions are dithered (0 = never)
+    void setDitherBelow(uint8_t step) { ditherLimit = step; }
+    uint8_t ditherBelow() const { return ditherLimit; }
+
+    // True while the brightness is low and between two steps
+    bool dithering() const { return brightness < (ditherLimit << 8) && (brightness & 0xFF) != 0; }
+
+    // True while a fade or ramp still has frames to show, or while dithering
+    bool active() const { return fading || ramping || dithering(); }
+
+    // True when active and the next frame slot has come
+    bool due(uint32_t nowMs) const { return active() && (int32_t)(nowMs - nextFrame) >= 0; }
+
+    // Milliseconds until the next frame slot (0 if due, the frame period if idle)
+    uint32_t msUntilNextFrame(uint32_t nowMs) const;
+
+    // Time between frames: TRANSITION_DITHER_MS while dithering, else TRANSITION_FRAME_MS
+    uint32_t framePeriod() const { return dithering() ? TRANSITION_DITHER_MS : TRANSITION_FRAME_MS; }
+
+    /**
+     * Blends the frame for `nowMs` into the LED buffer
+     * @return The whole brightness step to show the frame at
+     */
+    uint8_t render(uint32_t nowMs, CRGB* leds);
+
+    // Adds the time a frame took to blend and show, for the statistics
+    void recordFrameTime(uint32_t us);
+
+    FrameMask targetFrame() const { return toFrame; }
+    uint16_t targetBrightness() const { return toBrightness; }
+    const TransitionStats& stats() const { return counters; }
+    void resetStats() { counters = TransitionStats(); }
+
+private:
+    // 8-bit fraction (0-256) of the duration elapsed since `start`
+    uint16_t progress(uint32_t start, uint32_t nowMs) const;
+    void schedule(uint32_t nowMs);
+
+    uint32_t duration = TRANSITION_DEFAULT_MS;
+
+    uint8_t level[FACE_LEDS] = {};  // Level of each LED in the latest frame
+    uint8_t fromLevel[FACE_LEDS] = {};
+    FrameMask toFrame = 0;
+    uint32_t fadeStart = 0;
+    bool fading = false;
+
+    uint16_t brightness = 0;  // Brightness of the latest frame, 8.8 fixed point
+    uint16_t fromBrightness = 0;
+    uint16_t toBrightness = 0;
+    uint32_t rampStart = 0;
+    bool ramping = false;
+
+    uint8_t ditherLimit = TRANSITION_DITHER_BELOW;
+    uint8_t ditherError = 0;  // Fraction carried to the next frame
+    bool lastFrameDithered = false;
+
+    uint32_t nextFrame = 0;
+    TransitionStats counters;
+};
+
+/**
+ * Writes the /api/transition document: duration, state, frame and dithering
+ * statistics
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatTransitionJson(char* buffer, size_t size, const TransitionEngine& engine);
+
+#endif // WORD_CLOCK_TRANSITION_H
@@ -0,0 +1,33 @@
+/**
+ * Word Clock Core
+ *
+ * Hardware-independent clock logic shared by the firmware, the native
+ * build and the host tools. Nothing in this library may include
+ * WiFi, ezTime or WiFiManager; hardware access goes through hal.h.
+ */
+
+#ifndef WORD_CLOCK_CORE_H
+#define WORD_CLOCK_CORE_H
+
+#include "hal.h"
+#include "clock_face.h"
+#include "brightness.h"
+#include "transition.h"
+#include "light_histogram.h"
+#include "light_history.h"
+#include "double_buffer.h"
+#include "state_version.h"
+#include "rate_limit.h"
+#include "settings.h"
+#include "timezones.h"
+#include "posix_tz.h"
+#include "json_writer.h"
+#include "json_reader.h"
+#include "status.h"
+#include "status_binary.h"
+#include "health.h"
+#include "metrics.h"
+#include "firmware_update.h"
+#include "image_codec.h"
+
+#endif // WORD_CLOCK_CORE_H
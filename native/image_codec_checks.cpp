@@ -0,0 +1,171 @@
+/**
+ * Word Clock - Image decoder checks
+ *
+ * Feeds ImageDecoder (lib/WordClockCore/src/image_codec.h) hand-built
+ * streams: a few that must decode, and one for each way a stream from the
+ * network can be wrong, which must fail before anything outside the image
+ * is read or written. Each stream is fed whole and a byte at a time, so
+ * every state is also crossed at a call boundary.
+ *
+ * Run with: .pio/build/native/program --check-codec
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <word_clock_core.h>
+
+static const char* const BASE_MD5 = "00112233445566778899aabbccddeeff";
+static const std::string BASE = "0123456789abcdef";
+
+struct Decoded {
+    bool done = false;
+    bool failed = false;
+    const char* error = nullptr;
+    size_t consumed = 0;
+    std::string output;
+    bool refuseWrites = false;
+};
+
+static bool writeOutput(void* context, const uint8_t* data, size_t size) {
+    Decoded* decoded = (Decoded*)context;
+    if (decoded->refuseWrites) return false;
+    decoded->output.append((const char*)data, size);
+    return true;
+}
+
+static bool readBase(void*, uint32_t offset, uint8_t* buffer, size_t size) {
+    if (offset + size > BASE.size()) return false;
+    memcpy(buffer, BASE.data() + offset, size);
+    return true;
+}
+
+static std::string header(uint32_t imageSize, bool delta = false, int windowBits = IMAGE_WINDOW_BITS) {
+    std::string h("WCZ", 3);
+    h += (char)IMAGE_FORMAT_VERSION;
+    h += (char)(delta ? IMAGE_FLAG_DELTA : 0);
+    h += (char)windowBits;
+    h.append(2, '\0');
+    for (int i = 0; i < 4; i++) h += (char)(imageSize >> (8 * i));
+    uint32_t baseSize = delta ? BASE.size() : 0;
+    for (int i = 0; i < 4; i++) h += (char)(baseSize >> (8 * i));
+    for (int i = 0; i < 16; i++) h += delta ? (char)std::stoi(std::string(BASE_MD5 + 2 * i, 2), nullptr, 16) : '\0';
+    return h;
+}
+
+static std::string literals(const std::string& text) {
+    return std::string(1, (char)(text.size() - 1)) + text;
+}
+
+static std::string match(int length, int distance) {
+    std::string t(1, (char)(0x80 | (length - IMAGE_MATCH_MIN)));
+    t += (char)((distance - 1) & 0xFF);
+    t += (char)((distance - 1) >> 8);
+    return t;
+}
+
+// A base copy; offset is relative to the end of the last one, as the encoder writes it
+static std::string baseCopy(int offset, int length) {
+    std::string t(1, (char)IMAGE_TOKEN_BASE_COPY);
+    uint32_t zigzag = (uint32_t)((offset << 1) ^ (offset >> 31));
+    for (uint32_t v : {zigzag, (uint32_t)length}) {
+        for (; v >= 0x80; v >>= 7) t += (char)(v | 0x80);
+        t += (char)v;
+    }
+    return t;
+}
+
+static Decoded decode(const std::string& stream, size_t step, bool withBase, bool refuseWrites = false) {
+    static ImageDecoder decoder;  // 4 KB window
+    Decoded decoded;
+    decoded.refuseWrites = refuseWrites;
+    decoder.begin(writeOutput, withBase ? readBase : nullptr, &decoded, withBase ? BASE_MD5 : nullptr,
+                  withBase ? BASE.size() : 0);
+    const uint8_t* data = (const uint8_t*)stream.data();
+    while (decoded.consumed < stream.size() || decoder.pending()) {
+        size_t offered = std::min(step, stream.size() - decoded.consumed);
+        size_t used = decoder.feed(data + decoded.consumed, offered);
+        decoded.consumed += used;
+        if (decoder.failed() || (used < offered && !decoder.pending())) break;
+    }
+    decoded.done = decoder.done();
+    decoded.failed = decoder.failed();
+    decoded.error = decoder.error();
+    return decoded;
+}
+
+static int failures = 0;
+
+static void report(bool ok, const char* name, size_t step, const Decoded& d) {
+    if (ok) return;
+    failures++;
+    printf("FAIL %s (fed %s): done=%d failed=%d error=%s consumed=%zu output=\"%s\"\n", name,
+           step == 1 ? "a byte at a time" : "whole", d.done, d.failed, d.error ? d.error : "-", d.consumed,
+           d.output.c_str());
+}
+
+// The stream must decode to `expected`, consuming all of it
+static void expectImage(const char* name, const std::string& stream, const std::string& expected, bool withBase = false) {
+    for (size_t step : {stream.size(), (size_t)1}) {
+        Decoded d = decode(stream, step, withBase);
+        report(d.done && !d.failed && d.consumed == stream.size() && d.output == expected, name, step, d);
+    }
+}
+
+// The stream must fail with `error`, having written nothing past the image
+static void expectFailure(const char* name, const std::string& stream, const char* error, bool withBase = false,
+                          bool refuseWrites = false) {
+    for (size_t step : {stream.size(), (size_t)1}) {
+        Decoded d = decode(stream, step, withBase, refuseWrites);
+        report(d.failed && d.error && !strcmp(d.error, error), name, step, d);
+    }
+}
+
+int checkImageCodec() {
+    std::string hello = header(10) + literals("hello") + match(5, 5);
+    expectImage("literals and a match", hello, "hellohello");
+    expectImage("overlapping match", header(8) + literals("ab") + match(6, 2), "abababab");
+    expectImage("delta", header(12, true) + baseCopy(4, 8) + literals("XY") + baseCopy(-12, 2), "456789abXY01", true);
+
+    // A stream cut short is neither done nor failed; the caller must notice
+    for (size_t step : {hello.size() - 1, (size_t)1}) {
+        Decoded d = decode(hello.substr(0, hello.size() - 1), step, false);
+        report(!d.done && !d.failed && d.consumed == hello.size() - 1, "truncated stream", step, d);
+    }
+    // Bytes after the image are left unconsumed; the caller must notice
+    for (size_t step : {hello.size() + 1, (size_t)1}) {
+        Decoded d = decode(hello + "!", step, false);
+        report(d.done && d.consumed == hello.size() && d.output == "hellohello", "trailing data", step, d);
+    }
+
+    expectFailure("bad magic", "WCX" + header(10).substr(3) + literals("hello"), "Not an encoded image");
+    expectFailure("window too large", header(10, false, IMAGE_WINDOW_BITS + 1) + literals("hello"),
+                  "Image window too large");
+    expectFailure("empty image", header(0), "Empty image");
+    expectFailure("invalid token", header(10) + "\xC1", "Invalid token");
+    expectFailure("match before the image", header(10) + literals("ab") + match(5, 3),
+                  "Match before the start of the image");
+    std::string long300 = literals(std::string(128, 'a')) + literals(std::string(128, 'b')) + literals(std::string(44, 'c'));
+    expectFailure("match beyond the window", header(310, false, 8) + long300 + match(10, 257),
+                  "Match before the start of the image");
+    expectFailure("literals past the image", header(4) + literals("hello"), "Image longer than its header says");
+    expectFailure("match past the image", header(6) + literals("ab") + match(5, 2), "Image longer than its header says");
+    expectFailure("base copy in a plain image", header(8) + baseCopy(0, 8), "Base copy in a plain image");
+    expectFailure("delta without a base", header(8, true) + baseCopy(0, 8), "Delta without a base image");
+    std::string otherBase = header(8, true);
+    otherBase[16] ^= 1;
+    expectFailure("delta for another image", otherBase + baseCopy(0, 8), "Delta is for another image", true);
+    expectFailure("base copy past the base", header(8, true) + baseCopy(10, 8), "Base copy outside the base image", true);
+    expectFailure("base copy before the base", header(8, true) + baseCopy(-1, 4), "Base copy outside the base image",
+                  true);
+    expectFailure("empty base copy", header(8, true) + baseCopy(0, 0), "Base copy outside the base image", true);
+    expectFailure("base copy past the image", header(4, true) + baseCopy(0, 8), "Image longer than its header says",
+                  true);
+    expectFailure("varint over five bytes", header(8, true) + "\xC0\xFF\xFF\xFF\xFF\xFF\x01",
+                  "Invalid varint", true);
+    expectFailure("varint past 32 bits", header(8, true) + "\xC0\x80\x80\x80\x80\x10", "Invalid varint", true);
+    expectFailure("write refused", hello, "Image write failed", false, true);
+
+    printf("Image codec: %d failure%s\n", failures, failures == 1 ? "" : "s");
+    return failures;
+}
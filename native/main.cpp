@@ -0,0 +1,65 @@
+/**
+ * Word Clock - Native build entry point
+ *
+ * Runs the clock core on the host and prints what the face would show.
+ * --check-codec instead runs the image decoder checks
+ * (image_codec_checks.cpp) and exits non-zero if any fails.
+ *
+ * Usage: program [HH:MM]   (defaults to the current local time)
+ *        program --check-codec
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <word_clock_core.h>
+
+int checkImageCodec();
+
+/**
+ * Host wall clock in the local timezone
+ */
+class SystemClock : public ClockSource {
+public:
+    time_t now() override {
+        time_t utc = time(nullptr);
+        struct tm local;
+        localtime_r(&utc, &local);
+        return utc + local.tm_gmtoff;
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc > 1 && !strcmp(argv[1], "--check-codec")) return checkImageCodec() ? 1 : 0;
+
+    int hour, minute;
+    if (argc > 1) {
+        if (sscanf(argv[1], "%d:%d", &hour, &minute) != 2 || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+            fprintf(stderr, "usage: %s [HH:MM | --check-codec]\n", argv[0]);
+            return 2;
+        }
+    } else {
+        SystemClock clock;
+        time_t localTime = clock.now();
+        hour = hourOf(localTime);
+        minute = minuteOf(localTime);
+    }
+
+    FaceTime rounded = roundTime(hour, minute);
+    FrameMask frame = frameFor(rounded);
+
+    printf("%02d:%02d -> %02d:%02d:", hour, minute, rounded.hour, rounded.minute);
+    for (int w = 0; w < WORD_COUNT; w++) {
+        // Each word is lit as a whole, so checking its first LED is enough
+        if ((frame >> WORDS[w][0]) & 1) printf(" %s", WORD_NAMES[w]);
+    }
+    printf("\n\n");
+
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            printf(" %s", (frame >> ledAt(row, col)) & 1 ? "#" : ".");
+        }
+        printf("\n");
+    }
+    return 0;
+}
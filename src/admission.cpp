@@ -0,0 +1,107 @@
+/**
+ * Word Clock - Request admission
+ */
+
+#include "admission.h"
+#include "log.h"
+
+struct RoutePolicy {
+    TraceRoute route;
+    RateLimit limit;  // Per client
+};
+
+// Pages and the JavaScript they load are cheap and fetched in bursts;
+// anything that writes flash or freezes a ring buffer is kept slow
+static const RoutePolicy POLICIES[] = {
+    {TRACE_ROUTE_OTHER,           {20, 240}},
+    {TRACE_ROUTE_FAVICON,         {10, 60}},
+    {TRACE_ROUTE_BRIGHTNESS_PAGE, {10, 60}},
+    {TRACE_ROUTE_STATUS,          {10, 150}}, // A tab asks at most once a second; two tabs and a save
+    {TRACE_ROUTE_SAVE_BRIGHTNESS, {5, 30}},
+    {TRACE_ROUTE_TRACE,           {2, 6}},
+    {TRACE_ROUTE_PROFILE,         {5, 30}},
+    {TRACE_ROUTE_HEALTH,          {10, 120}},
+    {TRACE_ROUTE_CURVE,           {10, 60}},
+    {TRACE_ROUTE_TRANSITION,      {10, 60}},
+    {TRACE_ROUTE_LIGHT,           {10, 60}},
+    {TRACE_ROUTE_SETTINGS,        {10, 60}},
+    {TRACE_ROUTE_STATUS_BIN,      {10, 120}},
+    {TRACE_ROUTE_WAIT,            {10, 120}},
+    {TRACE_ROUTE_FRAME,           {10, 120}},
+    {TRACE_ROUTE_ADMISSION,       {10, 60}},
+    {TRACE_ROUTE_METRICS,         {5, 30}},   // Scraped every 15 s or slower
+    {TRACE_ROUTE_UPDATE,          {5, 30}},
+};
+
+#define POLICY_COUNT (sizeof(POLICIES) / sizeof(POLICIES[0]))
+#define REFUSAL_LOG_MS 10000  // A client refused again on the same route is logged at most this often
+
+struct RouteCounts {
+    uint32_t admitted;
+    uint32_t rejected;
+    uint32_t loggedClient;  // Last refusal logged, and when
+    uint32_t loggedAt;
+    uint32_t unlogged;      // Refusals since then
+};
+
+static RateLimiter limiter;
+static RouteCounts counts[POLICY_COUNT];
+
+static size_t policyFor(TraceRoute route) {
+    for (size_t i = 0; i < POLICY_COUNT; i++) {
+        if (POLICIES[i].route == route) return i;
+    }
+    return 0;
+}
+
+bool admitRequest(WebServer& server, TraceRoute route) {
+    size_t policy = policyFor(route);
+    IPAddress ip = server.client().remoteIP();
+    uint32_t waitMs = limiter.admit((uint32_t)ip, route, POLICIES[policy].limit, millis());
+    if (waitMs == 0) {
+        counts[policy].admitted++;
+        return true;
+    }
+
+    // Log each new client refused on a route at once, and repeats once per REFUSAL_LOG_MS
+    RouteCounts& c = counts[policy];
+    c.rejected++;
+    if ((uint32_t)ip != c.loggedClient || millis() - c.loggedAt >= REFUSAL_LOG_MS) {
+        LOG_INFO(LOG_CAT_HTTP, "Rate limited %u.%u.%u.%u on %s (%lu unlogged before)", ip[0], ip[1], ip[2], ip[3],
+                 TRACE_ROUTE_NAMES[route], (unsigned long)c.unlogged);
+        c.loggedClient = (uint32_t)ip;
+        c.loggedAt = millis();
+        c.unlogged = 0;
+    } else {
+        c.unlogged++;
+    }
+    char retryAfter[12];
+    snprintf(retryAfter, sizeof(retryAfter), "%lu", (unsigned long)(waitMs + 999) / 1000);
+    metricAdd(METRIC_RATE_LIMITED);
+    metricHttpResponse(route, 429);
+    server.sendHeader("Retry-After", retryAfter);
+    server.send(429, "text/plain", "Too many requests");
+    return false;
+}
+
+size_t formatAdmissionJson(char* buffer, size_t size) {
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .member("clients", limiter.clients())
+        .key("routes").beginObject();
+    for (size_t i = 0; i < POLICY_COUNT; i++) {
+        json.key(TRACE_ROUTE_NAMES[POLICIES[i].route]).beginObject()
+            .member("burst", POLICIES[i].limit.burst)
+            .member("perMinute", POLICIES[i].limit.perMinute)
+            .member("admitted", counts[i].admitted)
+            .member("rejected", counts[i].rejected)
+            .endObject();
+    }
+    json.endObject().endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+void admissionReset() {
+    limiter.reset();
+    for (RouteCounts& c : counts) c = {};
+}
@@ -0,0 +1,35 @@
+/**
+ * Word Clock - Request admission
+ *
+ * The web server runs in the loop task, so every request it serves holds
+ * up the next frame, the brightness update and OTA. Each traced route has
+ * a token bucket per client address (see rate_limit.h): a client over the
+ * route's limit is answered 429 with Retry-After and its handler never
+ * runs, so one misbehaving script or a few fast-polling tabs cannot starve
+ * the loop. Admitted and rejected requests are counted per route and
+ * served by /api/admission.
+ */
+
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include <WebServer.h>
+#include <word_clock_core.h>
+#include "trace.h"
+
+/**
+ * Charges the request being served to its client's bucket for `route`
+ * @return false if it was refused, with a 429 already sent
+ */
+bool admitRequest(WebServer& server, TraceRoute route);
+
+/**
+ * Writes every route's limit and counts as JSON
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatAdmissionJson(char* buffer, size_t size);
+
+// Zeroes the counts and forgets every client's bucket
+void admissionReset();
+
+#endif // ADMISSION_H
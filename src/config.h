@@ -18,6 +18,7 @@
 // WiFi Configuration
 #define WIFI_AP_NAME "WordClock-AP"      // Name when in AP mode
 #define WIFI_AP_PASSWORD "password123"    // Password when in AP mode
+#define WIFI_RETRY_MS 30000               // Rejoin attempts after booting offline
 
 // Over-the-Air (OTA) Update Configuration
 #define OTA_HOSTNAME "wordclock"          // Hostname for OTA updates
@@ -12,6 +12,7 @@
 // WiFi Configuration
 #define WIFI_AP_NAME "WordClock-AP"     // Name when in AP mode
 #define WIFI_AP_PASSWORD "password123"   // Password when in AP mode
+#define WIFI_RETRY_MS 30000              // Rejoin attempts after booting offline
 
 // Over-the-Air (OTA) Update Configuration
 #define OTA_HOSTNAME "wordclock"         // Hostname for OTA updates
@@ -21,4 +22,11 @@
 #define DEFAULT_WIFI_SSID ""             // Leave empty to force portal
 #define DEFAULT_WIFI_PASSWORD ""         // Leave empty to force portal
 
+// Debug Configuration
+#define DEBUG_LEVEL 0  // 0=minimal, 1=normal, 2=verbose
+// #define LOG_CATEGORIES 0xFF  // Bitmask of log categories to compile in (see log.h)
+
+// Timezone Configuration (the timezone setting's default)
+#define DEFAULT_TIMEZONE "Australia/Sydney"  // See: https://en.wikipedia.org/wiki/List_of_tz_database_time_zones
+
 #endif 
\ No newline at end of file
@@ -0,0 +1,72 @@
+/**
+ * Word Clock - Stack and heap health monitor
+ */
+
+#include "health_monitor.h"
+#include "log.h"
+
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+// Tasks watched: ours, Arduino's and the network stack's
+static const char* const HEALTH_TASKS[HEALTH_MAX_TASKS] = {
+    "loopTask",        // setup(), loop() and every web handler
+    "log",             // Deferred log drain (log.cpp)
+    "tiT",             // lwIP TCP/IP
+    "wifi",
+    "sys_evt",         // ESP-IDF default event loop
+    "arduino_events",  // WiFi.onEvent callbacks
+    "esp_timer",
+    "IDLE",
+};
+
+HealthMonitor healthMonitor(HEALTH_TASKS, HEALTH_MAX_TASKS);
+
+static void takeSample(HealthSample& sample) {
+    sample.uptimeMs = millis();
+#ifdef ESP_PLATFORM
+    sample.freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    sample.minFreeHeap = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    sample.largestFreeBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    for (int t = 0; t < HEALTH_MAX_TASKS; t++) {
+        TaskHandle_t task = xTaskGetHandle(HEALTH_TASKS[t]);
+        // ESP-IDF stacks are in bytes, so the high-water mark is too
+        sample.stackFree[t] = task ? uxTaskGetStackHighWaterMark(task) : HEALTH_TASK_MISSING;
+    }
+#else
+    sample.freeHeap = sample.minFreeHeap = sample.largestFreeBlock = ESP.getFreeHeap();
+    for (int t = 0; t < HEALTH_MAX_TASKS; t++) sample.stackFree[t] = HEALTH_TASK_MISSING;
+#endif
+}
+
+void healthPoll() {
+    static uint32_t lastSample = 0;
+    static bool sampled = false;
+    uint32_t now = millis();
+    if (sampled && now - lastSample < HEALTH_INTERVAL_MS) return;
+    sampled = true;
+    lastSample = now;
+
+    HealthSample sample;
+    takeSample(sample);
+    uint8_t raised = healthMonitor.record(sample);
+    if (raised & HEALTH_ALERT_STACK) {
+        for (int t = 0; t < healthMonitor.taskCount(); t++) {
+            if (sample.stackFree[t] < healthMonitor.limits().minStackFree) {
+                LOG_ERROR(LOG_CAT_SYSTEM, "Health: task %s has %u bytes of stack left", HEALTH_TASKS[t], sample.stackFree[t]);
+            }
+        }
+    }
+    if (raised & HEALTH_ALERT_HEAP_LOW) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Health: free heap low (%u bytes)", sample.freeHeap);
+    }
+    if (raised & HEALTH_ALERT_FRAGMENTATION) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Health: heap fragmented (largest block %u of %u free)", sample.largestFreeBlock, sample.freeHeap);
+    }
+    if (raised & HEALTH_ALERT_HEAP_TREND) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Health: free heap falling %d bytes/hour", healthMonitor.heapTrendPerHour());
+    }
+}
@@ -0,0 +1,24 @@
+/**
+ * Word Clock - Stack and heap health monitor
+ *
+ * Samples each known FreeRTOS task's stack high-water mark and the heap
+ * (free, minimum ever free, largest free block) every HEALTH_INTERVAL_MS
+ * into the core's HealthMonitor ring. New alerts are logged; the state is
+ * served by /api/health and the ring by /api/health/history.
+ */
+
+#ifndef HEALTH_MONITOR_H
+#define HEALTH_MONITOR_H
+
+#include <word_clock_core.h>
+
+#ifndef HEALTH_INTERVAL_MS
+#define HEALTH_INTERVAL_MS 60000  // One hour of history with HEALTH_HISTORY 60
+#endif
+
+extern HealthMonitor healthMonitor;
+
+// Takes a sample when one is due; call from loop()
+void healthPoll();
+
+#endif // HEALTH_MONITOR_H
@@ -0,0 +1,67 @@
+/**
+ * Word Clock - Adaptive light sensor calibration
+ */
+
+#include "light_calibration.h"
+#include "log.h"
+
+#include <Preferences.h>
+
+#define LIGHT_NVS_NAMESPACE "light"
+#define LIGHT_NVS_KEY "hist"
+
+LightHistogram lightHistogram;
+
+static bool dirty = false;
+static uint32_t lastSave = 0;
+
+static void save() {
+    Preferences prefs;
+    if (!prefs.begin(LIGHT_NVS_NAMESPACE, false)) {
+        LOG_ERROR(LOG_CAT_SENSOR, "Light histogram: NVS unavailable");
+        return;
+    }
+    size_t written = prefs.putBytes(LIGHT_NVS_KEY, lightHistogram.data(), LightHistogram::dataSize());
+    prefs.end();
+    if (written != LightHistogram::dataSize()) {
+        LOG_ERROR(LOG_CAT_SENSOR, "Light histogram: save failed");
+        return;
+    }
+    dirty = false;
+    lastSave = millis();
+    LOG_DEBUG(LOG_CAT_SENSOR, "Light histogram saved (%lu samples)", (unsigned long)lightHistogram.total());
+}
+
+void lightCalibrationBegin() {
+    static uint16_t buffer[LIGHT_HIST_HOURS][LIGHT_HIST_BINS];
+    Preferences prefs;
+    if (prefs.begin(LIGHT_NVS_NAMESPACE, true)) {
+        size_t size = prefs.getBytes(LIGHT_NVS_KEY, buffer, sizeof(buffer));
+        prefs.end();
+        if (lightHistogram.load(buffer, size)) {
+            LOG_INFO(LOG_CAT_SENSOR, "Light histogram loaded (%lu samples)", (unsigned long)lightHistogram.total());
+        }
+    }
+    lastSave = millis();
+}
+
+void lightCalibrationPoll(int lightLevel, int hour) {
+    static uint32_t lastSample = 0;
+    static bool sampled = false;
+    uint32_t now = millis();
+
+    if (hour >= 0 && (!sampled || now - lastSample >= LIGHT_HIST_INTERVAL_MS)) {
+        sampled = true;
+        lastSample = now;
+        lightHistogram.record(hour, lightLevel);
+        dirty = true;
+    }
+    if (dirty && now - lastSave >= LIGHT_HIST_SAVE_MS) {
+        save();
+    }
+}
+
+void lightCalibrationReset() {
+    lightHistogram.clear();
+    save();
+}
@@ -0,0 +1,41 @@
+/**
+ * Word Clock - Adaptive light sensor calibration
+ *
+ * Feeds the filtered light level into the core's LightHistogram once every
+ * LIGHT_HIST_INTERVAL_MS, against the local hour, and keeps the table in
+ * NVS across reboots. Writes are coalesced: the table is saved at most
+ * once per LIGHT_HIST_SAVE_MS, and only when it has changed, so flash
+ * wear stays at a couple of dozen small writes a day.
+ *
+ * The learned distribution and suggested breakpoints are served by
+ * /api/light/histogram.
+ */
+
+#ifndef LIGHT_CALIBRATION_H
+#define LIGHT_CALIBRATION_H
+
+#include <word_clock_core.h>
+
+#ifndef LIGHT_HIST_INTERVAL_MS
+#define LIGHT_HIST_INTERVAL_MS 60000  // One sample a minute
+#endif
+
+#ifndef LIGHT_HIST_SAVE_MS
+#define LIGHT_HIST_SAVE_MS 3600000  // Save a changed table at most hourly
+#endif
+
+extern LightHistogram lightHistogram;
+
+// Loads the saved table; call once from setup()
+void lightCalibrationBegin();
+
+/**
+ * Records a light level when a sample is due, and saves when a write is due
+ * @param hour Local hour, or -1 while the time is not known
+ */
+void lightCalibrationPoll(int lightLevel, int hour);
+
+// Clears the table, in RAM and in NVS
+void lightCalibrationReset();
+
+#endif // LIGHT_CALIBRATION_H
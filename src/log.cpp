@@ -0,0 +1,52 @@
+/**
+ * Word Clock - Deferred Logging drain task
+ */
+
+#include "log.h"
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/ringbuf.h>
+#include <freertos/task.h>
+
+#define LOG_TASK_STACK 2048
+#define LOG_TASK_PRIORITY 1  // Just above idle, below the loop task
+
+static RingbufHandle_t logRing = nullptr;
+static std::atomic<uint32_t> logDropCount{0};
+
+/**
+ * Writes queued records to Serial as they arrive
+ */
+static void logDrainTask(void*) {
+    for (;;) {
+        size_t length = 0;
+        uint8_t* payload = (uint8_t*)xRingbufferReceive(logRing, &length, portMAX_DELAY);
+        if (!payload) continue;
+
+        uint8_t checksum = 0;
+        for (size_t i = 0; i < length; i++) checksum += payload[i];
+        const uint8_t header[] = {LOG_SYNC0, LOG_SYNC1, (uint8_t)length};
+        Serial.write(header, sizeof(header));
+        Serial.write(payload, length);
+        Serial.write(checksum);
+
+        vRingbufferReturnItem(logRing, payload);
+    }
+}
+
+void logBegin() {
+    if (logRing) return;
+    logRing = xRingbufferCreate(LOG_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    if (!logRing) return;
+    xTaskCreate(logDrainTask, "log", LOG_TASK_STACK, nullptr, LOG_TASK_PRIORITY, nullptr);
+}
+
+void logSubmit(const uint8_t* payload, size_t length) {
+    if (!logRing || xRingbufferSend(logRing, payload, length, 0) != pdTRUE) {
+        logDropCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint32_t logDropped() {
+    return logDropCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,188 @@
+/**
+ * Word Clock - Deferred Logging
+ *
+ * Compile-time filtered logging that keeps formatting off the device:
+ * - Statements below LOG_LEVEL or outside LOG_CATEGORIES are discarded by
+ *   the compiler, arguments and format string included
+ * - Enabled statements copy the format string's address, a timestamp and
+ *   the raw arguments into a ring buffer; no printf runs on the caller
+ * - A low-priority task drains the ring to Serial as framed binary records
+ * - tools/logdecode.cpp looks the format strings up in firmware.elf and
+ *   turns the records back into text
+ *
+ * Usage:
+ *   LOG_INFO(LOG_CAT_DISPLAY, "Time updating: %02d:%02d", hours, minutes);
+ *
+ * Supported arguments: integers (up to 64 bits), enums, float/double,
+ * const char* and String. Strings are copied, truncated to LOG_MAX_STRING.
+ *
+ * Record layout on the wire (all little-endian):
+ *   0xA5 0x5A <length> <payload: length bytes> <checksum: sum of payload bytes>
+ *   payload = <format address u32> <millis u32> <level << 4 | category u8> <args>
+ *   arg     = <LogArgTag u8> <value: 4 or 8 bytes | string: length u8 + bytes>
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "config.h"
+
+// Levels
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+#define LOG_LEVEL_VERBOSE 4
+
+// Categories (bit numbers in LOG_CATEGORIES)
+#define LOG_CAT_SYSTEM 0
+#define LOG_CAT_DISPLAY 1
+#define LOG_CAT_SENSOR 2
+#define LOG_CAT_HTTP 3
+#define LOG_CAT_NET 4
+#define LOG_CAT_OTA 5
+
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL 0
+#endif
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL (LOG_LEVEL_INFO + DEBUG_LEVEL)  // DEBUG_LEVEL 0=info, 1=debug, 2=verbose
+#endif
+
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES 0xFF  // Bitmask of enabled categories
+#endif
+
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 2048  // Bytes of records waiting for the drain task
+#endif
+
+#define LOG_MAX_RECORD 96  // Largest payload of a single record
+#define LOG_MAX_STRING 32  // Longest string argument kept
+
+#define LOG_SYNC0 0xA5
+#define LOG_SYNC1 0x5A
+
+#define LOG_ENABLED(level, category) \
+    ((level) <= LOG_LEVEL && (LOG_CATEGORIES & (1u << (category))) != 0)
+
+#define LOG_AT(level, category, fmt, ...) \
+    do { \
+        if constexpr (LOG_ENABLED(level, category)) { \
+            logWrite(((level) << 4) | (category), fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_ERROR(category, fmt, ...) LOG_AT(LOG_LEVEL_ERROR, category, fmt, ##__VA_ARGS__)
+#define LOG_INFO(category, fmt, ...) LOG_AT(LOG_LEVEL_INFO, category, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(category, fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, category, fmt, ##__VA_ARGS__)
+#define LOG_VERBOSE(category, fmt, ...) LOG_AT(LOG_LEVEL_VERBOSE, category, fmt, ##__VA_ARGS__)
+
+// Argument type tags - part of the wire format
+enum LogArgTag : uint8_t {
+    LOG_ARG_INT32 = 1,
+    LOG_ARG_INT64 = 2,
+    LOG_ARG_FLOAT = 3,
+    LOG_ARG_STRING = 4,
+};
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+// Starts the drain task; records logged before this are dropped
+void logBegin();
+
+// Queues an encoded payload for the drain task (never blocks)
+void logSubmit(const uint8_t* payload, size_t length);
+
+// Number of records dropped because the ring was full
+uint32_t logDropped();
+
+namespace logdetail {
+
+struct Encoder {
+    uint8_t buffer[LOG_MAX_RECORD];
+    size_t length = 0;
+
+    void put(const void* data, size_t n) {
+        if (length + n > sizeof(buffer)) {
+            length = sizeof(buffer) + 1;  // Mark as overflowed
+            return;
+        }
+        memcpy(buffer + length, data, n);
+        length += n;
+    }
+
+    void putTagged(uint8_t tag, const void* data, size_t n) {
+        put(&tag, 1);
+        put(data, n);
+    }
+
+    void putString(const char* s) {
+        if (!s) s = "(null)";
+        uint8_t n = 0;
+        while (n < LOG_MAX_STRING && s[n]) n++;  // strnlen, without GCC's overread warning on short literals
+        uint8_t tag = LOG_ARG_STRING;
+        put(&tag, 1);
+        put(&n, 1);
+        put(s, n);
+    }
+};
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+encode(Encoder& e, T value) {
+    if (sizeof(T) <= 4) {
+        uint32_t v = std::is_signed<T>::value ? (uint32_t)(int32_t)value : (uint32_t)value;
+        e.putTagged(LOG_ARG_INT32, &v, sizeof(v));
+    } else {
+        uint64_t v = (uint64_t)value;
+        e.putTagged(LOG_ARG_INT64, &v, sizeof(v));
+    }
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+encode(Encoder& e, T value) {
+    float v = value;
+    e.putTagged(LOG_ARG_FLOAT, &v, sizeof(v));
+}
+
+inline void encode(Encoder& e, const char* s) { e.putString(s); }
+inline void encode(Encoder& e, const String& s) { e.putString(s.c_str()); }
+
+inline void encodeAll(Encoder&) {}
+
+template <typename T, typename... Rest>
+void encodeAll(Encoder& e, const T& first, const Rest&... rest) {
+    encode(e, first);
+    encodeAll(e, rest...);
+}
+
+} // namespace logdetail
+
+/**
+ * Encodes one record and hands it to the drain task.
+ * Called through the LOG_* macros only.
+ */
+template <typename... Args>
+void logWrite(uint8_t levelCategory, const char* fmt, const Args&... args) {
+    logdetail::Encoder e;
+    uint32_t address = (uint32_t)(uintptr_t)fmt;
+    uint32_t now = millis();
+    e.put(&address, sizeof(address));
+    e.put(&now, sizeof(now));
+    e.put(&levelCategory, 1);
+    logdetail::encodeAll(e, args...);
+    if (e.length <= sizeof(e.buffer)) {
+        logSubmit(e.buffer, e.length);
+    }
+}
+
+#endif // ARDUINO
+
+#endif // LOG_H
@@ -0,0 +1,101 @@
+/**
+ * Word Clock - Long polling
+ */
+
+#include "long_poll.h"
+#include "log.h"
+#include "trace.h"
+
+StateVersion stateVersion;
+
+struct Waiter {
+    WiFiClient client;
+    uint32_t address;
+    uint32_t since;
+    uint32_t startMs;
+    uint32_t timeoutMs;
+};
+
+static Waiter waiters[LONG_POLL_MAX_WAITERS];
+
+static void answer(WiFiClient& client, uint32_t since, bool timedOut) {
+    char json[96];
+    size_t length = formatStateJson(json, sizeof(json), stateVersion, since, timedOut);
+    int code = length ? 200 : 500;  // 0: did not fit
+    if (!length) length = snprintf(json, sizeof(json), "Response did not fit its buffer");
+    char head[160];
+    int n = snprintf(head, sizeof(head),
+                     "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\n"
+                     "Cache-Control: no-store\r\nConnection: close\r\n\r\n",
+                     code, code == 200 ? "OK" : "Internal Server Error", code == 200 ? "application/json" : "text/plain",
+                     (unsigned)length);
+    client.write((const uint8_t*)head, n);
+    client.write((const uint8_t*)json, length);
+    client.stop();
+    metricHttpResponse(TRACE_ROUTE_WAIT, code);
+}
+
+void longPollRequest(WebServer& server) {
+    uint32_t since = server.hasArg("since") ? strtoul(server.arg("since").c_str(), nullptr, 10) : stateVersion.version();
+    uint32_t timeout = LONG_POLL_DEFAULT_MS;
+    if (server.hasArg("timeout")) {
+        long ms = server.arg("timeout").toInt();
+        if (ms < 0 || ms > LONG_POLL_MAX_MS) {
+            metricHttpResponse(TRACE_ROUTE_WAIT, 400);
+            server.send(400, "text/plain", "timeout must be 0-60000");
+            return;
+        }
+        timeout = ms;
+    }
+
+    if (since != stateVersion.version() || timeout == 0) {
+        char json[96];
+        size_t length = formatStateJson(json, sizeof(json), stateVersion, since, since == stateVersion.version());
+        if (!length) {
+            metricHttpResponse(TRACE_ROUTE_WAIT, 500);
+            server.send(500, "text/plain", "Response did not fit its buffer");
+            return;
+        }
+        metricHttpResponse(TRACE_ROUTE_WAIT, 200);
+        server.sendHeader("Cache-Control", "no-store");
+        server.send_P(200, "application/json", json, length);
+        return;
+    }
+
+    WiFiClient client = server.client();
+    uint32_t address = client.remoteIP();
+    Waiter* slot = nullptr;
+    int waiting = 0, fromClient = 0;
+    for (Waiter& w : waiters) {
+        if (!w.client) {
+            slot = &w;
+            continue;
+        }
+        waiting++;
+        if (w.address == address) fromClient++;
+    }
+    if (!slot || fromClient >= LONG_POLL_MAX_PER_CLIENT) {
+        LOG_DEBUG(LOG_CAT_HTTP, "Long poll refused: %d waiting, %d from this client", waiting, fromClient);
+        metricHttpResponse(TRACE_ROUTE_WAIT, 429);
+        server.sendHeader("Retry-After", LONG_POLL_RETRY_AFTER);
+        server.send(429, "text/plain", "Too many waiting requests");
+        return;
+    }
+
+    // Send nothing: the server lets go of the connection, the copy keeps it open
+    *slot = {client, address, since, millis(), timeout};
+}
+
+void longPollService() {
+    uint32_t now = millis();
+    for (Waiter& w : waiters) {
+        if (!w.client) continue;
+        if (w.since != stateVersion.version()) {
+            answer(w.client, w.since, false);
+        } else if (now - w.startMs >= w.timeoutMs) {
+            answer(w.client, w.since, true);
+        } else if (!w.client.connected()) {
+            w.client.stop();  // Gave up waiting
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/**
+ * Word Clock - Long polling
+ *
+ * GET /api/wait?since=N&timeout=ms answers as soon as the state version
+ * (see state_version.h) differs from N, or with "timeout":true when the
+ * timeout runs out. A request that has to wait is parked: the handler keeps
+ * its connection and returns, so the web server and the main loop carry
+ * on, and longPollService() answers it from the loop once the version
+ * moves. At most LONG_POLL_MAX_WAITERS requests are parked, and at most
+ * LONG_POLL_MAX_PER_CLIENT from one address, so one client cannot hold
+ * every slot; a request that would need one more slot is answered 429.
+ */
+
+#ifndef LONG_POLL_H
+#define LONG_POLL_H
+
+#include <WebServer.h>
+#include <word_clock_core.h>
+
+#ifndef LONG_POLL_MAX_WAITERS
+#define LONG_POLL_MAX_WAITERS 4  // Each holds a socket; lwIP has 16
+#endif
+
+#ifndef LONG_POLL_MAX_PER_CLIENT
+#define LONG_POLL_MAX_PER_CLIENT 2  // A page and one more tab
+#endif
+
+#define LONG_POLL_RETRY_AFTER "5"  // Seconds, when no slot is free
+
+#define LONG_POLL_DEFAULT_MS 25000
+#define LONG_POLL_MAX_MS 60000
+
+extern StateVersion stateVersion;
+
+// Handles GET /api/wait on `server`
+void longPollRequest(WebServer& server);
+
+// Answers parked requests whose version moved or whose time is up; call from loop()
+void longPollService();
+
+#endif // LONG_POLL_H
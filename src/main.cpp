@@ -41,6 +41,16 @@
 #include "config.h"
 #include <ArduinoOTA.h>
 #include "favicon.h"
+#include "trace.h"
+#include "profiler.h"
+#include "health_monitor.h"
+#include "light_calibration.h"
+#include "settings_store.h"
+#include "long_poll.h"
+#include "admission.h"
+#include "pull_update.h"
+#include "log.h"
+#include <word_clock_core.h>
 
 // LED configuration
 CRGB leds[NUM_LEDS];
@@ -51,17 +61,41 @@ Timezone Australia;
 // Add WiFiManager instance
 WiFiManager wm;
 
-// Add brightness settings structure
-struct BrightnessSettings {
-    int darkBrightness = 5;     // Changed from 20
-    int lightBrightness = 25;   // Changed from 255
-    int threshold = 2600;       // Changed from 2000
-} brightnessSettings;
+/**
+ * User settings (see settings.h). HTTP handlers publish new versions;
+ * applySettings() picks them up on the display side, so nothing reads a
+ * half-written change.
+ */
+static ClockSettings defaultSettings() {
+    setDefaultTimezone(DEFAULT_TIMEZONE);  // The schema's default too
+    return ClockSettings();
+}
+DoubleBuffer<ClockSettings> settings(defaultSettings());
+
+// Light level -> brightness curve (see lib/WordClockCore/src/brightness.h)
+BrightnessController brightnessController;
+
+// Crossfades between phrases and ramps brightness (see transition.h)
+TransitionEngine transitions;
+
+// Light level and brightness over the last week (see light_history.h)
+LightHistory lightHistory;
+
+// Rounded time the face was last set to (0xFF until the first frame)
+FaceTime shownTime = {0xFF, 0xFF};
 
 // Add function declarations at the top with others
+extern ClockSource* clockSource;
 int readLightLevel();
+int lastLightLevel = 0;  // From the last brightness update, for handlers
+uint32_t uptimeSeconds();
 void updateBrightness();
 void bindServerCallback();
+void showLeds();
+void serviceTransitions();
+void applySettings();
+bool resolveTimezone(const char* name);
+bool applyTimezone(const char* name);
 
 // Add OTA setup function
 void setupOTA() {
@@ -69,29 +103,33 @@ void setupOTA() {
     ArduinoOTA.setPassword(OTA_PASSWORD);
     
     ArduinoOTA.onStart([]() {
-        Serial.println("OTA: Start");
+        LOG_INFO(LOG_CAT_OTA, "OTA: Start");
+        updateRecord(UPDATE_STARTED, UPDATE_PUSH, "", "Receiving");
         FastLED.clear(true);  // Clear LEDs during update
     });
     
     ArduinoOTA.onEnd([]() {
-        Serial.println("\nOTA: End");
+        LOG_INFO(LOG_CAT_OTA, "OTA: End");
+        updateRecord(UPDATE_INSTALLED, UPDATE_PUSH, "", "Image written");
     });
     
     ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
-        Serial.printf("OTA Progress: %u%%\r", (progress / (total / 100)));
+        LOG_DEBUG(LOG_CAT_OTA, "OTA Progress: %u%%", (progress / (total / 100)));
     });
     
     ArduinoOTA.onError([](ota_error_t error) {
-        Serial.printf("Error[%u]: ", error);
-        if (error == OTA_AUTH_ERROR) Serial.println("Auth Failed");
-        else if (error == OTA_BEGIN_ERROR) Serial.println("Begin Failed");
-        else if (error == OTA_CONNECT_ERROR) Serial.println("Connect Failed");
-        else if (error == OTA_RECEIVE_ERROR) Serial.println("Receive Failed");
-        else if (error == OTA_END_ERROR) Serial.println("End Failed");
+        const char* reason = "Unknown";
+        if (error == OTA_AUTH_ERROR) reason = "Auth Failed";
+        else if (error == OTA_BEGIN_ERROR) reason = "Begin Failed";
+        else if (error == OTA_CONNECT_ERROR) reason = "Connect Failed";
+        else if (error == OTA_RECEIVE_ERROR) reason = "Receive Failed";
+        else if (error == OTA_END_ERROR) reason = "End Failed";
+        LOG_ERROR(LOG_CAT_OTA, "Error[%u]: %s", error, reason);
+        updateRecord(UPDATE_FAILED, UPDATE_PUSH, "", reason);
     });
     
     ArduinoOTA.begin();
-    Serial.println("OTA ready");
+    LOG_INFO(LOG_CAT_OTA, "OTA ready");
 }
 
 // Add OTA function declaration at top
@@ -100,44 +138,6 @@ void setupOTA();
 // Add this function declaration at the top
 void showProgress(int step);
 
-// Add near the top with other globals
-const char* COMMON_TIMEZONES[] = {
-    "Africa/Cairo",
-    "America/Chicago",
-    "America/Los_Angeles",
-    "America/New_York",
-    "America/Toronto",
-    "Asia/Dubai",
-    "Asia/Hong_Kong",
-    "Asia/Singapore",
-    "Asia/Tokyo",
-    "Australia/Adelaide",
-    "Australia/Brisbane",
-    "Australia/Melbourne",
-    "Australia/Perth",
-    "Australia/Sydney",
-    "Europe/Amsterdam",
-    "Europe/Berlin",
-    "Europe/London",
-    "Europe/Paris",
-    "Pacific/Auckland"
-};
-
-// Add validation function
-bool isValidTimezone(const String& tz) {
-    // Check common timezones first
-    for (const char* validTz : COMMON_TIMEZONES) {
-        if (tz == validTz) return true;
-    }
-    
-    // Basic format validation
-    if (tz.indexOf('/') == -1) return false;  // Must contain region/city format
-    if (tz.length() < 7) return false;        // Minimum length (e.g., "US/East")
-    if (tz.indexOf(' ') != -1) return false;  // No spaces allowed
-    
-    return true;
-}
-
 // At the top of the file with other globals
 const char* BRIGHTNESS_PAGE_HTML = R"(
     <!DOCTYPE html>
@@ -201,6 +201,12 @@ const char* BRIGHTNESS_PAGE_HTML = R"(
                 color: #666;
                 margin-left: 10px;
             }
+            canvas.mirror { background: #111; border-radius: 4px; }
+            #curve, #history {
+                width: 100%;
+                border: 1px solid #ddd;
+                border-radius: 4px;
+            }
         </style>
     </head>
     <body>
@@ -208,7 +214,8 @@ const char* BRIGHTNESS_PAGE_HTML = R"(
             <h2 style='text-align: center;'>Brightness Settings</h2>
             
             <div class='status'>
-                <div>Current Time: <span id='time'>--:--</span></div>
+                <canvas class='mirror' width='240' height='240'></canvas>
+                <div>Device Time: <span class='mirror-clock'>--:--</span></div>
                 <div>
                     Room Light Level: <span id='lightLevel'>--</span>
                     <label style="margin-left: 15px;">
@@ -219,69 +226,216 @@ const char* BRIGHTNESS_PAGE_HTML = R"(
             </div>
 
             <form id='brightnessForm'>
-                <div class='setting'>
-                    <label>Dark Mode Brightness:</label>
-                    <input type='number' name='darkBrightness' min='0' max='255' required>
-                    <span class='current'>(Current: <span id='currentDark'>--</span>)</span>
-                    <div class='help'>Range: 0-255. Recommended: 1-10 for dark rooms.</div>
-                </div>
-                
-                <div class='setting'>
-                    <label>Light Mode Brightness:</label>
-                    <input type='number' name='lightBrightness' min='0' max='255' required>
-                    <span class='current'>(Current: <span id='currentLight'>--</span>)</span>
-                    <div class='help'>Range: 0-255. Recommended: 20-50 for bright rooms.</div>
-                </div>
-                
-                <div class='setting'>
-                    <label>Light/Dark Threshold:</label>
-                    <input type='number' name='threshold' min='0' max='4095' required>
-                    <span class='current'>(Current: <span id='currentThreshold'>--</span>)</span>
-                    <div class='help'>Range: 0-4095. Higher values mean the room needs to be brighter to trigger light mode.</div>
-                </div>
-                
-                <div class='setting'>
-                    <label>Timezone:</label>
-                    <input type='text' name='timezone' list='timezones' required>
-                    <datalist id='timezones'>
-                        <option value="Africa/Cairo">Africa/Cairo</option>
-                        <option value="America/Chicago">US Central</option>
-                        <option value="America/Los_Angeles">US Pacific</option>
-                        <option value="America/New_York">US Eastern</option>
-                        <option value="America/Toronto">Eastern Canada</option>
-                        <option value="Asia/Dubai">Dubai</option>
-                        <option value="Asia/Hong_Kong">Hong Kong</option>
-                        <option value="Asia/Singapore">Singapore</option>
-                        <option value="Asia/Tokyo">Japan</option>
-                        <option value="Australia/Adelaide">Adelaide</option>
-                        <option value="Australia/Brisbane">Brisbane</option>
-                        <option value="Australia/Melbourne">Melbourne</option>
-                        <option value="Australia/Perth">Perth</option>
-                        <option value="Australia/Sydney">Sydney</option>
-                        <option value="Europe/Amsterdam">Netherlands</option>
-                        <option value="Europe/Berlin">Germany</option>
-                        <option value="Europe/London">UK</option>
-                        <option value="Europe/Paris">France</option>
-                        <option value="Pacific/Auckland">New Zealand</option>
-                    </datalist>
-                    <span class='current'>(Current: <span id='currentTimezone'>--</span>)</span>
-                    <div class='help'>
-                        Enter timezone from the <a href="https://en.wikipedia.org/wiki/List_of_tz_database_time_zones" target="_blank">tz database</a> 
-                        or select from common options. Format: Region/City (e.g., "America/New_York")
-                    </div>
-                </div>
-                
+                <div id='settingFields'></div>
                 <div class='buttons'>
                     <button type='submit'>Save Settings</button>
                     <button type='button' class='back' onclick='window.location.href="/"'>Back</button>
                 </div>
             </form>
+
+            <h3 style='text-align: center;'>Brightness Curve</h3>
+            <canvas id='curve' width='560' height='220'></canvas>
+
+            <h3 style='text-align: center;'>Light History</h3>
+            <div class='setting'>
+                <label>Show:</label>
+                <select id='historyTier'>
+                    <option value='0'>Last 10 minutes</option>
+                    <option value='1'>Last day</option>
+                    <option value='2'>Last week</option>
+                </select>
+                <div class='help'>Blue: light level (0-4095). Orange: brightness applied.</div>
+            </div>
+            <canvas id='history' width='560' height='180'></canvas>
+
+            <h3 style='text-align: center;'>Learned Calibration</h3>
+            <div class='status'>
+                <div id='calibration'>Collecting light levels...</div>
+            </div>
+            <div class='buttons'>
+                <button type='button' id='applyCalibration' disabled>Apply to Curve</button>
+            </div>
         </div>
 
+        <script src='/mirror.js'></script>
         <script>
             let updateInterval = 5000;
             let updateTimer = null;
             let inputsInitialized = false;  // Track if inputs have been initialized
+            let schema = [];  // From /api/settings/schema
+            let curve = null;
+            let operatingPoint = null;
+
+            // Plot the curve with the current light level and brightness
+            function drawCurve() {
+                const canvas = document.getElementById('curve');
+                const ctx = canvas.getContext('2d');
+                const w = canvas.width, h = canvas.height, pad = 24;
+                ctx.clearRect(0, 0, w, h);
+                if (!curve) return;
+                let top = Math.max(1, ...curve.points.map(p => p[1]));
+                if (operatingPoint) top = Math.max(top, operatingPoint[1]);
+                top = Math.ceil(top * 1.1);
+                const x = level => pad + level / 4095 * (w - 2 * pad);
+                const y = b => h - pad - b / top * (h - 2 * pad);
+
+                ctx.strokeStyle = '#ccc';
+                ctx.strokeRect(pad, pad, w - 2 * pad, h - 2 * pad);
+                ctx.fillStyle = '#666';
+                ctx.font = '11px Arial';
+                ctx.fillText('0', pad - 4, h - 8);
+                ctx.fillText('4095', w - pad - 24, h - 8);
+                ctx.fillText(top, 2, pad + 4);
+
+                ctx.strokeStyle = '#1fa3ec';
+                ctx.lineWidth = 2;
+                ctx.beginPath();
+                curve.points.forEach((p, i) => i ? ctx.lineTo(x(p[0]), y(p[1])) : ctx.moveTo(x(p[0]), y(p[1])));
+                ctx.stroke();
+                ctx.fillStyle = '#1fa3ec';
+                curve.points.forEach(p => ctx.fillRect(x(p[0]) - 3, y(p[1]) - 3, 6, 6));
+
+                if (operatingPoint) {
+                    ctx.fillStyle = '#e33';
+                    ctx.beginPath();
+                    ctx.arc(x(operatingPoint[0]), y(operatingPoint[1]), 5, 0, 2 * Math.PI);
+                    ctx.fill();
+                }
+            }
+
+            // Plot one tier of /api/light/history (binary, see light_history.h)
+            function loadHistory() {
+                fetch('/api/light/history?tier=' + document.getElementById('historyTier').value)
+                    .then(r => r.arrayBuffer())
+                    .then(buffer => {
+                        const view = new DataView(buffer);
+                        if (view.getUint32(0, true) !== 0x484C4357) return;
+                        const entrySize = view.getUint16(6, true);
+                        const capacity = view.getUint16(24, true);
+                        const count = view.getUint16(26, true);
+                        const points = [];
+                        for (let i = 0, offset = 28; i < count; i++, offset += entrySize) {
+                            const level = view.getUint16(offset, true);
+                            points.push(level === 0xFFFF ? null : [level, view.getUint8(offset + 2)]);
+                        }
+                        drawHistory(points, capacity);
+                    })
+                    .catch(console.error);
+            }
+
+            function drawHistory(points, capacity) {
+                const canvas = document.getElementById('history');
+                const ctx = canvas.getContext('2d');
+                const w = canvas.width, h = canvas.height, pad = 10;
+                ctx.clearRect(0, 0, w, h);
+                ctx.strokeStyle = '#ccc';
+                ctx.strokeRect(pad, pad, w - 2 * pad, h - 2 * pad);
+                const top = Math.max(1, ...points.filter(p => p).map(p => p[1]));
+                // Newest at the right edge; a full ring spans the width
+                const x = i => pad + (capacity - points.length + i) / Math.max(1, capacity - 1) * (w - 2 * pad);
+                const plot = (colour, y) => {
+                    ctx.strokeStyle = colour;
+                    ctx.lineWidth = 1.5;
+                    ctx.beginPath();
+                    let drawing = false;
+                    points.forEach((p, i) => {
+                        if (!p) { drawing = false; return; }
+                        drawing ? ctx.lineTo(x(i), y(p)) : ctx.moveTo(x(i), y(p));
+                        drawing = true;
+                    });
+                    ctx.stroke();
+                };
+                plot('#1fa3ec', p => h - pad - p[0] / 4095 * (h - 2 * pad));
+                plot('#f90', p => h - pad - p[1] / top * (h - 2 * pad));
+            }
+
+            function loadCalibration() {
+                fetch('/api/light/histogram')
+                    .then(r => r.json())
+                    .then(data => {
+                        const s = data.suggestion;
+                        const text = document.getElementById('calibration');
+                        document.getElementById('applyCalibration').disabled = !s.valid;
+                        if (!s.valid) {
+                            text.textContent = 'Collecting light levels (' + data.samples + ' samples so far)...';
+                            return;
+                        }
+                        text.textContent = 'Dark below ' + s.darkLevel + ', light above ' + s.lightLevel +
+                            ' (split at ' + s.threshold + ', separation ' + Math.round(s.separation * 100) +
+                            '%, ' + data.samples + ' samples)';
+                    })
+                    .catch(console.error);
+            }
+
+            // Build the settings form from /api/settings/schema
+            function loadSchema() {
+                return fetch('/api/settings/schema')
+                    .then(r => r.json())
+                    .then(fields => {
+                        const box = document.getElementById('settingFields');
+                        box.innerHTML = '';
+                        fields.forEach(f => {
+                            const div = document.createElement('div');
+                            div.className = 'setting';
+                            const label = document.createElement('label');
+                            label.textContent = f.label + ':';
+                            const input = document.createElement('input');
+                            input.name = f.name;
+                            input.required = true;
+                            if (f.type === 'int') {
+                                input.type = 'number';
+                                input.min = f.min;
+                                input.max = f.max;
+                            } else {
+                                input.type = 'text';
+                                if (f.type === 'curve' || f.type === 'url') input.style.width = '260px';
+                            }
+                            div.append(label, input);
+                            if (f.options) {
+                                const list = document.createElement('datalist');
+                                list.id = 'options-' + f.name;
+                                f.options.forEach(o => list.appendChild(new Option(o, o)));
+                                input.setAttribute('list', list.id);
+                                div.appendChild(list);
+                            }
+                            const current = document.createElement('span');
+                            current.className = 'current';
+                            current.innerHTML = '(Current: <span id="current-' + f.name + '">--</span>)';
+                            const help = document.createElement('div');
+                            help.className = 'help';
+                            help.textContent = (f.type === 'int' ? 'Range: ' + f.min + '-' + f.max + '. ' : '') + f.help;
+                            div.append(current, help);
+                            box.appendChild(div);
+                        });
+                        schema = fields;
+                    });
+            }
+
+            function loadCurve() {
+                fetch('/api/curve')
+                    .then(r => r.json())
+                    .then(data => {
+                        curve = data;
+                        drawCurve();
+                    })
+                    .catch(console.error);
+            }
+
+            // Fetch status now, or at the end of the second if it was just
+            // fetched: however often changes arrive, a tab asks once a second
+            let lastStatusAt = 0;
+            let statusQueued = false;
+            function requestStatus() {
+                if (statusQueued) return;
+                const wait = lastStatusAt + 1000 - Date.now();
+                if (wait > 0) {
+                    statusQueued = true;
+                    setTimeout(() => { statusQueued = false; requestStatus(); }, wait);
+                    return;
+                }
+                lastStatusAt = Date.now();
+                updateStatus();
+            }
 
             // Update status
             function updateStatus() {
@@ -290,36 +444,51 @@ const char* BRIGHTNESS_PAGE_HTML = R"(
                     .then(data => {
                         document.getElementById('lightLevel').textContent = data.lightLevel;
                         document.getElementById('brightness').textContent = data.currentBrightness;
-                        document.getElementById('time').textContent = new Date().toLocaleTimeString();
-                        
-                        // Update current values display
-                        document.getElementById('currentDark').textContent = data.settings.darkBrightness;
-                        document.getElementById('currentLight').textContent = data.settings.lightBrightness;
-                        document.getElementById('currentThreshold').textContent = data.settings.threshold;
-                        document.getElementById('currentTimezone').textContent = data.timezone;
+                        operatingPoint = [data.lightLevel, data.currentBrightness];
+                        drawCurve();
                         
-                        // Set input values only on first load
-                        if (!inputsInitialized) {
-                            document.querySelector('[name="darkBrightness"]').value = data.settings.darkBrightness;
-                            document.querySelector('[name="lightBrightness"]').value = data.settings.lightBrightness;
-                            document.querySelector('[name="threshold"]').value = data.settings.threshold;
-                            document.querySelector('[name="timezone"]').value = data.timezone;
-                            inputsInitialized = true;
-                        }
+                        // Update current values display; set inputs only on first load
+                        schema.forEach(f => {
+                            document.getElementById('current-' + f.name).textContent = data.settings[f.name];
+                            if (!inputsInitialized) {
+                                document.querySelector('[name="' + f.name + '"]').value = data.settings[f.name];
+                            }
+                        });
+                        if (schema.length) inputsInitialized = true;
                     })
                     .catch(console.error);
             }
             
+            // Reload what the clock reports changed, as soon as it changes
+            let stateVersion = 0;
+            function waitForChanges() {
+                fetch('/api/wait?since=' + stateVersion)
+                    .then(r => r.json())
+                    .then(data => {
+                        stateVersion = data.version;
+                        if (data.changed.length) requestStatus();
+                        if (data.changed.includes('settings')) loadCurve();
+                        if (data.changed.some(c => c !== 'settings')) loadFrame();
+                        waitForChanges();
+                    })
+                    .catch(() => setTimeout(waitForChanges, 5000));
+            }
+            
             // Handle fast readout toggle
             document.getElementById('fastReadout').onchange = function(e) {
                 clearInterval(updateTimer);
                 updateInterval = e.target.checked ? 1000 : 5000;
-                updateTimer = setInterval(updateStatus, updateInterval);
+                updateTimer = setInterval(requestStatus, updateInterval);
             };
             
             // Initial update and start interval
-            updateStatus();
-            updateTimer = setInterval(updateStatus, updateInterval);
+            loadSchema().then(requestStatus).then(waitForChanges);
+            loadCurve();
+            loadCalibration();
+            loadHistory();
+            setInterval(loadHistory, 5000);
+            document.getElementById('historyTier').onchange = loadHistory;
+            updateTimer = setInterval(requestStatus, updateInterval);
             
             // Handle form submission
             document.getElementById('brightnessForm').onsubmit = function(e) {
@@ -328,13 +497,25 @@ const char* BRIGHTNESS_PAGE_HTML = R"(
                 fetch('/api/saveBrightness', {
                     method: 'POST',
                     body: formData
-                }).then(() => {
+                }).then(r => {
+                    if (!r.ok) return r.text().then(text => { throw new Error(text); });
                     alert('Settings saved');
-                    updateStatus();  // Refresh display after save
-                }).catch(err => {
-                    alert('Error saving settings');
-                    console.error(err);
-                });
+                    requestStatus();  // Refresh display after save
+                    loadCurve();     // The curve may have been rebuilt from these settings
+                }).catch(err => alert('Error saving settings: ' + err.message));
+            };
+
+            document.getElementById('applyCalibration').onclick = function() {
+                const body = new FormData();
+                body.append('action', 'apply');
+                fetch('/api/light/histogram', {method: 'POST', body: body})
+                    .then(r => {
+                        if (!r.ok) return r.text().then(text => { throw new Error(text); });
+                        inputsInitialized = false;  // Pick up the new threshold
+                        loadCurve();
+                        requestStatus();
+                    })
+                    .catch(err => alert('Error applying calibration: ' + err.message));
             };
         </script>
     </body>
@@ -342,149 +523,644 @@ const char* BRIGHTNESS_PAGE_HTML = R"(
 )";
 
 /**
- * LED Matrix Layout (8x8):
- * The matrix is arranged in a zig-zag pattern, with words overlaid on a mask.
- * Numbers represent LED indices (0-63).
- * 
- * 63 62 61 60 59 58 57 56   <- Row 0: IT IS | HALF | TEN
- * 48 49 50 51 52 53 54 55   <- Row 1: QUARTER | TWENTY
- * 47 46 45 44 43 42 41 40   <- Row 2: FIVE | MINUTES | TO
- * 32 33 34 35 36 37 38 39   <- Row 3: PAST | ONE | THREE
- * 31 30 29 28 27 26 25 24   <- Row 4: TWO | FOUR | FIVE
- * 16 17 18 19 20 21 22 23   <- Row 5: SIX | SEVEN | EIGHT
- * 15 14 13 12 11 10  9  8   <- Row 6: NINE | TEN | ELEVEN
- *  0  1  2  3  4  5  6  7   <- Row 7: TWELVE | O'CLOCK
+ * Live view of the face for the portal and the brightness page: draws
+ * /api/frame into every canvas.mirror and keeps every .mirror-clock
+ * showing the device's clock. watchFrame() redraws whenever /api/wait
+ * reports a change; a page with its own /api/wait loop calls loadFrame()
+ * from it instead, so it holds one waiting request, not two.
  */
+const char* MIRROR_JS = R"(
+    let mirrorLabels = null;
+    let mirrorOffset = null;  // Device local time minus browser time, seconds
+    let mirrorShowing = '';
 
-// Word positions in LED array - each sub-array contains LED indices for a word
-const int WORDS[][8] = {
-    {63, 62},          // IT IS
-    {60, 59},          // HALF
-    {57, 56},          // TEN
-    {48, 49, 50, 51},  // QUARTER
-    {52, 53, 54, 55},  // TWENTY
-    {47, 46},          // FIVE
-    {45, 44, 43, 42},  // MINUTES
-    {40},              // TO
-    {32, 33},          // PAST
-    {35, 36},          // ONE
-    {37, 38, 39},      // THREE
-    {31, 30},          // TWO
-    {28, 27},          // FOUR
-    {25, 24},          // FIVE
-    {16, 17},          // SIX
-    {18, 19, 20},      // SEVEN
-    {21, 22, 23},      // EIGHT
-    {15, 14},          // NINE
-    {13},              // TEN
-    {10, 9, 8},        // ELEVEN
-    {0, 1, 2},         // TWELVE
-    {4, 5, 6, 7},      // O'CLOCK
-};
-
-// Number of LEDs used for each word
-const int WORD_LENGTHS[] = {2, 2, 2, 4, 4, 2, 4, 1, 2, 2, 3, 2, 2, 2, 2, 3, 3, 2, 1, 3, 3, 4};
+    function drawMirror(frame) {
+        // Lit letters scale with the brightness, but stay readable when dim
+        const alpha = 0.35 + 0.65 * frame.brightness / 255;
+        document.querySelectorAll('canvas.mirror').forEach(canvas => {
+            const ctx = canvas.getContext('2d');
+            const cell = canvas.width / 8;
+            ctx.clearRect(0, 0, canvas.width, canvas.height);
+            ctx.font = 'bold ' + Math.floor(cell * 0.32) + 'px Arial';
+            ctx.textAlign = 'center';
+            ctx.textBaseline = 'middle';
+            for (let row = 0; row < 8; row++) {
+                for (let col = 0; col < 8; col++) {
+                    const lit = frame.rows[row] >> col & 1;
+                    ctx.fillStyle = lit ? 'rgba(255, 240, 200, ' + alpha + ')' : '#333';
+                    ctx.fillText(mirrorLabels[row * 8 + col], (col + 0.5) * cell, (row + 0.5) * cell);
+                }
+            }
+        });
+        mirrorOffset = frame.localTime - Date.now() / 1000;
+        mirrorShowing = ' (showing ' + frame.time + (frame.synced ? '' : ', not synced') + ')';
+        tickMirrorClock();
+    }
+
+    function tickMirrorClock() {
+        if (mirrorOffset === null) return;
+        const time = new Date((Date.now() / 1000 + mirrorOffset) * 1000).toISOString().substr(11, 8);
+        document.querySelectorAll('.mirror-clock').forEach(e => e.textContent = time + mirrorShowing);
+    }
+
+    // Fetches and draws the current frame (the letters only the first time)
+    function loadFrame() {
+        return fetch('/api/frame' + (mirrorLabels ? '' : '?labels=1'))
+            .then(r => r.json())
+            .then(frame => {
+                if (frame.labels) mirrorLabels = frame.labels;
+                drawMirror(frame);
+                return frame;
+            });
+    }
+
+    // Redraws after every change /api/wait reports, starting from `since`
+    function watchFrame(since) {
+        fetch('/api/wait?since=' + since)
+            .then(r => r.json())
+            .then(data => Promise.resolve(data.changed.some(c => c !== 'settings') ? loadFrame() : null)
+                .then(() => watchFrame(data.version)))
+            .catch(() => setTimeout(() => watchFrame(since), 5000));
+    }
+
+    setInterval(tickMirrorClock, 1000);
+)";
 
 /**
  * Tests all LEDs in sequence to verify wiring and positioning
  * Lights each LED for 100ms, then turns it off
  */
 void testLEDs() {
-    Serial.println("Testing LEDs sequentially...");
+    LOG_INFO(LOG_CAT_DISPLAY, "Testing LEDs sequentially...");
     for (int i = 0; i < NUM_LEDS; i++) {
         fill_solid(leds, NUM_LEDS, CRGB::Black);  // Clear all
         leds[i] = CRGB::White;  // Light current LED
-        FastLED.show();
+        showLeds();
         delay(25);  // Reduced from 100ms to 25ms per LED
     }
     fill_solid(leds, NUM_LEDS, CRGB::White);  // Flash all
-    FastLED.show();
+    showLeds();
     delay(250);  // Quick flash
     fill_solid(leds, NUM_LEDS, CRGB::Black);
+    showLeds();
+}
+
+/**
+ * Pushes the LED buffer to the matrix, recording the transfer in the trace ring
+ */
+void showLeds() {
+    traceRecord(TRACE_SHOW_BEGIN, FastLED.getBrightness());
+    metricAdd(METRIC_LED_SHOWS);
     FastLED.show();
+    traceRecord(TRACE_SHOW_END);
+}
+
+// Route whose handler is running, for counting its responses
+static TraceRoute servingRoute = TRACE_ROUTE_OTHER;
+
+/**
+ * Wraps a route handler so its start and end are recorded in the trace ring,
+ * and it only runs for clients within the route's rate limit (see admission.h)
+ */
+std::function<void()> traced(TraceRoute route, std::function<void()> handler) {
+    return [route, handler]() {
+        traceRecord(TRACE_HTTP_BEGIN, route);
+        servingRoute = route;
+        if (admitRequest(*wm.server, route)) handler();
+        servingRoute = TRACE_ROUTE_OTHER;
+        traceRecord(TRACE_HTTP_END, route);
+    };
+}
+
+/**
+ * Sends a handler's response, counting it by route and status code for
+ * /metrics
+ */
+void reply(int code, const char* contentType, const String& content = String()) {
+    metricHttpResponse(servingRoute, code);
+    wm.server->send(code, contentType, content);
+}
+
+// A length of 0 is a formatter's "buffer too small", answered with 500 rather than an empty 200
+void reply_P(int code, const char* contentType, const char* content, size_t length) {
+    if (length == 0) {
+        LOG_ERROR(LOG_CAT_HTTP, "Response to %s did not fit its buffer", wm.server->uri().c_str());
+        reply(500, "text/plain", "Response did not fit its buffer");
+        return;
+    }
+    metricHttpResponse(servingRoute, code);
+    wm.server->send_P(code, contentType, content, length);
+}
+
+#define SETTINGS_PATCH_MAX 1024  // Largest PATCH /api/settings body accepted
+
+// PATCH /api/settings body, kept as WebServer streams it in, so an
+// oversized one is counted and dropped rather than buffered whole
+static char patchBody[SETTINGS_PATCH_MAX];
+static size_t patchLength = 0;  // Past SETTINGS_PATCH_MAX once the body is too large
+
+static void receivePatchBody() {
+    HTTPRaw& raw = wm.server->raw();
+    if (raw.status == RAW_START) patchLength = 0;
+    if (raw.status != RAW_WRITE) return;
+    if (patchLength + raw.currentSize <= SETTINGS_PATCH_MAX) memcpy(patchBody + patchLength, raw.buf, raw.currentSize);
+    patchLength += raw.currentSize;
 }
+#define METRICS_CHUNK_SIZE 512   // /metrics is sent in chunks of at most this
 
 // Add this function before connectToWiFi()
 void bindServerCallback() {
     // Add favicon route
-    wm.server->on("/favicon.ico", HTTP_GET, []() {
-        wm.server->send_P(200, "image/x-icon", (const char*)esp32wordclockBW_32x32_bmp, esp32wordclockBW_32x32_bmp_len);
-    });
+    wm.server->on("/favicon.ico", HTTP_GET, traced(TRACE_ROUTE_FAVICON, []() {
+        reply_P(200, "image/x-icon", (const char*)esp32wordclockBW_32x32_bmp, esp32wordclockBW_32x32_bmp_len);
+    }));
     
     // Brightness configuration page
-    wm.server->on("/brightness", HTTP_GET, []() {
-        wm.server->send(200, "text/html", BRIGHTNESS_PAGE_HTML);
-    });
+    wm.server->on("/brightness", HTTP_GET, traced(TRACE_ROUTE_BRIGHTNESS_PAGE, []() {
+        reply(200, "text/html", BRIGHTNESS_PAGE_HTML);
+    }));
+    
+    // Live view of the face (see MIRROR_JS)
+    wm.server->on("/mirror.js", HTTP_GET, traced(TRACE_ROUTE_FRAME, []() {
+        reply(200, "application/javascript", MIRROR_JS);
+    }));
+    
+    // What the face shows; labels=1 adds the letters of every LED
+    wm.server->on("/api/frame", HTTP_GET, traced(TRACE_ROUTE_FRAME, []() {
+        FrameSnapshot frame;
+        frame.frame = transitions.targetFrame();
+        frame.brightness = (brightnessController.output() + 128) >> 8;
+        frame.time = shownTime;
+        frame.localTime = clockSource->now();
+        frame.synced = timeStatus() != timeNotSet;
+        frame.stateVersion = stateVersion.version();
+        
+        char json[768];
+        size_t length = formatFrameJson(json, sizeof(json), frame, wm.server->arg("labels") == "1");
+        reply_P(200, "application/json", json, length);
+    }));
     
     // Get all status information
-    wm.server->on("/api/status", HTTP_GET, []() {
-        if (DEBUG_LEVEL > 1) Serial.println("GET /api/status");
-        String json = "{";
-        json += "\"lightLevel\":" + String(readLightLevel()) + ",";
-        json += "\"currentBrightness\":" + String(FastLED.getBrightness()) + ",";
-        json += "\"timezone\":\"" + String(DEFAULT_TIMEZONE) + "\",";  // Use the IANA identifier instead
-        json += "\"settings\":{";
-        json += "\"darkBrightness\":" + String(brightnessSettings.darkBrightness) + ",";
-        json += "\"lightBrightness\":" + String(brightnessSettings.lightBrightness) + ",";
-        json += "\"threshold\":" + String(brightnessSettings.threshold);
-        json += "}}";
-        wm.server->send(200, "application/json", json);
-    });
+    wm.server->on("/api/status", HTTP_GET, traced(TRACE_ROUTE_STATUS, []() {
+        LOG_VERBOSE(LOG_CAT_HTTP, "GET /api/status");
+        StatusSnapshot status;
+        ClockSettings current = settings.load(&status.settingsVersion);
+        status.lightLevel = lastLightLevel;
+        status.currentBrightness = FastLED.getBrightness();
+        status.timezone = current.timezone;
+        status.settings = current;
+        
+        char json[640];
+        size_t length = formatStatusJson(json, sizeof(json), status);
+        reply_P(200, "application/json", json, length);
+    }));
+    
+    // The same for monitoring, as fixed-layout MessagePack (see status_binary.h)
+    wm.server->on("/api/status.bin", HTTP_GET, traced(TRACE_ROUTE_STATUS_BIN, []() {
+        StatusBinary status;
+        status.uptimeSeconds = uptimeSeconds();
+        status.localTime = clockSource->now();
+        status.lastSync = lastNtpUpdateTime();
+        status.syncState = timeStatus();
+        status.lightLevel = lastLightLevel;
+        status.brightness = FastLED.getBrightness();
+        status.settingsVersion = settings.version();
+        status.frame = transitions.targetFrame();
+        status.freeHeap = ESP.getFreeHeap();
+        status.minFreeHeap = ESP.getMinFreeHeap();
+        status.healthAlerts = healthMonitor.latchedAlerts();
+        
+        uint8_t packet[STATUS_BINARY_SIZE];
+        size_t length = encodeStatusBinary(packet, sizeof(packet), status);
+        reply_P(200, "application/msgpack", (const char*)packet, length);
+    }));
     
     // Save brightness settings
-    wm.server->on("/api/saveBrightness", HTTP_POST, []() {
-        if (DEBUG_LEVEL > 0) {
-            Serial.println("POST /api/saveBrightness");
-            if (wm.server->args() > 0) {
-                Serial.println("Args:");
-                for (int i = 0; i < wm.server->args(); i++) {
-                    Serial.printf("  %s: %s\n", 
-                        wm.server->argName(i).c_str(), 
-                        wm.server->arg(i).c_str());
+    wm.server->on("/api/saveBrightness", HTTP_POST, traced(TRACE_ROUTE_SAVE_BRIGHTNESS, []() {
+        LOG_DEBUG(LOG_CAT_HTTP, "POST /api/saveBrightness");
+        if (LOG_ENABLED(LOG_LEVEL_DEBUG, LOG_CAT_HTTP)) {
+            for (int i = 0; i < wm.server->args(); i++) {
+                LOG_DEBUG(LOG_CAT_HTTP, "  %s: %s", wm.server->argName(i), wm.server->arg(i));
+            }
+        }
+        // Every argument named in the schema (see settings.h) is parsed and
+        // range-checked; nothing is published unless all of them pass
+        char error[64] = "";
+        settings.update([&error](ClockSettings& next) {
+            ClockSettings before = next;
+            for (int i = 0; i < wm.server->args(); i++) {
+                SettingId id = findSetting(wm.server->argName(i).c_str());
+                if (id == SETTING_COUNT) continue;  // Not a setting
+                if (parseSetting(next, id, wm.server->arg(i).c_str()) != SETTING_OK) {
+                    formatSettingError(error, sizeof(error), id);
+                    return false;
                 }
             }
+            if (strcmp(next.timezone, before.timezone) != 0 && !resolveTimezone(next.timezone)) {
+                snprintf(error, sizeof(error), "Invalid timezone");
+                return false;
+            }
+            rebuildCurve(next, before);
+            return true;
+        });
+        if (error[0]) {
+            reply(400, "text/plain", error);
+            return;
         }
-        bool changed = false;
         
-        if (wm.server->hasArg("darkBrightness")) {
-            brightnessSettings.darkBrightness = wm.server->arg("darkBrightness").toInt();
-            changed = true;
+        reply(200, "text/plain", "OK");
+    }));
+    
+    // Every setting's name, type, range, default and label, for building forms
+    wm.server->on("/api/settings/schema", HTTP_GET, traced(TRACE_ROUTE_SETTINGS, []() {
+        char json[768];
+        wm.server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+        reply(200, "application/json", "");
+        wm.server->sendContent("[");
+        for (int i = 0; i < SETTING_COUNT; i++) {
+            if (i) wm.server->sendContent(",");
+            size_t length = formatSettingSchemaJson(json, sizeof(json), (SettingId)i);
+            wm.server->sendContent(json, length);
         }
-        if (wm.server->hasArg("lightBrightness")) {
-            brightnessSettings.lightBrightness = wm.server->arg("lightBrightness").toInt();
-            changed = true;
+        wm.server->sendContent("]");
+        wm.server->sendContent("");
+    }));
+    
+    // Change any number of settings in one go from a JSON object, e.g.
+    // {"darkBrightness":3,"timezone":"Europe/Paris"}. Members left out keep
+    // their value; if any member is rejected nothing changes.
+    wm.server->on("/api/settings", HTTP_PATCH, traced(TRACE_ROUTE_SETTINGS, []() {
+        static JsonReader document;  // Fixed capacity, kept off the loop task's stack
+        size_t length = patchLength;
+        patchLength = 0;  // A request without a body never calls receivePatchBody()
+        if (length > SETTINGS_PATCH_MAX) {
+            reply(413, "text/plain", "Settings document too large");
+            return;
         }
-        if (wm.server->hasArg("threshold")) {
-            brightnessSettings.threshold = wm.server->arg("threshold").toInt();
-            changed = true;
+        if (!document.parse(patchBody, length)) {
+            char error[96];
+            snprintf(error, sizeof(error), "%s at offset %u", document.error(), (unsigned)document.errorOffset());
+            reply(400, "text/plain", error);
+            return;
         }
-        if (wm.server->hasArg("timezone")) {
-            String newTimezone = wm.server->arg("timezone");
-            if (isValidTimezone(newTimezone)) {
-                if (Australia.setLocation(newTimezone)) {
-                    changed = true;
-                    waitForSync(10);
-                } else {
-                    wm.server->send(400, "text/plain", "Invalid timezone");
-                    return;
+        
+        char error[64] = "";
+        ClockSettings applied;
+        uint32_t version;
+        settings.update([&error, &applied](ClockSettings& next) {
+            ClockSettings before = next;
+            if (!parseSettingsJson(next, document, error, sizeof(error))) return false;
+            if (strcmp(next.timezone, before.timezone) != 0 && !resolveTimezone(next.timezone)) {
+                snprintf(error, sizeof(error), "Invalid timezone");
+                return false;
+            }
+            rebuildCurve(next, before);
+            applied = next;
+            return document.count() > 0;
+        }, &version);
+        if (error[0]) {
+            reply(400, "text/plain", error);
+            return;
+        }
+        LOG_INFO(LOG_CAT_HTTP, "Settings: %d changed in version %lu", document.count(), (unsigned long)version);
+        
+        char json[512];
+        JsonWriter out(json, sizeof(json));
+        out.beginObject().member("settingsVersion", version).key("settings").beginObject();
+        writeSettingsJson(out, applied);
+        out.endObject().endObject();
+        reply_P(200, "application/json", json, out.ok() ? out.length() : 0);
+    }), receivePatchBody);
+    
+    // Long poll: answers when the state version moves past `since` (see long_poll.h)
+    wm.server->on("/api/wait", HTTP_GET, traced(TRACE_ROUTE_WAIT, []() {
+        longPollRequest(*wm.server);
+    }));
+    
+    // Settings version only, for clients polling for changes
+    wm.server->on("/api/settings/version", HTTP_GET, traced(TRACE_ROUTE_SETTINGS, []() {
+        char json[48];
+        snprintf(json, sizeof(json), "{\"settingsVersion\":%lu}", (unsigned long)settings.version());
+        reply(200, "application/json", json);
+    }));
+    
+    // Brightness curve: points, hysteresis and slew rate
+    wm.server->on("/api/curve", HTTP_GET, traced(TRACE_ROUTE_CURVE, []() {
+        char json[256];
+        size_t length = formatCurveJson(json, sizeof(json), settings.load().curve);
+        reply_P(200, "application/json", json, length);
+    }));
+    
+    // Replace the curve: points=level:brightness,..., hysteresis, slew (all optional)
+    wm.server->on("/api/curve", HTTP_POST, traced(TRACE_ROUTE_CURVE, []() {
+        static const struct { const char* arg; SettingId id; } ARGS[] = {
+            {"points", SETTING_points}, {"hysteresis", SETTING_hysteresis}, {"slew", SETTING_slew},
+        };
+        char error[64] = "";
+        CurveSettings curve;
+        settings.update([&error, &curve](ClockSettings& next) {
+            for (const auto& a : ARGS) {
+                if (wm.server->hasArg(a.arg) && parseSetting(next, a.id, wm.server->arg(a.arg).c_str()) != SETTING_OK) {
+                    formatSettingError(error, sizeof(error), a.id);
+                    return false;
                 }
-            } else {
-                wm.server->send(400, "text/plain", "Invalid timezone format");
+            }
+            curve = next.curve;
+            return true;
+        });
+        if (error[0]) {
+            reply(400, "text/plain", error);
+            return;
+        }
+        LOG_INFO(LOG_CAT_HTTP, "Brightness curve updated (%d points)", curve.count);
+        
+        char json[256];
+        size_t length = formatCurveJson(json, sizeof(json), curve);
+        reply_P(200, "application/json", json, length);
+    }));
+    
+    // Learned light distribution: sample count, suggested breakpoints and
+    // the per-hour histogram (hours[hour][bin], bins LIGHT_HIST_BIN_WIDTH wide)
+    wm.server->on("/api/light/histogram", HTTP_GET, traced(TRACE_ROUTE_LIGHT, []() {
+        char json[256];
+        wm.server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+        reply(200, "application/json", "");
+        snprintf(json, sizeof(json), "{\"binWidth\":%d,\"samples\":%lu,\"suggestion\":",
+                 LIGHT_HIST_BIN_WIDTH, (unsigned long)lightHistogram.total());
+        wm.server->sendContent(json);
+        size_t length = formatLightSuggestionJson(json, sizeof(json), lightHistogram.suggest());
+        wm.server->sendContent(json, length);
+        wm.server->sendContent(",\"hours\":[");
+        for (int hour = 0; hour < LIGHT_HIST_HOURS; hour++) {
+            if (hour) wm.server->sendContent(",");
+            length = formatLightHistogramRow(json, sizeof(json), lightHistogram, hour);
+            wm.server->sendContent(json, length);
+        }
+        wm.server->sendContent("]}");
+        wm.server->sendContent("");
+    }));
+    
+    // action=apply builds the curve from the suggestion; action=reset forgets everything learned
+    wm.server->on("/api/light/histogram", HTTP_POST, traced(TRACE_ROUTE_LIGHT, []() {
+        String action = wm.server->arg("action");
+        if (action == "apply") {
+            LightSuggestion suggestion = lightHistogram.suggest();
+            if (!suggestion.valid) {
+                reply(409, "text/plain", "Not enough light samples yet");
+                return;
+            }
+            settings.update([&suggestion](ClockSettings& next) {
+                CurveSettings curve = curveFromSuggestion(suggestion, next.brightness);
+                curve.hysteresis = next.curve.hysteresis;
+                curve.slewPerSecond = next.curve.slewPerSecond;
+                next.curve = curve;
+                next.brightness.threshold = suggestion.threshold;
+                return true;
+            });
+            LOG_INFO(LOG_CAT_SENSOR, "Applied learned calibration: dark %d, light %d",
+                     suggestion.darkLevel, suggestion.lightLevel);
+        } else if (action == "reset") {
+            lightCalibrationReset();
+        } else {
+            reply(400, "text/plain", "action must be apply or reset");
+            return;
+        }
+        reply(200, "text/plain", "OK");
+    }));
+    
+    // Light level history: tier=0 (seconds), 1 (minutes) or 2 (quarter hours),
+    // all tiers if omitted; binary (see light_history.h) or format=csv for one tier
+    wm.server->on("/api/light/history", HTTP_GET, traced(TRACE_ROUTE_LIGHT, []() {
+        int first = 0, last = LIGHT_HISTORY_TIERS - 1;
+        if (wm.server->hasArg("tier")) {
+            first = last = wm.server->arg("tier").toInt();
+            if (first < 0 || first >= LIGHT_HISTORY_TIERS) {
+                reply(400, "text/plain", "tier must be 0-2");
                 return;
             }
         }
         
-        if (changed) {
-            updateBrightness();
+        if (wm.server->arg("format") == "csv") {
+            if (first != last) {
+                reply(400, "text/plain", "format=csv needs a tier");
+                return;
+            }
+            const LightHistoryTier& tier = lightHistory.tier(first);
+            char line[64];
+            wm.server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+            reply(200, "text/csv", "");
+            for (int i = -1; i < tier.count(); i++) {
+                size_t length = formatLightHistoryCsvLine(line, sizeof(line), tier, i);
+                wm.server->sendContent(line, length);
+            }
+            wm.server->sendContent("");
+            return;
         }
         
-        wm.server->send(200, "text/plain", "OK");
-    });
+        LightHistoryHeader header = {LIGHT_HISTORY_MAGIC, LIGHT_HISTORY_FORMAT_VERSION,
+                                     sizeof(LightHistoryEntry), uptimeSeconds(), (uint32_t)(last - first + 1)};
+        size_t total = sizeof(header);
+        for (int t = first; t <= last; t++) {
+            total += sizeof(LightHistoryTierHeader) + lightHistory.tier(t).count() * sizeof(LightHistoryEntry);
+        }
+        wm.server->setContentLength(total);
+        reply(200, "application/octet-stream", "");
+        wm.server->sendContent((const char*)&header, sizeof(header));
+        for (int t = first; t <= last; t++) {
+            const LightHistoryTier& tier = lightHistory.tier(t);
+            LightHistoryTierHeader tierHeader;
+            tier.fillHeader(tierHeader);
+            wm.server->sendContent((const char*)&tierHeader, sizeof(tierHeader));
+            // The ring holds at most two runs: oldest to the end, then from the start
+            for (int i = 0; i < tier.count(); ) {
+                int run = tier.runFrom(i);
+                wm.server->sendContent((const char*)&tier.at(i), run * sizeof(LightHistoryEntry));
+                i += run;
+            }
+        }
+    }));
+    
+    // Transition duration and frame statistics
+    wm.server->on("/api/transition", HTTP_GET, traced(TRACE_ROUTE_TRANSITION, []() {
+        char json[384];
+        size_t length = formatTransitionJson(json, sizeof(json), transitions);
+        reply_P(200, "application/json", json, length);
+    }));
+    
+    // Set the fade length: duration=ms (0 = hard cut), the dithering limit:
+    // ditherBelow=step (0 = off); action=reset clears the statistics
+    wm.server->on("/api/transition", HTTP_POST, traced(TRACE_ROUTE_TRANSITION, []() {
+        static const struct { const char* arg; SettingId id; } ARGS[] = {
+            {"duration", SETTING_transitionMs}, {"ditherBelow", SETTING_ditherBelow},
+        };
+        char error[64] = "";
+        settings.update([&error](ClockSettings& next) {
+            bool changed = false;
+            for (const auto& a : ARGS) {
+                if (!wm.server->hasArg(a.arg)) continue;
+                if (parseSetting(next, a.id, wm.server->arg(a.arg).c_str()) != SETTING_OK) {
+                    formatSettingError(error, sizeof(error), a.id);
+                    return false;
+                }
+                changed = true;
+            }
+            return changed;
+        });
+        if (error[0]) {
+            reply(400, "text/plain", error);
+            return;
+        }
+        if (wm.server->arg("action") == "reset") {
+            transitions.resetStats();
+        }
+        reply(200, "text/plain", "OK");
+    }));
+    
+    // Download the event trace ring (convert with tools/trace2json.cpp)
+    wm.server->on("/api/trace", HTTP_GET, traced(TRACE_ROUTE_TRACE, []() {
+        TraceDumpHeader header;
+        traceFillHeader(header);
+        wm.server->setContentLength(sizeof(header) + sizeof(traceRing));
+        reply(200, "application/octet-stream", "");
+        wm.server->sendContent((const char*)&header, sizeof(header));
+        wm.server->sendContent((const char*)traceRing, sizeof(traceRing));
+    }));
+    
+    // Download the CPU profile (symbolise with tools/profsym.cpp)
+    wm.server->on("/api/profile", HTTP_GET, traced(TRACE_ROUTE_PROFILE, []() {
+        ProfileDumpHeader header;
+        profileFreeze(header);
+        wm.server->setContentLength(sizeof(header) + sizeof(profileTable) + sizeof(profileTasks));
+        reply(200, "application/octet-stream", "");
+        wm.server->sendContent((const char*)&header, sizeof(header));
+        wm.server->sendContent((const char*)profileTable, sizeof(profileTable));
+        wm.server->sendContent((const char*)profileTasks, sizeof(profileTasks));
+        profileThaw();
+    }));
+    
+    // Control the CPU profiler: action=start|stop|reset, optional hz
+    wm.server->on("/api/profile", HTTP_POST, traced(TRACE_ROUTE_PROFILE, []() {
+        String action = wm.server->arg("action");
+        LOG_INFO(LOG_CAT_HTTP, "Profiler %s", action);
+        if (action == "start") {
+            uint32_t hz = wm.server->hasArg("hz") ? wm.server->arg("hz").toInt() : PROFILE_DEFAULT_HZ;
+            if (!profileStart(hz)) {
+                reply(501, "text/plain", "Profiler not available");
+                return;
+            }
+        } else if (action == "stop") {
+            profileStop();
+        } else if (action == "reset") {
+            profileReset();
+        } else {
+            reply(400, "text/plain", "action must be start, stop or reset");
+            return;
+        }
+        
+        ProfileDumpHeader header;
+        profileFreeze(header);
+        profileThaw();
+        char json[128];
+        JsonWriter writer(json, sizeof(json));
+        writer.beginObject()
+            .member("running", profileRunning())
+            .member("hz", header.hz)
+            .member("samples", header.samples)
+            .member("dropped", header.dropped)
+            .member("durationMs", header.durationMs)
+            .endObject();
+        reply_P(200, "application/json", json, writer.ok() ? writer.length() : 0);
+    }));
+    
+    // Prometheus scrape target: every counter and gauge (see metrics.h)
+    wm.server->on("/metrics", HTTP_GET, traced(TRACE_ROUTE_METRICS, []() {
+        metricSet(METRIC_UPTIME, uptimeSeconds());
+        metricSet(METRIC_LIGHT_LEVEL, lastLightLevel);
+        metricSet(METRIC_BRIGHTNESS, (brightnessController.output() + 128) >> 8);
+        metricSet(METRIC_FREE_HEAP, ESP.getFreeHeap());
+        metricSet(METRIC_MIN_FREE_HEAP, ESP.getMinFreeHeap());
+        
+        static char chunk[METRICS_CHUNK_SIZE];
+        MetricsText text(FIRMWARE_VERSION, TRACE_ROUTE_NAMES, TRACE_ROUTE_COUNT);
+        wm.server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+        reply(200, "text/plain; version=0.0.4", "");
+        while (size_t length = text.next(chunk, sizeof(chunk))) {
+            wm.server->sendContent(chunk, length);
+        }
+        wm.server->sendContent("");
+    }));
+    
+    // Rate limits, and requests admitted and refused per route
+    wm.server->on("/api/admission", HTTP_GET, traced(TRACE_ROUTE_ADMISSION, []() {
+        char json[1280];
+        size_t length = formatAdmissionJson(json, sizeof(json));
+        reply_P(200, "application/json", json, length);
+    }));
+    
+    // Forget every client's bucket and zero the counts: action=reset
+    wm.server->on("/api/admission", HTTP_POST, traced(TRACE_ROUTE_ADMISSION, []() {
+        if (wm.server->arg("action") != "reset") {
+            reply(400, "text/plain", "action must be reset");
+            return;
+        }
+        admissionReset();
+        reply(200, "text/plain", "OK");
+    }));
+    
+    // Stack and heap health: latest sample, trend and alerts
+    wm.server->on("/api/health", HTTP_GET, traced(TRACE_ROUTE_HEALTH, []() {
+        char json[768];
+        size_t length = formatHealthJson(json, sizeof(json), healthMonitor);
+        reply_P(200, "application/json", json, length);
+    }));
+    
+    // Acknowledge latched health alerts: action=clear
+    wm.server->on("/api/health", HTTP_POST, traced(TRACE_ROUTE_HEALTH, []() {
+        if (wm.server->arg("action") != "clear") {
+            reply(400, "text/plain", "action must be clear");
+            return;
+        }
+        healthMonitor.clearLatched();
+        reply(200, "text/plain", "OK");
+    }));
+    
+    // Every health sample in the ring, oldest first, as CSV
+    wm.server->on("/api/health/history", HTTP_GET, traced(TRACE_ROUTE_HEALTH, []() {
+        char line[128];
+        wm.server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+        reply(200, "text/csv", "");
+        for (int i = -1; i < healthMonitor.count(); i++) {
+            size_t length = formatHealthCsvLine(line, sizeof(line), healthMonitor, i);
+            wm.server->sendContent(line, length);
+        }
+        wm.server->sendContent("");
+    }));
+    
+    // Pull updates: running version, download progress and the update log
+    wm.server->on("/api/update", HTTP_GET, traced(TRACE_ROUTE_UPDATE, []() {
+        char json[2048];
+        size_t length = formatUpdateJson(json, sizeof(json), settings.load());
+        reply_P(200, "application/json", json, length);
+    }));
+    
+    // Fetch the manifest now instead of at the next check: action=check
+    wm.server->on("/api/update", HTTP_POST, traced(TRACE_ROUTE_UPDATE, []() {
+        if (wm.server->arg("action") != "check") {
+            reply(400, "text/plain", "action must be check");
+            return;
+        }
+        if (!settings.load().updateUrl[0]) {
+            reply(409, "text/plain", "No update URL set");
+            return;
+        }
+        pullUpdateCheckNow();
+        reply(202, "text/plain", "Checking");
+    }));
 }
 
 // Then modify connectToWiFi()
 void connectToWiFi() {
-    Serial.println("Starting WiFiManager...");
+    LOG_INFO(LOG_CAT_NET, "Starting WiFiManager...");
     
     // Set portal title and theme
     wm.setTitle("WordClock");
@@ -502,16 +1178,12 @@ void connectToWiFi() {
             color: #444;
             margin-top: 20px;
         '>
-            Current Time: <span id='current-time'>--:--</span>
+            <canvas class='mirror' width='200' height='200' style='background: #111; border-radius: 4px;'></canvas>
+            <div>Device Time: <span class='mirror-clock'>--:--</span></div>
         </div>
+        <script src='/mirror.js'></script>
         <script>
-            function updateTime() {
-                const now = new Date();
-                const timeStr = now.toLocaleTimeString();
-                document.getElementById('current-time').textContent = timeStr;
-            }
-            updateTime();
-            setInterval(updateTime, 1000);
+            loadFrame().then(frame => watchFrame(frame.version)).catch(() => watchFrame(0));
         </script>
     )";
     
@@ -531,25 +1203,29 @@ void connectToWiFi() {
     
     // If default credentials are set, try them
     if (!connected && strlen(DEFAULT_WIFI_SSID) > 0) {
-        Serial.println("Trying default credentials...");
+        LOG_INFO(LOG_CAT_NET, "Trying default credentials...");
         WiFi.begin(DEFAULT_WIFI_SSID, DEFAULT_WIFI_PASSWORD);
         delay(5000);  // Give it time to connect
         connected = (WiFi.status() == WL_CONNECTED);
     }
     
+    if (!connected && pullUpdatePending()) {
+        // A restart would make the bootloader roll the new image back; loop() keeps trying
+        LOG_ERROR(LOG_CAT_NET, "Failed to connect, running offline until WiFi returns");
+        return;
+    }
     if (!connected) {
-        Serial.println("Failed to connect");
+        LOG_ERROR(LOG_CAT_NET, "Failed to connect");
         delay(3000);
         ESP.restart();
     }
     
     // Start the config portal in non-blocking mode
     wm.startWebPortal();
-    Serial.println("Web portal started");
+    LOG_INFO(LOG_CAT_NET, "Web portal started");
     
-    Serial.println("\nWiFi connected");
-    Serial.println("IP address: ");
-    Serial.println(WiFi.localIP());
+    IPAddress ip = WiFi.localIP();
+    LOG_INFO(LOG_CAT_NET, "WiFi connected, IP address: %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
 }
 
 // Add a simulated time for testing
@@ -557,182 +1233,194 @@ unsigned long lastUpdate = 0;
 time_t simulatedTime = 0;
 
 /**
- * Returns current time, either from NTP or simulation
+ * Clock source for the firmware, either from NTP or simulation
  * If network is available, returns actual time from NTP
  * If network is unavailable, returns simulated time advancing 1 minute per second
  */
-time_t getTime() {
-    if (WiFi.status() != WL_CONNECTED) {
-        // If no network, use simulated time
-        unsigned long currentMillis = millis();
-        if (currentMillis - lastUpdate >= 1000) {  // Every second
-            simulatedTime += 60;  // Add one minute
-            lastUpdate = currentMillis;
+class DeviceClock : public ClockSource {
+public:
+    time_t now() override {
+        if (WiFi.status() != WL_CONNECTED) {
+            // If no network, use simulated time
+            unsigned long currentMillis = millis();
+            if (currentMillis - lastUpdate >= 1000) {  // Every second
+                simulatedTime += 60;  // Add one minute
+                lastUpdate = currentMillis;
+            }
+            return simulatedTime;
         }
-        return simulatedTime;
+        return Australia.now();
     }
-    return Australia.now();
-}
+} deviceClock;
+
+// Where the display gets its time from
+ClockSource* clockSource = &deviceClock;
 
 /**
  * Displays the time on the LED matrix
  * @param localTime Current time (either real or simulated)
  * 
  * Process:
- * 1. Clears all LEDs
- * 2. Always displays "IT IS"
- * 3. Rounds minutes to nearest 5
- * 4. Determines minute phrase (PAST/TO)
- * 5. Determines hour (handling the "TO" case for next hour)
- * 6. Lights appropriate LEDs for all words
+ * 1. Rounds the time to the nearest 5 minutes
+ * 2. Skips the update if the rounded time is unchanged
+ * 3. Looks up the frame for the phrase (see clock_face.h)
+ * 4. Starts a crossfade to the frame (drawn by serviceTransitions())
  */
 void displayTime(time_t localTime) {
-    static int lastHour = -1;
-    static int lastMinute = -1;
-    
-    int hours = hour(localTime);
-    int minutes = minute(localTime);
-    
-    // Round minutes to nearest 5
-    int roundedMinutes = ((minutes + 2) / 5) * 5;
-    if (roundedMinutes == 60) {
-        roundedMinutes = 0;
-        hours = (hours + 1) % 24;
-    }
+    FaceTime rounded = roundTime(hourOf(localTime), minuteOf(localTime));
     
     // Only update display if time has changed
-    if (hours != lastHour || roundedMinutes != lastMinute) {
-        Serial.printf("Time updating: %02d:%02d (rounded from %02d:%02d)\n", 
-                     hours, roundedMinutes, hour(localTime), minute(localTime));
-        
-        lastHour = hours;
-        lastMinute = roundedMinutes;
-        
-        // Clear all LEDs
-        fill_solid(leds, NUM_LEDS, CRGB::Black);
-        
-        // Always display "IT IS"
-        for (int i = 0; i < WORD_LENGTHS[0]; i++) {
-            leds[WORDS[0][i]] = CRGB::White;
-        }
-        
-        // Convert 24-hour format to 12-hour
-        hours = hours % 12;
-        if (hours == 0) hours = 12;
-        
-        // Handle minute phrases
-        if (roundedMinutes > 30) {
-            hours = (hours % 12) + 1;
-            if (hours == 13) hours = 1;
-        }
-        
-        // Display minutes
-        if (roundedMinutes > 0) {
-            if (roundedMinutes <= 30) {
-                // PAST
-                for (int i = 0; i < WORD_LENGTHS[8]; i++) {
-                    leds[WORDS[8][i]] = CRGB::White;
-                }
-            } else {
-                // TO
-                for (int i = 0; i < WORD_LENGTHS[7]; i++) {
-                    leds[WORDS[7][i]] = CRGB::White;
-                }
-                roundedMinutes = 60 - roundedMinutes;
-            }
-            
-            // Handle specific minute patterns
-            if (roundedMinutes == 5) {
-                // FIVE
-                for (int i = 0; i < WORD_LENGTHS[5]; i++) {
-                    leds[WORDS[5][i]] = CRGB::White;
-                }
-            } else if (roundedMinutes == 10) {
-                // TEN
-                for (int i = 0; i < WORD_LENGTHS[2]; i++) {
-                    leds[WORDS[2][i]] = CRGB::White;
-                }
-            } else if (roundedMinutes == 15) {
-                // QUARTER
-                for (int i = 0; i < WORD_LENGTHS[3]; i++) {
-                    leds[WORDS[3][i]] = CRGB::White;
-                }
-            } else if (roundedMinutes == 20) {
-                // TWENTY
-                for (int i = 0; i < WORD_LENGTHS[4]; i++) {
-                    leds[WORDS[4][i]] = CRGB::White;
-                }
-            } else if (roundedMinutes == 25) {
-                // TWENTY FIVE
-                for (int i = 0; i < WORD_LENGTHS[4]; i++) {
-                    leds[WORDS[4][i]] = CRGB::White;
-                }
-                for (int i = 0; i < WORD_LENGTHS[5]; i++) {
-                    leds[WORDS[5][i]] = CRGB::White;
-                }
-            } else if (roundedMinutes == 30) {
-                // HALF
-                for (int i = 0; i < WORD_LENGTHS[1]; i++) {
-                    leds[WORDS[1][i]] = CRGB::White;
-                }
-            }
-        }
-        
-        // Display hour
-        int hourWordIndex;
-        switch (hours) {
-            case 1: hourWordIndex = 9; break;
-            case 2: hourWordIndex = 11; break;
-            case 3: hourWordIndex = 10; break;
-            case 4: hourWordIndex = 12; break;
-            case 5: hourWordIndex = 13; break;
-            case 6: hourWordIndex = 14; break;
-            case 7: hourWordIndex = 15; break;
-            case 8: hourWordIndex = 16; break;
-            case 9: hourWordIndex = 17; break;
-            case 10: hourWordIndex = 18; break;
-            case 11: hourWordIndex = 19; break;
-            case 12: hourWordIndex = 20; break;
-        }
-        
-        // Display hour word
-        for (int i = 0; i < WORD_LENGTHS[hourWordIndex]; i++) {
-            leds[WORDS[hourWordIndex][i]] = CRGB::White;
-        }
+    if (rounded != shownTime) {
+        traceRecord(TRACE_RENDER_BEGIN, rounded.hour, rounded.minute);
+        LOG_INFO(LOG_CAT_DISPLAY, "Time updating: %02d:%02d (rounded from %02d:%02d)", 
+                 rounded.hour, rounded.minute, hourOf(localTime), minuteOf(localTime));
         
-        // Only display O'CLOCK when it's exactly on the hour
-        if (roundedMinutes == 0) {
-            for (int i = 0; i < WORD_LENGTHS[21]; i++) {
-                leds[WORDS[21][i]] = CRGB::White;
-            }
-        }
+        shownTime = rounded;
+        transitions.setFrame(frameFor(rounded), millis());
+        stateVersion.bump(STATE_FRAME);
+        metricAdd(METRIC_PHRASES);
         
-        FastLED.show();
+        traceRecord(TRACE_RENDER_END);
     }
 }
 
+/**
+ * Shows the next transition frame if one is due; does nothing once the
+ * face has settled
+ */
+void serviceTransitions() {
+    if (!transitions.due(millis())) return;
+    uint32_t start = micros();
+    FastLED.setBrightness(transitions.render(millis(), leds));
+    showLeds();
+    transitions.recordFrameTime(micros() - start);
+    metricAdd(METRIC_FRAMES);
+}
+
 // Add these functions after testLEDs()
 int readLightLevel() {
-    int total = 0;
+    uint16_t samples[LIGHT_SAMPLES];
     for(int i = 0; i < LIGHT_SAMPLES; i++) {
-        total += analogRead(LIGHT_SENSOR_PIN);
-        delay(10);
+        samples[i] = analogRead(LIGHT_SENSOR_PIN);
+        // Wait 10 ms between samples, drawing any frames due meanwhile
+        uint32_t sampleDue = millis() + 10;
+        while ((int32_t)(sampleDue - millis()) > 0) {
+            uint32_t wait = sampleDue - millis();
+            if (transitions.active() && transitions.msUntilNextFrame(millis()) < wait) {
+                wait = transitions.msUntilNextFrame(millis());
+            }
+            delay(wait);
+            serviceTransitions();
+        }
     }
-    return total / LIGHT_SAMPLES;
+    metricAdd(METRIC_ADC_SAMPLES, LIGHT_SAMPLES);
+    int level = averageLightSamples(samples, LIGHT_SAMPLES);
+    traceRecord(TRACE_ADC_SAMPLE, 0, level);
+    return level;
 }
 
-void updateBrightness() {
-    int lightLevel = readLightLevel();
-    int newBrightness;
+#define TIMEZONE_RETRY_MS 60000  // Between attempts to set a timezone that failed
+
+// Last zone looked up by resolveTimezone(), so applying it needs no second lookup
+static char resolvedName[TIMEZONE_NAME_MAX] = "";
+static String resolvedRule;
+
+/**
+ * Checks that a timezone exists before a handler publishes it. Common zones
+ * are known here; others are looked up on ezTime's server, which blocks the
+ * handler as setting the zone always has. Handlers answer 400 on failure.
+ */
+bool resolveTimezone(const char* name) {
+    if (posixRuleFor(name) || strcmp(name, resolvedName) == 0) return true;
     
-    if (lightLevel < brightnessSettings.threshold) {
-        newBrightness = brightnessSettings.darkBrightness;
-    } else {
-        newBrightness = brightnessSettings.lightBrightness;
+    Timezone probe;
+    if (!probe.setLocation(name)) {
+        LOG_ERROR(LOG_CAT_NET, "Timezone %s not found", name);
+        return false;
+    }
+    snprintf(resolvedName, sizeof(resolvedName), "%s", name);
+    resolvedRule = probe.getPosix();
+    return true;
+}
+
+/**
+ * Switches the clock to a timezone: straight from the POSIX rule for common
+ * zones or one resolveTimezone() looked up, otherwise via ezTime's lookup
+ * server (a zone loaded from NVS at boot)
+ */
+bool applyTimezone(const char* name) {
+    static char applied[TIMEZONE_NAME_MAX] = "";
+    if (strcmp(name, applied) == 0) return true;
+    
+    const char* rule = posixRuleFor(name);
+    if (!rule && strcmp(name, resolvedName) == 0) rule = resolvedRule.c_str();
+    bool ok = rule ? Australia.setPosix(rule) : Australia.setLocation(name);
+    if (!ok) {
+        LOG_ERROR(LOG_CAT_NET, "Timezone %s could not be set", name);
+        return false;
     }
+    snprintf(applied, sizeof(applied), "%s", name);
+    LOG_INFO(LOG_CAT_NET, "Timezone set to %s", name);
+    return true;
+}
+
+/**
+ * Applies a newly published settings version. Runs on the display side
+ * only, so the curve, the transition engine and the timezone are never
+ * changed under the code using them.
+ */
+void applySettings() {
+    static uint32_t appliedVersion = UINT32_MAX;
+    static bool timezonePending = true;
+    static uint32_t lastTimezoneAttempt = 0;
     
-    FastLED.setBrightness(newBrightness);
-    FastLED.show();
+    if (settings.version() != appliedVersion) {
+        ClockSettings current = settings.load(&appliedVersion);
+        settingsStoreSave(current);
+        brightnessController.setCurve(current.curve);
+        transitions.setDuration(current.transitionMs);
+        transitions.setDitherBelow(current.ditherBelow);
+        timezonePending = true;
+        lastTimezoneAttempt = millis() - TIMEZONE_RETRY_MS;
+        updateBrightness();
+        stateVersion.bump(STATE_SETTINGS);
+    }
+    
+    // Zones may need the network, so wait for time sync and retry slowly
+    if (timezonePending && timeStatus() != timeNotSet && millis() - lastTimezoneAttempt >= TIMEZONE_RETRY_MS) {
+        lastTimezoneAttempt = millis();
+        timezonePending = !applyTimezone(settings.load().timezone);
+    }
+}
+
+/**
+ * Seconds since boot, carried across the 49-day millis() wrap
+ */
+uint32_t uptimeSeconds() {
+    static uint32_t seconds = 0;
+    static uint32_t lastMillis = 0;
+    static uint32_t carry = 0;
+    uint32_t now = millis();
+    carry += now - lastMillis;
+    lastMillis = now;
+    seconds += carry / 1000;
+    carry %= 1000;
+    return seconds;
+}
+
+void updateBrightness() {
+    int lightLevel = readLightLevel();
+    lastLightLevel = lightLevel;
+    lightCalibrationPoll(lightLevel, timeStatus() == timeNotSet ? -1 : hourOf(clockSource->now()));
+    static uint8_t lastBrightness = 0;
+    uint8_t brightness = brightnessController.update(lightLevel, millis());
+    if (brightness != lastBrightness) {
+        lastBrightness = brightness;
+        stateVersion.bump(STATE_BRIGHTNESS);
+        metricAdd(METRIC_BRIGHTNESS_CHANGES);
+    }
+    transitions.setBrightness(brightnessController.output(), millis());
+    lightHistory.record(uptimeSeconds(), lightLevel, (brightnessController.output() + 128) >> 8);
 }
 
 // Add a variable to track last brightness update
@@ -750,11 +1438,28 @@ unsigned long lastBrightnessCheck = 0;
  */
 void setup() {
     Serial.begin(115200);
-    Serial.println("Word Clock Starting...");
+    logBegin();
+    lightCalibrationBegin();
+    LOG_INFO(LOG_CAT_SYSTEM, "Word Clock Starting...");
+    
+    ClockSettings stored = settings.load();
+    settingsStoreLoad(stored);
+    settings.store(stored);
+    
+    // Record WiFi state changes in the trace ring
+    WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t) {
+        static bool connectedBefore = false;
+        traceRecord(TRACE_WIFI_STATE, event);
+        if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+            if (connectedBefore) metricAdd(METRIC_WIFI_RECONNECTS);
+            connectedBefore = true;
+        }
+    });
     
     // Initialize FastLED
     FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
     FastLED.setBrightness(50);
+    FastLED.setDither(DISABLE_DITHER);  // Low brightness is dithered by the transition engine
     showProgress(0);  // Show "IT IS ONE"
     
     // Test LEDs
@@ -774,18 +1479,19 @@ void setup() {
         int progressCount = 4;  // Start at FIVE
         
         while (syncAttempts < 3) {
-            Serial.printf("NTP sync attempt %d of 3...\n", syncAttempts + 1);
+            LOG_INFO(LOG_CAT_NET, "NTP sync attempt %d of 3...", syncAttempts + 1);
             showProgress(progressCount++);  // Show next number and increment
             waitForSync(10);
             
             if (timeStatus() != timeNotSet) {
-                Australia.setLocation("Australia/Sydney");
-                Serial.println("Current Sydney time: " + Australia.dateTime());
+                applyTimezone(settings.load().timezone);
+                LOG_INFO(LOG_CAT_NET, "Current local time: %s", Australia.dateTime());
                 simulatedTime = Australia.now();
                 break;
             }
             
-            Serial.println("Time sync failed, retrying...");
+            LOG_ERROR(LOG_CAT_NET, "Time sync failed, retrying...");
+            metricAdd(METRIC_NTP_FAILURES);
             delay(1000);
             syncAttempts++;
         }
@@ -793,20 +1499,38 @@ void setup() {
         showProgress(5);  // Show final number (SIX) before starting
         delay(1000);  // Show final progress state briefly
     }
+    
+    pullUpdateBegin();  // Loads the update log; a new image starts its self-check
 }
 
+#ifndef WIFI_RETRY_MS
+#define WIFI_RETRY_MS 30000  // Rejoin attempts after booting offline (see config.h)
+#endif
+
 /**
  * Main loop
  * 1. Handles ezTime events (if connected)
  * 2. Gets current time (real or simulated)
  * 3. Updates display
- * 4. Waits 1 second before next update
+ * 4. Runs pull updates and the self-check of a new image
+ * 5. Waits for the next transition frame, or 1 second when the face is settled
  */
 void loop() {
+    static uint32_t lastWiFiRetry = 0;
     if (WiFi.status() == WL_CONNECTED) {
+        if (!wm.getWebPortalActive()) {
+            // Booted offline with a new image (see connectToWiFi)
+            wm.startWebPortal();
+            setupOTA();
+            LOG_INFO(LOG_CAT_NET, "WiFi connected, web portal started");
+        }
         ArduinoOTA.handle();  // Handle OTA updates
         wm.process();         // Keep WiFiManager running
+    } else if (!wm.getWebPortalActive() && millis() - lastWiFiRetry >= WIFI_RETRY_MS) {
+        lastWiFiRetry = millis();
+        WiFi.begin();  // The saved network
     }
+    applySettings();  // Pick up anything the handlers just changed
     
     // Check if it's time to update brightness
     unsigned long currentMillis = millis();
@@ -816,47 +1540,52 @@ void loop() {
     }
     
     events();
-    displayTime(getTime());
-    delay(1000);
+    healthPoll();
+    
+    // Record NTP syncs in the trace ring
+    static time_t lastNtpSync = 0;
+    if (lastNtpUpdateTime() != lastNtpSync) {
+        lastNtpSync = lastNtpUpdateTime();
+        traceRecord(TRACE_NTP_SYNC, timeStatus());
+        stateVersion.bump(STATE_SYNC);
+        metricAdd(METRIC_NTP_SYNCS);
+    }
+    
+    // ezTime marks the time as needing a sync once a resync is overdue
+    static timeStatus_t lastTimeStatus = timeNotSet;
+    if (timeStatus() != lastTimeStatus) {
+        if (timeStatus() == timeNeedsSync) metricAdd(METRIC_NTP_FAILURES);
+        lastTimeStatus = timeStatus();
+    }
+    
+    displayTime(clockSource->now());
+    serviceTransitions();
+    longPollService();
+    pullUpdatePoll(settings.load());
+    if (pullUpdateBusy()) {
+        delay(UPDATE_POLL_MS);
+    } else {
+        delay(transitions.active() ? transitions.msUntilNextFrame(millis()) : 1000);
+    }
 }
 
 void showBootAnimation() {
     // Numbers 1-12 in sequence
-    const int NUMBERS[] = {9, 11, 10, 12, 13, 14, 15, 16, 17, 18, 19, 20};  // Word indices for 1-12
-    
-    for (int i = 0; i < 12; i++) {
-        fill_solid(leds, NUM_LEDS, CRGB::Black);  // Clear display
-        
-        // Show "IT IS"
-        for (int j = 0; j < WORD_LENGTHS[0]; j++) {
-            leds[WORDS[0][j]] = CRGB::White;
-        }
-        
-        // Show current number
-        for (int j = 0; j < WORD_LENGTHS[NUMBERS[i]]; j++) {
-            leds[WORDS[NUMBERS[i]][j]] = CRGB::White;
-        }
-        
-        FastLED.show();
+    for (int i = 1; i <= 12; i++) {
+        // Show "IT IS" and the current number
+        renderFrame(wordMask(WORD_IT_IS) | wordMask(HOUR_WORDS[i % 12]), leds);
+        showLeds();
         delay(500);  // Show each number for half a second
     }
     fill_solid(leds, NUM_LEDS, CRGB::Black);
-    FastLED.show();
+    showLeds();
 }
 
 // Add the function implementation
 void showProgress(int step) {
-    // Numbers in order of display for setup progress
-    const int PROGRESS_NUMBERS[] = {9, 11, 10, 12, 13, 14};  // Word indices for ONE through SIX
-    
-    if (step >= 0 && step < 6) {  // We have 6 progress steps
-        fill_solid(leds, NUM_LEDS, CRGB::Black);
-        
+    if (step >= 0 && step < 6) {  // We have 6 progress steps, ONE through SIX
         // Show progress number only
-        for (int j = 0; j < WORD_LENGTHS[PROGRESS_NUMBERS[step]]; j++) {
-            leds[WORDS[PROGRESS_NUMBERS[step]][j]] = CRGB::White;
-        }
-        
-        FastLED.show();
+        renderFrame(wordMask(HOUR_WORDS[step + 1]), leds);
+        showLeds();
     }
 } 
\ No newline at end of file
@@ -0,0 +1,149 @@
+/**
+ * Word Clock - Sampling CPU profiler
+ */
+
+#include "profiler.h"
+
+ProfileEntry profileTable[PROFILE_SLOTS];
+ProfileTask profileTasks[PROFILE_MAX_TASKS];
+
+static volatile bool profileFrozen = false;
+static volatile uint32_t profileSamples = 0;
+static volatile uint32_t profileDropped = 0;
+static void* profileTaskHandles[PROFILE_MAX_TASKS];  // Task behind each profileTasks entry
+static volatile uint32_t profileTaskCount = 0;
+static uint32_t profileHz = 0;
+static uint32_t profileElapsedMs = 0;  // Sampling time before the current run
+static uint32_t profileStartedAt = 0;
+static bool profileActive = false;
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define PROFILE_TIMER 0        // Hardware timer used for sampling
+#define PROFILE_MAX_PROBES 16  // Slots tried before a sample is dropped
+
+static hw_timer_t* profileTimer = nullptr;
+
+// Interrupt frame layout saved by the ESP-IDF RISC-V vectors (rvruntime-frames.h)
+struct InterruptFrame {
+    uint32_t mepc;
+    uint32_t ra;
+};
+
+static uint32_t IRAM_ATTR taskIndex(TaskHandle_t task) {
+    uint32_t count = profileTaskCount;
+    for (uint32_t i = 0; i < count; i++) {
+        if (profileTaskHandles[i] == task) return i;
+    }
+    return PROFILE_NO_TASK;
+}
+
+/**
+ * Timer interrupt: counts one sample for the interrupted code
+ */
+static void IRAM_ATTR profileSample() {
+    if (profileFrozen) return;
+    profileSamples = profileSamples + 1;
+
+    uint32_t pc;
+    asm volatile("csrr %0, mepc" : "=r"(pc));
+
+    // FreeRTOS saves the interrupted task's stack pointer, which points at
+    // its interrupt frame, in the first word of the TCB
+    uint32_t caller = 0;
+    uint32_t task = PROFILE_NO_TASK;
+    TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+    if (handle) {
+        const InterruptFrame* frame = *(const InterruptFrame**)handle;
+        if (frame && frame->mepc == pc) caller = frame->ra;
+
+        task = taskIndex(handle);
+        if (task == PROFILE_NO_TASK && profileTaskCount < PROFILE_MAX_TASKS) {
+            task = profileTaskCount;
+            profileTaskHandles[task] = handle;
+            strncpy(profileTasks[task].name, pcTaskGetName(handle), PROFILE_TASK_NAME - 1);
+            profileTaskCount = task + 1;
+        }
+    }
+
+    uint32_t slot = ((pc ^ (caller * 31) ^ task) * 2654435761u) >> 16;
+    for (int probe = 0; probe < PROFILE_MAX_PROBES; probe++, slot++) {
+        ProfileEntry& e = profileTable[slot & (PROFILE_SLOTS - 1)];
+        if (e.count == 0) {
+            e = {pc, caller, task, 1};
+            return;
+        }
+        if (e.pc == pc && e.caller == caller && e.task == task) {
+            e.count++;
+            return;
+        }
+    }
+    profileDropped = profileDropped + 1;
+}
+
+bool profileStart(uint32_t hz) {
+    if (hz < 1) hz = 1;
+    if (hz > PROFILE_MAX_HZ) hz = PROFILE_MAX_HZ;
+    if (!profileTimer) {
+        profileTimer = timerBegin(PROFILE_TIMER, 80, true);  // 80 MHz APB / 80 = 1 us ticks
+        if (!profileTimer) return false;
+        timerAttachInterrupt(profileTimer, &profileSample, true);
+    }
+    if (!profileActive) profileStartedAt = millis();
+    profileHz = hz;
+    profileActive = true;
+    timerAlarmWrite(profileTimer, 1000000 / hz, true);
+    timerAlarmEnable(profileTimer);
+    return true;
+}
+
+void profileStop() {
+    if (!profileActive) return;
+    timerAlarmDisable(profileTimer);
+    profileElapsedMs += millis() - profileStartedAt;
+    profileActive = false;
+}
+
+#else
+
+// No sampling timer outside the device (the host emulator)
+bool profileStart(uint32_t) { return false; }
+void profileStop() {}
+
+#endif // ESP_PLATFORM
+
+void profileReset() {
+    profileFrozen = true;
+    memset(profileTable, 0, sizeof(profileTable));
+    memset(profileTasks, 0, sizeof(profileTasks));
+    memset(profileTaskHandles, 0, sizeof(profileTaskHandles));
+    profileTaskCount = 0;
+    profileSamples = 0;
+    profileDropped = 0;
+    profileElapsedMs = 0;
+    profileStartedAt = millis();
+    profileFrozen = false;
+}
+
+bool profileRunning() {
+    return profileActive;
+}
+
+void profileFreeze(ProfileDumpHeader& header) {
+    profileFrozen = true;
+    header.magic = PROFILE_MAGIC;
+    header.version = PROFILE_FORMAT_VERSION;
+    header.entrySize = sizeof(ProfileEntry);
+    header.slots = PROFILE_SLOTS;
+    header.taskCount = PROFILE_MAX_TASKS;
+    header.samples = profileSamples;
+    header.dropped = profileDropped;
+    header.hz = profileHz;
+    header.durationMs = profileElapsedMs + (profileActive ? millis() - profileStartedAt : 0);
+}
+
+void profileThaw() {
+    profileFrozen = false;
+}
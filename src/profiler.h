@@ -0,0 +1,99 @@
+/**
+ * Word Clock - Sampling CPU profiler
+ *
+ * A hardware timer interrupts the CPU PROFILE rate times a second and
+ * records where it was: the interrupted program counter, the return
+ * address (the caller, for leaf functions) and the running task. Samples
+ * are counted in a fixed hash table in RAM, so profiling costs no
+ * allocation and can run for hours.
+ *
+ * Control it at runtime from /api/profile (POST action=start|stop|reset,
+ * optional hz), download the table with GET /api/profile and symbolise it
+ * against firmware.elf with tools/profsym.cpp.
+ *
+ * Code that runs with interrupts masked (critical sections, other ISRs)
+ * cannot be sampled; its time is attributed to whatever runs next.
+ *
+ * This header is shared with the host tools, so everything outside the
+ * ARDUINO section must stay plain C++.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#define PROFILE_MAGIC 0x52504357  // "WCPR" little-endian
+#define PROFILE_FORMAT_VERSION 1
+
+#ifndef PROFILE_SLOTS
+#define PROFILE_SLOTS 512         // Distinct (pc, caller, task) entries (must be a power of two)
+#endif
+
+#ifndef PROFILE_DEFAULT_HZ
+#define PROFILE_DEFAULT_HZ 997    // Prime, so sampling does not lock onto the 1 kHz tick
+#endif
+
+#define PROFILE_MAX_HZ 10000
+#define PROFILE_MAX_TASKS 16
+#define PROFILE_TASK_NAME 16
+#define PROFILE_NO_TASK 0xFFFFFFFF
+
+static_assert((PROFILE_SLOTS & (PROFILE_SLOTS - 1)) == 0, "PROFILE_SLOTS must be a power of two");
+
+struct ProfileEntry {
+    uint32_t pc;      // Interrupted program counter
+    uint32_t caller;  // Return address register at the time (0 if unknown)
+    uint32_t task;    // Index into the task table, or PROFILE_NO_TASK
+    uint32_t count;   // Samples; 0 marks an empty slot
+};
+
+struct ProfileTask {
+    char name[PROFILE_TASK_NAME];  // NUL-terminated FreeRTOS task name
+};
+
+struct ProfileDumpHeader {
+    uint32_t magic;       // PROFILE_MAGIC
+    uint16_t version;     // PROFILE_FORMAT_VERSION
+    uint16_t entrySize;   // sizeof(ProfileEntry)
+    uint32_t slots;       // ProfileEntry records that follow (empty ones included)
+    uint32_t taskCount;   // ProfileTask records after the entries
+    uint32_t samples;     // Samples taken, including dropped ones
+    uint32_t dropped;     // Samples lost because the table was full
+    uint32_t hz;          // Sampling rate
+    uint32_t durationMs;  // Time spent sampling
+};
+
+static_assert(sizeof(ProfileEntry) == 16, "ProfileEntry layout changed");
+static_assert(sizeof(ProfileTask) == 16, "ProfileTask layout changed");
+static_assert(sizeof(ProfileDumpHeader) == 32, "ProfileDumpHeader layout changed");
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+extern ProfileEntry profileTable[PROFILE_SLOTS];
+extern ProfileTask profileTasks[PROFILE_MAX_TASKS];
+
+/**
+ * Starts (or re-rates) sampling; samples add to the existing table
+ * @return false if the profiler is not available on this target
+ */
+bool profileStart(uint32_t hz = PROFILE_DEFAULT_HZ);
+
+void profileStop();
+
+// Clears the table and counters
+void profileReset();
+
+bool profileRunning();
+
+/**
+ * Pauses sampling and describes the table for a download.
+ * Call profileThaw() once profileTable and profileTasks have been sent.
+ */
+void profileFreeze(ProfileDumpHeader& header);
+void profileThaw();
+
+#endif // ARDUINO
+
+#endif // PROFILER_H
@@ -0,0 +1,494 @@
+/**
+ * Word Clock - Pull updates and boot verification
+ */
+
+#include "pull_update.h"
+#include "log.h"
+#include <HTTPClient.h>
+#include <Preferences.h>
+#include <Update.h>
+#include <WiFi.h>
+#include <esp_ota_ops.h>
+#include <ezTime.h>
+
+#define UPDATE_NVS_NAMESPACE "update"
+#define UPDATE_NVS_KEY "log"
+
+#ifdef ESP_PLATFORM
+// Keep a new image pending until the self-check below has passed, rather
+// than letting the Arduino core mark it valid before setup()
+extern "C" bool verifyRollbackLater() {
+    return true;
+}
+#endif
+
+#define MANIFEST_MAX 1024  // Raw text; JsonReader holds 512 bytes of keys and values
+#define CHUNK_SIZE 1460    // One TCP segment
+
+UpdateLog updateLog;
+
+enum PullState : uint8_t {
+    PULL_IDLE,
+    PULL_DOWNLOADING,  // Reading the image, or backing off before the next request
+};
+
+enum CheckState : uint8_t {
+    CHECK_DONE,
+    CHECK_RENDER,    // Waiting for the face to be drawn
+    CHECK_REQUEST,   // Waiting to ask our own web server
+    CHECK_RESPONSE,  // Waiting for its answer
+};
+
+static PullState state = PULL_IDLE;
+static CheckState check = CHECK_DONE;
+static uint32_t checkPolled = 0;
+static uint32_t checkElapsed = 0;  // Time the self-check has run with WiFi up
+static uint32_t framesAtBoot = 0;
+static WiFiClient checkClient;
+
+static bool checkDue = true;   // First check soon after boot
+static uint32_t lastCheck = 0;
+static uint32_t lastCheckUtc = 0;
+static char lastResult[UPDATE_DETAIL_MAX] = "";
+static UpdateManifest manifest;
+
+static HTTPClient http;
+static bool connected = false;
+static long skip = 0;         // Body bytes already received, repeated by the server
+static uint32_t lastByte = 0;
+static int resumes = 0;
+static UpdateDownload download;
+
+static UpdateEncoding encoding = UPDATE_RAW;  // Of what is being downloaded
+static const char* downloadUrl = "";
+static ImageDecoder decoder;
+static uint8_t chunk[CHUNK_SIZE];
+static size_t chunkUsed = 0;    // Received bytes up to chunkLength wait for the decoder
+static size_t chunkLength = 0;
+static char deltaFailed[UPDATE_VERSION_MAX] = "";  // Fetch this version whole next time
+
+// Update timing, for the log and /api/update
+static uint32_t downloadStarted = 0;
+static uint32_t decodeUs = 0;
+static uint32_t flashUs = 0;
+
+static uint32_t utcNow() {
+    return timeStatus() == timeNotSet ? 0 : (uint32_t)UTC.now();
+}
+
+static void saveLog() {
+    Preferences prefs;
+    if (!prefs.begin(UPDATE_NVS_NAMESPACE, false)) {
+        LOG_ERROR(LOG_CAT_OTA, "Update log: NVS unavailable");
+        return;
+    }
+    prefs.putBytes(UPDATE_NVS_KEY, updateLog.data(), UpdateLog::dataSize());
+    prefs.end();
+}
+
+void updateRecord(UpdateEventKind kind, UpdateSource source, const char* version, const char* detail) {
+    updateLog.record(utcNow(), kind, source, version, detail);
+    saveLog();
+    if (kind == UPDATE_STARTED) metricAdd(METRIC_OTA_ATTEMPTS);
+    if (kind == UPDATE_FAILED) metricAdd(METRIC_OTA_FAILURES);
+    if (kind == UPDATE_ROLLED_BACK) metricAdd(METRIC_OTA_ROLLBACKS);
+    const char* named = version && *version ? version : "new image";
+    LOG_INFO(LOG_CAT_OTA, "Update %s (%s) %s: %s", UPDATE_EVENT_NAMES[kind], source == UPDATE_PULL ? "pull" : "push",
+             named, detail ? detail : "");
+}
+
+// Boot verification
+
+bool pullUpdatePending() {
+    esp_ota_img_states_t image;
+    return esp_ota_get_state_partition(esp_ota_get_running_partition(), &image) == ESP_OK &&
+           image == ESP_OTA_IMG_PENDING_VERIFY;
+}
+
+void pullUpdateBegin() {
+    Preferences prefs;
+    if (prefs.begin(UPDATE_NVS_NAMESPACE, true)) {
+        static uint8_t buffer[UpdateLog::dataSize()];
+        size_t size = prefs.getBytes(UPDATE_NVS_KEY, buffer, sizeof(buffer));
+        prefs.end();
+        updateLog.load(buffer, size);
+    }
+    if (pullUpdatePending()) {
+        check = CHECK_RENDER;
+        checkPolled = millis();
+        checkElapsed = 0;
+        framesAtBoot = metricValue(METRIC_FRAMES);
+        LOG_INFO(LOG_CAT_OTA, "Update: new image, self-check running");
+        return;
+    }
+
+    // Installed last time but never verified: the bootloader kept the old image, or cannot roll back
+    const UpdateEvent* last = updateLog.latest();
+    if (last && last->kind == UPDATE_INSTALLED) {
+        if (last->version[0] && strcmp(last->version, FIRMWARE_VERSION) != 0) {
+            updateRecord(UPDATE_ROLLED_BACK, last->source, last->version, "Did not boot");
+        } else {
+            updateRecord(UPDATE_VERIFIED, last->source, FIRMWARE_VERSION, "Booted, no self-check");
+        }
+    }
+}
+
+static void finishCheck(bool passed, const char* detail) {
+    check = CHECK_DONE;
+    checkClient.stop();
+    const UpdateEvent* last = updateLog.latest();
+    UpdateSource source = last && last->kind == UPDATE_INSTALLED ? last->source : UPDATE_PUSH;
+    if (passed) {
+        esp_ota_mark_app_valid_cancel_rollback();
+        updateRecord(UPDATE_VERIFIED, source, FIRMWARE_VERSION, detail);
+        return;
+    }
+    // Under the version the manifest offered, which is what rolledBack() is asked about,
+    // in case the image calls itself something else
+    const char* version = last && last->kind == UPDATE_INSTALLED && last->version[0] ? last->version
+                                                                                     : FIRMWARE_VERSION;
+    updateRecord(UPDATE_ROLLED_BACK, source, version, detail);
+    LOG_ERROR(LOG_CAT_OTA, "Update: self-check failed, restoring the previous image");
+    delay(100);  // Let the log drain
+    esp_ota_mark_app_invalid_rollback_and_reboot();
+}
+
+static void pollCheck() {
+    // The web server only runs while WiFi is up, so time without it does not count against the image
+    uint32_t now = millis();
+    if (WiFi.status() == WL_CONNECTED) checkElapsed += now - checkPolled;
+    checkPolled = now;
+    if (checkElapsed > UPDATE_CHECK_TIMEOUT_MS) {
+        finishCheck(false, check == CHECK_RENDER ? "Face not drawn" : "Web server did not answer");
+        return;
+    }
+    switch (check) {
+        case CHECK_RENDER:
+            if (metricValue(METRIC_PHRASES) > 0 && metricValue(METRIC_FRAMES) > framesAtBoot) check = CHECK_REQUEST;
+            break;
+        case CHECK_REQUEST:
+            // Over loopback, so nothing goes through the access point; loop()
+            // only serves the web server while WiFi is up. Answered by
+            // wm.process() later in this loop() pass, or the next.
+            if (WiFi.status() != WL_CONNECTED || !checkClient.connect(IPAddress(127, 0, 0, 1), 80)) break;
+            checkClient.write("GET " UPDATE_CHECK_PATH " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+            check = CHECK_RESPONSE;
+            break;
+        case CHECK_RESPONSE: {
+            if (checkClient.available() < 12) {
+                if (!checkClient.connected()) check = CHECK_REQUEST;
+                break;
+            }
+            char status[13] = {};
+            checkClient.read((uint8_t*)status, 12);
+            if (strncmp(status + 9, "200", 3) == 0) {
+                finishCheck(true, "Face drawn, web server answered");
+            } else {
+                checkClient.stop();
+                check = CHECK_REQUEST;
+            }
+            break;
+        }
+        case CHECK_DONE:
+            break;
+    }
+}
+
+// Manifest and download
+
+static void setResult(const char* result) {
+    snprintf(lastResult, sizeof(lastResult), "%s", result);
+}
+
+static void abandon(const char* why) {
+    if (connected) http.end();
+    connected = false;
+    chunkUsed = chunkLength = 0;
+    Update.abort();
+    state = PULL_IDLE;
+    setResult(why);
+    updateRecord(UPDATE_FAILED, UPDATE_PULL, manifest.version, why);
+}
+
+static const char* runningMd5() {
+    static char md5[UPDATE_MD5_SIZE] = "";
+    if (!md5[0]) snprintf(md5, sizeof(md5), "%s", ESP.getSketchMD5().c_str());
+    return md5;
+}
+
+static bool writeImage(const uint8_t* data, size_t size) {
+    uint32_t start = micros();
+    bool ok = Update.write(const_cast<uint8_t*>(data), size) == size;
+    flashUs += micros() - start;
+    return ok;
+}
+
+static bool decoderWrite(void*, const uint8_t* data, size_t size) {
+    return writeImage(data, size);
+}
+
+static bool decoderReadBase(void*, uint32_t offset, uint8_t* buffer, size_t size) {
+    return esp_partition_read(esp_ota_get_running_partition(), offset, buffer, size) == ESP_OK;
+}
+
+static unsigned long kbPerSecond(uint32_t bytes, uint32_t us) {
+    return us ? (unsigned long)((uint64_t)bytes * 1000000 / 1024 / us) : 0;
+}
+
+// Bytes of the image written so far
+static uint32_t imageWritten() {
+    return encoding == UPDATE_RAW ? download.offset() : decoder.produced();
+}
+
+static void checkManifest(const char* url) {
+    lastCheck = millis();
+    lastCheckUtc = utcNow();
+    checkDue = false;
+
+    HTTPClient request;
+    request.setConnectTimeout(UPDATE_CONNECT_TIMEOUT_MS);
+    request.setTimeout(UPDATE_HEADER_TIMEOUT_MS);
+    if (!request.begin(url)) {
+        setResult("Bad manifest URL");
+        return;
+    }
+    int code = request.GET();
+    // getString() reads until the connection closes when there is no
+    // Content-Length (-1), so the length must be known and small
+    int size = request.getSize();
+    if (code != 200 || size <= 0 || size > MANIFEST_MAX) {
+        char why[UPDATE_DETAIL_MAX];
+        if (code != 200) snprintf(why, sizeof(why), "Manifest: HTTP %d", code);
+        else snprintf(why, sizeof(why), size > 0 ? "Manifest too large" : "Manifest has no Content-Length");
+        setResult(why);
+        request.end();
+        return;
+    }
+    String body = request.getString();
+    request.end();
+
+    char error[UPDATE_DETAIL_MAX];
+    if (!parseUpdateManifest(body.c_str(), body.length(), url, manifest, error, sizeof(error))) {
+        setResult(error);
+        return;
+    }
+    if (strcmp(manifest.version, FIRMWARE_VERSION) == 0) {
+        setResult("Up to date");
+        return;
+    }
+    if (updateLog.rolledBack(manifest.version)) {
+        setResult("Offered version was rolled back");
+        return;
+    }
+    if (!Update.begin(manifest.size) || !Update.setMD5(manifest.md5)) {
+        Update.abort();
+        setResult("Image does not fit");
+        updateRecord(UPDATE_FAILED, UPDATE_PULL, manifest.version, "Image does not fit");
+        return;
+    }
+
+    encoding = manifest.encoding;
+    if (manifest.deltaUrl[0] && strcmp(deltaFailed, manifest.version) != 0) {
+        encoding = chooseUpdateEncoding(manifest, runningMd5());
+    }
+    uint32_t transferSize = encoding == UPDATE_DELTA ? manifest.deltaSize : manifest.transferSize;
+    downloadUrl = encoding == UPDATE_DELTA ? manifest.deltaUrl : manifest.url;
+    if (encoding == UPDATE_DELTA) {
+        decoder.begin(decoderWrite, decoderReadBase, nullptr, runningMd5(), ESP.getSketchSize());
+    } else {
+        decoder.begin(decoderWrite, nullptr, nullptr, nullptr, 0);
+    }
+    chunkUsed = chunkLength = 0;
+
+    char detail[UPDATE_DETAIL_MAX];
+    snprintf(detail, sizeof(detail), "%s, %lu of %lu bytes", UPDATE_ENCODING_NAMES[encoding],
+             (unsigned long)transferSize, (unsigned long)manifest.size);
+    updateRecord(UPDATE_STARTED, UPDATE_PULL, manifest.version, detail);
+    setResult("Downloading");
+    download.begin(transferSize, millis());
+    resumes = 0;
+    downloadStarted = millis();
+    decodeUs = flashUs = 0;
+    state = PULL_DOWNLOADING;
+}
+
+// Sends the next request for the image, from where the download stands
+static bool requestImage() {
+    http.setConnectTimeout(UPDATE_CONNECT_TIMEOUT_MS);
+    http.setTimeout(UPDATE_HEADER_TIMEOUT_MS);
+    if (!http.begin(downloadUrl)) return false;
+    char range[24];
+    if (download.formatRange(range, sizeof(range))) {
+        http.addHeader("Range", range);
+        resumes++;
+    }
+    static const char* HEADERS[] = {"Content-Range"};
+    http.collectHeaders(HEADERS, 1);
+    int code = http.GET();
+    skip = download.accept(code, http.header("Content-Range").c_str());
+    if (skip < 0) {
+        LOG_ERROR(LOG_CAT_OTA, "Update: HTTP %d at offset %lu", code, (unsigned long)download.offset());
+        http.end();
+        return false;
+    }
+    connected = true;
+    lastByte = millis();
+    return true;
+}
+
+static void dropped() {
+    if (connected) http.end();
+    connected = false;
+    if (!download.failed(millis())) {
+        char why[UPDATE_DETAIL_MAX];
+        snprintf(why, sizeof(why), "Gave up at %lu of %lu", (unsigned long)download.offset(),
+                 (unsigned long)download.size());
+        abandon(why);
+    }
+}
+
+// Runs the decoder over received bytes; false once the update was abandoned
+static bool decodeReceived() {
+    uint32_t start = micros();
+    uint32_t flashBefore = flashUs;
+    chunkUsed += decoder.feed(chunk + chunkUsed, chunkLength - chunkUsed);
+    decodeUs += micros() - start - (flashUs - flashBefore);
+    if (decoder.failed() || (decoder.done() && chunkUsed < chunkLength)) {
+        // A delta that will not apply is fetched whole at the next check
+        if (encoding == UPDATE_DELTA) {
+            snprintf(deltaFailed, sizeof(deltaFailed), "%s", manifest.version);
+            checkDue = true;
+        }
+        abandon(decoder.failed() ? decoder.error() : "Data after the encoded image");
+        return false;
+    }
+    return true;
+}
+
+static void finishDownload() {
+    http.end();
+    connected = false;
+    state = PULL_IDLE;
+    if (encoding != UPDATE_RAW && !decoder.done()) {
+        abandon("Encoded image ended early");
+        return;
+    }
+    if (!Update.end()) {
+        setResult(Update.errorString());
+        updateRecord(UPDATE_FAILED, UPDATE_PULL, manifest.version, Update.errorString());
+        return;
+    }
+    uint32_t elapsed = millis() - downloadStarted;
+    uint32_t written = imageWritten();
+    LOG_INFO(LOG_CAT_OTA, "Update: %s, %lu bytes fetched for %lu, %lu ms; decode %lu KB/s, flash %lu KB/s",
+             UPDATE_ENCODING_NAMES[encoding], (unsigned long)download.size(), (unsigned long)written,
+             (unsigned long)elapsed, kbPerSecond(written, decodeUs), kbPerSecond(written, flashUs));
+    char detail[64];
+    snprintf(detail, sizeof(detail), "%lu/%lu KB, %lu.%lu s, %d resumes", (unsigned long)download.size() / 1024,
+             (unsigned long)written / 1024, (unsigned long)elapsed / 1000, (unsigned long)elapsed / 100 % 10, resumes);
+    updateRecord(UPDATE_INSTALLED, UPDATE_PULL, manifest.version, detail);
+    delay(100);  // Let the log drain
+    ESP.restart();
+}
+
+static void downloadSlice() {
+    uint32_t start = millis();
+    while (millis() - start < UPDATE_SLICE_MS) {
+        // Received bytes go through the decoder first, however the connection is doing
+        if (chunkUsed < chunkLength || decoder.pending()) {
+            if (!decodeReceived()) return;
+            continue;
+        }
+        if (download.complete()) {
+            finishDownload();
+            return;
+        }
+        if (!connected) {
+            if (!download.due(millis())) return;
+            if (!requestImage()) {
+                dropped();
+                return;
+            }
+        }
+
+        WiFiClient* stream = http.getStreamPtr();
+        int available = stream->available();
+        if (available <= 0) {
+            if (!stream->connected() || millis() - lastByte > UPDATE_HTTP_TIMEOUT_MS) dropped();
+            return;
+        }
+        int n = stream->read(chunk, available < (int)sizeof(chunk) ? available : sizeof(chunk));
+        if (n <= 0) return;
+        lastByte = millis();
+        int offset = 0;
+        if (skip > 0) {
+            offset = n < skip ? n : skip;
+            skip -= offset;
+        }
+        size_t wanted = n - offset;
+        if (download.offset() + wanted > download.size()) wanted = download.size() - download.offset();
+        download.received(wanted);
+        metricAdd(METRIC_OTA_BYTES, wanted);
+        if (encoding != UPDATE_RAW) {
+            chunkUsed = offset;
+            chunkLength = offset + wanted;
+        } else if (wanted && !writeImage(chunk + offset, wanted)) {
+            abandon(Update.errorString());
+            return;
+        }
+    }
+}
+
+void pullUpdatePoll(const ClockSettings& settings) {
+    if (check != CHECK_DONE) {
+        pollCheck();
+        return;  // Nothing new is fetched until this image is known good
+    }
+    if (state == PULL_DOWNLOADING) {
+        downloadSlice();
+        return;
+    }
+    if (!settings.updateUrl[0] || WiFi.status() != WL_CONNECTED) return;
+    if (checkDue || millis() - lastCheck >= settings.updateHours * 3600000UL) checkManifest(settings.updateUrl);
+}
+
+bool pullUpdateBusy() {
+    return state == PULL_DOWNLOADING || check != CHECK_DONE;
+}
+
+void pullUpdateCheckNow() {
+    checkDue = true;
+}
+
+size_t formatUpdateJson(char* buffer, size_t size, const ClockSettings& settings) {
+    static const char* const CHECK_NAMES[] = {"done", "render", "request", "response"};
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .member("running", FIRMWARE_VERSION)
+        .member("url", (const char*)settings.updateUrl)
+        .member("hours", settings.updateHours)
+        .member("state", state == PULL_DOWNLOADING ? "downloading" : check != CHECK_DONE ? "verifying" : "idle");
+    if (check != CHECK_DONE) json.member("selfCheck", CHECK_NAMES[check]);
+    json.member("lastCheckUtc", (unsigned long)lastCheckUtc)
+        .member("lastResult", (const char*)lastResult);
+    if (state == PULL_DOWNLOADING) {
+        uint32_t written = imageWritten();
+        json.key("download").beginObject()
+            .member("version", (const char*)manifest.version)
+            .member("encoding", UPDATE_ENCODING_NAMES[encoding])
+            .member("received", (unsigned long)download.offset())
+            .member("size", (unsigned long)download.size())
+            .member("written", (unsigned long)written)
+            .member("imageSize", (unsigned long)manifest.size)
+            .member("elapsedMs", (unsigned long)(millis() - downloadStarted))
+            .member("decodeKBps", kbPerSecond(written, decodeUs))
+            .member("flashKBps", kbPerSecond(written, flashUs))
+            .member("resumes", resumes)
+            .member("failures", download.failures())
+            .endObject();
+    }
+    json.key("log");
+    updateLog.writeJson(json);
+    json.endObject();
+    return json.ok() ? json.length() : 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * Word Clock - Pull updates and boot verification
+ *
+ * Every updateHours the clock fetches the manifest at the updateUrl
+ * setting (see firmware_update.h). When it offers a version other than
+ * the running one, and not one rolled back before, the image is streamed
+ * through Update into the inactive OTA partition. Each loop() pass writes
+ * at most UPDATE_SLICE_MS of it, so the face and the web server keep
+ * running. Opening a request, for the manifest or for the image at the
+ * start and after each backoff, does wait in loop(): for a DNS lookup,
+ * then up to UPDATE_CONNECT_TIMEOUT_MS to connect and
+ * UPDATE_HEADER_TIMEOUT_MS for the headers. A dropped connection is
+ * resumed with a Range request after a backoff. A compressed image, or a delta against the running image
+ * when the manifest offers one for it, is decoded on the way through
+ * (see image_codec.h); a delta that will not apply is fetched whole at
+ * the next check.
+ *
+ * A new image, pulled or pushed, boots pending verification. It is kept
+ * once the face has been drawn and the web server has answered the
+ * clock's own request for UPDATE_CHECK_PATH over loopback. If that does
+ * not happen within UPDATE_CHECK_TIMEOUT_MS of running with WiFi up, the
+ * previous image is restored; time without WiFi does not count, and a
+ * pending image does not restart when it cannot join the network, since
+ * the bootloader would roll it back. This needs a bootloader built with
+ * app rollback; without one a new image is kept as soon as it boots. Every step goes into an UpdateLog kept in NVS
+ * and served by /api/update.
+ */
+
+#ifndef PULL_UPDATE_H
+#define PULL_UPDATE_H
+
+#include <word_clock_core.h>
+
+#ifndef FIRMWARE_VERSION
+#define FIRMWARE_VERSION "unknown"  // Set from git describe by platformio.ini
+#endif
+
+#ifndef UPDATE_SLICE_MS
+#define UPDATE_SLICE_MS 40  // Longest one download slice holds up loop()
+#endif
+
+#ifndef UPDATE_POLL_MS
+#define UPDATE_POLL_MS 10  // loop() delay while a download or self-check is running
+#endif
+
+#ifndef UPDATE_CONNECT_TIMEOUT_MS
+#define UPDATE_CONNECT_TIMEOUT_MS 1500  // TCP connect, while loop() waits
+#endif
+
+#ifndef UPDATE_HEADER_TIMEOUT_MS
+#define UPDATE_HEADER_TIMEOUT_MS 1500  // Response headers, and the manifest body, while loop() waits
+#endif
+
+#ifndef UPDATE_HTTP_TIMEOUT_MS
+#define UPDATE_HTTP_TIMEOUT_MS 10000  // Silence mid-body; read a slice at a time, so loop() runs on
+#endif
+
+#ifndef UPDATE_CHECK_TIMEOUT_MS
+#define UPDATE_CHECK_TIMEOUT_MS 120000  // For a new image to pass its self-check
+#endif
+
+#ifndef UPDATE_CHECK_PATH
+#define UPDATE_CHECK_PATH "/api/status.bin"
+#endif
+
+extern UpdateLog updateLog;
+
+// Whether the running image is new and not yet verified; callable before pullUpdateBegin()
+bool pullUpdatePending();
+
+/**
+ * Loads the log and starts the self-check if this image is pending
+ * verification; call at the end of setup()
+ */
+void pullUpdateBegin();
+
+// Runs the self-check, the manifest check and the download; call from loop()
+void pullUpdatePoll(const ClockSettings& settings);
+
+// Whether a download or self-check is running, so loop() should come back soon
+bool pullUpdateBusy();
+
+// Makes the next pullUpdatePoll() fetch the manifest
+void pullUpdateCheckNow();
+
+/**
+ * Records an update event in the log and NVS, and counts it in the
+ * OTA metrics
+ */
+void updateRecord(UpdateEventKind kind, UpdateSource source, const char* version, const char* detail);
+
+/**
+ * Writes /api/update: running version, state, download progress, the
+ * last manifest check and the log
+ * @return Length written, or 0 if the buffer was too small
+ */
+size_t formatUpdateJson(char* buffer, size_t size, const ClockSettings& settings);
+
+#endif // PULL_UPDATE_H
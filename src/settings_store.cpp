@@ -0,0 +1,36 @@
+/**
+ * Word Clock - Settings persistence
+ */
+
+#include "settings_store.h"
+#include "log.h"
+
+#include <Preferences.h>
+
+#define SETTINGS_NVS_NAMESPACE "settings"
+
+// What NVS holds, with defaults for anything never saved
+static ClockSettings saved;
+
+void settingsStoreLoad(ClockSettings& settings) {
+    Preferences prefs;
+    if (prefs.begin(SETTINGS_NVS_NAMESPACE, true)) {
+        int loaded = loadSettings(prefs, settings);
+        prefs.end();
+        LOG_INFO(LOG_CAT_SYSTEM, "Settings: %d loaded from NVS", loaded);
+    }
+    saved = settings;
+}
+
+void settingsStoreSave(const ClockSettings& settings) {
+    Preferences prefs;
+    if (!prefs.begin(SETTINGS_NVS_NAMESPACE, false)) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "Settings: NVS unavailable");
+        return;
+    }
+    int written = saveSettings(prefs, settings, saved);
+    prefs.end();
+    metricAdd(METRIC_NVS_WRITES, written);
+    if (written) LOG_DEBUG(LOG_CAT_SYSTEM, "Settings: %d saved", written);
+    saved = settings;
+}
@@ -0,0 +1,20 @@
+/**
+ * Word Clock - Settings persistence
+ *
+ * Keeps the clock settings in NVS across reboots, using the codec
+ * generated from the settings schema (see settings.h). Only settings that
+ * changed since the last save are written.
+ */
+
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+#include <word_clock_core.h>
+
+// Reads the saved settings over `settings`; call once from setup()
+void settingsStoreLoad(ClockSettings& settings);
+
+// Writes whatever differs from the last load or save
+void settingsStoreSave(const ClockSettings& settings);
+
+#endif // SETTINGS_STORE_H
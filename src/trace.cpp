@@ -0,0 +1,28 @@
+/**
+ * Word Clock - Event Trace storage
+ */
+
+#include "trace.h"
+
+TraceEvent traceRing[TRACE_CAPACITY];
+std::atomic<uint32_t> traceHead{0};
+
+const char* const TRACE_ROUTE_NAMES[TRACE_ROUTE_COUNT] = {
+    "other", "favicon", "brightnessPage", "status", "saveBrightness", "trace", "profile", "health",
+    "curve", "transition", "light", "settings", "statusBin", "wait", "frame", "admission", "metrics",
+    "update",
+};
+
+void traceFillHeader(TraceDumpHeader& header) {
+    header.magic = TRACE_MAGIC;
+    header.version = TRACE_FORMAT_VERSION;
+    header.eventSize = sizeof(TraceEvent);
+    header.capacity = TRACE_CAPACITY;
+    header.head = traceHead.load(std::memory_order_relaxed);
+#ifdef ESP_PLATFORM
+    header.ticksPerMicro = getCpuFrequencyMhz();
+#else
+    header.ticksPerMicro = 1;
+#endif
+    header.dumpTimestamp = traceClock();
+}
@@ -0,0 +1,124 @@
+/**
+ * Word Clock - Event Trace
+ *
+ * Fixed-size ring of compact binary events kept in RAM, so a clock that
+ * misbehaves in the field can be inspected after the fact even when serial
+ * logging is compiled out.
+ *
+ * Recording an event is one atomic increment plus an 8 byte store; the
+ * timestamp is the raw CPU cycle counter. The ring is downloaded from
+ * /api/trace as a TraceDumpHeader followed by TRACE_CAPACITY events and
+ * converted to Chrome/Perfetto JSON with tools/trace2json.cpp.
+ *
+ * This header is shared with the host tools, so everything outside the
+ * ARDUINO section must stay plain C++.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#define TRACE_MAGIC 0x52544357  // "WCTR" little-endian
+#define TRACE_FORMAT_VERSION 1
+
+#ifndef TRACE_CAPACITY
+#define TRACE_CAPACITY 1024     // Events kept in RAM (must be a power of two)
+#endif
+
+static_assert((TRACE_CAPACITY & (TRACE_CAPACITY - 1)) == 0, "TRACE_CAPACITY must be a power of two");
+
+// Event types - append only, the numbers are part of the dump format
+enum TraceEventType : uint8_t {
+    TRACE_RENDER_BEGIN = 1,   // arg8 = hour, arg16 = rounded minute
+    TRACE_RENDER_END = 2,
+    TRACE_SHOW_BEGIN = 3,     // arg8 = global brightness
+    TRACE_SHOW_END = 4,
+    TRACE_ADC_SAMPLE = 5,     // arg16 = averaged light level
+    TRACE_HTTP_BEGIN = 6,     // arg8 = TraceRoute
+    TRACE_HTTP_END = 7,       // arg8 = TraceRoute
+    TRACE_NTP_SYNC = 8,       // arg8 = ezTime timeStatus()
+    TRACE_WIFI_STATE = 9,     // arg8 = arduino_event_id_t
+};
+
+// HTTP routes - append only, the numbers are part of the dump format
+enum TraceRoute : uint8_t {
+    TRACE_ROUTE_OTHER = 0,
+    TRACE_ROUTE_FAVICON = 1,
+    TRACE_ROUTE_BRIGHTNESS_PAGE = 2,
+    TRACE_ROUTE_STATUS = 3,
+    TRACE_ROUTE_SAVE_BRIGHTNESS = 4,
+    TRACE_ROUTE_TRACE = 5,
+    TRACE_ROUTE_PROFILE = 6,
+    TRACE_ROUTE_HEALTH = 7,
+    TRACE_ROUTE_CURVE = 8,
+    TRACE_ROUTE_TRANSITION = 9,
+    TRACE_ROUTE_LIGHT = 10,
+    TRACE_ROUTE_SETTINGS = 11,
+    TRACE_ROUTE_STATUS_BIN = 12,
+    TRACE_ROUTE_WAIT = 13,
+    TRACE_ROUTE_FRAME = 14,
+    TRACE_ROUTE_ADMISSION = 15,
+    TRACE_ROUTE_METRICS = 16,
+    TRACE_ROUTE_UPDATE = 17,
+    TRACE_ROUTE_COUNT  // Keep last
+};
+
+struct TraceEvent {
+    uint32_t timestamp;  // CPU cycles (wraps; see TraceDumpHeader::ticksPerMicro)
+    uint8_t type;        // TraceEventType
+    uint8_t arg8;
+    uint16_t arg16;
+};
+
+struct TraceDumpHeader {
+    uint32_t magic;          // TRACE_MAGIC
+    uint16_t version;        // TRACE_FORMAT_VERSION
+    uint16_t eventSize;      // sizeof(TraceEvent)
+    uint32_t capacity;       // Number of events that follow the header
+    uint32_t head;           // Total events ever recorded; head % capacity is the oldest slot once wrapped
+    uint32_t ticksPerMicro;  // Timestamp ticks per microsecond
+    uint32_t dumpTimestamp;  // Timestamp at the moment of the dump
+};
+
+static_assert(sizeof(TraceEvent) == 8, "TraceEvent must stay 8 bytes");
+static_assert(sizeof(TraceDumpHeader) == 24, "TraceDumpHeader layout changed");
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <atomic>
+
+#ifdef ESP_PLATFORM
+#include "hal/cpu_hal.h"
+#endif
+
+extern TraceEvent traceRing[TRACE_CAPACITY];
+extern std::atomic<uint32_t> traceHead;
+
+// Ticks of the clock used for event timestamps
+inline uint32_t traceClock() {
+#ifdef ESP_PLATFORM
+    return cpu_hal_get_cycle_count();
+#else
+    return micros();
+#endif
+}
+
+/**
+ * Appends an event to the ring, overwriting the oldest once full.
+ * Safe to call from any task; never blocks.
+ */
+inline void traceRecord(uint8_t type, uint8_t arg8 = 0, uint16_t arg16 = 0) {
+    uint32_t slot = traceHead.fetch_add(1, std::memory_order_relaxed) & (TRACE_CAPACITY - 1);
+    traceRing[slot] = {traceClock(), type, arg8, arg16};
+}
+
+// Fills in a dump header describing the current ring contents
+void traceFillHeader(TraceDumpHeader& header);
+
+// Short name of each route, for rate limits and metrics labels
+extern const char* const TRACE_ROUTE_NAMES[TRACE_ROUTE_COUNT];
+
+#endif // ARDUINO
+
+#endif // TRACE_H
@@ -0,0 +1,166 @@
+/**
+ * Word Clock - Brightness tests
+ *
+ * The compiled curve lookup table, hysteresis and slew limiting in
+ * BrightnessController, and the light histogram's Otsu split that
+ * suggests new curve points.
+ *
+ * Run with: pio test -e native
+ */
+
+#include <unity.h>
+#include <word_clock_core.h>
+
+void setUp() {}
+void tearDown() {}
+
+static CurveSettings curve(const char* points, uint16_t hysteresis = 64, uint16_t slew = 10) {
+    CurveSettings c;
+    TEST_ASSERT_TRUE(parseCurvePoints(points, c));
+    c.hysteresis = hysteresis;
+    c.slewPerSecond = slew;
+    return c;
+}
+
+static void test_default_curve_ramps_around_the_threshold() {
+    CurveSettings c = curveFromSettings(BrightnessSettings());
+    TEST_ASSERT_EQUAL(4, c.count);
+    TEST_ASSERT_EQUAL(0, c.points[0].level);
+    TEST_ASSERT_EQUAL(2600 - CURVE_DEFAULT_RAMP / 2, c.points[1].level);
+    TEST_ASSERT_EQUAL(2600 + CURVE_DEFAULT_RAMP / 2, c.points[2].level);
+    TEST_ASSERT_EQUAL(LIGHT_LEVEL_MAX, c.points[3].level);
+    TEST_ASSERT_EQUAL(5, c.points[1].brightness);
+    TEST_ASSERT_EQUAL(25, c.points[2].brightness);
+}
+
+static void test_extreme_thresholds_still_give_a_valid_curve() {
+    for (int threshold : {0, 1, LIGHT_LEVEL_MAX - 1, LIGHT_LEVEL_MAX}) {
+        BrightnessSettings settings;
+        settings.threshold = threshold;
+        CurveSettings c = curveFromSettings(settings);
+        for (int i = 1; i < c.count; i++) TEST_ASSERT_TRUE(c.points[i].level > c.points[i - 1].level);
+    }
+}
+
+static void test_lookup_table_follows_the_curve() {
+    BrightnessController controller;
+    controller.setCurve(curve("0:10,2048:110,4095:210"));
+    TEST_ASSERT_EQUAL(10, controller.lookup(0));
+    TEST_ASSERT_EQUAL(210, controller.lookup(LIGHT_LEVEL_MAX));
+    TEST_ASSERT_INT_WITHIN(1, 60, controller.lookup(1024));
+    TEST_ASSERT_INT_WITHIN(1, 110, controller.lookup(2048));
+    TEST_ASSERT_INT_WITHIN(1, 160, controller.lookup(3072));
+    // Out-of-range readings clamp to the ends
+    TEST_ASSERT_EQUAL(10, controller.lookup(-5));
+    TEST_ASSERT_EQUAL(210, controller.lookup(9999));
+}
+
+static void test_lookup_is_monotonic_for_a_rising_curve() {
+    BrightnessController controller;
+    controller.setCurve(curveFromSettings(BrightnessSettings()));
+    uint16_t previous = 0;
+    for (int level = 0; level <= LIGHT_LEVEL_MAX; level++) {
+        uint16_t value = controller.lookupFixed(level);
+        TEST_ASSERT_TRUE(value >= previous);
+        previous = value;
+    }
+}
+
+static void test_lookup_keeps_the_fraction_between_steps() {
+    BrightnessController controller;
+    controller.setCurve(curve("0:4,4095:5"));
+    uint16_t middle = controller.lookupFixed(2048);
+    TEST_ASSERT_TRUE(middle > 4 << 8 && middle < 5 << 8);
+}
+
+static void test_small_changes_are_ignored() {
+    BrightnessController controller;
+    controller.setCurve(curve("0:0,4095:255", 64, 0));
+    controller.update(1000, 0);
+    TEST_ASSERT_EQUAL(1000, controller.acceptedLevel());
+    controller.update(1064, 100);
+    TEST_ASSERT_EQUAL(1000, controller.acceptedLevel());
+    controller.update(936, 200);
+    TEST_ASSERT_EQUAL(1000, controller.acceptedLevel());
+    controller.update(1065, 300);
+    TEST_ASSERT_EQUAL(1065, controller.acceptedLevel());
+}
+
+static void test_output_is_slew_limited() {
+    BrightnessController controller;
+    controller.setCurve(curve("0:5,4095:25", 0, 10));
+    TEST_ASSERT_EQUAL(5, controller.update(0, 0));  // The first reading is taken at once
+    TEST_ASSERT_EQUAL(10, controller.update(LIGHT_LEVEL_MAX, 500));
+    TEST_ASSERT_EQUAL(15, controller.update(LIGHT_LEVEL_MAX, 1000));
+    TEST_ASSERT_EQUAL(25, controller.update(LIGHT_LEVEL_MAX, 3000));
+    TEST_ASSERT_EQUAL(25, controller.update(LIGHT_LEVEL_MAX, 4000));  // No overshoot
+    TEST_ASSERT_EQUAL(15, controller.update(0, 5000));
+}
+
+static void test_zero_slew_is_instant() {
+    BrightnessController controller;
+    controller.setCurve(curve("0:5,4095:25", 0, 0));
+    controller.update(0, 0);
+    TEST_ASSERT_EQUAL(25, controller.update(LIGHT_LEVEL_MAX, 1));
+}
+
+static void test_histogram_splits_dark_and_light_rooms() {
+    LightHistogram histogram;
+    for (int i = 0; i < 100; i++) {
+        for (int hour = 0; hour < 24; hour++) histogram.record(hour, hour < 8 ? 200 : 3000);
+    }
+    LightSuggestion s = histogram.suggest();
+    TEST_ASSERT_TRUE(s.valid);
+    TEST_ASSERT_TRUE(s.threshold > 255 && s.threshold < 2944);
+    TEST_ASSERT_EQUAL(2 * LIGHT_HIST_BIN_WIDTH - 1, s.darkLevel);   // Top of 200's bin
+    TEST_ASSERT_EQUAL(23 * LIGHT_HIST_BIN_WIDTH, s.lightLevel);     // Bottom of 3000's bin
+    TEST_ASSERT_EQUAL_UINT32(0xFF, s.darkHours);
+    TEST_ASSERT_TRUE(s.separation > 0.99);
+
+    CurveSettings c = curveFromSuggestion(s, BrightnessSettings());
+    TEST_ASSERT_EQUAL(s.darkLevel, c.points[1].level);
+    TEST_ASSERT_EQUAL(s.lightLevel, c.points[2].level);
+}
+
+static void test_histogram_needs_enough_samples_and_two_classes() {
+    LightHistogram histogram;
+    for (int i = 0; i < LIGHT_HIST_MIN_SAMPLES - 2; i++) histogram.record(i % 24, i % 2 ? 200 : 3000);
+    TEST_ASSERT_FALSE(histogram.suggest().valid);
+
+    histogram.clear();
+    for (int i = 0; i < LIGHT_HIST_MIN_SAMPLES * 2; i++) histogram.record(i % 24, 1500);
+    TEST_ASSERT_FALSE(histogram.suggest().valid);
+}
+
+static void test_histogram_ages_old_samples() {
+    LightHistogram histogram;
+    for (int i = 0; i < LIGHT_HIST_AGE_AT; i++) histogram.record(5, 100);
+    TEST_ASSERT_EQUAL_UINT32(LIGHT_HIST_AGE_AT / 2, histogram.hourTotal(5));
+    histogram.record(-1, 100);
+    histogram.record(24, 100);
+    TEST_ASSERT_EQUAL_UINT32(LIGHT_HIST_AGE_AT / 2, histogram.total());
+}
+
+static void test_histogram_loads_only_its_own_size() {
+    LightHistogram histogram;
+    static uint8_t bytes[LightHistogram::dataSize() + 1] = {};
+    TEST_ASSERT_FALSE(histogram.load(bytes, sizeof(bytes)));
+    TEST_ASSERT_TRUE(histogram.load(bytes, LightHistogram::dataSize()));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_curve_ramps_around_the_threshold);
+    RUN_TEST(test_extreme_thresholds_still_give_a_valid_curve);
+    RUN_TEST(test_lookup_table_follows_the_curve);
+    RUN_TEST(test_lookup_is_monotonic_for_a_rising_curve);
+    RUN_TEST(test_lookup_keeps_the_fraction_between_steps);
+    RUN_TEST(test_small_changes_are_ignored);
+    RUN_TEST(test_output_is_slew_limited);
+    RUN_TEST(test_zero_slew_is_instant);
+    RUN_TEST(test_histogram_splits_dark_and_light_rooms);
+    RUN_TEST(test_histogram_needs_enough_samples_and_two_classes);
+    RUN_TEST(test_histogram_ages_old_samples);
+    RUN_TEST(test_histogram_loads_only_its_own_size);
+    return UNITY_END();
+}
@@ -0,0 +1,92 @@
+/**
+ * Word Clock - Clock face tests
+ *
+ * Rounding to the five-minute slot and the words lit for it.
+ * verify/ replays years of frames against a golden file; these pin down
+ * the phrases themselves, so a change to the table says which one broke.
+ *
+ * Run with: pio test -e native
+ */
+
+#include <stdio.h>
+#include <initializer_list>
+#include <unity.h>
+#include <word_clock_core.h>
+
+void setUp() {}
+void tearDown() {}
+
+static FrameMask words(std::initializer_list<Word> list) {
+    FrameMask mask = 0;
+    for (Word w : list) mask |= wordMask(w);
+    return mask;
+}
+
+static void expectRounded(int hour, int minute, int roundedHour, int roundedMinute) {
+    FaceTime t = roundTime(hour, minute);
+    char message[32];
+    snprintf(message, sizeof(message), "%02d:%02d", hour, minute);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(roundedHour, t.hour, message);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(roundedMinute, t.minute, message);
+}
+
+static void test_rounds_to_the_nearest_five_minutes() {
+    expectRounded(0, 0, 0, 0);
+    expectRounded(14, 32, 14, 30);
+    expectRounded(14, 33, 14, 35);
+    expectRounded(14, 37, 14, 35);
+    expectRounded(14, 57, 14, 55);
+}
+
+static void test_rounding_rolls_over_the_hour_and_day() {
+    expectRounded(14, 58, 15, 0);
+    expectRounded(11, 59, 12, 0);
+    expectRounded(23, 58, 0, 0);
+}
+
+static void test_on_the_hour_says_oclock() {
+    TEST_ASSERT_EQUAL_HEX64(words({WORD_IT_IS, WORD_THREE, WORD_OCLOCK}), frameFor({15, 0}));
+    TEST_ASSERT_EQUAL_HEX64(words({WORD_IT_IS, WORD_TWELVE, WORD_OCLOCK}), frameFor({0, 0}));
+    TEST_ASSERT_EQUAL_HEX64(frameFor({0, 0}), frameFor({12, 0}));
+}
+
+static void test_past_and_to() {
+    TEST_ASSERT_EQUAL_HEX64(words({WORD_IT_IS, WORD_FIVE_MINUTES, WORD_PAST, WORD_ONE}), frameFor({13, 5}));
+    TEST_ASSERT_EQUAL_HEX64(words({WORD_IT_IS, WORD_HALF, WORD_PAST, WORD_NINE}), frameFor({9, 30}));
+    TEST_ASSERT_EQUAL_HEX64(words({WORD_IT_IS, WORD_TWENTY, WORD_FIVE_MINUTES, WORD_TO, WORD_THREE}),
+                            frameFor({14, 35}));
+    TEST_ASSERT_EQUAL_HEX64(words({WORD_IT_IS, WORD_QUARTER, WORD_TO, WORD_ELEVEN}), frameFor({10, 45}));
+    TEST_ASSERT_EQUAL_HEX64(words({WORD_IT_IS, WORD_TEN_MINUTES, WORD_TO, WORD_TWELVE}), frameFor({23, 50}));
+}
+
+static void test_every_phrase_names_one_hour() {
+    for (int hour = 0; hour < 24; hour++) {
+        for (int minute = 0; minute < 60; minute += 5) {
+            FrameMask frame = frameFor({(uint8_t)hour, (uint8_t)minute});
+            TEST_ASSERT_EQUAL_HEX64(wordMask(WORD_IT_IS), frame & wordMask(WORD_IT_IS));
+            int hours = 0;
+            for (Word w : HOUR_WORDS) hours += (frame & wordMask(w)) == wordMask(w);
+            TEST_ASSERT_EQUAL(1, hours);
+            TEST_ASSERT_EQUAL(minute == 0, (frame & wordMask(WORD_OCLOCK)) != 0);
+        }
+    }
+}
+
+static void test_words_do_not_overlap() {
+    FrameMask seen = 0;
+    for (int w = 0; w < WORD_COUNT; w++) {
+        TEST_ASSERT_EQUAL_HEX64(0, seen & wordMask((Word)w));
+        seen |= wordMask((Word)w);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_rounds_to_the_nearest_five_minutes);
+    RUN_TEST(test_rounding_rolls_over_the_hour_and_day);
+    RUN_TEST(test_on_the_hour_says_oclock);
+    RUN_TEST(test_past_and_to);
+    RUN_TEST(test_every_phrase_names_one_hour);
+    RUN_TEST(test_words_do_not_overlap);
+    return UNITY_END();
+}
@@ -0,0 +1,132 @@
+/**
+ * Word Clock - Double buffer tests
+ *
+ * Versioning and publishing in DoubleBuffer, and a reader that never sees
+ * a value torn between two writes while writers publish from other
+ * threads.
+ *
+ * Run with: pio test -e native
+ */
+
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <unity.h>
+#include <word_clock_core.h>
+
+void setUp() {}
+void tearDown() {}
+
+// Every field equal, so a copy mixing two versions shows. Copying yields
+// halfway, so other threads run mid-copy even on a single core.
+struct Stamped {
+    uint32_t words[16];
+
+    Stamped(uint32_t value = 0) {
+        for (uint32_t& w : words) w = value;
+    }
+    Stamped(const Stamped& other) {
+        memcpy(words, other.words, sizeof(words) / 2);
+        std::this_thread::yield();
+        memcpy(words + 8, other.words + 8, sizeof(words) / 2);
+    }
+    Stamped& operator=(const Stamped& other) = default;
+    bool consistent() const {
+        for (uint32_t w : words) {
+            if (w != words[0]) return false;
+        }
+        return true;
+    }
+};
+
+static void test_starts_at_version_zero_with_the_initial_value() {
+    DoubleBuffer<Stamped> buffer(Stamped(7));
+    uint32_t version = 99;
+    TEST_ASSERT_EQUAL_UINT32(7, buffer.load(&version).words[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, version);
+    TEST_ASSERT_EQUAL_UINT32(0, buffer.version());
+}
+
+static void test_each_publish_is_the_next_version() {
+    DoubleBuffer<Stamped> buffer;
+    for (uint32_t i = 1; i <= 5; i++) {
+        buffer.store(Stamped(i));
+        uint32_t version;
+        TEST_ASSERT_EQUAL_UINT32(i, buffer.load(&version).words[15]);
+        TEST_ASSERT_EQUAL_UINT32(i, version);
+    }
+}
+
+static void test_update_edits_the_current_value() {
+    DoubleBuffer<Stamped> buffer(Stamped(1));
+    uint32_t version = 0;
+    TEST_ASSERT_TRUE(buffer.update([](Stamped& s) {
+        s.words[0] = 2;
+        return true;
+    }, &version));
+    TEST_ASSERT_EQUAL_UINT32(1, version);
+    Stamped now = buffer.load();
+    TEST_ASSERT_EQUAL_UINT32(2, now.words[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, now.words[1]);  // Kept from the value edited
+}
+
+static void test_declined_update_publishes_nothing() {
+    DoubleBuffer<Stamped> buffer(Stamped(1));
+    uint32_t version = 99;
+    TEST_ASSERT_FALSE(buffer.update([](Stamped& s) {
+        s.words[0] = 2;  // Edited, then rejected
+        return false;
+    }, &version));
+    TEST_ASSERT_EQUAL_UINT32(0, version);
+    TEST_ASSERT_EQUAL_UINT32(1, buffer.load().words[0]);
+}
+
+static void test_readers_never_see_a_torn_value() {
+    static DoubleBuffer<Stamped> buffer;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> torn(0), backwards(0);
+
+    std::thread readers[2];
+    for (std::thread& reader : readers) {
+        reader = std::thread([&]() {
+            uint32_t last = 0;
+            while (!done) {
+                uint32_t version;
+                Stamped s = buffer.load(&version);
+                if (!s.consistent()) torn++;
+                if (version < last || s.words[0] != version) backwards++;
+                last = version;
+            }
+        });
+    }
+    // Two writers, each adding one, so no increment may be lost
+    std::thread writers[2];
+    for (std::thread& writer : writers) {
+        writer = std::thread([&]() {
+            for (int i = 0; i < 20000; i++) {
+                buffer.update([](Stamped& s) {
+                    s = Stamped(s.words[0] + 1);
+                    return true;
+                });
+            }
+        });
+    }
+    for (std::thread& writer : writers) writer.join();
+    done = true;
+    for (std::thread& reader : readers) reader.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, backwards.load());
+    TEST_ASSERT_EQUAL_UINT32(40000, buffer.load().words[0]);
+    TEST_ASSERT_EQUAL_UINT32(40000, buffer.version());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_starts_at_version_zero_with_the_initial_value);
+    RUN_TEST(test_each_publish_is_the_next_version);
+    RUN_TEST(test_update_edits_the_current_value);
+    RUN_TEST(test_declined_update_publishes_nothing);
+    RUN_TEST(test_readers_never_see_a_torn_value);
+    return UNITY_END();
+}
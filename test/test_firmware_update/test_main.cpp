@@ -0,0 +1,252 @@
+/**
+ * Word Clock - Firmware update tests
+ *
+ * Manifest parsing and URL resolution, the choice between a delta and the
+ * full image, resuming a download with Range and backing off, and the
+ * update log's memory of rolled-back versions.
+ *
+ * Run with: pio test -e native
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include <word_clock_core.h>
+
+static const char* const MANIFEST_URL = "http://updates.lan:8080/clock/manifest.json";
+static const char* const MD5 = "0123456789abcdef0123456789abcdef";
+static const char* const BASE_MD5 = "fedcba9876543210fedcba9876543210";
+
+static UpdateManifest manifest;
+static char error[64];
+
+void setUp() {
+    memset(&manifest, 0x55, sizeof(manifest));
+    error[0] = '\0';
+}
+void tearDown() {}
+
+static bool parse(const char* json) {
+    return parseUpdateManifest(json, strlen(json), MANIFEST_URL, manifest, error, sizeof(error));
+}
+
+// A manifest with the required members and `extra` appended
+static bool parseWith(const char* extra, const char* url = "firmware.bin") {
+    char json[512];
+    snprintf(json, sizeof(json), "{\"version\":\"v1.4.0\",\"url\":\"%s\",\"size\":1184512,\"md5\":\"%s\"%s}", url, MD5,
+             extra);
+    return parse(json);
+}
+
+static void expectRejected(const char* json, const char* message) {
+    TEST_ASSERT_FALSE_MESSAGE(parse(json), json);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(message, error, json);
+}
+
+static void test_reads_a_plain_manifest() {
+    TEST_ASSERT_TRUE(parseWith(""));
+    TEST_ASSERT_EQUAL_STRING("v1.4.0", manifest.version);
+    TEST_ASSERT_EQUAL_STRING("http://updates.lan:8080/clock/firmware.bin", manifest.url);
+    TEST_ASSERT_EQUAL_UINT32(1184512, manifest.size);
+    TEST_ASSERT_EQUAL_STRING(MD5, manifest.md5);
+    TEST_ASSERT_EQUAL(UPDATE_RAW, manifest.encoding);
+    TEST_ASSERT_EQUAL_UINT32(1184512, manifest.transferSize);
+    TEST_ASSERT_EQUAL_STRING("", manifest.deltaUrl);
+    TEST_ASSERT_EQUAL_UINT32(0, manifest.deltaSize);
+}
+
+static void test_resolves_urls_against_the_manifest() {
+    TEST_ASSERT_TRUE(parseWith("", "/images/fw.bin"));
+    TEST_ASSERT_EQUAL_STRING("http://updates.lan:8080/images/fw.bin", manifest.url);
+    TEST_ASSERT_TRUE(parseWith("", "http://cdn.lan/fw.bin"));
+    TEST_ASSERT_EQUAL_STRING("http://cdn.lan/fw.bin", manifest.url);
+
+    const char* json = "{\"version\":\"v1\",\"url\":\"fw.bin\",\"size\":1,\"md5\":\"0123456789abcdef0123456789abcdef\"}";
+    TEST_ASSERT_TRUE(parseUpdateManifest(json, strlen(json), "http://updates.lan", manifest, error, sizeof(error)));
+    TEST_ASSERT_EQUAL_STRING("http://updates.lan/fw.bin", manifest.url);
+}
+
+static void test_lowercases_the_md5() {
+    const char* json = "{\"version\":\"v1\",\"url\":\"fw.bin\",\"size\":1,\"md5\":\"0123456789ABCDEF0123456789ABCDEF\"}";
+    TEST_ASSERT_TRUE(parse(json));
+    TEST_ASSERT_EQUAL_STRING(MD5, manifest.md5);
+}
+
+static void test_reads_compressed_and_delta_images() {
+    TEST_ASSERT_TRUE(parseWith(",\"encoding\":\"lzss\",\"transferSize\":700000"
+                               ",\"delta\":\"delta.bin\",\"deltaBase\":\"fedcba9876543210fedcba9876543210\""
+                               ",\"deltaSize\":40000"));
+    TEST_ASSERT_EQUAL(UPDATE_LZSS, manifest.encoding);
+    TEST_ASSERT_EQUAL_UINT32(700000, manifest.transferSize);
+    TEST_ASSERT_EQUAL_STRING("http://updates.lan:8080/clock/delta.bin", manifest.deltaUrl);
+    TEST_ASSERT_EQUAL_STRING(BASE_MD5, manifest.deltaBase);
+    TEST_ASSERT_EQUAL_UINT32(40000, manifest.deltaSize);
+
+    TEST_ASSERT_TRUE(parseWith(",\"encoding\":\"raw\""));
+    TEST_ASSERT_EQUAL(UPDATE_RAW, manifest.encoding);
+}
+
+static void test_rejects_bad_json() {
+    expectRejected("[1]", "Manifest: Expected an object");
+    expectRejected("{\"version\":\"v1\",", "Manifest: Expected a member name");
+}
+
+static void test_rejects_missing_or_invalid_members() {
+    expectRejected("{\"url\":\"fw.bin\",\"size\":1,\"md5\":\"0123456789abcdef0123456789abcdef\"}",
+                   "Manifest: missing or invalid version");
+    expectRejected("{\"version\":\"\",\"url\":\"fw.bin\",\"size\":1,\"md5\":\"0123456789abcdef0123456789abcdef\"}",
+                   "Manifest: missing or invalid version");
+    expectRejected("{\"version\":\"v1\",\"url\":\"fw 1.bin\",\"size\":1,"
+                   "\"md5\":\"0123456789abcdef0123456789abcdef\"}",
+                   "Manifest: missing or invalid url");
+    expectRejected("{\"version\":\"v1\",\"url\":\"fw.bin\",\"size\":\"1\",\"md5\":\"0123456789abcdef0123456789abcdef\"}",
+                   "Manifest: missing or invalid size");
+    expectRejected("{\"version\":\"v1\",\"url\":\"fw.bin\",\"size\":0,\"md5\":\"0123456789abcdef0123456789abcdef\"}",
+                   "Manifest: missing or invalid size");
+    expectRejected("{\"version\":\"v1\",\"url\":\"fw.bin\",\"size\":4294967296,"
+                   "\"md5\":\"0123456789abcdef0123456789abcdef\"}",
+                   "Manifest: missing or invalid size");
+    expectRejected("{\"version\":\"v1\",\"url\":\"fw.bin\",\"size\":1.5,\"md5\":\"0123456789abcdef0123456789abcdef\"}",
+                   "Manifest: missing or invalid size");
+    expectRejected("{\"version\":\"v1\",\"url\":\"fw.bin\",\"size\":1,\"md5\":\"0123456789abcdef\"}",
+                   "Manifest: missing or invalid md5");
+    expectRejected("{\"version\":\"v1\",\"url\":\"fw.bin\",\"size\":1,\"md5\":\"0123456789abcdef0123456789abcdeg\"}",
+                   "Manifest: missing or invalid md5");
+}
+
+static void test_rejects_inconsistent_encodings_and_deltas() {
+    TEST_ASSERT_FALSE(parseWith(",\"encoding\":\"gzip\""));
+    TEST_ASSERT_EQUAL_STRING("Manifest: missing or invalid encoding", error);
+    TEST_ASSERT_FALSE(parseWith(",\"encoding\":\"lzss\""));
+    TEST_ASSERT_EQUAL_STRING("Manifest: missing or invalid transferSize", error);
+    TEST_ASSERT_FALSE(parseWith(",\"transferSize\":10"));  // Only meaningful when compressed
+    TEST_ASSERT_EQUAL_STRING("Manifest: missing or invalid transferSize", error);
+    TEST_ASSERT_FALSE(parseWith(",\"delta\":\"delta.bin\",\"deltaBase\":\"fedcba9876543210fedcba9876543210\""));
+    TEST_ASSERT_EQUAL_STRING("Manifest: missing or invalid delta", error);
+    TEST_ASSERT_FALSE(parseWith(",\"delta\":\"delta.bin\",\"deltaSize\":40000"));
+    TEST_ASSERT_EQUAL_STRING("Manifest: missing or invalid deltaBase", error);
+}
+
+static void test_delta_only_for_its_base_image() {
+    TEST_ASSERT_TRUE(parseWith(",\"encoding\":\"lzss\",\"transferSize\":700000"
+                               ",\"delta\":\"delta.bin\",\"deltaBase\":\"fedcba9876543210fedcba9876543210\""
+                               ",\"deltaSize\":40000"));
+    TEST_ASSERT_EQUAL(UPDATE_DELTA, chooseUpdateEncoding(manifest, BASE_MD5));
+    TEST_ASSERT_EQUAL(UPDATE_LZSS, chooseUpdateEncoding(manifest, MD5));
+
+    TEST_ASSERT_TRUE(parseWith(""));
+    TEST_ASSERT_EQUAL(UPDATE_RAW, chooseUpdateEncoding(manifest, ""));
+}
+
+static void test_update_urls() {
+    TEST_ASSERT_TRUE(isValidUpdateUrl(""));
+    TEST_ASSERT_TRUE(isValidUpdateUrl("http://updates.lan/manifest.json"));
+    TEST_ASSERT_TRUE(isValidUpdateUrl("http://10.0.0.2:8080/m.json"));
+    TEST_ASSERT_TRUE(isValidUpdateUrl("http://updates.lan"));
+    TEST_ASSERT_FALSE(isValidUpdateUrl("https://updates.lan/manifest.json"));
+    TEST_ASSERT_FALSE(isValidUpdateUrl("http:///manifest.json"));
+    TEST_ASSERT_FALSE(isValidUpdateUrl("http://updates.lan:0/m.json"));
+    TEST_ASSERT_FALSE(isValidUpdateUrl("http://updates.lan:65536/m.json"));
+    TEST_ASSERT_FALSE(isValidUpdateUrl("http://updates.lan:80x/m.json"));
+    TEST_ASSERT_FALSE(isValidUpdateUrl("http://updates.lan/a b.json"));
+    TEST_ASSERT_FALSE(isValidUpdateUrl("http://updates.lan/a\"b.json"));
+
+    char longUrl[UPDATE_URL_MAX + 1];
+    memset(longUrl, 'a', sizeof(longUrl) - 1);
+    memcpy(longUrl, "http://", 7);
+    longUrl[UPDATE_URL_MAX] = '\0';
+    TEST_ASSERT_FALSE(isValidUpdateUrl(longUrl));
+}
+
+static void test_download_resumes_with_a_range() {
+    UpdateDownload download;
+    download.begin(10000, 0);
+    char range[32];
+    TEST_ASSERT_EQUAL(0, download.formatRange(range, sizeof(range)));
+    TEST_ASSERT_EQUAL(0, download.accept(200, ""));
+
+    download.received(4096);
+    TEST_ASSERT_EQUAL(11, download.formatRange(range, sizeof(range)));
+    TEST_ASSERT_EQUAL_STRING("bytes=4096-", range);
+    TEST_ASSERT_EQUAL(0, download.formatRange(range, 8));  // Does not fit
+
+    TEST_ASSERT_EQUAL(0, download.accept(206, "bytes 4096-9999/10000"));
+    TEST_ASSERT_EQUAL(96, download.accept(206, "bytes 4000-9999/10000"));  // Overlap is skipped
+    TEST_ASSERT_EQUAL(4096, download.accept(200, ""));                      // Range ignored: skip what we have
+    TEST_ASSERT_EQUAL(-1, download.accept(206, "bytes 5000-9999/10000"));   // A gap
+    TEST_ASSERT_EQUAL(-1, download.accept(206, "bytes 4096-9999/20000"));   // Another image
+    TEST_ASSERT_EQUAL(-1, download.accept(206, "bytes 0-100/10000"));       // Ends before the offset
+    TEST_ASSERT_EQUAL(-1, download.accept(206, ""));
+    TEST_ASSERT_EQUAL(-1, download.accept(404, ""));
+
+    download.received(10000 - 4096);
+    TEST_ASSERT_TRUE(download.complete());
+}
+
+static void test_download_backs_off_then_gives_up() {
+    UpdateDownload download;
+    download.begin(10000, 1000);
+    TEST_ASSERT_TRUE(download.due(1000));
+
+    TEST_ASSERT_TRUE(download.failed(1000));
+    TEST_ASSERT_FALSE(download.due(1000 + UPDATE_RETRY_MIN_MS - 1));
+    TEST_ASSERT_TRUE(download.due(1000 + UPDATE_RETRY_MIN_MS));
+    TEST_ASSERT_TRUE(download.failed(5000));
+    TEST_ASSERT_FALSE(download.due(5000 + 2 * UPDATE_RETRY_MIN_MS - 1));
+    TEST_ASSERT_TRUE(download.due(5000 + 2 * UPDATE_RETRY_MIN_MS));
+
+    // Progress clears the count
+    download.received(100);
+    TEST_ASSERT_EQUAL(0, download.failures());
+
+    bool retry = true;
+    for (int i = 0; i < UPDATE_RETRIES; i++) {
+        TEST_ASSERT_TRUE(retry);
+        retry = download.failed(10000);
+    }
+    TEST_ASSERT_FALSE(retry);
+    TEST_ASSERT_FALSE(download.due(10000 + UPDATE_RETRY_MAX_MS - 1));  // Capped
+    TEST_ASSERT_TRUE(download.due(10000 + UPDATE_RETRY_MAX_MS));
+}
+
+static void test_log_remembers_rolled_back_versions() {
+    UpdateLog log;
+    log.record(0, UPDATE_STARTED, UPDATE_PULL, "v1.4.0", "");
+    log.record(0, UPDATE_INSTALLED, UPDATE_PULL, "v1.4.0", "");
+    log.record(0, UPDATE_ROLLED_BACK, UPDATE_PULL, "v1.4.0", "Self-check failed");
+    TEST_ASSERT_TRUE(log.rolledBack("v1.4.0"));
+    TEST_ASSERT_FALSE(log.rolledBack("v1.4.1"));
+
+    // Until the event falls out of the log
+    for (int i = 0; i < UPDATE_LOG_SIZE; i++) log.record(0, UPDATE_VERIFIED, UPDATE_PUSH, "v1.3.9", "");
+    TEST_ASSERT_FALSE(log.rolledBack("v1.4.0"));
+    TEST_ASSERT_EQUAL(UPDATE_LOG_SIZE, log.count());
+}
+
+static void test_log_survives_a_reload() {
+    UpdateLog log;
+    log.record(1700000000, UPDATE_ROLLED_BACK, UPDATE_PULL, "v1.4.0", "Did not boot");
+    UpdateLog reloaded;
+    TEST_ASSERT_TRUE(reloaded.load(log.data(), UpdateLog::dataSize()));
+    TEST_ASSERT_TRUE(reloaded.rolledBack("v1.4.0"));
+    TEST_ASSERT_EQUAL_STRING("Did not boot", reloaded.latest()->detail);
+    TEST_ASSERT_FALSE(reloaded.load(log.data(), UpdateLog::dataSize() - 1));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reads_a_plain_manifest);
+    RUN_TEST(test_resolves_urls_against_the_manifest);
+    RUN_TEST(test_lowercases_the_md5);
+    RUN_TEST(test_reads_compressed_and_delta_images);
+    RUN_TEST(test_rejects_bad_json);
+    RUN_TEST(test_rejects_missing_or_invalid_members);
+    RUN_TEST(test_rejects_inconsistent_encodings_and_deltas);
+    RUN_TEST(test_delta_only_for_its_base_image);
+    RUN_TEST(test_update_urls);
+    RUN_TEST(test_download_resumes_with_a_range);
+    RUN_TEST(test_download_backs_off_then_gives_up);
+    RUN_TEST(test_log_remembers_rolled_back_versions);
+    RUN_TEST(test_log_survives_a_reload);
+    return UNITY_END();
+}
@@ -0,0 +1,136 @@
+/**
+ * Word Clock - Health monitor tests
+ *
+ * Stack, heap and fragmentation limits, the least-squares heap trend that
+ * flags a leak, and alerts staying latched until cleared.
+ *
+ * Run with: pio test -e native
+ */
+
+#include <string.h>
+#include <unity.h>
+#include <word_clock_core.h>
+
+static const char* const TASKS[] = {"loop", "render"};
+
+void setUp() {}
+void tearDown() {}
+
+// A healthy sample: plenty of heap in one block, plenty of stack
+static HealthSample sample(uint32_t uptimeMs, uint32_t freeHeap = 100000) {
+    HealthSample s;
+    memset(&s, 0, sizeof(s));
+    s.uptimeMs = uptimeMs;
+    s.freeHeap = freeHeap;
+    s.minFreeHeap = freeHeap;
+    s.largestFreeBlock = freeHeap / 2;
+    s.stackFree[0] = 2048;
+    s.stackFree[1] = 2048;
+    return s;
+}
+
+static void test_healthy_samples_raise_nothing() {
+    HealthMonitor monitor(TASKS, 2);
+    for (int i = 0; i < 20; i++) TEST_ASSERT_EQUAL_HEX8(0, monitor.record(sample(i * 60000)));
+    TEST_ASSERT_EQUAL_HEX8(0, monitor.latchedAlerts());
+    TEST_ASSERT_EQUAL_INT32(0, monitor.heapTrendPerHour());
+}
+
+static void test_low_stack_is_an_alert_unless_the_task_is_missing() {
+    HealthMonitor monitor(TASKS, 2);
+    HealthSample s = sample(0);
+    s.stackFree[1] = HEALTH_TASK_MISSING;
+    TEST_ASSERT_EQUAL_HEX8(0, monitor.record(s));
+    s.stackFree[0] = 511;
+    TEST_ASSERT_EQUAL_HEX8(HEALTH_ALERT_STACK, monitor.record(s));
+    // Columns past taskCount are not looked at
+    HealthMonitor one(TASKS, 1);
+    s = sample(0);
+    s.stackFree[1] = 0;
+    TEST_ASSERT_EQUAL_HEX8(0, one.record(s));
+}
+
+static void test_low_and_fragmented_heap() {
+    HealthMonitor monitor(TASKS, 2);
+    TEST_ASSERT_EQUAL_HEX8(HEALTH_ALERT_HEAP_LOW, monitor.record(sample(0, 16 * 1024 - 1)));
+
+    HealthSample s = sample(1000);
+    s.largestFreeBlock = s.freeHeap / 4;  // Exactly at the limit
+    TEST_ASSERT_EQUAL_HEX8(0, monitor.record(s));
+    s.largestFreeBlock--;
+    TEST_ASSERT_EQUAL_HEX8(HEALTH_ALERT_FRAGMENTATION, monitor.record(s));
+}
+
+static void test_record_reports_only_new_alerts() {
+    HealthMonitor monitor(TASKS, 2);
+    HealthSample low = sample(0, 1000);
+    low.largestFreeBlock = 1000;
+    TEST_ASSERT_EQUAL_HEX8(HEALTH_ALERT_HEAP_LOW, monitor.record(low));
+    TEST_ASSERT_EQUAL_HEX8(0, monitor.record(low));
+    TEST_ASSERT_EQUAL_HEX8(HEALTH_ALERT_HEAP_LOW, monitor.alerts());
+}
+
+static void test_alerts_stay_latched_until_cleared() {
+    HealthMonitor monitor(TASKS, 2);
+    monitor.record(sample(0, 1000));
+    monitor.record(sample(1000));
+    TEST_ASSERT_EQUAL_HEX8(0, monitor.alerts());
+    TEST_ASSERT_EQUAL_HEX8(HEALTH_ALERT_HEAP_LOW, monitor.latchedAlerts());
+    monitor.clearLatched();
+    TEST_ASSERT_EQUAL_HEX8(0, monitor.latchedAlerts());
+
+    // Clearing keeps whatever is still active
+    monitor.record(sample(2000, 1000));
+    monitor.clearLatched();
+    TEST_ASSERT_EQUAL_HEX8(HEALTH_ALERT_HEAP_LOW, monitor.latchedAlerts());
+}
+
+static void test_trend_waits_for_enough_samples() {
+    HealthMonitor monitor(TASKS, 2);
+    for (int i = 0; i < HEALTH_TREND_MIN_SAMPLES - 1; i++) monitor.record(sample(i * 60000, 100000 - i * 1000));
+    TEST_ASSERT_EQUAL_INT32(0, monitor.heapTrendPerHour());
+    monitor.record(sample((HEALTH_TREND_MIN_SAMPLES - 1) * 60000, 100000 - (HEALTH_TREND_MIN_SAMPLES - 1) * 1000));
+    TEST_ASSERT_INT32_WITHIN(1, -60000, monitor.heapTrendPerHour());  // 1000 bytes a minute
+}
+
+static void test_slow_leak_raises_the_trend_alert() {
+    HealthMonitor monitor(TASKS, 2);
+    // 100 bytes a minute is 6000 an hour, over the 4096 allowed
+    uint8_t raised = 0;
+    for (int i = 0; i < HEALTH_TREND_MIN_SAMPLES; i++) raised |= monitor.record(sample(i * 60000, 100000 - i * 100));
+    TEST_ASSERT_INT32_WITHIN(1, -6000, monitor.heapTrendPerHour());
+    TEST_ASSERT_EQUAL_HEX8(HEALTH_ALERT_HEAP_TREND, raised);
+}
+
+static void test_noise_and_a_rising_heap_are_not_a_leak() {
+    HealthMonitor monitor(TASKS, 2);
+    for (int i = 0; i < HEALTH_HISTORY; i++) monitor.record(sample(i * 60000, 100000 + (i % 2 ? 500 : -500)));
+    TEST_ASSERT_EQUAL_HEX8(0, monitor.latchedAlerts());
+
+    HealthMonitor rising(TASKS, 2);
+    for (int i = 0; i < 20; i++) rising.record(sample(i * 60000, 50000 + i * 1000));
+    TEST_ASSERT_TRUE(rising.heapTrendPerHour() > 0);
+    TEST_ASSERT_EQUAL_HEX8(0, rising.latchedAlerts());
+}
+
+static void test_ring_keeps_the_newest_samples_oldest_first() {
+    HealthMonitor monitor(TASKS, 2);
+    for (int i = 0; i < HEALTH_HISTORY + 5; i++) monitor.record(sample(i));
+    TEST_ASSERT_EQUAL(HEALTH_HISTORY, monitor.count());
+    TEST_ASSERT_EQUAL_UINT32(5, monitor.at(0).uptimeMs);
+    TEST_ASSERT_EQUAL_UINT32(HEALTH_HISTORY + 4, monitor.latest()->uptimeMs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_healthy_samples_raise_nothing);
+    RUN_TEST(test_low_stack_is_an_alert_unless_the_task_is_missing);
+    RUN_TEST(test_low_and_fragmented_heap);
+    RUN_TEST(test_record_reports_only_new_alerts);
+    RUN_TEST(test_alerts_stay_latched_until_cleared);
+    RUN_TEST(test_trend_waits_for_enough_samples);
+    RUN_TEST(test_slow_leak_raises_the_trend_alert);
+    RUN_TEST(test_noise_and_a_rising_heap_are_not_a_leak);
+    RUN_TEST(test_ring_keeps_the_newest_samples_oldest_first);
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+/**
+ * Word Clock - JSON reader tests
+ *
+ * JsonReader parses PATCH /api/settings bodies and update manifests, both
+ * straight off the network, so every way a document can be wrong must be
+ * refused with its reason rather than read past or half-stored.
+ *
+ * Run with: pio test -e native
+ */
+
+#include <string>
+#include <unity.h>
+#include <word_clock_core.h>
+
+static JsonReader reader;
+
+void setUp() {}
+void tearDown() {}
+
+static bool parse(const std::string& json) {
+    return reader.parse(json.data(), json.size());
+}
+
+// The document must be refused, for `error`
+static void expectReject(const std::string& json, const char* error) {
+    TEST_ASSERT_FALSE_MESSAGE(parse(json), json.c_str());
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(error, reader.error(), json.c_str());
+}
+
+static void test_reads_every_value_type() {
+    TEST_ASSERT_TRUE(parse(" {\"s\":\"text\", \"n\":-12.5e3, \"t\":true, \"f\":false, \"z\":null} "));
+    TEST_ASSERT_EQUAL(5, reader.count());
+    const JsonValueType types[] = {JSON_STRING, JSON_NUMBER, JSON_BOOL, JSON_BOOL, JSON_NULL};
+    const char* const values[] = {"text", "-12.5e3", "true", "false", ""};
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(types[i], reader.member(i).type);
+        TEST_ASSERT_EQUAL_STRING(values[i], reader.member(i).value);
+    }
+    TEST_ASSERT_EQUAL_STRING("z", reader.member(4).key);
+}
+
+static void test_reads_an_empty_object() {
+    TEST_ASSERT_TRUE(parse("{ }"));
+    TEST_ASSERT_EQUAL(0, reader.count());
+}
+
+static void test_unescapes_strings() {
+    TEST_ASSERT_TRUE(parse("{\"a\":\"q\\\"b\\\\s\\/n\\n\",\"b\":\"\\u00e9\\u20ac\",\"c\":\"\\ud83d\\ude00\"}"));
+    TEST_ASSERT_EQUAL_STRING("q\"b\\s/n\n", reader.member(0).value);
+    TEST_ASSERT_EQUAL_STRING("\xC3\xA9\xE2\x82\xAC", reader.member(1).value);
+    TEST_ASSERT_EQUAL_STRING("\xF0\x9F\x98\x80", reader.member(2).value);
+}
+
+static void test_rejects_what_is_not_one_object() {
+    expectReject("", "Expected an object");
+    expectReject("   ", "Expected an object");
+    expectReject("[1]", "Expected an object");
+    expectReject("\"a\"", "Expected an object");
+    expectReject("{\"a\":1} x", "Trailing characters after the object");
+    expectReject("{\"a\":1}{}", "Trailing characters after the object");
+}
+
+static void test_rejects_broken_structure() {
+    expectReject("{", "Expected a member name");
+    expectReject("{a:1}", "Expected a member name");
+    expectReject("{\"a\":1,}", "Expected a member name");
+    expectReject("{\"a\" 1}", "Expected ':'");
+    expectReject("{\"a\":", "Expected a value");
+    expectReject("{\"a\":1", "Expected ',' or '}'");
+    expectReject("{\"a\":1 \"b\":2}", "Expected ',' or '}'");
+    expectReject("{\"a\":{}}", "Nested values are not supported");
+    expectReject("{\"a\":[1]}", "Nested values are not supported");
+    expectReject("{\"a\":1,\"a\":2}", "Duplicate member");
+}
+
+static void test_rejects_bad_strings() {
+    expectReject("{\"a\":\"open}", "Unterminated string");
+    expectReject("{\"a\":\"ends in \\", "Unterminated string");
+    expectReject("{\"a\":\"tab\there\"}", "Control character in string");
+    expectReject("{\"a\":\"\\x41\"}", "Invalid escape");
+    expectReject("{\"a\":\"\\u12\"}", "Invalid escape");
+    expectReject("{\"a\":\"\\u12G4\"}", "Invalid escape");
+    expectReject("{\"a\":\"\\ud800\"}", "Unpaired surrogate");
+    expectReject("{\"a\":\"\\ud800\\u0041\"}", "Unpaired surrogate");
+    expectReject("{\"a\":\"\\udc00\"}", "Unpaired surrogate");
+    expectReject("{\"a\":\"\\u0000\"}", "NUL in string");
+}
+
+static void test_rejects_bad_numbers_and_literals() {
+    expectReject("{\"a\":-}", "Invalid number");
+    expectReject("{\"a\":+1}", "Invalid number");
+    expectReject("{\"a\":.5}", "Invalid number");
+    expectReject("{\"a\":1.}", "Invalid number");
+    expectReject("{\"a\":1e}", "Invalid number");
+    expectReject("{\"a\":1e+}", "Invalid number");
+    expectReject("{\"a\":01}", "Expected ',' or '}'");
+    expectReject("{\"a\":tru}", "Invalid value");
+    expectReject("{\"a\":nul}", "Invalid value");
+    expectReject("{\"a\":True}", "Invalid number");
+}
+
+static void test_rejects_documents_that_do_not_fit() {
+    std::string many = "{";
+    for (int i = 0; i <= JSON_READER_MAX_MEMBERS; i++) many += (i ? ",\"k" : "\"k") + std::to_string(i) + "\":1";
+    expectReject(many + "}", "Too many members");
+
+    expectReject("{\"a\":\"" + std::string(JSON_READER_TEXT_MAX, 'x') + "\"}", "Document too large");
+    expectReject("{\"a\":" + std::string(JSON_READER_TEXT_MAX, '1') + "}", "Document too large");
+}
+
+static void test_reports_where_it_failed() {
+    TEST_ASSERT_FALSE(parse("{\"a\":1,\"b\":x}"));
+    TEST_ASSERT_EQUAL(11, reader.errorOffset());  // At the x
+}
+
+static void test_reads_only_the_given_length() {
+    const char json[] = "{\"a\":1}garbage";
+    TEST_ASSERT_TRUE(reader.parse(json, 7));
+    TEST_ASSERT_EQUAL_STRING("1", reader.member(0).value);
+    TEST_ASSERT_FALSE(reader.parse(json, 6));
+}
+
+static void test_a_failed_parse_leaves_nothing_behind() {
+    TEST_ASSERT_TRUE(parse("{\"a\":1,\"b\":2}"));
+    TEST_ASSERT_FALSE(parse("{\"c\":3,\"c\":4}"));
+    TEST_ASSERT_TRUE(parse("{\"d\":5}"));
+    TEST_ASSERT_EQUAL(1, reader.count());
+    TEST_ASSERT_EQUAL_STRING("d", reader.member(0).key);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reads_every_value_type);
+    RUN_TEST(test_reads_an_empty_object);
+    RUN_TEST(test_unescapes_strings);
+    RUN_TEST(test_rejects_what_is_not_one_object);
+    RUN_TEST(test_rejects_broken_structure);
+    RUN_TEST(test_rejects_bad_strings);
+    RUN_TEST(test_rejects_bad_numbers_and_literals);
+    RUN_TEST(test_rejects_documents_that_do_not_fit);
+    RUN_TEST(test_reports_where_it_failed);
+    RUN_TEST(test_reads_only_the_given_length);
+    RUN_TEST(test_a_failed_parse_leaves_nothing_behind);
+    return UNITY_END();
+}
@@ -0,0 +1,83 @@
+/**
+ * Word Clock - Rate limiter tests
+ *
+ * Token buckets per client and route: the burst, the sustained rate, the
+ * Retry-After hint, and eviction once the fixed table is full.
+ *
+ * Run with: pio test -e native
+ */
+
+#include <unity.h>
+#include <word_clock_core.h>
+
+static const RateLimit LIMIT = {3, 60};  // Three at once, then one a second
+static const uint32_t CLIENT = 0x0A000001;  // 10.0.0.1
+
+static RateLimiter limiter;
+
+void setUp() { limiter.reset(); }
+void tearDown() {}
+
+static void test_allows_the_burst_then_refuses() {
+    for (int i = 0; i < LIMIT.burst; i++) TEST_ASSERT_EQUAL_UINT32(0, limiter.admit(CLIENT, 1, LIMIT, 1000));
+    TEST_ASSERT_EQUAL_UINT32(1000, limiter.admit(CLIENT, 1, LIMIT, 1000));
+}
+
+static void test_refills_at_the_sustained_rate() {
+    for (int i = 0; i < LIMIT.burst; i++) limiter.admit(CLIENT, 1, LIMIT, 0);
+    TEST_ASSERT_EQUAL_UINT32(400, limiter.admit(CLIENT, 1, LIMIT, 600));
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.admit(CLIENT, 1, LIMIT, 1000));
+    TEST_ASSERT_TRUE(limiter.admit(CLIENT, 1, LIMIT, 1000) > 0);
+    // A long idle spell refills to the burst, no further
+    for (int i = 0; i < LIMIT.burst; i++) TEST_ASSERT_EQUAL_UINT32(0, limiter.admit(CLIENT, 1, LIMIT, 3600000));
+    TEST_ASSERT_TRUE(limiter.admit(CLIENT, 1, LIMIT, 3600000) > 0);
+}
+
+static void test_clients_and_routes_have_their_own_buckets() {
+    for (int i = 0; i < LIMIT.burst; i++) limiter.admit(CLIENT, 1, LIMIT, 0);
+    TEST_ASSERT_TRUE(limiter.admit(CLIENT, 1, LIMIT, 0) > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.admit(CLIENT, 2, LIMIT, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.admit(CLIENT + 1, 1, LIMIT, 0));
+    TEST_ASSERT_EQUAL(3, limiter.clients());
+}
+
+static void test_zero_burst_is_unlimited() {
+    const RateLimit unlimited = {0, 0};
+    for (int i = 0; i < 1000; i++) TEST_ASSERT_EQUAL_UINT32(0, limiter.admit(CLIENT, 1, unlimited, 0));
+    TEST_ASSERT_EQUAL(0, limiter.clients());
+}
+
+static void test_zero_rate_never_refills() {
+    const RateLimit once = {1, 0};
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.admit(CLIENT, 1, once, 0));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, limiter.admit(CLIENT, 1, once, 3600000));
+}
+
+static void test_full_table_evicts_the_longest_idle() {
+    for (uint32_t c = 0; c < RATE_LIMIT_BUCKETS; c++) limiter.admit(c, 1, LIMIT, c);
+    TEST_ASSERT_EQUAL(RATE_LIMIT_BUCKETS, limiter.clients());
+    // Client 0 is the oldest; drain client 1 so its bucket is recognisable
+    for (int i = 0; i < LIMIT.burst; i++) limiter.admit(1, 1, LIMIT, 100);
+    limiter.admit(1000, 1, LIMIT, 200);  // Takes client 0's slot
+    TEST_ASSERT_EQUAL(RATE_LIMIT_BUCKETS, limiter.clients());
+    TEST_ASSERT_TRUE(limiter.admit(1, 1, LIMIT, 200) > 0);  // Still tracked, still empty
+}
+
+static void test_survives_the_millis_wrap() {
+    uint32_t before = UINT32_MAX - 500;
+    for (int i = 0; i < LIMIT.burst; i++) limiter.admit(CLIENT, 1, LIMIT, before);
+    TEST_ASSERT_TRUE(limiter.admit(CLIENT, 1, LIMIT, before) > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, limiter.admit(CLIENT, 1, LIMIT, before + 1000));  // Wrapped past 0
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_allows_the_burst_then_refuses);
+    RUN_TEST(test_refills_at_the_sustained_rate);
+    RUN_TEST(test_clients_and_routes_have_their_own_buckets);
+    RUN_TEST(test_zero_burst_is_unlimited);
+    RUN_TEST(test_zero_rate_never_refills);
+    RUN_TEST(test_full_table_evicts_the_longest_idle);
+    RUN_TEST(test_survives_the_millis_wrap);
+    return UNITY_END();
+}
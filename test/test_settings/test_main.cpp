@@ -0,0 +1,249 @@
+/**
+ * Word Clock - Settings tests
+ *
+ * Everything generated from CLOCK_SETTINGS: defaults, the form parser and
+ * its range check, the JSON applier and the NVS codec. Form and PATCH
+ * values come from any client on the network, and NVS values may predate
+ * the current limits, so out-of-range or malformed input must be refused
+ * and leave the settings as they were.
+ *
+ * Run with: pio test -e native
+ */
+
+#include <map>
+#include <string>
+#include <unity.h>
+#include <word_clock_core.h>
+
+// Preferences-shaped store for loadSettings()/saveSettings()
+struct FakeStore {
+    std::map<std::string, long> ints;
+    std::map<std::string, std::string> strings;
+    int writes = 0;
+
+    bool isKey(const char* key) { return ints.count(key) || strings.count(key); }
+    long getInt(const char* key, long fallback) { return ints.count(key) ? ints[key] : fallback; }
+    size_t getString(const char* key, char* buffer, size_t size) {
+        if (!strings.count(key) || strings[key].size() >= size) return 0;
+        memcpy(buffer, strings[key].c_str(), strings[key].size() + 1);
+        return strings[key].size() + 1;
+    }
+    void putInt(const char* key, long value) { ints[key] = value, writes++; }
+    void putString(const char* key, const char* value) { strings[key] = value, writes++; }
+};
+
+void setUp() {}
+void tearDown() {}
+
+static void expectInvalid(SettingId id, const char* text) {
+    ClockSettings settings;
+    ClockSettings before = settings;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(SETTING_INVALID, parseSetting(settings, id, text), text);
+    TEST_ASSERT_TRUE_MESSAGE(memcmp(&settings, &before, sizeof(settings)) == 0, text);
+}
+
+static void expectValid(SettingId id, const char* text) {
+    ClockSettings settings;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(SETTING_OK, parseSetting(settings, id, text), text);
+    char formatted[SETTING_TEXT_MAX];
+    TEST_ASSERT_TRUE(formatSetting(formatted, sizeof(formatted), settings, id) > 0 || !text[0]);
+    TEST_ASSERT_EQUAL_STRING(text, formatted);
+}
+
+static void test_defaults_come_from_the_schema() {
+    ClockSettings settings;
+    TEST_ASSERT_EQUAL(5, settings.brightness.darkBrightness);
+    TEST_ASSERT_EQUAL(25, settings.brightness.lightBrightness);
+    TEST_ASSERT_EQUAL(2600, settings.brightness.threshold);
+    TEST_ASSERT_EQUAL(TRANSITION_DEFAULT_MS, settings.transitionMs);
+    TEST_ASSERT_EQUAL(24, settings.updateHours);
+    TEST_ASSERT_EQUAL_STRING("", settings.updateUrl);
+    TEST_ASSERT_EQUAL_STRING("Etc/UTC", settings.timezone);
+    // The curve is built from the brightness defaults
+    CurveSettings built = curveFromSettings(settings.brightness);
+    TEST_ASSERT_EQUAL(built.count, settings.curve.count);
+    TEST_ASSERT_EQUAL(built.points[2].level, settings.curve.points[2].level);
+}
+
+static void test_timezone_default_can_be_set() {
+    TEST_ASSERT_FALSE(setDefaultTimezone("Nowhere"));
+    TEST_ASSERT_TRUE(setDefaultTimezone("Europe/Paris"));
+    ClockSettings settings;
+    TEST_ASSERT_EQUAL_STRING("Europe/Paris", settings.timezone);
+
+    char schema[768];
+    TEST_ASSERT_TRUE(formatSettingSchemaJson(schema, sizeof(schema), SETTING_timezone) > 0);
+    TEST_ASSERT_NOT_NULL(strstr(schema, "\"default\":\"Europe/Paris\""));
+    TEST_ASSERT_TRUE(setDefaultTimezone("Etc/UTC"));
+}
+
+static void test_int_settings_accept_their_range() {
+    expectValid(SETTING_darkBrightness, "0");
+    expectValid(SETTING_darkBrightness, "255");
+    expectValid(SETTING_threshold, "4095");
+    expectValid(SETTING_updateHours, "1");
+    expectValid(SETTING_updateHours, "168");
+    expectValid(SETTING_transitionMs, "0");
+}
+
+static void test_int_settings_reject_out_of_range_and_junk() {
+    expectInvalid(SETTING_darkBrightness, "256");
+    expectInvalid(SETTING_darkBrightness, "-1");
+    expectInvalid(SETTING_darkBrightness, "999");
+    expectInvalid(SETTING_threshold, "4096");
+    expectInvalid(SETTING_updateHours, "0");
+    expectInvalid(SETTING_updateHours, "169");
+    expectInvalid(SETTING_lightBrightness, "");
+    expectInvalid(SETTING_lightBrightness, "abc");
+    expectInvalid(SETTING_lightBrightness, "12abc");
+    expectInvalid(SETTING_lightBrightness, "12 ");
+    expectInvalid(SETTING_lightBrightness, "1.5");
+    expectInvalid(SETTING_lightBrightness, "99999999999999999999");
+}
+
+static void test_timezone_is_checked() {
+    expectValid(SETTING_timezone, "Europe/London");
+    expectValid(SETTING_timezone, "America/Argentina/Buenos_Aires");
+    expectInvalid(SETTING_timezone, "");
+    expectInvalid(SETTING_timezone, "London");
+    expectInvalid(SETTING_timezone, "Bad Zone/City");
+    expectInvalid(SETTING_timezone, ("Europe/" + std::string(TIMEZONE_NAME_MAX, 'x')).c_str());
+}
+
+static void test_curve_points_are_checked() {
+    expectValid(SETTING_points, "0:5,2200:5,3000:25,4095:25");
+    expectInvalid(SETTING_points, "0:5");
+    expectInvalid(SETTING_points, "0:5,0:6");
+    expectInvalid(SETTING_points, "100:5,50:6");
+    expectInvalid(SETTING_points, "0:5,4096:6");
+    expectInvalid(SETTING_points, "0:5,100:256");
+    expectInvalid(SETTING_points, "0:1,1:1,2:1,3:1,4:1,5:1,6:1,7:1,8:1");
+}
+
+static void test_update_url_is_checked() {
+    expectValid(SETTING_updateUrl, "");
+    expectValid(SETTING_updateUrl, "http://updates.local:8000/clock/manifest.json");
+    expectInvalid(SETTING_updateUrl, "https://updates.local/manifest.json");
+    expectInvalid(SETTING_updateUrl, "ftp://updates.local/manifest.json");
+    expectInvalid(SETTING_updateUrl, ("http://host/" + std::string(UPDATE_URL_MAX, 'x')).c_str());
+}
+
+static void test_lookup_by_name() {
+    ClockSettings settings;
+    TEST_ASSERT_EQUAL(SETTING_OK, parseSetting(settings, "slew", "20"));
+    TEST_ASSERT_EQUAL(20, settings.curve.slewPerSecond);
+    TEST_ASSERT_EQUAL(SETTING_UNKNOWN, parseSetting(settings, "slewRate", "20"));
+    TEST_ASSERT_EQUAL(SETTING_COUNT, findSetting(""));
+}
+
+static void test_errors_name_the_range() {
+    char error[64];
+    TEST_ASSERT_TRUE(formatSettingError(error, sizeof(error), SETTING_darkBrightness) > 0);
+    TEST_ASSERT_EQUAL_STRING("darkBrightness must be 0-255", error);
+    TEST_ASSERT_TRUE(formatSettingError(error, sizeof(error), SETTING_COUNT) > 0);
+    TEST_ASSERT_EQUAL_STRING("Unknown setting", error);
+}
+
+static void test_json_members_are_applied_or_refused() {
+    static JsonReader document;
+    char error[64] = "";
+    ClockSettings settings;
+
+    const char ok[] = "{\"darkBrightness\":3,\"timezone\":\"Europe/Paris\"}";
+    TEST_ASSERT_TRUE(document.parse(ok, strlen(ok)));
+    TEST_ASSERT_TRUE(parseSettingsJson(settings, document, error, sizeof(error)));
+    TEST_ASSERT_EQUAL(3, settings.brightness.darkBrightness);
+    TEST_ASSERT_EQUAL_STRING("Europe/Paris", settings.timezone);
+
+    const struct { const char* json; const char* error; } REFUSED[] = {
+        {"{\"darkBrightness\":\"3\"}", "darkBrightness must be a number"},
+        {"{\"timezone\":3}", "timezone must be a string"},
+        {"{\"darkBrightness\":true}", "darkBrightness must be a number"},
+        {"{\"darkBrightness\":null}", "darkBrightness must be a number"},
+        {"{\"darkBrightness\":999}", "darkBrightness must be 0-255"},
+        {"{\"darkBrightness\":2.5}", "darkBrightness must be 0-255"},
+        {"{\"brightness\":3}", "Unknown setting: brightness"},
+        {"{\"timezone\":\"Nowhere\"}", "Invalid timezone format"},
+    };
+    for (const auto& r : REFUSED) {
+        TEST_ASSERT_TRUE(document.parse(r.json, strlen(r.json)));
+        TEST_ASSERT_FALSE_MESSAGE(parseSettingsJson(settings, document, error, sizeof(error)), r.json);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(r.error, error, r.json);
+    }
+}
+
+static void test_curve_is_rebuilt_only_when_brightness_changes_alone() {
+    ClockSettings before;
+    ClockSettings edited = before;
+    edited.brightness.threshold = 1000;
+    rebuildCurve(edited, before);
+    TEST_ASSERT_EQUAL(curveFromSettings(edited.brightness).points[1].level, edited.curve.points[1].level);
+
+    ClockSettings both = before;
+    both.brightness.threshold = 1000;
+    TEST_ASSERT_EQUAL(SETTING_OK, parseSetting(both, SETTING_points, "0:1,4095:200"));
+    rebuildCurve(both, before);
+    TEST_ASSERT_EQUAL(2, both.curve.count);
+    TEST_ASSERT_EQUAL(200, both.curve.points[1].brightness);
+}
+
+static void test_every_setting_round_trips_through_its_text_form() {
+    ClockSettings settings;
+    TEST_ASSERT_EQUAL(SETTING_OK, parseSetting(settings, SETTING_updateUrl, "http://host/m.json"));
+    for (int i = 0; i < SETTING_COUNT; i++) {
+        char text[SETTING_TEXT_MAX];
+        TEST_ASSERT_TRUE_MESSAGE(formatSetting(text, sizeof(text), settings, (SettingId)i) > 0,
+                                 SETTING_FIELDS[i].name);
+        ClockSettings copy;
+        TEST_ASSERT_EQUAL_INT_MESSAGE(SETTING_OK, parseSetting(copy, (SettingId)i, text), SETTING_FIELDS[i].name);
+    }
+}
+
+static void test_store_keeps_defaults_for_rejected_values() {
+    FakeStore store;
+    store.ints["dark"] = 999;  // Out of range, e.g. from an older firmware
+    store.ints["light"] = 40;
+    store.strings["tz"] = "Nowhere";
+    ClockSettings settings;
+    TEST_ASSERT_EQUAL(1, loadSettings(store, settings));
+    TEST_ASSERT_EQUAL(5, settings.brightness.darkBrightness);
+    TEST_ASSERT_EQUAL(40, settings.brightness.lightBrightness);
+    TEST_ASSERT_EQUAL_STRING("Etc/UTC", settings.timezone);
+}
+
+static void test_store_writes_only_changed_settings() {
+    FakeStore store;
+    ClockSettings saved;
+    ClockSettings settings = saved;
+    TEST_ASSERT_EQUAL(0, saveSettings(store, settings, saved));
+    settings.brightness.darkBrightness = 7;
+    TEST_ASSERT_EQUAL(SETTING_OK, parseSetting(settings, SETTING_timezone, "Asia/Tokyo"));
+    TEST_ASSERT_EQUAL(2, saveSettings(store, settings, saved));
+    TEST_ASSERT_EQUAL(2, store.writes);
+    TEST_ASSERT_EQUAL(7, store.ints["dark"]);
+    TEST_ASSERT_EQUAL_STRING("Asia/Tokyo", store.strings["tz"].c_str());
+
+    ClockSettings loaded;
+    TEST_ASSERT_EQUAL(2, loadSettings(store, loaded));
+    TEST_ASSERT_EQUAL(7, loaded.brightness.darkBrightness);
+    TEST_ASSERT_EQUAL_STRING("Asia/Tokyo", loaded.timezone);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_defaults_come_from_the_schema);
+    RUN_TEST(test_timezone_default_can_be_set);
+    RUN_TEST(test_int_settings_accept_their_range);
+    RUN_TEST(test_int_settings_reject_out_of_range_and_junk);
+    RUN_TEST(test_timezone_is_checked);
+    RUN_TEST(test_curve_points_are_checked);
+    RUN_TEST(test_update_url_is_checked);
+    RUN_TEST(test_lookup_by_name);
+    RUN_TEST(test_errors_name_the_range);
+    RUN_TEST(test_json_members_are_applied_or_refused);
+    RUN_TEST(test_curve_is_rebuilt_only_when_brightness_changes_alone);
+    RUN_TEST(test_every_setting_round_trips_through_its_text_form);
+    RUN_TEST(test_store_keeps_defaults_for_rejected_values);
+    RUN_TEST(test_store_writes_only_changed_settings);
+    return UNITY_END();
+}
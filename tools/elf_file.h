@@ -0,0 +1,140 @@
+/**
+ * Word Clock - Minimal ELF32 reader for the host tools
+ *
+ * Just enough of the ELF format to look up constant data and function
+ * symbols in the firmware image (.pio/build/esp32dev/firmware.elf):
+ * - stringAt() finds a NUL-terminated string at a device address, used to
+ *   recover deferred log format strings
+ * - symbolFor() maps a program counter to the enclosing function
+ *
+ * Header-only so each tool stays a single g++ invocation.
+ */
+
+#ifndef ELF_FILE_H
+#define ELF_FILE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class ElfFile {
+public:
+    struct Symbol {
+        uint32_t address;
+        uint32_t size;
+        std::string name;
+    };
+
+    /**
+     * Loads and indexes an ELF32 little-endian file
+     * @return false (with a message on stderr) if the file is unusable
+     */
+    bool load(const char* path) {
+        FILE* f = fopen(path, "rb");
+        if (!f) {
+            perror(path);
+            return false;
+        }
+        fseek(f, 0, SEEK_END);
+        data_.resize(ftell(f));
+        fseek(f, 0, SEEK_SET);
+        bool ok = fread(data_.data(), 1, data_.size(), f) == data_.size();
+        fclose(f);
+        if (!ok || data_.size() < 52 || memcmp(data_.data(), "\x7f" "ELF", 4) != 0) {
+            fprintf(stderr, "%s: not an ELF file\n", path);
+            return false;
+        }
+        if (data_[4] != 1 || data_[5] != 1) {
+            fprintf(stderr, "%s: only 32-bit little-endian ELF is supported\n", path);
+            return false;
+        }
+
+        uint32_t shoff = read32(32);
+        uint16_t shentsize = read16(46);
+        uint16_t shnum = read16(48);
+        if (shoff + (uint64_t)shentsize * shnum > data_.size()) {
+            fprintf(stderr, "%s: corrupt section table\n", path);
+            return false;
+        }
+        for (uint16_t i = 0; i < shnum; i++) {
+            uint32_t base = shoff + i * shentsize;
+            sections_.push_back({read32(base + 4), read32(base + 8), read32(base + 12),
+                                 read32(base + 16), read32(base + 20), read32(base + 24)});
+        }
+        indexSymbols();
+        return true;
+    }
+
+    /**
+     * Returns the string stored at a device address, or nullptr if the
+     * address is not inside an initialised, loadable section
+     */
+    const char* stringAt(uint32_t address) const {
+        for (const Section& s : sections_) {
+            if (!(s.flags & SHF_ALLOC) || s.type == SHT_NOBITS) continue;
+            if (address < s.addr || address >= s.addr + s.size) continue;
+            uint32_t offset = s.offset + (address - s.addr);
+            uint32_t end = s.offset + s.size;
+            if (end > data_.size()) return nullptr;
+            if (!memchr(&data_[offset], '\0', end - offset)) return nullptr;
+            return (const char*)&data_[offset];
+        }
+        return nullptr;
+    }
+
+    /**
+     * Returns the function symbol containing an address, or nullptr
+     */
+    const Symbol* symbolFor(uint32_t address) const {
+        auto it = std::upper_bound(symbols_.begin(), symbols_.end(), address,
+                                   [](uint32_t a, const Symbol& s) { return a < s.address; });
+        if (it == symbols_.begin()) return nullptr;
+        --it;
+        uint32_t size = it->size ? it->size : 1;
+        return address < it->address + size ? &*it : nullptr;
+    }
+
+private:
+    static const uint32_t SHT_SYMTAB = 2;
+    static const uint32_t SHT_NOBITS = 8;
+    static const uint32_t SHF_ALLOC = 2;
+    static const uint8_t STT_FUNC = 2;
+
+    struct Section {
+        uint32_t type;
+        uint32_t flags;
+        uint32_t addr;
+        uint32_t offset;
+        uint32_t size;
+        uint32_t link;
+    };
+
+    uint16_t read16(size_t at) const { return data_[at] | (data_[at + 1] << 8); }
+    uint32_t read32(size_t at) const { return read16(at) | ((uint32_t)read16(at + 2) << 16); }
+
+    void indexSymbols() {
+        for (const Section& s : sections_) {
+            if (s.type != SHT_SYMTAB || s.link >= sections_.size()) continue;
+            const Section& strtab = sections_[s.link];
+            for (uint32_t at = s.offset; at + 16 <= s.offset + s.size && at + 16 <= data_.size(); at += 16) {
+                uint32_t nameOffset = read32(at);
+                uint32_t value = read32(at + 4);
+                uint32_t size = read32(at + 8);
+                if ((data_[at + 12] & 0xf) != STT_FUNC || value == 0) continue;
+                if (strtab.offset + nameOffset >= data_.size()) continue;
+                symbols_.push_back({value & ~1u, size, (const char*)&data_[strtab.offset + nameOffset]});
+            }
+        }
+        std::sort(symbols_.begin(), symbols_.end(),
+                  [](const Symbol& a, const Symbol& b) { return a.address < b.address; });
+    }
+
+    std::vector<uint8_t> data_;
+    std::vector<Section> sections_;
+    std::vector<Symbol> symbols_;
+};
+
+#endif // ELF_FILE_H
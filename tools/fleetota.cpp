@@ -0,0 +1,523 @@
+/**
+ * Word Clock - Fleet OTA Orchestrator
+ *
+ * Pushes one firmware image to many clocks with ArduinoOTA's own protocol
+ * (the one espota.py speaks), in stages: a canary first, then waves. Up to
+ * --parallel clocks in a stage update at once. After each push the clock
+ * reboots, and it counts as updated only once /metrics reports the
+ * expected version, /api/update shows the new image past its self-check
+ * (so it will not roll back), and /api/status.bin shows the time synced
+ * and no health alerts. When more clocks fail than --max-failures allows, no
+ * further clock is started and later stages never run.
+ *
+ * Clocks already on the expected version are left alone, so a halted
+ * rollout resumes by running the same command again. Clocks that do not
+ * answer before their push are reported but do not stop the rollout.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread -o fleetota tools/fleetota.cpp lib/WordClockCore/src/status_binary.cpp
+ * Usage:  WORDCLOCK_OTA_PASSWORD=... ./fleetota --image firmware.bin --expect v1.4.0 --hosts clocks.txt
+ *         ./fleetota --image .pio/build/emulator/program --expect v1.4.0-emulator \
+ *             127.0.0.1:18080:3232 127.0.0.1:18081:3233      (emulators, see emulator/ota.cpp)
+ *
+ * Clocks are host[:httpPort[:otaPort]], 80 and 3232 by default. The report
+ * on stdout is one JSON document with a "summary" object and a "devices"
+ * array holding each clock's transfer time, throughput and reboot time.
+ */
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lib/WordClockCore/src/status_binary.h"
+#include "http_client.h"
+#include "md5.h"
+
+#define OTA_COMMAND_FLASH 0
+#define OTA_COMMAND_AUTH 200
+#define OTA_REPLY_TIMEOUT_MS 10000  // As espota.py
+#define OTA_END_TIMEOUT_MS 60000    // The clock checks the image before its last reply
+#define OTA_CHUNK 1460              // What the clock reads at a time
+#define HTTP_TIMEOUT_MS 5000
+#define POLL_INTERVAL_MS 1000       // While waiting for a clock to come back
+#define TIME_SET 2                  // ezTime's timeSet, as in StatusBinary::syncState
+
+static long long nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct Options {
+    std::string image;  // The firmware, whole
+    std::string imageName;
+    std::string imageMd5;
+    std::string expect;
+    std::string password;
+    int canary = 1;
+    int wave = 10;
+    int parallel = 4;
+    int maxFailures = 0;
+    int bootTimeoutS = 90;
+    int soakS = 0;
+};
+
+enum Result { RESULT_PENDING, RESULT_CURRENT, RESULT_UNREACHABLE, RESULT_UPDATED, RESULT_FAILED };
+static const char* const RESULT_NAMES[] = {"notAttempted", "current", "unreachable", "updated", "failed"};
+
+struct Device {
+    std::string host;
+    uint16_t httpPort = 80;
+    uint16_t otaPort = 3232;
+    sockaddr_in address = {};
+
+    int stage = 0;
+    Result result = RESULT_PENDING;
+    std::string error;
+    std::string versionBefore, versionAfter;
+    long long transferMs = -1;  // First byte sent to the clock's OK
+    long long bootMs = -1;      // OK to healthy on the new version
+    long long totalMs = -1;
+};
+
+static std::mutex logLock;
+
+static void progress(const Device& d, const char* format, ...) __attribute__((format(printf, 2, 3)));
+static void progress(const Device& d, const char* format, ...) {
+    std::lock_guard<std::mutex> lock(logLock);
+    fprintf(stderr, "%s:%u ", d.host.c_str(), d.httpPort);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+static bool addDevice(std::vector<Device>& devices, const std::string& spec) {
+    Device d;
+    unsigned http = 80, ota = 3232;
+    char host[256];
+    int fields = sscanf(spec.c_str(), "%255[^:]:%u:%u", host, &http, &ota);
+    if (fields < 1 || http < 1 || http > 65535 || ota < 1 || ota > 65535) {
+        fprintf(stderr, "%s: expected host[:httpPort[:otaPort]]\n", spec.c_str());
+        return false;
+    }
+    addrinfo hints = {}, *result;
+    hints.ai_family = AF_INET;
+    if (getaddrinfo(host, nullptr, &hints, &result) != 0) {
+        fprintf(stderr, "%s: unknown host\n", host);
+        return false;
+    }
+    d.address = *(sockaddr_in*)result->ai_addr;
+    d.address.sin_port = htons(http);
+    freeaddrinfo(result);
+    d.host = host;
+    d.httpPort = http;
+    d.otaPort = ota;
+    devices.push_back(d);
+    return true;
+}
+
+static bool readHostFile(std::vector<Device>& devices, const char* path) {
+    FILE* in = fopen(path, "r");
+    if (!in) {
+        perror(path);
+        return false;
+    }
+    char line[256];
+    bool ok = true;
+    while (fgets(line, sizeof(line), in)) {
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char spec[256];
+        if (sscanf(line, "%255s", spec) == 1) ok &= addDevice(devices, spec);
+    }
+    fclose(in);
+    return ok;
+}
+
+// Clock state over HTTP
+
+struct Observation {
+    std::string version;
+    StatusBinary status;
+};
+
+static bool observe(const Device& d, Observation& seen, std::string& error) {
+    std::string body;
+    int code = httpGet(d.address, d.host, "/metrics", HTTP_TIMEOUT_MS, body);
+    if (code != 200) {
+        error = code ? "/metrics answered HTTP " + std::to_string(code) : body;
+        return false;
+    }
+    const char* marker = "wordclock_build_info{version=\"";
+    size_t at = body.find(marker);
+    if (at == std::string::npos) {
+        error = "/metrics has no wordclock_build_info";
+        return false;
+    }
+    at += strlen(marker);
+    seen.version = body.substr(at, body.find('"', at) - at);
+
+    code = httpGet(d.address, d.host, "/api/status.bin", HTTP_TIMEOUT_MS, body);
+    if (code != 200) {
+        error = code ? "/api/status.bin answered HTTP " + std::to_string(code) : body;
+        return false;
+    }
+    if (!decodeStatusBinary((const uint8_t*)body.data(), body.size(), seen.status)) {
+        error = "bad status document";
+        return false;
+    }
+    return true;
+}
+
+// Whether the clock runs `expect` and is healthy; `error` says why not
+static bool healthy(const Device& d, const std::string& expect, Observation& seen, std::string& error) {
+    if (!observe(d, seen, error)) return false;
+    if (seen.version != expect) {
+        error = "running " + seen.version;
+        return false;
+    }
+    if (seen.status.syncState != TIME_SET) {
+        error = "time not synced";
+        return false;
+    }
+    if (seen.status.healthAlerts) {
+        error = "health alerts " + std::to_string(seen.status.healthAlerts);
+        return false;
+    }
+    // A clock without /api/update has no self-check to wait for
+    std::string body;
+    int code = httpGet(d.address, d.host, "/api/update", HTTP_TIMEOUT_MS, body);
+    if (code == 0) {
+        error = body;
+        return false;
+    }
+    if (code == 200 && body.find("\"state\":\"verifying\"") != std::string::npos) {
+        error = "self-check not passed yet";
+        return false;
+    }
+    return true;
+}
+
+// The OTA push
+
+static bool waitReadable(int fd, int timeoutMs) {
+    pollfd ready = {fd, POLLIN, 0};
+    return poll(&ready, 1, timeoutMs) > 0;
+}
+
+static std::string udpExchange(int udp, const std::string& message) {
+    send(udp, message.data(), message.size(), 0);
+    char reply[64];
+    ssize_t n = waitReadable(udp, OTA_REPLY_TIMEOUT_MS) ? recv(udp, reply, sizeof(reply) - 1, 0) : -1;
+    return n > 0 ? std::string(reply, n) : "";
+}
+
+/**
+ * Sends the image as espota.py does: invitation and password challenge
+ * over UDP, then the clock connects back and is fed the image over TCP
+ */
+static bool push(Device& d, const Options& options) {
+    int listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    socklen_t localSize = sizeof(local);
+    if (bind(listener, (sockaddr*)&local, sizeof(local)) != 0 || listen(listener, 1) != 0 ||
+        getsockname(listener, (sockaddr*)&local, &localSize) != 0) {
+        d.error = std::string("listen: ") + strerror(errno);
+        close(listener);
+        return false;
+    }
+
+    int udp = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    sockaddr_in ota = d.address;
+    ota.sin_port = htons(d.otaPort);
+    connect(udp, (sockaddr*)&ota, sizeof(ota));
+    char invitation[96];
+    snprintf(invitation, sizeof(invitation), "%d %u %zu %s\n", OTA_COMMAND_FLASH, ntohs(local.sin_port),
+             options.image.size(), options.imageMd5.c_str());
+    std::string reply = udpExchange(udp, invitation);
+    if (reply.compare(0, 5, "AUTH ") == 0) {
+        if (options.password.empty()) {
+            d.error = "the clock wants a password (--password or WORDCLOCK_OTA_PASSWORD)";
+        } else {
+            std::string nonce = reply.substr(5, 32);
+            std::string cnonce = Md5::of(options.imageName + std::to_string(options.image.size()) +
+                                         options.imageMd5 + d.host);
+            std::string answer = Md5::of(Md5::of(options.password) + ":" + nonce + ":" + cnonce);
+            reply = udpExchange(udp, std::to_string(OTA_COMMAND_AUTH) + " " + cnonce + " " + answer + "\n");
+            if (reply != "OK") d.error = reply.empty() ? "no answer to the password" : reply;
+        }
+    } else if (reply != "OK") {
+        d.error = reply.empty() ? "no answer to the OTA invitation" : "OTA invitation refused: " + reply;
+    }
+    close(udp);
+
+    int client = -1;
+    if (d.error.empty()) {
+        client = waitReadable(listener, OTA_REPLY_TIMEOUT_MS) ? accept4(listener, nullptr, nullptr, SOCK_CLOEXEC) : -1;
+        if (client < 0) d.error = "the clock did not connect for the image";
+    }
+    close(listener);
+    if (client < 0) return false;
+
+    // The clock acknowledges each read with its length, and ends with OK or an error
+    timeval sendTimeout = {OTA_REPLY_TIMEOUT_MS / 1000, 0};
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+    long long start = nowMs();
+    std::string replies;
+    char buffer[256];
+    for (size_t sent = 0; sent < options.image.size();) {
+        ssize_t n = send(client, options.image.data() + sent, std::min<size_t>(OTA_CHUNK, options.image.size() - sent),
+                         MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += n;
+        while ((n = recv(client, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) replies.append(buffer, n);
+        replies.erase(0, replies.size() > 128 ? replies.size() - 128 : 0);
+    }
+    long long deadline = nowMs() + OTA_END_TIMEOUT_MS;
+    while (replies.find("OK") == std::string::npos && waitReadable(client, std::max(0LL, deadline - nowMs()))) {
+        ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        replies.append(buffer, n);
+    }
+    close(client);
+    if (replies.find("OK") == std::string::npos) {
+        size_t text = replies.find_first_not_of("0123456789");
+        d.error = text == std::string::npos ? "transfer cut off" : "the clock refused the image: " + replies.substr(text);
+        return false;
+    }
+    d.transferMs = nowMs() - start;
+    return true;
+}
+
+static void updateOne(Device& d, const Options& options) {
+    long long start = nowMs();
+    Observation seen;
+    if (!observe(d, seen, d.error)) {
+        d.result = RESULT_UNREACHABLE;
+        progress(d, "unreachable: %s", d.error.c_str());
+        return;
+    }
+    d.versionBefore = seen.version;
+    if (seen.version == options.expect) {
+        d.result = RESULT_CURRENT;
+        d.versionAfter = seen.version;
+        progress(d, "already on %s", seen.version.c_str());
+        return;
+    }
+
+    progress(d, "pushing %zu bytes over %s", options.image.size(), seen.version.c_str());
+    if (!push(d, options)) {
+        d.result = RESULT_FAILED;
+        progress(d, "failed: %s", d.error.c_str());
+        return;
+    }
+    long long pushed = nowMs();
+    progress(d, "sent in %lld ms (%.1f KB/s), waiting for it to come back", d.transferMs,
+             options.image.size() / 1024.0 / std::max(1LL, d.transferMs) * 1000);
+
+    long long deadline = pushed + options.bootTimeoutS * 1000LL;
+    std::string error;
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+        if (healthy(d, options.expect, seen, error)) break;
+        if (nowMs() > deadline) {
+            d.result = RESULT_FAILED;
+            d.error = "not healthy " + std::to_string(options.bootTimeoutS) + " s after the update: " + error;
+            d.versionAfter = seen.version;
+            progress(d, "failed: %s", d.error.c_str());
+            return;
+        }
+    }
+    d.versionAfter = seen.version;
+    d.bootMs = nowMs() - pushed;
+    d.totalMs = nowMs() - start;
+    d.result = RESULT_UPDATED;
+    progress(d, "updated, healthy on %s after %lld ms", seen.version.c_str(), d.bootMs);
+}
+
+// Stages
+
+static std::atomic<int> failures(0);
+static std::atomic<bool> halted(false);
+static std::string haltReason;
+
+static void fail(Device& d, const Options& options) {
+    if (++failures > options.maxFailures && !halted.exchange(true)) {
+        std::lock_guard<std::mutex> lock(logLock);
+        haltReason = d.host + ":" + std::to_string(d.httpPort) + ": " + d.error;
+    }
+}
+
+static void runStage(std::vector<Device*>& stage, const Options& options) {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i; !halted && (i = next++) < stage.size();) {
+            updateOne(*stage[i], options);
+            if (stage[i]->result == RESULT_FAILED) fail(*stage[i], options);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 0; i < std::min<int>(options.parallel, stage.size()); i++) workers.emplace_back(worker);
+    for (std::thread& t : workers) t.join();
+
+    if (halted || options.soakS == 0) return;
+    fprintf(stderr, "soaking for %d s\n", options.soakS);
+    std::this_thread::sleep_for(std::chrono::seconds(options.soakS));
+    for (Device* d : stage) {
+        Observation seen;
+        std::string error;
+        if (d->result != RESULT_UPDATED || healthy(*d, options.expect, seen, error)) continue;
+        d->result = RESULT_FAILED;
+        d->error = "not healthy after the soak: " + error;
+        progress(*d, "failed: %s", d->error.c_str());
+        fail(*d, options);
+    }
+}
+
+// Report
+
+static std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if ((unsigned char)c < 0x20) continue;
+        out += c;
+    }
+    return out + "\"";
+}
+
+static long long median(std::vector<long long> values) {
+    if (values.empty()) return -1;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static void printReport(const std::vector<Device>& devices, const Options& options, int stages) {
+    int counts[5] = {};
+    std::vector<long long> transfer, boot;
+    for (const Device& d : devices) {
+        counts[d.result]++;
+        if (d.result != RESULT_UPDATED) continue;
+        transfer.push_back(d.transferMs);
+        boot.push_back(d.bootMs);
+    }
+    long long transferMedian = median(transfer);
+    printf("{\"summary\":{\"devices\":%zu,\"stages\":%d,\"expect\":%s,\"imageBytes\":%zu,\"imageMd5\":\"%s\"",
+           devices.size(), stages, jsonString(options.expect).c_str(), options.image.size(), options.imageMd5.c_str());
+    for (int i = 0; i < 5; i++) printf(",\"%s\":%d", RESULT_NAMES[i], counts[i]);
+    printf(",\"medianTransferMs\":%lld,\"medianKBps\":%.1f,\"medianBootMs\":%lld,\"halted\":%s",
+           transferMedian, transferMedian > 0 ? options.image.size() / 1024.0 / transferMedian * 1000 : 0.0,
+           median(boot), halted ? "true" : "false");
+    if (halted) printf(",\"haltReason\":%s", jsonString(haltReason).c_str());
+    printf("},\n\"devices\":[\n");
+    for (size_t i = 0; i < devices.size(); i++) {
+        const Device& d = devices[i];
+        printf("{\"host\":%s,\"port\":%u,\"otaPort\":%u,\"stage\":%d,\"result\":\"%s\"", jsonString(d.host).c_str(),
+               d.httpPort, d.otaPort, d.stage, RESULT_NAMES[d.result]);
+        if (!d.versionBefore.empty()) printf(",\"versionBefore\":%s", jsonString(d.versionBefore).c_str());
+        if (!d.versionAfter.empty()) printf(",\"versionAfter\":%s", jsonString(d.versionAfter).c_str());
+        if (d.transferMs >= 0) {
+            printf(",\"bytes\":%zu,\"transferMs\":%lld,\"KBps\":%.1f", options.image.size(), d.transferMs,
+                   options.image.size() / 1024.0 / std::max(1LL, d.transferMs) * 1000);
+        }
+        if (d.bootMs >= 0) printf(",\"bootMs\":%lld,\"totalMs\":%lld", d.bootMs, d.totalMs);
+        if (!d.error.empty() && d.result != RESULT_UPDATED) printf(",\"error\":%s", jsonString(d.error).c_str());
+        printf("}%s\n", i + 1 < devices.size() ? "," : "");
+    }
+    printf("]}\n");
+}
+
+static void usage(const char* self) {
+    fprintf(stderr,
+            "usage: %s --image FILE --expect VERSION [options] [host[:httpPort[:otaPort]]...]\n"
+            "  --image FILE        firmware to push\n"
+            "  --expect VERSION    what /metrics reports once a clock runs it\n"
+            "  --hosts FILE        clocks to update, one per line\n"
+            "  --password TEXT     OTA password (default: $WORDCLOCK_OTA_PASSWORD)\n"
+            "  --canary N          clocks in the first stage (default 1)\n"
+            "  --wave N            clocks in each later stage (default 10)\n"
+            "  --parallel N        clocks updating at once (default 4)\n"
+            "  --max-failures N    failures tolerated before halting (default 0)\n"
+            "  --boot-timeout S    for a clock to come back healthy (default 90)\n"
+            "  --soak S            wait after each stage, then check it again (default 0)\n",
+            self);
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<Device> devices;
+    const char* imagePath = nullptr;
+    if (const char* password = getenv("WORDCLOCK_OTA_PASSWORD")) options.password = password;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--image") && hasValue) imagePath = argv[++i];
+        else if (!strcmp(a, "--expect") && hasValue) options.expect = argv[++i];
+        else if (!strcmp(a, "--hosts") && hasValue) {
+            if (!readHostFile(devices, argv[++i])) return 2;
+        }
+        else if (!strcmp(a, "--password") && hasValue) options.password = argv[++i];
+        else if (!strcmp(a, "--canary") && hasValue) options.canary = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(a, "--wave") && hasValue) options.wave = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(a, "--parallel") && hasValue) options.parallel = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(a, "--max-failures") && hasValue) options.maxFailures = std::max(0, atoi(argv[++i]));
+        else if (!strcmp(a, "--boot-timeout") && hasValue) options.bootTimeoutS = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(a, "--soak") && hasValue) options.soakS = std::max(0, atoi(argv[++i]));
+        else if (a[0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else if (!addDevice(devices, a)) {
+            return 2;
+        }
+    }
+    if (!imagePath || options.expect.empty() || devices.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE* in = fopen(imagePath, "rb");
+    if (!in) {
+        perror(imagePath);
+        return 2;
+    }
+    char buffer[65536];
+    for (size_t n; (n = fread(buffer, 1, sizeof(buffer), in)) > 0;) options.image.append(buffer, n);
+    fclose(in);
+    const char* slash = strrchr(imagePath, '/');
+    options.imageName = slash ? slash + 1 : imagePath;
+    options.imageMd5 = Md5::of(options.image);
+    fprintf(stderr, "%s: %zu bytes, MD5 %s\n", imagePath, options.image.size(), options.imageMd5.c_str());
+
+    int stages = 0;
+    for (size_t first = 0; first < devices.size() && !halted; stages++) {
+        size_t size = stages == 0 ? options.canary : options.wave;
+        std::vector<Device*> stage;
+        for (size_t i = first; i < std::min(devices.size(), first + size); i++) {
+            devices[i].stage = stages + 1;
+            stage.push_back(&devices[i]);
+        }
+        fprintf(stderr, "stage %d (%s): %zu clocks\n", stages + 1, stages == 0 ? "canary" : "wave", stage.size());
+        runStage(stage, options);
+        first += size;
+    }
+    if (halted) fprintf(stderr, "halted: %s\n", haltReason.c_str());
+
+    printReport(devices, options, stages);
+    return halted || failures ? 1 : 0;
+}
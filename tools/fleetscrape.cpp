@@ -0,0 +1,645 @@
+/**
+ * Word Clock - Fleet Scraper
+ *
+ * Polls many clocks at once and summarises them: time sync health, the
+ * brightness they show, firmware versions and free-heap trends. Each
+ * clock is asked for /api/status.bin (see status_binary.h) and /metrics
+ * (see metrics.h) over plain HTTP. Every connection is non-blocking and
+ * driven by one epoll loop, so thousands of clocks need one thread and a
+ * file descriptor per request in flight, never one per clock.
+ *
+ * Clocks come from the command line, a file (one per line, # comments) or
+ * mDNS: the firmware's OTA service announces itself as _arduino._tcp.
+ * host:first-last expands to a port range, which is how a fleet of
+ * emulators on one machine is addressed.
+ *
+ * Build:  g++ -std=c++17 -O2 -o fleetscrape tools/fleetscrape.cpp lib/WordClockCore/src/status_binary.cpp
+ * Usage:  ./fleetscrape --mdns                          discover and scrape once
+ *         ./fleetscrape --hosts clocks.txt --rounds 5 --interval 60 --csv
+ *         ./fleetscrape 127.0.0.1:18080-18179          one hundred emulators
+ *
+ * JSON output is one document with a "summary" object and a "devices"
+ * array. CSV output is one row per clock; the summary then goes to stderr.
+ * Linux only (epoll).
+ */
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../lib/WordClockCore/src/status_binary.h"
+#include "http_client.h"
+
+#define DEFAULT_CONCURRENCY 256    // Requests in flight at once
+#define DEFAULT_TIMEOUT_MS 5000    // Per request, connect to last byte
+#define DEFAULT_MDNS_MS 2000       // How long to collect mDNS answers
+#define HEAP_FALLING_PER_HOUR -4096  // As the firmware's health monitor
+#define SYNC_STALE_SECONDS 7200    // ezTime resyncs every 30 minutes
+
+static long long nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Clocks
+
+struct HeapSample {
+    double hours;  // Since the first round
+    uint32_t freeHeap;
+};
+
+struct Device {
+    std::string host;
+    uint16_t port = 80;
+    sockaddr_in address = {};
+    bool resolved = false;
+
+    bool reachable = false;  // Latest round answered /api/status.bin
+    std::string error;       // Why the latest round failed
+    StatusBinary status;
+    long long scrapedAt = 0;  // UTC seconds when the status was read
+    std::string version;
+    std::map<std::string, double> metrics;  // Unlabelled samples from /metrics
+    std::vector<HeapSample> heap;
+};
+
+static bool addDevice(std::vector<Device>& devices, const std::string& spec) {
+    std::string host = spec;
+    long first = 80, last = 80;
+    size_t colon = spec.rfind(':');
+    if (colon != std::string::npos) {
+        host = spec.substr(0, colon);
+        char* end;
+        first = last = strtol(spec.c_str() + colon + 1, &end, 10);
+        if (*end == '-') last = strtol(end + 1, &end, 10);
+        if (*end || first < 1 || last > 65535 || last < first) {
+            fprintf(stderr, "%s: expected host, host:port or host:first-last\n", spec.c_str());
+            return false;
+        }
+    }
+    for (long port = first; port <= last; port++) {
+        Device d;
+        d.host = host;
+        d.port = port;
+        devices.push_back(d);
+    }
+    return true;
+}
+
+static bool readHostFile(std::vector<Device>& devices, const char* path) {
+    FILE* in = fopen(path, "r");
+    if (!in) {
+        perror(path);
+        return false;
+    }
+    char line[256];
+    bool ok = true;
+    while (fgets(line, sizeof(line), in)) {
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char spec[256];
+        if (sscanf(line, "%255s", spec) == 1) ok &= addDevice(devices, spec);
+    }
+    fclose(in);
+    return ok;
+}
+
+static bool resolve(Device& d) {
+    addrinfo hints = {}, *result;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(d.host.c_str(), nullptr, &hints, &result) != 0) return false;
+    d.address = *(sockaddr_in*)result->ai_addr;
+    d.address.sin_port = htons(d.port);
+    freeaddrinfo(result);
+    return true;
+}
+
+// mDNS discovery
+
+static void putName(std::string& packet, const char* name) {
+    while (*name) {
+        const char* dot = strchr(name, '.');
+        size_t length = dot ? (size_t)(dot - name) : strlen(name);
+        packet += (char)length;
+        packet.append(name, length);
+        name += length + (dot ? 1 : 0);
+    }
+    packet += '\0';
+}
+
+// Reads a possibly compressed name; returns the offset after it, or 0
+static size_t readName(const uint8_t* packet, size_t size, size_t at, std::string& name) {
+    size_t next = 0;
+    name.clear();
+    for (int jumps = 0; at < size && jumps < 16;) {
+        uint8_t length = packet[at];
+        if (length == 0) return next ? next : at + 1;
+        if ((length & 0xC0) == 0xC0) {
+            if (at + 1 >= size) return 0;
+            if (!next) next = at + 2;
+            at = (length & 0x3F) << 8 | packet[at + 1];
+            jumps++;
+            continue;
+        }
+        if (at + 1 + length > size) return 0;
+        if (!name.empty()) name += '.';
+        name.append((const char*)packet + at + 1, length);
+        at += 1 + length;
+    }
+    return 0;
+}
+
+/**
+ * Asks the local network for _arduino._tcp services and adds each clock
+ * that answers with an address. Answers go to our own port (a "legacy
+ * unicast" query), so no multicast group has to be joined.
+ */
+static int discoverMdns(std::vector<Device>& devices, int waitMs) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("mDNS socket");
+        return 0;
+    }
+    std::string query("\0\0\0\0\0\1\0\0\0\0\0\0", 12);  // One question
+    putName(query, "_arduino._tcp.local");
+    query.append("\0\x0c\0\x01", 4);  // PTR, IN
+    sockaddr_in group = {};
+    group.sin_family = AF_INET;
+    group.sin_port = htons(5353);
+    inet_pton(AF_INET, "224.0.0.251", &group.sin_addr);
+    if (sendto(fd, query.data(), query.size(), 0, (sockaddr*)&group, sizeof(group)) < 0) {
+        perror("mDNS query");
+        close(fd);
+        return 0;
+    }
+
+    std::map<std::string, std::string> targets;  // Service instance -> host name
+    std::map<std::string, in_addr> addresses;    // Host name -> IPv4 address
+    long long deadline = nowMs() + waitMs;
+    for (long long left; (left = deadline - nowMs()) > 0;) {
+        epoll_event unused;
+        int ep = epoll_create1(0);
+        epoll_event ev = {EPOLLIN, {}};
+        epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+        int ready = epoll_wait(ep, &unused, 1, left);
+        close(ep);
+        if (ready <= 0) continue;
+
+        uint8_t packet[1500];
+        ssize_t size = recv(fd, packet, sizeof(packet), 0);
+        if (size < 12) continue;
+        int records = (packet[6] << 8 | packet[7]) + (packet[8] << 8 | packet[9]) + (packet[10] << 8 | packet[11]);
+        size_t at = 12;
+        std::string name, data;
+        for (int q = packet[4] << 8 | packet[5]; q > 0 && at; q--) {
+            at = readName(packet, size, at, name);
+            if (at) at += 4;
+        }
+        for (; records > 0 && at && at + 10 <= (size_t)size; records--) {
+            at = readName(packet, size, at, name);
+            if (!at || at + 10 > (size_t)size) break;
+            uint16_t type = packet[at] << 8 | packet[at + 1];
+            uint16_t length = packet[at + 8] << 8 | packet[at + 9];
+            size_t rdata = at + 10;
+            at = rdata + length;
+            if (at > (size_t)size) break;
+            if (type == 1 && length == 4) {  // A
+                memcpy(&addresses[name], packet + rdata, 4);
+            } else if (type == 33 && length > 6 && readName(packet, size, rdata + 6, data)) {  // SRV
+                targets[name] = data;
+            } else if (type == 12 && readName(packet, size, rdata, data) && !targets.count(data)) {  // PTR
+                targets[data] = "";
+            }
+        }
+    }
+    close(fd);
+
+    int found = 0;
+    for (const auto& t : targets) {
+        auto a = addresses.find(t.second);
+        if (a == addresses.end()) continue;
+        char ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &a->second, ip, sizeof(ip));
+        addDevice(devices, ip);
+        devices.back().host = t.second.empty() ? ip : t.second;
+        devices.back().address.sin_family = AF_INET;
+        devices.back().address.sin_addr = a->second;
+        devices.back().address.sin_port = htons(80);
+        devices.back().resolved = true;
+        found++;
+    }
+    return found;
+}
+
+// HTTP over epoll
+
+enum RequestKind { REQUEST_STATUS, REQUEST_METRICS };
+
+struct Request {
+    Device* device;
+    RequestKind kind;
+    int fd = -1;
+    std::string out;     // Still to send
+    std::string in;      // Received so far
+    long long deadline;
+};
+
+// Keeps the unlabelled samples, and the version from wordclock_build_info
+static void parseMetrics(Device& d, const std::string& text) {
+    d.metrics.clear();
+    size_t at = 0;
+    while (at < text.size()) {
+        size_t end = text.find('\n', at);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(at, end - at);
+        at = end + 1;
+        if (line.empty() || line[0] == '#') continue;
+        size_t version = line.find("wordclock_build_info{version=\"");
+        if (version == 0) {
+            size_t start = strlen("wordclock_build_info{version=\"");
+            d.version = line.substr(start, line.find('"', start) - start);
+            continue;
+        }
+        size_t space = line.find(' ');
+        if (space == std::string::npos || line.find('{') < space) continue;
+        d.metrics[line.substr(0, space)] = strtod(line.c_str() + space + 1, nullptr);
+    }
+}
+
+static void finish(Request& r, const char* error) {
+    Device& d = *r.device;
+    if (!error) {
+        std::string body;
+        int code = parseHttpResponse(r.in, body);
+        if (code != 200) {
+            error = code ? "HTTP error" : "bad response";
+        } else if (r.kind == REQUEST_METRICS) {
+            parseMetrics(d, body);
+        } else if (!decodeStatusBinary((const uint8_t*)body.data(), body.size(), d.status)) {
+            error = "bad status document";
+        } else {
+            d.reachable = true;
+            d.scrapedAt = time(nullptr);
+        }
+        if (error && code) {
+            char text[32];
+            snprintf(text, sizeof(text), "HTTP %d", code);
+            d.error = text;
+            error = nullptr;
+        }
+    }
+    if (error) d.error = error;
+    if (r.fd >= 0) close(r.fd);
+    r.fd = -1;
+}
+
+/**
+ * Runs every request to completion, at most `concurrency` at a time
+ */
+static void runRequests(std::vector<Request>& requests, int concurrency, int timeoutMs) {
+    int ep = epoll_create1(0);
+    size_t next = 0, active = 0, done = 0;
+    std::vector<Request*> inFlight;
+
+    while (done < requests.size()) {
+        // Start requests while there is room
+        while (next < requests.size() && (int)active < concurrency) {
+            Request& r = requests[next++];
+            r.deadline = nowMs() + timeoutMs;
+            r.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            if (r.fd < 0) {
+                finish(r, "no socket");
+                done++;
+                continue;
+            }
+            if (connect(r.fd, (sockaddr*)&r.device->address, sizeof(r.device->address)) < 0 && errno != EINPROGRESS) {
+                finish(r, strerror(errno));
+                done++;
+                continue;
+            }
+            epoll_event ev = {EPOLLOUT | EPOLLIN | EPOLLRDHUP, {}};
+            ev.data.ptr = &r;
+            epoll_ctl(ep, EPOLL_CTL_ADD, r.fd, &ev);
+            inFlight.push_back(&r);
+            active++;
+        }
+
+        epoll_event events[256];
+        int ready = epoll_wait(ep, events, 256, 50);
+        for (int i = 0; i < ready; i++) {
+            Request& r = *(Request*)events[i].data.ptr;
+            if (r.fd < 0) continue;
+            if (!r.out.empty() && (events[i].events & EPOLLOUT)) {
+                int error = 0;
+                socklen_t size = sizeof(error);
+                getsockopt(r.fd, SOL_SOCKET, SO_ERROR, &error, &size);
+                if (error) {
+                    finish(r, strerror(error));
+                    continue;
+                }
+                ssize_t n = send(r.fd, r.out.data(), r.out.size(), MSG_NOSIGNAL);
+                if (n > 0) r.out.erase(0, n);
+                if (r.out.empty()) {
+                    epoll_event ev = {EPOLLIN | EPOLLRDHUP, {}};
+                    ev.data.ptr = &r;
+                    epoll_ctl(ep, EPOLL_CTL_MOD, r.fd, &ev);
+                }
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                char buffer[4096];
+                ssize_t n;
+                while ((n = recv(r.fd, buffer, sizeof(buffer), 0)) > 0 && r.in.size() < HTTP_RESPONSE_MAX) {
+                    r.in.append(buffer, n);
+                }
+                if (n == 0) {
+                    finish(r, nullptr);  // The clock closes the connection after each response
+                } else if (r.in.size() >= HTTP_RESPONSE_MAX) {
+                    finish(r, "response too large");
+                } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    finish(r, strerror(errno));
+                }
+            }
+        }
+
+        // Retire finished and expired requests
+        long long now = nowMs();
+        for (size_t i = 0; i < inFlight.size();) {
+            Request& r = *inFlight[i];
+            if (r.fd >= 0 && now > r.deadline) finish(r, "timed out");
+            if (r.fd >= 0) {
+                i++;
+                continue;
+            }
+            inFlight[i] = inFlight.back();
+            inFlight.pop_back();
+            active--;
+            done++;
+        }
+    }
+    close(ep);
+}
+
+static void scrapeRound(std::vector<Device>& devices, int concurrency, int timeoutMs, long long startMs) {
+    std::vector<Request> requests;
+    requests.reserve(devices.size() * 2);
+    for (Device& d : devices) {
+        d.reachable = false;
+        d.error.clear();
+        if (!d.resolved) d.resolved = resolve(d);
+        if (!d.resolved) {
+            d.error = "unknown host";
+            continue;
+        }
+        // Metrics first, so a failed status read is the error reported
+        for (RequestKind kind : {REQUEST_METRICS, REQUEST_STATUS}) {
+            Request r;
+            r.device = &d;
+            r.kind = kind;
+            r.out = httpRequest("GET", kind == REQUEST_STATUS ? "/api/status.bin" : "/metrics", d.host);
+            requests.push_back(r);
+        }
+    }
+    runRequests(requests, concurrency, timeoutMs);
+    for (Device& d : devices) {
+        if (d.reachable) d.heap.push_back({(nowMs() - startMs) / 3600000.0, d.status.freeHeap});
+    }
+}
+
+// Summaries
+
+enum SyncHealth { SYNC_OK, SYNC_STALE, SYNC_NEEDS_SYNC, SYNC_NOT_SET, SYNC_HEALTH_COUNT };
+static const char* const SYNC_NAMES[SYNC_HEALTH_COUNT] = {"ok", "stale", "needsSync", "notSet"};
+
+static SyncHealth syncHealth(const Device& d) {
+    if (d.status.syncState == 0) return SYNC_NOT_SET;
+    if (d.status.syncState == 1) return SYNC_NEEDS_SYNC;
+    return d.scrapedAt - (long long)d.status.lastSync > SYNC_STALE_SECONDS ? SYNC_STALE : SYNC_OK;
+}
+
+// Least-squares slope of free heap, bytes per hour; NAN with under two rounds
+static double heapTrend(const Device& d) {
+    size_t n = d.heap.size();
+    if (n < 2) return NAN;
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (const HeapSample& s : d.heap) {
+        sx += s.hours;
+        sy += s.freeHeap;
+        sxx += s.hours * s.hours;
+        sxy += s.hours * s.freeHeap;
+    }
+    double spread = n * sxx - sx * sx;
+    return spread > 0 ? (n * sxy - sx * sy) / spread : NAN;
+}
+
+static double metric(const Device& d, const char* name) {
+    auto m = d.metrics.find(name);
+    return m == d.metrics.end() ? NAN : m->second;
+}
+
+struct Summary {
+    int devices = 0;
+    int reachable = 0;
+    int sync[SYNC_HEALTH_COUNT] = {};
+    int brightness[8] = {};  // Buckets of 32
+    std::map<std::string, int> versions;
+    std::vector<uint32_t> freeHeap;
+    uint32_t lowestMinFreeHeap = UINT32_MAX;
+    int heapFalling = 0;
+    int healthAlerts = 0;
+    std::map<std::string, int> errors;
+};
+
+static Summary summarise(const std::vector<Device>& devices) {
+    Summary s;
+    for (const Device& d : devices) {
+        s.devices++;
+        if (!d.reachable) {
+            s.errors[d.error]++;
+            continue;
+        }
+        s.reachable++;
+        s.sync[syncHealth(d)]++;
+        s.brightness[d.status.brightness / 32]++;
+        s.versions[d.version.empty() ? "unknown" : d.version]++;
+        s.freeHeap.push_back(d.status.freeHeap);
+        s.lowestMinFreeHeap = std::min(s.lowestMinFreeHeap, d.status.minFreeHeap);
+        if (heapTrend(d) < HEAP_FALLING_PER_HOUR) s.heapFalling++;
+        if (d.status.healthAlerts) s.healthAlerts++;
+    }
+    std::sort(s.freeHeap.begin(), s.freeHeap.end());
+    return s;
+}
+
+// Output
+
+static std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if ((unsigned char)c < 0x20) continue;
+        out += c;
+    }
+    return out + "\"";
+}
+
+static std::string jsonNumber(double value) {
+    if (std::isnan(value)) return "null";
+    char text[32];
+    snprintf(text, sizeof(text), "%.0f", value);
+    return text;
+}
+
+static void printSummaryJson(FILE* out, const Summary& s) {
+    fprintf(out, "{\"devices\":%d,\"reachable\":%d,\"sync\":{", s.devices, s.reachable);
+    for (int i = 0; i < SYNC_HEALTH_COUNT; i++) fprintf(out, "%s\"%s\":%d", i ? "," : "", SYNC_NAMES[i], s.sync[i]);
+    fprintf(out, "},\"brightness\":[");
+    for (int i = 0; i < 8; i++) fprintf(out, "%s%d", i ? "," : "", s.brightness[i]);
+    fprintf(out, "],\"versions\":{");
+    bool first = true;
+    for (const auto& v : s.versions) {
+        fprintf(out, "%s%s:%d", first ? "" : ",", jsonString(v.first).c_str(), v.second);
+        first = false;
+    }
+    fprintf(out, "},\"heap\":{\"medianFree\":%s,\"lowestMinFree\":%s,\"falling\":%d},\"healthAlerts\":%d,\"errors\":{",
+            jsonNumber(s.freeHeap.empty() ? NAN : s.freeHeap[s.freeHeap.size() / 2]).c_str(),
+            jsonNumber(s.freeHeap.empty() ? NAN : s.lowestMinFreeHeap).c_str(), s.heapFalling, s.healthAlerts);
+    first = true;
+    for (const auto& e : s.errors) {
+        fprintf(out, "%s%s:%d", first ? "" : ",", jsonString(e.first).c_str(), e.second);
+        first = false;
+    }
+    fprintf(out, "}}");
+}
+
+static void printJson(const std::vector<Device>& devices, const Summary& summary) {
+    printf("{\"summary\":");
+    printSummaryJson(stdout, summary);
+    printf(",\n\"devices\":[\n");
+    for (size_t i = 0; i < devices.size(); i++) {
+        const Device& d = devices[i];
+        printf("{\"host\":%s,\"port\":%u,\"reachable\":%s", jsonString(d.host).c_str(), d.port,
+               d.reachable ? "true" : "false");
+        if (!d.reachable) {
+            printf(",\"error\":%s}%s\n", jsonString(d.error).c_str(), i + 1 < devices.size() ? "," : "");
+            continue;
+        }
+        const StatusBinary& s = d.status;
+        printf(",\"version\":%s,\"sync\":\"%s\",\"uptime\":%" PRIu32 ",\"lastSync\":%" PRIu32
+               ",\"lightLevel\":%u,\"brightness\":%u,\"freeHeap\":%" PRIu32 ",\"minFreeHeap\":%" PRIu32
+               ",\"heapTrendPerHour\":%s,\"healthAlerts\":%u,\"ntpFailures\":%s,\"wifiReconnects\":%s"
+               ",\"rateLimited\":%s}%s\n",
+               jsonString(d.version).c_str(), SYNC_NAMES[syncHealth(d)], s.uptimeSeconds, s.lastSync,
+               s.lightLevel, s.brightness, s.freeHeap, s.minFreeHeap, jsonNumber(heapTrend(d)).c_str(),
+               s.healthAlerts, jsonNumber(metric(d, "wordclock_ntp_sync_failures_total")).c_str(),
+               jsonNumber(metric(d, "wordclock_wifi_reconnects_total")).c_str(),
+               jsonNumber(metric(d, "wordclock_http_rate_limited_total")).c_str(),
+               i + 1 < devices.size() ? "," : "");
+    }
+    printf("]}\n");
+}
+
+static void printCsv(const std::vector<Device>& devices) {
+    printf("host,port,reachable,error,version,sync,uptime,lastSync,lightLevel,brightness,freeHeap,"
+           "minFreeHeap,heapTrendPerHour,healthAlerts,ntpFailures,wifiReconnects,rateLimited\n");
+    for (const Device& d : devices) {
+        printf("%s,%u,%d,%s", d.host.c_str(), d.port, d.reachable, d.reachable ? "" : d.error.c_str());
+        if (!d.reachable) {
+            printf(",,,,,,,,,,,,,\n");
+            continue;
+        }
+        const StatusBinary& s = d.status;
+        printf(",%s,%s,%" PRIu32 ",%" PRIu32 ",%u,%u,%" PRIu32 ",%" PRIu32 ",%s,%u,%s,%s,%s\n",
+               d.version.c_str(), SYNC_NAMES[syncHealth(d)], s.uptimeSeconds, s.lastSync, s.lightLevel,
+               s.brightness, s.freeHeap, s.minFreeHeap, std::isnan(heapTrend(d)) ? "" : jsonNumber(heapTrend(d)).c_str(),
+               s.healthAlerts, jsonNumber(metric(d, "wordclock_ntp_sync_failures_total")).c_str(),
+               jsonNumber(metric(d, "wordclock_wifi_reconnects_total")).c_str(),
+               jsonNumber(metric(d, "wordclock_http_rate_limited_total")).c_str());
+    }
+}
+
+static void usage(const char* self) {
+    fprintf(stderr,
+            "usage: %s [options] [host[:port|:first-last]...]\n"
+            "  --hosts FILE       clocks to scrape, one per line\n"
+            "  --mdns [MS]        also discover clocks via mDNS (default %d ms)\n"
+            "  --rounds N         scrape N times, for heap trends (default 1)\n"
+            "  --interval S       seconds between rounds (default 60)\n"
+            "  --concurrency N    requests in flight (default %d)\n"
+            "  --timeout MS       per request (default %d)\n"
+            "  --csv              one CSV row per clock; summary to stderr\n",
+            self, DEFAULT_MDNS_MS, DEFAULT_CONCURRENCY, DEFAULT_TIMEOUT_MS);
+}
+
+int main(int argc, char** argv) {
+    std::vector<Device> devices;
+    int mdnsMs = 0, rounds = 1, interval = 60;
+    int concurrency = DEFAULT_CONCURRENCY, timeoutMs = DEFAULT_TIMEOUT_MS;
+    bool csv = false;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--hosts") && hasValue) {
+            if (!readHostFile(devices, argv[++i])) return 2;
+        } else if (!strcmp(a, "--mdns")) {
+            mdnsMs = hasValue && isdigit((unsigned char)argv[i + 1][0]) ? atoi(argv[++i]) : DEFAULT_MDNS_MS;
+        } else if (!strcmp(a, "--rounds") && hasValue) {
+            rounds = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(a, "--interval") && hasValue) {
+            interval = std::max(0, atoi(argv[++i]));
+        } else if (!strcmp(a, "--concurrency") && hasValue) {
+            concurrency = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(a, "--timeout") && hasValue) {
+            timeoutMs = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(a, "--csv")) {
+            csv = true;
+        } else if (a[0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else if (!addDevice(devices, a)) {
+            return 2;
+        }
+    }
+    if (mdnsMs) fprintf(stderr, "mDNS: found %d clocks\n", discoverMdns(devices, mdnsMs));
+    if (devices.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    long long start = nowMs();
+    for (int round = 0; round < rounds; round++) {
+        if (round) sleep(interval);
+        long long began = nowMs();
+        scrapeRound(devices, concurrency, timeoutMs, start);
+        Summary s = summarise(devices);
+        fprintf(stderr, "round %d: %d of %d clocks answered in %lld ms\n", round + 1, s.reachable, s.devices,
+                nowMs() - began);
+    }
+
+    Summary summary = summarise(devices);
+    if (csv) {
+        printCsv(devices);
+        printSummaryJson(stderr, summary);
+        fputc('\n', stderr);
+    } else {
+        printJson(devices, summary);
+    }
+    return summary.reachable ? 0 : 1;
+}
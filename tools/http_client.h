@@ -0,0 +1,114 @@
+/**
+ * Word Clock - HTTP/1.1 client pieces for the fleet tools
+ *
+ * The clock answers every request with Connection: close, so a response
+ * is everything read until the clock hangs up:
+ * - parseHttpResponse() splits that into status code and body, undoing
+ *   chunked encoding (/metrics is sent in chunks)
+ * - httpGet() is a blocking GET with one deadline for the whole exchange
+ *
+ * Header-only so each tool stays a single g++ invocation.
+ */
+
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define HTTP_RESPONSE_MAX 65536  // Larger responses are cut off and fail
+
+/**
+ * Splits a response into status code and body, undoing chunked encoding
+ * @return The status code, or 0 if it is not a whole HTTP response
+ */
+static inline int parseHttpResponse(const std::string& response, std::string& body) {
+    size_t headEnd = response.find("\r\n\r\n");
+    int code;
+    if (headEnd == std::string::npos || sscanf(response.c_str(), "HTTP/1.%*d %d", &code) != 1) return 0;
+    std::string head = response.substr(0, headEnd);
+    for (char& c : head) c = tolower(c);
+    size_t at = headEnd + 4;
+    if (head.find("transfer-encoding: chunked") == std::string::npos) {
+        body = response.substr(at);
+        return code;
+    }
+    body.clear();
+    for (;;) {
+        size_t lineEnd = response.find("\r\n", at);
+        if (lineEnd == std::string::npos) return 0;
+        size_t length = strtoul(response.c_str() + at, nullptr, 16);
+        at = lineEnd + 2;
+        if (length == 0) return code;
+        if (at + length > response.size()) return 0;
+        body.append(response, at, length);
+        at += length + 2;
+    }
+}
+
+static inline std::string httpRequest(const char* method, const std::string& path, const std::string& host) {
+    return std::string(method) + " " + path + " HTTP/1.1\r\nHost: " + host + "\r\nConnection: close\r\n\r\n";
+}
+
+/**
+ * GETs `path`, giving up after `timeoutMs` in all
+ * @return The status code, or 0 with `body` holding why it failed
+ */
+static inline int httpGet(const sockaddr_in& address, const std::string& host, const std::string& path,
+                          int timeoutMs, std::string& body) {
+    using namespace std::chrono;
+    auto deadline = steady_clock::now() + milliseconds(timeoutMs);
+    auto left = [&]() { return (int)std::max<long long>(0, duration_cast<milliseconds>(deadline - steady_clock::now()).count()); };
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        body = strerror(errno);
+        return 0;
+    }
+    std::string out = httpRequest("GET", path, host), in;
+    const char* error = nullptr;
+    if (connect(fd, (const sockaddr*)&address, sizeof(address)) < 0 && errno != EINPROGRESS) error = strerror(errno);
+    while (!error) {
+        pollfd ready = {fd, (short)(out.empty() ? POLLIN : POLLOUT), 0};
+        if (poll(&ready, 1, left()) <= 0) {
+            error = "timed out";
+            break;
+        }
+        if (!out.empty()) {
+            int failure = 0;
+            socklen_t size = sizeof(failure);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &failure, &size);
+            ssize_t n = failure ? -1 : send(fd, out.data(), out.size(), MSG_NOSIGNAL);
+            if (n < 0) error = strerror(failure ? failure : errno);
+            else out.erase(0, n);
+            continue;
+        }
+        char buffer[4096];
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n == 0) break;
+        if (n < 0 && errno != EAGAIN) error = strerror(errno);
+        if (n > 0) in.append(buffer, n);
+        if (in.size() > HTTP_RESPONSE_MAX) error = "response too large";
+    }
+    close(fd);
+    if (error) {
+        body = error;
+        return 0;
+    }
+    int code = parseHttpResponse(in, body);
+    if (!code) body = "bad response";
+    return code;
+}
+
+#endif // HTTP_CLIENT_H
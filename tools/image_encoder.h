@@ -0,0 +1,199 @@
+/**
+ * Word Clock - Encoder for compressed and delta firmware images
+ *
+ * Writes the format ImageDecoder reads (see
+ * lib/WordClockCore/src/image_codec.h). Greedy LZSS with hash chains over
+ * the decoder's window; for a delta, runs that also appear in the base
+ * image become base copies. Base runs are found through a hash of every
+ * 8-byte substring of the base, and by continuing where the last copy
+ * ended, which catches code that moved as a block.
+ *
+ * Header-only so each tool stays a single g++ invocation.
+ */
+
+#ifndef IMAGE_ENCODER_H
+#define IMAGE_ENCODER_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../lib/WordClockCore/src/image_codec.h"
+#include "md5.h"
+
+#define ENCODER_CHAIN_MAX 128     // Window candidates tried per position
+#define ENCODER_BASE_CHAIN_MAX 32 // Base candidates tried per position
+#define ENCODER_BASE_GRAM 8       // Bytes hashed to find base runs
+#define ENCODER_BASE_MIN 12       // Shortest base run worth a copy token
+
+class ImageEncoder {
+public:
+    /**
+     * Encodes `image`, as a delta against `base` if it is not null
+     * @param windowBits Match reach, at most the decoder's IMAGE_WINDOW_BITS
+     */
+    static std::string encode(const std::string& image, const std::string* base = nullptr,
+                              int windowBits = IMAGE_WINDOW_BITS) {
+        ImageEncoder encoder(image, base, windowBits);
+        return encoder.run();
+    }
+
+private:
+    ImageEncoder(const std::string& image, const std::string* base, int windowBits)
+        : in((const uint8_t*)image.data()), size(image.size()), reach(1u << windowBits), windowBits(windowBits),
+          head(1u << 16, -1), prev(image.size(), -1) {
+        if (base) {
+            this->base = (const uint8_t*)base->data();
+            baseSize = base->size();
+            baseMd5 = Md5::of(*base);
+            baseHead.assign(1u << 20, -1);
+            basePrev.assign(baseSize, -1);
+            for (size_t i = 0; i + ENCODER_BASE_GRAM <= baseSize; i++) {
+                uint32_t h = gramHash(this->base + i);
+                basePrev[i] = baseHead[h];
+                baseHead[h] = (int32_t)i;
+            }
+        }
+    }
+
+    static uint32_t hash3(const uint8_t* p) { return ((p[0] << 8) ^ (p[1] << 4) ^ p[2]) * 2654435761u >> 16; }
+
+    static uint32_t gramHash(const uint8_t* p) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return (uint32_t)((v * 0x9E3779B97F4A7C15ull) >> 44);
+    }
+
+    void insert(size_t i) {
+        if (i + 3 > size) return;
+        uint32_t h = hash3(in + i);
+        prev[i] = head[h];
+        head[h] = (int32_t)i;
+    }
+
+    size_t matchLength(const uint8_t* a, const uint8_t* b, size_t limit) const {
+        size_t n = 0;
+        while (n < limit && a[n] == b[n]) n++;
+        return n;
+    }
+
+    void findWindowMatch(size_t i, size_t& length, size_t& distance) const {
+        length = 0;
+        if (i + IMAGE_MATCH_MIN > size) return;
+        size_t limit = std::min<size_t>(IMAGE_MATCH_MAX, size - i);
+        int tries = ENCODER_CHAIN_MAX;
+        for (int32_t j = head[hash3(in + i)]; j >= 0 && tries-- > 0; j = prev[j]) {
+            if (i - j > reach) break;
+            size_t n = matchLength(in + i, in + j, limit);
+            if (n > length) {
+                length = n;
+                distance = i - j;
+                if (n == limit) break;
+            }
+        }
+        if (length < IMAGE_MATCH_MIN) length = 0;
+    }
+
+    void findBaseMatch(size_t i, size_t& length, size_t& offset) const {
+        length = 0;
+        if (!base) return;
+        size_t expected = baseNext + (i - outputAtBaseNext);
+        if (expected < baseSize) {
+            length = matchLength(in + i, base + expected, std::min(size - i, baseSize - expected));
+            offset = expected;
+        }
+        if (i + ENCODER_BASE_GRAM > size) return;
+        int tries = ENCODER_BASE_CHAIN_MAX;
+        for (int32_t j = baseHead[gramHash(in + i)]; j >= 0 && tries-- > 0; j = basePrev[j]) {
+            size_t n = matchLength(in + i, base + j, std::min(size - i, baseSize - j));
+            if (n > length) {
+                length = n;
+                offset = j;
+            }
+        }
+        if (length < ENCODER_BASE_MIN) length = 0;
+    }
+
+    void putVarint(uint32_t v) {
+        while (v >= 0x80) {
+            out += (char)(v | 0x80);
+            v >>= 7;
+        }
+        out += (char)v;
+    }
+
+    void flushLiterals(size_t end) {
+        while (literalStart < end) {
+            size_t n = std::min<size_t>(IMAGE_LITERAL_MAX, end - literalStart);
+            out += (char)(n - 1);
+            out.append((const char*)in + literalStart, n);
+            literalStart += n;
+        }
+    }
+
+    void putUint32(uint32_t v) {
+        for (int i = 0; i < 4; i++) out += (char)(v >> (8 * i));
+    }
+
+    std::string run() {
+        out.assign("WCZ", 3);
+        out += (char)IMAGE_FORMAT_VERSION;
+        out += (char)(base ? IMAGE_FLAG_DELTA : 0);
+        out += (char)windowBits;
+        out.append(2, '\0');
+        putUint32((uint32_t)size);
+        putUint32((uint32_t)baseSize);
+        for (int i = 0; i < 16; i++) {
+            out += base ? (char)std::stoi(baseMd5.substr(2 * i, 2), nullptr, 16) : '\0';
+        }
+
+        size_t i = 0;
+        while (i < size) {
+            size_t windowLength, distance = 0, baseLength, offset = 0;
+            findWindowMatch(i, windowLength, distance);
+            findBaseMatch(i, baseLength, offset);
+            size_t advance = 1;  // A literal, unless a copy is found
+            if (baseLength && baseLength >= windowLength) {
+                flushLiterals(i);
+                int64_t delta = (int64_t)offset - (int64_t)baseNext;
+                out += (char)IMAGE_TOKEN_BASE_COPY;
+                putVarint((uint32_t)(((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63)));  // Zigzag
+                putVarint((uint32_t)baseLength);
+                baseNext = offset + baseLength;
+                outputAtBaseNext = i + baseLength;
+                advance = baseLength;
+            } else if (windowLength) {
+                flushLiterals(i);
+                out += (char)(0x80 | (windowLength - IMAGE_MATCH_MIN));
+                out += (char)((distance - 1) & 0xFF);
+                out += (char)((distance - 1) >> 8);
+                advance = windowLength;
+            }
+            for (size_t k = 0; k < advance; k++) insert(i + k);
+            i += advance;
+            if (advance > 1) literalStart = i;
+        }
+        flushLiterals(size);
+        return out;
+    }
+
+    const uint8_t* in;
+    size_t size;
+    uint32_t reach;
+    int windowBits;
+    std::vector<int32_t> head, prev;
+
+    const uint8_t* base = nullptr;
+    size_t baseSize = 0;
+    std::string baseMd5;
+    std::vector<int32_t> baseHead, basePrev;
+    size_t baseNext = 0;          // End of the last base copy
+    size_t outputAtBaseNext = 0;  // Where in the image that copy ended
+
+    size_t literalStart = 0;
+    std::string out;
+};
+
+#endif // IMAGE_ENCODER_H
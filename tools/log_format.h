@@ -0,0 +1,129 @@
+/**
+ * Word Clock - Log record formatting
+ *
+ * Expands the argument payload of a deferred log record (see src/log.h)
+ * with its format string. Shared by tools/logdecode.cpp, which finds the
+ * format in the firmware ELF, and the host emulator, which can read it
+ * straight from memory.
+ */
+
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "../src/log.h"
+
+static const char* const LOG_LEVEL_NAMES[] = {"", "E", "I", "D", "V"};
+static const char* const LOG_CATEGORY_NAMES[] = {"system", "display", "sensor", "http", "net", "ota", "cat6", "cat7"};
+
+/**
+ * Reads the argument values in a record payload
+ */
+class ArgReader {
+public:
+    ArgReader(const uint8_t* data, size_t length) : p_(data), end_(data + length) {}
+
+    bool next(uint8_t& tag, uint64_t& integer, double& real, std::string& text) {
+        if (p_ >= end_) return false;
+        tag = *p_++;
+        switch (tag) {
+            case LOG_ARG_INT32: {
+                uint32_t v;
+                if (!take(&v, 4)) return false;
+                integer = v;
+                return true;
+            }
+            case LOG_ARG_INT64:
+                return take(&integer, 8);
+            case LOG_ARG_FLOAT: {
+                float v;
+                if (!take(&v, 4)) return false;
+                real = v;
+                return true;
+            }
+            case LOG_ARG_STRING: {
+                if (p_ >= end_) return false;
+                uint8_t n = *p_++;
+                if (p_ + n > end_) return false;
+                text.assign((const char*)p_, n);
+                p_ += n;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+private:
+    bool take(void* out, size_t n) {
+        if (p_ + n > end_) return false;
+        memcpy(out, p_, n);
+        p_ += n;
+        return true;
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+/**
+ * Expands a printf format string using the recorded arguments.
+ * Each conversion is re-run through snprintf with the length modifier
+ * replaced to match the width the device recorded.
+ */
+inline std::string formatLogRecord(const char* fmt, ArgReader& args) {
+    std::string out;
+    char piece[256];
+    for (const char* p = fmt; *p;) {
+        if (*p != '%') {
+            out += *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out += '%';
+            p += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision; drop any length modifier
+        std::string spec = "%";
+        const char* q = p + 1;
+        while (*q && strchr("-+ #0123456789.*", *q)) spec += *q++;
+        while (*q && strchr("hlLqjzt", *q)) q++;
+        char conversion = *q;
+        if (!conversion) break;
+        p = q + 1;
+
+        uint8_t tag;
+        uint64_t integer = 0;
+        double real = 0;
+        std::string text;
+        if (!args.next(tag, integer, real, text)) {
+            out += "<missing>";
+            continue;
+        }
+
+        if (conversion == 's' || tag == LOG_ARG_STRING) {
+            snprintf(piece, sizeof(piece), (spec + 's').c_str(), text.c_str());
+        } else if (strchr("feEgGaA", conversion) || tag == LOG_ARG_FLOAT) {
+            snprintf(piece, sizeof(piece), (spec + (strchr("feEgGaA", conversion) ? conversion : 'f')).c_str(), real);
+        } else if (conversion == 'c') {
+            snprintf(piece, sizeof(piece), (spec + 'c').c_str(), (int)integer);
+        } else if (conversion == 'p') {
+            snprintf(piece, sizeof(piece), "0x%08llx", (unsigned long long)integer);
+        } else if (tag == LOG_ARG_INT64) {
+            snprintf(piece, sizeof(piece), (spec + "ll" + conversion).c_str(), (long long)integer);
+        } else if (conversion == 'd' || conversion == 'i') {
+            snprintf(piece, sizeof(piece), (spec + conversion).c_str(), (int32_t)integer);
+        } else {
+            snprintf(piece, sizeof(piece), (spec + conversion).c_str(), (uint32_t)integer);
+        }
+        out += piece;
+    }
+    return out;
+}
+
+#endif // LOG_FORMAT_H
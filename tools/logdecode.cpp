@@ -0,0 +1,83 @@
+/**
+ * Word Clock - Log Decoder
+ *
+ * Turns the binary log records written by src/log.cpp back into text.
+ * Format strings are recovered from the firmware ELF that produced the
+ * log, so always decode with the image that is running on the clock.
+ * Bytes outside valid records (boot ROM messages, stray prints) are passed
+ * through unchanged.
+ *
+ * Build:  g++ -std=c++17 -O2 -o logdecode tools/logdecode.cpp
+ * Usage:  stty -F /dev/ttyACM0 115200 raw
+ *         ./logdecode .pio/build/esp32dev/firmware.elf < /dev/ttyACM0
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "elf_file.h"
+#include "log_format.h"
+
+static void printRecord(const ElfFile& elf, const uint8_t* payload, size_t length) {
+    uint32_t address, timestamp;
+    memcpy(&address, payload, 4);
+    memcpy(&timestamp, payload + 4, 4);
+    uint8_t level = payload[8] >> 4;
+    uint8_t category = payload[8] & 0x7;
+
+    const char* fmt = elf.stringAt(address);
+    ArgReader args(payload + 9, length - 9);
+    char unknown[32];
+    snprintf(unknown, sizeof(unknown), "<unknown format 0x%08x>", address);
+    std::string text = fmt ? formatLogRecord(fmt, args) : unknown;
+    printf("[%8u.%03u] %s %-7s %s\n", timestamp / 1000, timestamp % 1000,
+           level < 5 ? LOG_LEVEL_NAMES[level] : "?", LOG_CATEGORY_NAMES[category], text.c_str());
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s firmware.elf [capture.bin] (reads stdin by default)\n", argv[0]);
+        return 2;
+    }
+
+    ElfFile elf;
+    if (!elf.load(argv[1])) return 1;
+    FILE* in = argc == 3 ? fopen(argv[2], "rb") : stdin;
+    if (!in) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    // Scan for sync bytes; anything that does not form a valid record is text
+    uint8_t frame[3 + LOG_MAX_RECORD + 1];
+    size_t have = 0;
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        frame[have++] = (uint8_t)c;
+        while (have > 0) {
+            if (frame[0] != LOG_SYNC0 || (have > 1 && frame[1] != LOG_SYNC1) ||
+                (have > 2 && (frame[2] < 9 || frame[2] > LOG_MAX_RECORD))) {
+                // Not a record start: emit one byte and rescan the rest
+                putchar(frame[0]);
+                memmove(frame, frame + 1, --have);
+                continue;
+            }
+            if (have < 3 || have < (size_t)frame[2] + 4) break;  // Need more bytes
+
+            size_t length = frame[2];
+            uint8_t checksum = 0;
+            for (size_t i = 0; i < length; i++) checksum += frame[3 + i];
+            if (checksum != frame[3 + length]) {
+                putchar(frame[0]);
+                memmove(frame, frame + 1, --have);
+                continue;
+            }
+            printRecord(elf, frame + 3, length);
+            have = 0;
+        }
+    }
+    fwrite(frame, 1, have, stdout);
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * Word Clock - MD5 for the OTA tools
+ *
+ * ArduinoOTA identifies an image by its MD5 and answers a password
+ * challenge with MD5 digests (see espota.py in the Arduino core), so the
+ * update tools and the emulator's OTA receiver need it. Not for anything
+ * that has to resist a deliberate collision.
+ *
+ * Header-only so each tool stays a single g++ invocation.
+ */
+
+#ifndef MD5_H
+#define MD5_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+class Md5 {
+public:
+    void update(const void* data, size_t size) {
+        const uint8_t* in = (const uint8_t*)data;
+        size_t used = length_ % 64;
+        length_ += size;
+        while (size) {
+            size_t take = std::min(size, 64 - used);
+            memcpy(block_ + used, in, take);
+            used += take;
+            in += take;
+            size -= take;
+            if (used == 64) {
+                transform();
+                used = 0;
+            }
+        }
+    }
+
+    // Finishes the digest as 32 lowercase hex digits; the object is spent
+    std::string hex() {
+        uint64_t bits = length_ * 8;
+        uint8_t pad = 0x80;
+        update(&pad, 1);
+        pad = 0;
+        while (length_ % 64 != 56) update(&pad, 1);
+        uint8_t size[8];
+        for (int i = 0; i < 8; i++) size[i] = bits >> (8 * i);
+        update(size, 8);
+
+        std::string out;
+        for (uint32_t word : state_) {
+            for (int i = 0; i < 4; i++) {
+                out += "0123456789abcdef"[word >> (8 * i + 4) & 15];
+                out += "0123456789abcdef"[word >> (8 * i) & 15];
+            }
+        }
+        return out;
+    }
+
+    static std::string of(const std::string& text) {
+        Md5 md5;
+        md5.update(text.data(), text.size());
+        return md5.hex();
+    }
+
+private:
+    void transform() {
+        static const uint32_t K[64] = {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+        };
+        static const uint8_t SHIFT[16] = {7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+
+        uint32_t m[16];
+        for (int i = 0; i < 16; i++) {
+            m[i] = block_[i * 4] | block_[i * 4 + 1] << 8 | block_[i * 4 + 2] << 16 | (uint32_t)block_[i * 4 + 3] << 24;
+        }
+        uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+        for (int i = 0; i < 64; i++) {
+            uint32_t f;
+            int g;
+            if (i < 16) {
+                f = (b & c) | (~b & d);
+                g = i;
+            } else if (i < 32) {
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) % 16;
+            } else if (i < 48) {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) % 16;
+            } else {
+                f = c ^ (b | ~d);
+                g = (7 * i) % 16;
+            }
+            uint32_t sum = a + f + K[i] + m[g];
+            int shift = SHIFT[i / 16 * 4 + i % 4];
+            a = d;
+            d = c;
+            c = b;
+            b += sum << shift | sum >> (32 - shift);
+        }
+        state_[0] += a;
+        state_[1] += b;
+        state_[2] += c;
+        state_[3] += d;
+    }
+
+    uint32_t state_[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+    uint8_t block_[64];
+    uint64_t length_ = 0;
+};
+
+#endif // MD5_H
@@ -0,0 +1,169 @@
+/**
+ * Word Clock - Update Packer
+ *
+ * Prepares a firmware image for clocks that pull updates (see
+ * src/pull_update.h) from any static web server. Writes into --out:
+ *   firmware.wcz   the image compressed (see image_codec.h)
+ *   delta.wcz      with --base, a delta against the image clocks run now
+ *   manifest.json  describing both, for the clocks' updateUrl setting
+ * Each encoded file is decoded again and compared with the image before
+ * anything is written. tools/otaserve.cpp serves the same files directly.
+ *
+ * Build:  g++ -std=c++17 -O2 -o otapack tools/otapack.cpp lib/WordClockCore/src/image_codec.cpp
+ * Usage:  ./otapack --image firmware.bin --version v1.4.0 --out public/ [--base v1.3.0.bin]
+ *
+ * The report on stdout is one JSON document with each file's size, its
+ * ratio to the image, and the encode time and host decode throughput.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "image_encoder.h"
+#include "md5.h"
+
+struct Packed {
+    std::string data;
+    double encodeMs = 0;
+    double decodeMBps = 0;
+};
+
+struct DecodeCheck {
+    std::string output;
+    const std::string* base;
+};
+
+static double nowMs() {
+    using namespace std::chrono;
+    return duration_cast<duration<double, std::milli>>(steady_clock::now().time_since_epoch()).count();
+}
+
+static bool readFile(const char* path, std::string& contents) {
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return false;
+    }
+    char buffer[65536];
+    for (size_t n; (n = fread(buffer, 1, sizeof(buffer), in)) > 0;) contents.append(buffer, n);
+    fclose(in);
+    if (contents.empty()) fprintf(stderr, "%s: empty\n", path);
+    return !contents.empty();
+}
+
+static bool writeFile(const std::string& path, const std::string& contents) {
+    FILE* out = fopen(path.c_str(), "wb");
+    if (!out) {
+        perror(path.c_str());
+        return false;
+    }
+    bool ok = fwrite(contents.data(), 1, contents.size(), out) == contents.size();
+    ok = fclose(out) == 0 && ok;
+    if (!ok) perror(path.c_str());
+    return ok;
+}
+
+static bool checkWrite(void* context, const uint8_t* data, size_t size) {
+    ((DecodeCheck*)context)->output.append((const char*)data, size);
+    return true;
+}
+
+static bool checkReadBase(void* context, uint32_t offset, uint8_t* buffer, size_t size) {
+    const std::string* base = ((DecodeCheck*)context)->base;
+    if (offset + size > base->size()) return false;
+    memcpy(buffer, base->data() + offset, size);
+    return true;
+}
+
+// Encodes `image` and decodes the result again as a clock would
+static bool pack(const char* name, const std::string& image, const std::string* base, Packed& packed) {
+    double start = nowMs();
+    packed.data = ImageEncoder::encode(image, base);
+    packed.encodeMs = nowMs() - start;
+
+    DecodeCheck check{std::string(), base};
+    check.output.reserve(image.size());
+    std::string baseMd5 = base ? Md5::of(*base) : std::string();
+    ImageDecoder* decoder = new ImageDecoder();
+    decoder->begin(checkWrite, base ? checkReadBase : nullptr, &check, base ? baseMd5.c_str() : nullptr,
+                   base ? (uint32_t)base->size() : 0);
+    start = nowMs();
+    const uint8_t* data = (const uint8_t*)packed.data.data();
+    size_t left = packed.data.size();
+    while ((left || decoder->pending()) && !decoder->failed()) {
+        size_t used = decoder->feed(data, left);
+        data += used;
+        left -= used;
+        if (!used && !decoder->pending()) break;
+    }
+    double elapsed = nowMs() - start;
+    bool ok = decoder->done() && !left && check.output == image;
+    if (!ok) fprintf(stderr, "%s: does not decode to the image (%s)\n", name, decoder->failed() ? decoder->error() : "mismatch");
+    delete decoder;
+    packed.decodeMBps = elapsed > 0 ? image.size() / 1048576.0 / (elapsed / 1000) : 0;
+    return ok;
+}
+
+static void report(const char* name, const Packed& packed, size_t imageSize, bool last) {
+    printf("\"%s\":{\"bytes\":%zu,\"ratio\":%.3f,\"encodeMs\":%.1f,\"decodeMBps\":%.1f}%s\n", name, packed.data.size(),
+           (double)packed.data.size() / imageSize, packed.encodeMs, packed.decodeMBps, last ? "" : ",");
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "Usage: %s --image FILE --version VERSION --out DIR [--base FILE]\n", program);
+}
+
+int main(int argc, char** argv) {
+    const char* imagePath = nullptr;
+    const char* basePath = nullptr;
+    std::string version, outDir;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--image") && hasValue) imagePath = argv[++i];
+        else if (!strcmp(a, "--version") && hasValue) version = argv[++i];
+        else if (!strcmp(a, "--out") && hasValue) outDir = argv[++i];
+        else if (!strcmp(a, "--base") && hasValue) basePath = argv[++i];
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!imagePath || outDir.empty() || version.empty() || version.find('"') != std::string::npos) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string image, base;
+    if (!readFile(imagePath, image) || (basePath && !readFile(basePath, base))) return 2;
+    std::string md5 = Md5::of(image);
+    Packed compressed, delta;
+    if (!pack("firmware.wcz", image, nullptr, compressed)) return 1;
+    if (basePath && !pack("delta.wcz", image, &base, delta)) return 1;
+
+    char manifest[512];
+    int n = snprintf(manifest, sizeof(manifest),
+                     "{\"version\":\"%s\",\"size\":%zu,\"md5\":\"%s\",\"url\":\"firmware.wcz\",\"encoding\":\"lzss\","
+                     "\"transferSize\":%zu",
+                     version.c_str(), image.size(), md5.c_str(), compressed.data.size());
+    if (basePath) {
+        n += snprintf(manifest + n, sizeof(manifest) - n, ",\"delta\":\"delta.wcz\",\"deltaBase\":\"%s\",\"deltaSize\":%zu",
+                      Md5::of(base).c_str(), delta.data.size());
+    }
+    snprintf(manifest + n, sizeof(manifest) - n, "}\n");
+
+    if (outDir.back() != '/') outDir += '/';
+    if (!writeFile(outDir + "firmware.wcz", compressed.data) ||
+        (basePath && !writeFile(outDir + "delta.wcz", delta.data)) || !writeFile(outDir + "manifest.json", manifest)) {
+        return 1;
+    }
+
+    printf("{\"version\":\"%s\",\"imageBytes\":%zu,\"imageMd5\":\"%s\",\n", version.c_str(), image.size(), md5.c_str());
+    report("lzss", compressed, image.size(), !basePath);
+    if (basePath) report("delta", delta, image.size(), true);
+    printf("}\n");
+    return 0;
+}
@@ -0,0 +1,263 @@
+/**
+ * Word Clock - Update Server
+ *
+ * Serves one firmware image for clocks that pull updates (see
+ * src/pull_update.h): GET /manifest.json describes it and GET
+ * /firmware.bin returns it, honouring "Range: bytes=first-[last]" so an
+ * interrupted download resumes. Point a clock's updateUrl setting at
+ * http://<this host>:<port>/manifest.json.
+ *
+ * --compress offers the image compressed instead (/firmware.wcz), and
+ * --base also offers a delta against an older image (/delta.wcz), both
+ * encoded at startup; tools/otapack.cpp writes the same files for any
+ * web server.
+ *
+ * --drop-every cuts each image response after that many body bytes,
+ * --ignore-range answers every request with the whole image, and
+ * --wrong-md5 puts an MD5 in the manifest that the image does not have, so
+ * a clock's resume, restart and rejection paths can be tried on a bench or
+ * with the emulator.
+ *
+ * Build:  g++ -std=c++17 -O2 -pthread -o otaserve tools/otaserve.cpp lib/WordClockCore/src/image_codec.cpp
+ * Usage:  ./otaserve --image firmware.bin --version v1.4.0 [--port 8000]
+ *             [--compress] [--base old.bin] [--drop-every 65536] [--ignore-range] [--wrong-md5]
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "image_encoder.h"
+#include "md5.h"
+
+#define REQUEST_MAX 4096
+#define SEND_CHUNK 4096
+
+struct Options {
+    std::string image;
+    std::string version;
+    std::string md5;
+    std::string compressed;  // Empty unless --compress
+    std::string delta;       // Empty unless --base
+    std::string baseMd5;
+    int port = 8000;
+    size_t dropEvery = 0;  // 0 = never
+    bool ignoreRange = false;
+};
+
+static Options options;
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s --image FILE --version VERSION [--port 8000] [--compress] [--base FILE]\n"
+            "           [--drop-every BYTES] [--ignore-range] [--wrong-md5]\n",
+            program);
+}
+
+static bool sendAll(int fd, const char* data, size_t size) {
+    while (size) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+static void reply(int fd, int code, const char* status, const std::string& type, const std::string& body) {
+    char header[256];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n", code,
+                     status, type.c_str(), body.size());
+    if (sendAll(fd, header, n)) sendAll(fd, body.data(), body.size());
+}
+
+// Parses "bytes=first-" or "bytes=first-last"; false if absent or not satisfiable
+static bool parseRange(const std::string& request, size_t size, size_t& first, size_t& last) {
+    size_t at = request.find("\r\nRange: bytes=");
+    if (at == std::string::npos) at = request.find("\r\nrange: bytes=");
+    if (at == std::string::npos) return false;
+    const char* spec = request.c_str() + at + strlen("\r\nRange: bytes=");
+    char* end;
+    first = strtoul(spec, &end, 10);
+    if (end == spec || *end != '-') return false;
+    last = size - 1;
+    if (end[1] >= '0' && end[1] <= '9') last = std::min<size_t>(last, strtoul(end + 1, nullptr, 10));
+    return first <= last;
+}
+
+static void sendImage(int fd, const std::string& request, const std::string& body, std::string& note) {
+    size_t first = 0, last = body.size() - 1;
+    bool ranged = !options.ignoreRange && request.find("ange: bytes=") != std::string::npos;
+    if (ranged && !parseRange(request, body.size(), first, last)) {
+        char header[160];
+        int n = snprintf(header, sizeof(header),
+                         "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */%zu\r\n"
+                         "Content-Length: 0\r\nConnection: close\r\n\r\n",
+                         body.size());
+        sendAll(fd, header, n);
+        note = "416";
+        return;
+    }
+    size_t length = last - first + 1;
+    char header[256];
+    int n;
+    if (ranged) {
+        n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 206 Partial Content\r\nContent-Type: application/octet-stream\r\n"
+                     "Content-Range: bytes %zu-%zu/%zu\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                     first, last, body.size(), length);
+    } else {
+        n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\n"
+                     "Content-Length: %zu\r\nConnection: close\r\n\r\n",
+                     length);
+    }
+    if (!sendAll(fd, header, n)) return;
+    size_t limit = options.dropEvery ? std::min(length, options.dropEvery) : length;
+    size_t sent = 0;
+    while (sent < limit) {
+        size_t size = std::min<size_t>(SEND_CHUNK, limit - sent);
+        if (!sendAll(fd, body.data() + first + sent, size)) break;
+        sent += size;
+    }
+    char text[96];
+    snprintf(text, sizeof(text), "%d bytes %zu-%zu%s", ranged ? 206 : 200, first, first + sent - 1,
+             sent < length ? ", dropped" : "");
+    note = text;
+}
+
+static std::string manifest() {
+    char json[512];
+    int n = snprintf(json, sizeof(json), "{\"version\":\"%s\",\"size\":%zu,\"md5\":\"%s\"", options.version.c_str(),
+                     options.image.size(), options.md5.c_str());
+    if (options.compressed.empty()) {
+        n += snprintf(json + n, sizeof(json) - n, ",\"url\":\"firmware.bin\"");
+    } else {
+        n += snprintf(json + n, sizeof(json) - n, ",\"url\":\"firmware.wcz\",\"encoding\":\"lzss\",\"transferSize\":%zu",
+                      options.compressed.size());
+    }
+    if (!options.delta.empty()) {
+        n += snprintf(json + n, sizeof(json) - n, ",\"delta\":\"delta.wcz\",\"deltaBase\":\"%s\",\"deltaSize\":%zu",
+                      options.baseMd5.c_str(), options.delta.size());
+    }
+    snprintf(json + n, sizeof(json) - n, "}\n");
+    return json;
+}
+
+static void serve(int fd, std::string peer) {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < REQUEST_MAX) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        request.append(buffer, n);
+    }
+    std::string line = request.substr(0, request.find("\r\n"));
+    std::string note;
+    if (line.compare(0, 4, "GET ") != 0) {
+        reply(fd, 405, "Method Not Allowed", "text/plain", "GET only\n");
+        note = "405";
+    } else if (line.compare(4, 15, "/manifest.json ") == 0) {
+        reply(fd, 200, "OK", "application/json", manifest());
+        note = "200";
+    } else if (line.compare(4, 14, "/firmware.bin ") == 0) {
+        sendImage(fd, request, options.image, note);
+    } else if (line.compare(4, 14, "/firmware.wcz ") == 0 && !options.compressed.empty()) {
+        sendImage(fd, request, options.compressed, note);
+    } else if (line.compare(4, 11, "/delta.wcz ") == 0 && !options.delta.empty()) {
+        sendImage(fd, request, options.delta, note);
+    } else {
+        reply(fd, 404, "Not Found", "text/plain", "Not found\n");
+        note = "404";
+    }
+    fprintf(stderr, "%s %s -> %s\n", peer.c_str(), line.c_str(), note.c_str());
+    close(fd);
+}
+
+static bool readFile(const char* path, std::string& contents) {
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return false;
+    }
+    char buffer[65536];
+    for (size_t n; (n = fread(buffer, 1, sizeof(buffer), in)) > 0;) contents.append(buffer, n);
+    fclose(in);
+    if (contents.empty()) fprintf(stderr, "%s: empty\n", path);
+    return !contents.empty();
+}
+
+int main(int argc, char** argv) {
+    const char* imagePath = nullptr;
+    const char* basePath = nullptr;
+    bool compress = false;
+    bool wrongMd5 = false;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--image") && hasValue) imagePath = argv[++i];
+        else if (!strcmp(a, "--version") && hasValue) options.version = argv[++i];
+        else if (!strcmp(a, "--port") && hasValue) options.port = atoi(argv[++i]);
+        else if (!strcmp(a, "--drop-every") && hasValue) options.dropEvery = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--ignore-range")) options.ignoreRange = true;
+        else if (!strcmp(a, "--wrong-md5")) wrongMd5 = true;
+        else if (!strcmp(a, "--compress")) compress = true;
+        else if (!strcmp(a, "--base") && hasValue) basePath = argv[++i];
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!imagePath || options.version.empty() || options.version.find('"') != std::string::npos) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (!readFile(imagePath, options.image)) return 2;
+    options.md5 = Md5::of(options.image);
+    if (wrongMd5) options.md5[31] = options.md5[31] == '0' ? '1' : '0';
+    if (compress) options.compressed = ImageEncoder::encode(options.image);
+    if (basePath) {
+        std::string base;
+        if (!readFile(basePath, base)) return 2;
+        options.baseMd5 = Md5::of(base);
+        options.delta = ImageEncoder::encode(options.image, &base);
+    }
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options.port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        perror("listen");
+        return 1;
+    }
+    fprintf(stderr, "%s: %zu bytes, MD5 %s, version %s\n", imagePath, options.image.size(), options.md5.c_str(),
+            options.version.c_str());
+    if (wrongMd5) fprintf(stderr, "The manifest's MD5 is wrong on purpose (--wrong-md5)\n");
+    if (compress) fprintf(stderr, "firmware.wcz: %zu bytes\n", options.compressed.size());
+    if (basePath) fprintf(stderr, "delta.wcz: %zu bytes against %s\n", options.delta.size(), options.baseMd5.c_str());
+    fprintf(stderr, "Serving http://0.0.0.0:%d/manifest.json\n", options.port);
+
+    for (;;) {
+        sockaddr_in peer = {};
+        socklen_t size = sizeof(peer);
+        int fd = accept(listener, (sockaddr*)&peer, &size);
+        if (fd < 0) continue;
+        char text[32];
+        snprintf(text, sizeof(text), "%s:%u", inet_ntoa(peer.sin_addr), ntohs(peer.sin_port));
+        std::thread(serve, fd, std::string(text)).detach();
+    }
+}
@@ -0,0 +1,145 @@
+/**
+ * Word Clock - Profile symboliser
+ *
+ * Turns a CPU profile downloaded from /api/profile into:
+ * - a flat profile on stdout: samples per task and per function
+ * - optionally a folded-stack file ("task;caller;function count" lines)
+ *   for flamegraph.pl, speedscope or inferno
+ *
+ * Symbols come from the firmware ELF, so always use the image that is
+ * running on the clock. Addresses outside it (mask ROM) are shown raw.
+ * The caller frame is only known for leaf functions; it is left out when
+ * the return address points back into the sampled function itself.
+ *
+ * Build:  g++ -std=c++17 -O2 -o profsym tools/profsym.cpp
+ * Usage:  curl -d action=start http://<device-ip>/api/profile
+ *         curl -o profile.bin http://<device-ip>/api/profile
+ *         ./profsym .pio/build/esp32dev/firmware.elf profile.bin [--folded out.folded]
+ *         flamegraph.pl out.folded > profile.svg
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../src/profiler.h"
+#include "elf_file.h"
+
+#define FLAT_ROWS 40  // Functions listed in the flat profile
+
+/**
+ * Demangled name of the function containing an address
+ */
+static std::string functionAt(const ElfFile& elf, uint32_t address) {
+    const ElfFile::Symbol* symbol = elf.symbolFor(address);
+    if (!symbol) {
+        char raw[16];
+        snprintf(raw, sizeof(raw), "0x%08x", address);
+        return raw;
+    }
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(symbol->name.c_str(), nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : symbol->name;
+    free(demangled);
+    return name;
+}
+
+static void printTable(const char* title, const std::map<std::string, uint64_t>& counts, uint64_t total, size_t rows) {
+    std::vector<std::pair<std::string, uint64_t>> sorted(counts.begin(), counts.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    printf("\n%s\n     %%   samples  name\n", title);
+    for (size_t i = 0; i < sorted.size() && i < rows; i++) {
+        printf("%6.2f%% %9llu  %s\n", 100.0 * sorted[i].second / total, (unsigned long long)sorted[i].second,
+               sorted[i].first.c_str());
+    }
+    if (sorted.size() > rows) printf("  ... %zu more\n", sorted.size() - rows);
+}
+
+int main(int argc, char** argv) {
+    const char* foldedPath = nullptr;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--folded") && i + 1 < argc) foldedPath = argv[++i];
+        else files.push_back(argv[i]);
+    }
+    if (files.size() != 2) {
+        fprintf(stderr, "usage: %s firmware.elf profile.bin [--folded out.folded]\n", argv[0]);
+        return 2;
+    }
+
+    ElfFile elf;
+    if (!elf.load(files[0])) return 1;
+
+    FILE* in = fopen(files[1], "rb");
+    if (!in) {
+        perror(files[1]);
+        return 1;
+    }
+    ProfileDumpHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || header.magic != PROFILE_MAGIC) {
+        fprintf(stderr, "%s: not a profile dump\n", files[1]);
+        return 1;
+    }
+    if (header.version != PROFILE_FORMAT_VERSION || header.entrySize != sizeof(ProfileEntry)) {
+        fprintf(stderr, "%s: unsupported profile format %u\n", files[1], header.version);
+        return 1;
+    }
+    std::vector<ProfileEntry> entries(header.slots);
+    std::vector<ProfileTask> tasks(header.taskCount);
+    if (fread(entries.data(), sizeof(ProfileEntry), entries.size(), in) != entries.size() ||
+        fread(tasks.data(), sizeof(ProfileTask), tasks.size(), in) != tasks.size()) {
+        fprintf(stderr, "%s: truncated\n", files[1]);
+        return 1;
+    }
+    fclose(in);
+
+    std::map<std::string, uint64_t> byTask, byFunction, byStack;
+    uint64_t total = 0;
+    for (const ProfileEntry& e : entries) {
+        if (e.count == 0) continue;
+        total += e.count;
+
+        std::string task = "?";
+        if (e.task < tasks.size()) task.assign(tasks[e.task].name, strnlen(tasks[e.task].name, PROFILE_TASK_NAME));
+        std::string function = functionAt(elf, e.pc);
+        byTask[task] += e.count;
+        byFunction[function] += e.count;
+
+        std::string stack = task;
+        if (e.caller) {
+            std::string caller = functionAt(elf, e.caller);
+            if (caller != function) stack += ";" + caller;
+        }
+        byStack[stack + ";" + function] += e.count;
+    }
+
+    printf("%llu samples over %.1f s at %u Hz", (unsigned long long)total, header.durationMs / 1000.0, header.hz);
+    if (header.dropped) printf(" (%u dropped: table full)", header.dropped);
+    printf("\n");
+    if (total == 0) return 0;
+
+    printTable("By task:", byTask, total, tasks.size());
+    printTable("Flat profile (self):", byFunction, total, FLAT_ROWS);
+
+    if (foldedPath) {
+        FILE* out = fopen(foldedPath, "w");
+        if (!out) {
+            perror(foldedPath);
+            return 1;
+        }
+        for (const auto& s : byStack) {
+            // Folded stacks use spaces as the count separator
+            std::string frames = s.first;
+            std::replace(frames.begin(), frames.end(), ' ', '_');
+            fprintf(out, "%s %llu\n", frames.c_str(), (unsigned long long)s.second);
+        }
+        fclose(out);
+        printf("\nwrote %s\n", foldedPath);
+    }
+    return 0;
+}
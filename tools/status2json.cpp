@@ -0,0 +1,67 @@
+/**
+ * Word Clock - Binary Status Decoder
+ *
+ * Decodes /api/status.bin documents (see lib/WordClockCore/src/
+ * status_binary.h) into one JSON line each, for collectors that poll many
+ * clocks. Collectors written in C or C++ can link status_binary.cpp and
+ * call decodeStatusBinary() directly; it does not allocate.
+ *
+ * Build:  g++ -std=c++17 -O2 -o status2json tools/status2json.cpp lib/WordClockCore/src/status_binary.cpp
+ * Usage:  for h in clock1 clock2; do curl -so $h.bin http://$h.local/api/status.bin; done
+ *         ./status2json clock1.bin clock2.bin      (or one document on stdin)
+ */
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "../lib/WordClockCore/src/status_binary.h"
+
+// Reads one document; anything longer than this is not a status document
+static bool decodeFile(FILE* in, StatusBinary& status) {
+    uint8_t data[256];
+    size_t size = fread(data, 1, sizeof(data), in);
+    return size < sizeof(data) && decodeStatusBinary(data, size, status);
+}
+
+static void printStatus(const char* source, const StatusBinary& s) {
+    printf("{\"source\":\"%s\",\"version\":%u,\"uptime\":%" PRIu32 ",\"localTime\":%" PRIu32
+           ",\"lastSync\":%" PRIu32 ",\"syncState\":%u,\"lightLevel\":%u,\"brightness\":%u"
+           ",\"settingsVersion\":%" PRIu32 ",\"frame\":\"0x%016" PRIx64 "\",\"freeHeap\":%" PRIu32
+           ",\"minFreeHeap\":%" PRIu32 ",\"healthAlerts\":%u}\n",
+           source, s.version, s.uptimeSeconds, s.localTime, s.lastSync, s.syncState, s.lightLevel,
+           s.brightness, s.settingsVersion, s.frame, s.freeHeap, s.minFreeHeap, s.healthAlerts);
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && argv[1][0] == '-' && argv[1][1]) {
+        fprintf(stderr, "usage: %s [status.bin...] (reads stdin by default)\n", argv[0]);
+        return 2;
+    }
+
+    int failed = 0;
+    StatusBinary status;
+    if (argc == 1) {
+        if (!decodeFile(stdin, status)) {
+            fprintf(stderr, "stdin: not a status document\n");
+            return 1;
+        }
+        printStatus("-", status);
+        return 0;
+    }
+    for (int i = 1; i < argc; i++) {
+        FILE* in = fopen(argv[i], "rb");
+        if (!in) {
+            perror(argv[i]);
+            failed++;
+            continue;
+        }
+        if (decodeFile(in, status)) {
+            printStatus(argv[i], status);
+        } else {
+            fprintf(stderr, "%s: not a status document\n", argv[i]);
+            failed++;
+        }
+        fclose(in);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * Word Clock - Trace Converter
+ *
+ * Converts a dump downloaded from /api/trace into Chrome trace JSON, which
+ * loads directly into chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Build:  g++ -std=c++17 -O2 -o trace2json tools/trace2json.cpp
+ * Usage:  curl -o trace.bin http://wordclock.local/api/trace
+ *         ./trace2json trace.bin > trace.json
+ *
+ * Timestamps on the device are a 32-bit cycle counter that wraps every
+ * ~27 s at 160 MHz. The clock samples the light sensor every second, so
+ * consecutive events are always closer than one wrap and the converter
+ * unwraps them by assuming time only moves forward.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../src/trace.h"
+
+// Timeline rows in the viewer
+enum Track { TRACK_RENDER = 1, TRACK_LEDS, TRACK_HTTP, TRACK_SENSOR, TRACK_NETWORK };
+
+static const char* routeName(uint8_t route) {
+    switch (route) {
+        case TRACE_ROUTE_FAVICON: return "GET /favicon.ico";
+        case TRACE_ROUTE_BRIGHTNESS_PAGE: return "GET /brightness";
+        case TRACE_ROUTE_STATUS: return "GET /api/status";
+        case TRACE_ROUTE_SAVE_BRIGHTNESS: return "POST /api/saveBrightness";
+        case TRACE_ROUTE_TRACE: return "GET /api/trace";
+        case TRACE_ROUTE_PROFILE: return "/api/profile";
+        case TRACE_ROUTE_HEALTH: return "/api/health";
+        case TRACE_ROUTE_CURVE: return "/api/curve";
+        case TRACE_ROUTE_TRANSITION: return "/api/transition";
+        case TRACE_ROUTE_LIGHT: return "/api/light";
+        case TRACE_ROUTE_SETTINGS: return "/api/settings";
+        case TRACE_ROUTE_STATUS_BIN: return "GET /api/status.bin";
+        case TRACE_ROUTE_WAIT: return "GET /api/wait";
+        case TRACE_ROUTE_FRAME: return "GET /api/frame";
+        case TRACE_ROUTE_ADMISSION: return "/api/admission";
+        case TRACE_ROUTE_METRICS: return "GET /metrics";
+        case TRACE_ROUTE_UPDATE: return "/api/update";
+        default: return "HTTP";
+    }
+}
+
+static bool readDump(const char* path, TraceDumpHeader& header, std::vector<TraceEvent>& events) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    bool ok = fread(&header, sizeof(header), 1, f) == 1;
+    if (!ok || header.magic != TRACE_MAGIC) {
+        fprintf(stderr, "%s: not a word clock trace dump\n", path);
+        ok = false;
+    } else if (header.version != TRACE_FORMAT_VERSION || header.eventSize != sizeof(TraceEvent)) {
+        fprintf(stderr, "%s: unsupported trace format %u (event size %u)\n", path, header.version, header.eventSize);
+        ok = false;
+    } else {
+        events.resize(header.capacity);
+        if (fread(events.data(), sizeof(TraceEvent), header.capacity, f) != header.capacity) {
+            fprintf(stderr, "%s: truncated dump\n", path);
+            ok = false;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s trace.bin > trace.json\n", argv[0]);
+        return 2;
+    }
+
+    TraceDumpHeader header;
+    std::vector<TraceEvent> ring;
+    if (!readDump(argv[1], header, ring)) return 1;
+
+    // Put the events back in recording order, oldest first
+    uint32_t count = header.head < header.capacity ? header.head : header.capacity;
+    uint32_t first = header.head < header.capacity ? 0 : header.head % header.capacity;
+    double ticksPerMicro = header.ticksPerMicro ? header.ticksPerMicro : 1;
+
+    printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    printf("{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"args\":{\"name\":\"wordclock\"}}");
+    const char* trackNames[] = {"", "render", "leds", "http", "sensor", "network"};
+    for (int t = TRACK_RENDER; t <= TRACK_NETWORK; t++) {
+        printf(",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", t, trackNames[t]);
+    }
+
+    uint64_t elapsed = 0;
+    uint32_t previous = count ? ring[first].timestamp : 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const TraceEvent& e = ring[(first + i) % header.capacity];
+        elapsed += (uint32_t)(e.timestamp - previous);
+        previous = e.timestamp;
+        double ts = elapsed / ticksPerMicro;
+
+        switch (e.type) {
+            case TRACE_RENDER_BEGIN:
+                printf(",\n{\"ph\":\"B\",\"name\":\"render\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"time\":\"%02u:%02u\"}}",
+                       TRACK_RENDER, ts, e.arg8, e.arg16);
+                break;
+            case TRACE_RENDER_END:
+                printf(",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", TRACK_RENDER, ts);
+                break;
+            case TRACE_SHOW_BEGIN:
+                printf(",\n{\"ph\":\"B\",\"name\":\"show\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"brightness\":%u}}",
+                       TRACK_LEDS, ts, e.arg8);
+                break;
+            case TRACE_SHOW_END:
+                printf(",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", TRACK_LEDS, ts);
+                break;
+            case TRACE_ADC_SAMPLE:
+                printf(",\n{\"ph\":\"C\",\"name\":\"lightLevel\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"level\":%u}}",
+                       TRACK_SENSOR, ts, e.arg16);
+                break;
+            case TRACE_HTTP_BEGIN:
+                printf(",\n{\"ph\":\"B\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", routeName(e.arg8), TRACK_HTTP, ts);
+                break;
+            case TRACE_HTTP_END:
+                printf(",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", TRACK_HTTP, ts);
+                break;
+            case TRACE_NTP_SYNC:
+                printf(",\n{\"ph\":\"i\",\"s\":\"g\",\"name\":\"ntp sync\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"timeStatus\":%u}}",
+                       TRACK_NETWORK, ts, e.arg8);
+                break;
+            case TRACE_WIFI_STATE:
+                printf(",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"wifi event\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"event\":%u}}",
+                       TRACK_NETWORK, ts, e.arg8);
+                break;
+            default:
+                fprintf(stderr, "skipping unknown event type %u\n", e.type);
+                break;
+        }
+    }
+    printf("\n]}\n");
+
+    fprintf(stderr, "%u events (%u recorded, %u overwritten), %.3f s span\n",
+            count, header.head, header.head - count, elapsed / ticksPerMicro / 1e6);
+    return 0;
+}
@@ -0,0 +1,274 @@
+/**
+ * Word Clock - Golden frame verification
+ *
+ * Drives the clock face through simulated time as fast as the host allows
+ * and compares every displayed frame with verify/golden_frames.txt, which
+ * lists the expected LED mask for each minute of the day.
+ *
+ * Sweeps:
+ * 1. Every second of --days local days (default 365), straight through
+ *    rounding, the "TO" switch and the 12/0 hour handling
+ * 2. Every second of --year (default 2025, plus a day either side) in each
+ *    zone of COMMON_TIMEZONES, converting from UTC with the zone's POSIX
+ *    rule, so both DST transitions are crossed. Each transition must move
+ *    local time by exactly the zone's DST delta.
+ *
+ * The display logic mirrors displayTime(): the frame is only re-rendered
+ * when the rounded time changes, and each render is checked LED by LED.
+ * Zones are swept in parallel, one per hardware thread.
+ *
+ * Usage: program [--golden FILE] [--write-golden] [--days N] [--year YYYY]
+ *   pio run -e golden -t exec
+ * Exits non-zero if any frame differs from the golden file.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <word_clock_core.h>
+
+#define MINUTES_PER_DAY (24 * 60)
+#define MAX_REPORTED_FAILURES 20
+
+typedef FrameMask GoldenTable[MINUTES_PER_DAY];
+
+struct Failure {
+    std::string sweep;
+    time_t clockTime;  // Time reported by the clock source
+    time_t localTime;
+    FrameMask expected;
+    FrameMask actual;
+};
+
+/**
+ * The firmware's display path, minus the LEDs' hardware
+ */
+class RenderHarness {
+public:
+    // Advances to a new local minute of the day; returns false if a render was wrong
+    bool tick(int minuteOfDay) {
+        FaceTime rounded = roundTime(minuteOfDay / 60, minuteOfDay % 60);
+        if (rounded == lastTime) return true;
+
+        lastTime = rounded;
+        frame = frameFor(rounded);
+        renderFrame(frame, leds);
+        renders++;
+        for (int i = 0; i < FACE_LEDS; i++) {
+            bool lit = (frame >> i) & 1;
+            if (leds[i] != (lit ? CRGB(CRGB::White) : CRGB(CRGB::Black))) return false;
+        }
+        return true;
+    }
+
+    FrameMask frame = 0;
+    uint64_t renders = 0;
+
+private:
+    FaceTime lastTime = {0xFF, 0xFF};
+    CRGB leds[FACE_LEDS];
+};
+
+static std::mutex failureLock;
+static std::vector<Failure> failures;
+static uint64_t failureCount = 0;
+
+static void fail(const std::string& sweep, time_t clockTime, time_t localTime, FrameMask expected, FrameMask actual) {
+    std::lock_guard<std::mutex> guard(failureLock);
+    failureCount++;
+    if (failures.size() < MAX_REPORTED_FAILURES) {
+        failures.push_back({sweep, clockTime, localTime, expected, actual});
+    }
+}
+
+/**
+ * Runs `clock` one second at a time from `from` to `to` (clock time)
+ * @return Number of simulated seconds
+ */
+template <typename Clock>
+static uint64_t sweep(const std::string& name, ManualClock& driver, Clock& clock,
+                      time_t from, time_t to, const GoldenTable& golden,
+                      int32_t expectedJump, int& jumps) {
+    RenderHarness display;
+    time_t previous = 0;
+    jumps = 0;
+    for (time_t t = from; t < to; t++) {
+        driver.set(t);
+        time_t local = clock.now();
+
+        if (t != from && local - previous != 1) {
+            jumps++;
+            int32_t jump = (int32_t)(local - previous - 1);
+            if (jump != expectedJump && jump != -expectedJump) {
+                fail(name + " (unexpected jump of " + std::to_string(jump) + " s)", t, local, 0, 0);
+            }
+        }
+        previous = local;
+
+        int minuteOfDay = (int)(((local % 86400) + 86400) % 86400) / 60;
+        bool rendered = display.tick(minuteOfDay);
+        FrameMask expected = golden[minuteOfDay];
+        if (!rendered || display.frame != expected) {
+            fail(name, t, local, expected, display.frame);
+        }
+    }
+    return (uint64_t)(to - from);
+}
+
+static bool loadGolden(const char* path, GoldenTable& golden) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    std::vector<bool> seen(MINUTES_PER_DAY, false);
+    char line[256];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNumber++;
+        if (line[0] == '#' || line[0] == '\n') continue;
+        int hour, minute;
+        unsigned long long mask;
+        if (sscanf(line, "%d:%d %llx", &hour, &minute, &mask) != 3 || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+            fprintf(stderr, "%s:%d: malformed line\n", path, lineNumber);
+            fclose(f);
+            return false;
+        }
+        golden[hour * 60 + minute] = mask;
+        seen[hour * 60 + minute] = true;
+    }
+    fclose(f);
+    for (int m = 0; m < MINUTES_PER_DAY; m++) {
+        if (!seen[m]) {
+            fprintf(stderr, "%s: no frame for %02d:%02d\n", path, m / 60, m % 60);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool writeGolden(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fprintf(f, "# Expected LED mask (bit N = LED N) for every minute of the day.\n");
+    fprintf(f, "# Regenerate with --write-golden only after checking the phrase column by hand.\n");
+    for (int m = 0; m < MINUTES_PER_DAY; m++) {
+        FrameMask frame = frameFor(roundTime(m / 60, m % 60));
+        fprintf(f, "%02d:%02d 0x%016llx ", m / 60, m % 60, (unsigned long long)frame);
+        for (int w = 0; w < WORD_COUNT; w++) {
+            if ((frame >> WORDS[w][0]) & 1) fprintf(f, " %s", WORD_NAMES[w]);
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    return true;
+}
+
+static void printTime(time_t t) {
+    struct tm fields;
+    char text[32];
+    gmtime_r(&t, &fields);
+    strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &fields);
+    printf("%s", text);
+}
+
+int main(int argc, char** argv) {
+    const char* goldenPath = "verify/golden_frames.txt";
+    bool write = false;
+    int days = 365;
+    int year = 2025;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--golden") && i + 1 < argc) goldenPath = argv[++i];
+        else if (!strcmp(argv[i], "--write-golden")) write = true;
+        else if (!strcmp(argv[i], "--days") && i + 1 < argc) days = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--year") && i + 1 < argc) year = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--golden FILE] [--write-golden] [--days N] [--year YYYY]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (write) {
+        if (!writeGolden(goldenPath)) return 1;
+        printf("wrote %s\n", goldenPath);
+        return 0;
+    }
+
+    static GoldenTable golden;
+    if (!loadGolden(goldenPath, golden)) return 1;
+
+    auto started = std::chrono::steady_clock::now();
+    uint64_t simulated = 0;
+    int jumps;
+
+    // 1. Local time, no timezone
+    ManualClock localClock;
+    simulated += sweep("local", localClock, localClock, 0, (time_t)days * 86400, golden, 0, jumps);
+
+    // 2. Each common zone across a year of DST transitions, one zone per thread
+    time_t yearStart = (time_t)(daysFromCivil(year, 1, 1) * 86400) - 86400;
+    time_t yearEnd = (time_t)(daysFromCivil(year + 1, 1, 1) * 86400) + 86400;
+    std::vector<int> zoneJumps(COMMON_TIMEZONE_COUNT, -1);
+    std::atomic<size_t> nextZone{0};
+    std::atomic<uint64_t> zoneSeconds{0};
+    auto worker = [&]() {
+        for (size_t z; (z = nextZone++) < COMMON_TIMEZONE_COUNT;) {
+            PosixTimezone zone;
+            if (!zone.parse(COMMON_TIMEZONE_RULES[z])) {
+                fail(std::string(COMMON_TIMEZONES[z]) + " (bad POSIX rule)", 0, 0, 0, 0);
+                continue;
+            }
+            ManualClock utc;
+            ZonedClock clock(utc, zone);
+            int32_t dstDelta = zone.daylightOffset() - zone.standardOffset();
+            zoneSeconds += sweep(COMMON_TIMEZONES[z], utc, clock, yearStart, yearEnd, golden, dstDelta, zoneJumps[z]);
+
+            int expectedJumps = zone.hasDst() ? 2 : 0;
+            if (zoneJumps[z] != expectedJumps) {
+                fail(std::string(COMMON_TIMEZONES[z]) + " (expected " + std::to_string(expectedJumps) + " transitions)", 0, 0, 0, 0);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threadCount; i++) threads.emplace_back(worker);
+    for (std::thread& t : threads) t.join();
+    simulated += zoneSeconds;
+
+    for (size_t z = 0; z < COMMON_TIMEZONE_COUNT; z++) {
+        printf("%-20s %-32s %d transitions\n", COMMON_TIMEZONES[z], COMMON_TIMEZONE_RULES[z], zoneJumps[z]);
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    double simulatedDays = simulated / 86400.0;
+    printf("\nsimulated %.0f days (%llu s) in %.3f s on %u threads: %.0f days/s, %.1f M frames checked/s\n",
+           simulatedDays, (unsigned long long)simulated, elapsed, threadCount, simulatedDays / elapsed, simulated / elapsed / 1e6);
+
+    if (failureCount == 0) {
+        printf("all frames match %s\n", goldenPath);
+        return 0;
+    }
+
+    printf("%llu frames differ from %s", (unsigned long long)failureCount, goldenPath);
+    if (failureCount > failures.size()) printf(" (first %zu shown)", failures.size());
+    printf(":\n");
+    for (const Failure& f : failures) {
+        printf("  %s: clock ", f.sweep.c_str());
+        printTime(f.clockTime);
+        printf(" local ");
+        printTime(f.localTime);
+        printf(" expected 0x%016llx got 0x%016llx\n", (unsigned long long)f.expected, (unsigned long long)f.actual);
+    }
+    return 1;
+}